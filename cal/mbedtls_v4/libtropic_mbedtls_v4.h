@@ -23,6 +23,8 @@ typedef struct lt_aesgcm_ctx_mbedtls_v4_t {
     psa_key_id_t key_id;
     /** @private @brief Flag indicating if key is set. */
     uint8_t key_set;
+    /** @private @brief Multi-part operation of a message processed in parts. */
+    psa_aead_operation_t operation;
 } lt_aesgcm_ctx_mbedtls_v4_t;
 
 /**
@@ -6,6 +6,7 @@
  */
 
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -64,8 +65,15 @@ static lt_ret_t lt_aesgcm_init(lt_aesgcm_ctx_mbedtls_v4_t *ctx, const uint8_t *k
  */
 static lt_ret_t lt_aesgcm_deinit(lt_aesgcm_ctx_mbedtls_v4_t *ctx)
 {
+    // Unfinished message might be left behind, aborting an inactive operation does nothing.
+    psa_status_t status = psa_aead_abort(&ctx->operation);
+    if (status != PSA_SUCCESS) {
+        LT_LOG_ERROR("Failed to abort AES-GCM operation, status=%" PRId32 " (psa_status_t)", status);
+        return LT_CRYPTO_ERR;
+    }
+
     if (ctx->key_set) {
-        psa_status_t status = psa_destroy_key(ctx->key_id);
+        status = psa_destroy_key(ctx->key_id);
         if (status != PSA_SUCCESS) {
             LT_LOG_ERROR("Failed to destroy AES-GCM key, status=%" PRId32 " (psa_status_t)", status);
             return LT_CRYPTO_ERR;
@@ -75,6 +83,11 @@ static lt_ret_t lt_aesgcm_deinit(lt_aesgcm_ctx_mbedtls_v4_t *ctx)
     return LT_OK;
 }
 
+bool lt_aesgcm_streaming_supported(void)
+{
+    return true;
+}
+
 lt_ret_t lt_aesgcm_encrypt_init(void *ctx, const uint8_t *key, const uint32_t key_len)
 {
     lt_ctx_mbedtls_v4_t *_ctx = (lt_ctx_mbedtls_v4_t *)ctx;
@@ -89,6 +102,93 @@ lt_ret_t lt_aesgcm_decrypt_init(void *ctx, const uint8_t *key, const uint32_t ke
     return lt_aesgcm_init(&_ctx->aesgcm_decrypt_ctx, key, key_len);
 }
 
+/**
+ * @brief Starts MbedTLS AES-GCM multi-part operation.
+ *
+ * @param ctx      AES-GCM context structure (MbedTLS specific)
+ * @param encrypt  True to start encryption, false to start decryption
+ * @param iv       Initialization vector
+ * @param iv_len   Length of the initialization vector
+ * @param add      Additional data
+ * @param add_len  Length of additional data
+ * @return         LT_OK if success, otherwise returns other error code.
+ */
+static lt_ret_t lt_aesgcm_start(lt_aesgcm_ctx_mbedtls_v4_t *ctx, const bool encrypt, const uint8_t *iv,
+                                const uint32_t iv_len, const uint8_t *add, const uint32_t add_len)
+{
+    psa_status_t status;
+
+    if (!ctx->key_set) {
+        LT_LOG_ERROR("AES-GCM context key not set!");
+        return LT_CRYPTO_ERR;
+    }
+
+    // Previous message might not have been finished (e.g. its transfer failed).
+    status = psa_aead_abort(&ctx->operation);
+    if (status != PSA_SUCCESS) {
+        LT_LOG_ERROR("Failed to abort AES-GCM operation, status=%" PRId32 " (psa_status_t)", status);
+        return LT_CRYPTO_ERR;
+    }
+
+    if (encrypt) {
+        status = psa_aead_encrypt_setup(&ctx->operation, ctx->key_id, PSA_ALG_GCM);
+    }
+    else {
+        status = psa_aead_decrypt_setup(&ctx->operation, ctx->key_id, PSA_ALG_GCM);
+    }
+    if (status == PSA_SUCCESS) {
+        status = psa_aead_set_nonce(&ctx->operation, iv, iv_len);
+    }
+    if (status == PSA_SUCCESS && add_len) {
+        status = psa_aead_update_ad(&ctx->operation, add, add_len);
+    }
+
+    if (status != PSA_SUCCESS) {
+        LT_LOG_ERROR("Failed to start AES-GCM operation, status=%" PRId32 " (psa_status_t)", status);
+        psa_aead_abort(&ctx->operation);
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+/**
+ * @brief Processes next part of the message in MbedTLS AES-GCM multi-part operation.
+ *
+ * @param ctx      AES-GCM context structure (MbedTLS specific)
+ * @param input    Input buffer
+ * @param output   Output buffer
+ * @param len      Length of the part in bytes
+ * @return         LT_OK if success, otherwise returns other error code.
+ */
+static lt_ret_t lt_aesgcm_update(lt_aesgcm_ctx_mbedtls_v4_t *ctx, const uint8_t *input, uint8_t *output,
+                                 const uint32_t len)
+{
+    size_t resulting_length;
+
+    // Some implementations of MbedTLS (e.g. in ESP-IDF) require output != NULL and non-zero length.
+    if (!len) {
+        return LT_OK;
+    }
+
+    psa_status_t status = psa_aead_update(&ctx->operation, input, len, output, len, &resulting_length);
+    if (status != PSA_SUCCESS) {
+        LT_LOG_ERROR("AES-GCM update failed, status=%" PRId32 " (psa_status_t)", status);
+        psa_aead_abort(&ctx->operation);
+        return LT_CRYPTO_ERR;
+    }
+
+    // The rest of the message is expected to be processed by each update, as the output is written in place.
+    if (resulting_length != len) {
+        LT_LOG_ERROR("AES-GCM update output length mismatch! Current: %zu bytes, expected: %" PRIu32 " bytes",
+                     resulting_length, len);
+        psa_aead_abort(&ctx->operation);
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
 lt_ret_t lt_aesgcm_encrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
                            const uint32_t add_len, const uint8_t *plaintext, const uint32_t plaintext_len,
                            uint8_t *ciphertext, const uint32_t ciphertext_len)
@@ -177,6 +277,96 @@ lt_ret_t lt_aesgcm_decrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len,
     return LT_OK;
 }
 
+lt_ret_t lt_aesgcm_encrypt_start(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                                 const uint32_t add_len)
+{
+    lt_ctx_mbedtls_v4_t *_ctx = (lt_ctx_mbedtls_v4_t *)ctx;
+
+    return lt_aesgcm_start(&_ctx->aesgcm_encrypt_ctx, true, iv, iv_len, add, add_len);
+}
+
+lt_ret_t lt_aesgcm_encrypt_update(void *ctx, const uint8_t *plaintext, uint8_t *ciphertext, const uint32_t len)
+{
+    lt_ctx_mbedtls_v4_t *_ctx = (lt_ctx_mbedtls_v4_t *)ctx;
+
+    return lt_aesgcm_update(&_ctx->aesgcm_encrypt_ctx, plaintext, ciphertext, len);
+}
+
+lt_ret_t lt_aesgcm_encrypt_finish(void *ctx, uint8_t *tag, const uint32_t tag_len)
+{
+    lt_ctx_mbedtls_v4_t *_ctx = (lt_ctx_mbedtls_v4_t *)ctx;
+    uint8_t rest[PSA_AEAD_FINISH_OUTPUT_SIZE(PSA_KEY_TYPE_AES, PSA_ALG_GCM)];
+    size_t rest_length;
+    size_t tag_length;
+
+    psa_status_t status = psa_aead_finish(&_ctx->aesgcm_encrypt_ctx.operation, rest, sizeof(rest), &rest_length, tag,
+                                          tag_len, &tag_length);
+    if (status != PSA_SUCCESS) {
+        LT_LOG_ERROR("AES-GCM encryption finish failed, status=%" PRId32 " (psa_status_t)", status);
+        psa_aead_abort(&_ctx->aesgcm_encrypt_ctx.operation);
+        return LT_CRYPTO_ERR;
+    }
+
+    if (rest_length != 0 || tag_length != tag_len) {
+        LT_LOG_ERROR("AES-GCM encryption finish output length mismatch! Rest: %zu bytes, tag: %zu bytes", rest_length,
+                     tag_length);
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_decrypt_start(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                                 const uint32_t add_len)
+{
+    lt_ctx_mbedtls_v4_t *_ctx = (lt_ctx_mbedtls_v4_t *)ctx;
+
+    return lt_aesgcm_start(&_ctx->aesgcm_decrypt_ctx, false, iv, iv_len, add, add_len);
+}
+
+lt_ret_t lt_aesgcm_decrypt_update(void *ctx, const uint8_t *ciphertext, uint8_t *plaintext, const uint32_t len)
+{
+    lt_ctx_mbedtls_v4_t *_ctx = (lt_ctx_mbedtls_v4_t *)ctx;
+
+    return lt_aesgcm_update(&_ctx->aesgcm_decrypt_ctx, ciphertext, plaintext, len);
+}
+
+lt_ret_t lt_aesgcm_decrypt_finish(void *ctx, const uint8_t *tag, const uint32_t tag_len)
+{
+    lt_ctx_mbedtls_v4_t *_ctx = (lt_ctx_mbedtls_v4_t *)ctx;
+    uint8_t rest[PSA_AEAD_VERIFY_OUTPUT_SIZE(PSA_KEY_TYPE_AES, PSA_ALG_GCM)];
+    size_t rest_length;
+
+    psa_status_t status
+        = psa_aead_verify(&_ctx->aesgcm_decrypt_ctx.operation, rest, sizeof(rest), &rest_length, tag, tag_len);
+    if (status != PSA_SUCCESS) {
+        LT_LOG_ERROR("AES-GCM decryption finish failed, status=%" PRId32 " (psa_status_t)", status);
+        psa_aead_abort(&_ctx->aesgcm_decrypt_ctx.operation);
+        return LT_CRYPTO_ERR;
+    }
+
+    if (rest_length != 0) {
+        LT_LOG_ERROR("AES-GCM decryption finish output length mismatch! Current: %zu bytes, expected: 0 bytes",
+                     rest_length);
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_decrypt_abort(void *ctx)
+{
+    lt_ctx_mbedtls_v4_t *_ctx = (lt_ctx_mbedtls_v4_t *)ctx;
+
+    psa_status_t status = psa_aead_abort(&_ctx->aesgcm_decrypt_ctx.operation);
+    if (status != PSA_SUCCESS) {
+        LT_LOG_ERROR("Failed to abort AES-GCM decryption, status=%" PRId32 " (psa_status_t)", status);
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
 lt_ret_t lt_aesgcm_encrypt_deinit(void *ctx)
 {
     lt_ctx_mbedtls_v4_t *_ctx = (lt_ctx_mbedtls_v4_t *)ctx;
@@ -22,6 +22,8 @@ lt_ret_t lt_crypto_ctx_init(void *ctx)
 
     _ctx->aesgcm_encrypt_ctx.key_set = 0;
     _ctx->aesgcm_decrypt_ctx.key_set = 0;
+    _ctx->aesgcm_encrypt_ctx.operation = psa_aead_operation_init();
+    _ctx->aesgcm_decrypt_ctx.operation = psa_aead_operation_init();
 
     return LT_OK;
 }
@@ -0,0 +1,57 @@
+/**
+ * @file lt_mbedtls_v4_ecdsa_p256.c
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see LICENSE.md in the root directory of this source tree.
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wredundant-decls"
+#include "psa/crypto.h"
+#pragma GCC diagnostic pop
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "lt_ecdsa_p256.h"
+
+lt_ret_t lt_ecdsa_p256_verify(const uint8_t *pubkey, const uint8_t *digest, const uint8_t *signature)
+{
+    psa_status_t status;
+    psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
+    psa_key_id_t key_id = 0;
+
+    // Set up key attributes for P-256 public key
+    psa_set_key_usage_flags(&attributes, PSA_KEY_USAGE_VERIFY_HASH);
+    psa_set_key_algorithm(&attributes, PSA_ALG_ECDSA(PSA_ALG_SHA_256));
+    psa_set_key_type(&attributes, PSA_KEY_TYPE_ECC_PUBLIC_KEY(PSA_ECC_FAMILY_SECP_R1));
+    psa_set_key_bits(&attributes, 256);
+
+    // Import the public key (uncompressed point)
+    status = psa_import_key(&attributes, pubkey, LT_ECDSA_P256_PUBKEY_LEN, &key_id);
+    psa_reset_key_attributes(&attributes);
+
+    if (status != PSA_SUCCESS) {
+        LT_LOG_ERROR("Couldn't import P-256 public key, status=%" PRId32 " (psa_status_t)", status);
+        return LT_CRYPTO_ERR;
+    }
+
+    status = psa_verify_hash(key_id, PSA_ALG_ECDSA(PSA_ALG_SHA_256), digest, LT_ECDSA_P256_DIGEST_LEN, signature,
+                             LT_ECDSA_P256_SIGNATURE_LEN);
+
+    // Clean up
+    psa_status_t destroy_key_status = psa_destroy_key(key_id);
+
+    if (status != PSA_SUCCESS) {
+        LT_LOG_ERROR("P-256 signature verification failed, status=%" PRId32 " (psa_status_t)", status);
+        return LT_CRYPTO_ERR;
+    }
+
+    if (destroy_key_status != PSA_SUCCESS) {
+        LT_LOG_ERROR("Couldn't destroy P-256 public key, status=%" PRId32 " (psa_status_t)", destroy_key_status);
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
@@ -17,6 +17,11 @@
 #include "libtropic_openssl.h"
 #include "lt_aesgcm.h"
 
+bool lt_aesgcm_streaming_supported(void)
+{
+    return true;
+}
+
 lt_ret_t lt_aesgcm_encrypt_init(void *ctx, const uint8_t *key, const uint32_t key_len)
 {
     if (key_len != TR01_AES256_KEY_LEN) {
@@ -111,9 +116,8 @@ lt_ret_t lt_aesgcm_decrypt_init(void *ctx, const uint8_t *key, const uint32_t ke
     return LT_OK;
 }
 
-lt_ret_t lt_aesgcm_encrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
-                           const uint32_t add_len, const uint8_t *plaintext, const uint32_t plaintext_len,
-                           uint8_t *ciphertext, const uint32_t ciphertext_len)
+lt_ret_t lt_aesgcm_encrypt_start(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                                 const uint32_t add_len)
 {
     if (iv_len != TR01_L3_IV_SIZE) {
         LT_LOG_ERROR("Invalid AES-GCM IV length: got %" PRIu32 " bytes, expected %d bytes", iv_len, TR01_L3_IV_SIZE);
@@ -139,8 +143,22 @@ lt_ret_t lt_aesgcm_encrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len,
         return LT_CRYPTO_ERR;
     }
 
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_encrypt_update(void *ctx, const uint8_t *plaintext, uint8_t *ciphertext, const uint32_t len)
+{
+    lt_ctx_openssl_t *_ctx = (lt_ctx_openssl_t *)ctx;
+    unsigned long err_code;
+    int out_len;
+
+    // With NULL output, EVP_EncryptUpdate() would take the data as AAD.
+    if (!len) {
+        return LT_OK;
+    }
+
     // Encrypt plaintext.
-    if (!EVP_EncryptUpdate(_ctx->aesgcm_encrypt_ctx, ciphertext, &out_len, plaintext, (int)plaintext_len)) {
+    if (!EVP_EncryptUpdate(_ctx->aesgcm_encrypt_ctx, ciphertext, &out_len, plaintext, (int)len)) {
         err_code = ERR_get_error();
         LT_LOG_ERROR("Failed to encrypt AES-GCM plaintext, err_code=%lu (%s)", err_code,
                      ERR_error_string(err_code, NULL));
@@ -148,14 +166,23 @@ lt_ret_t lt_aesgcm_encrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len,
     }
 
     // Check that all plaintext data was processed.
-    if (out_len != (int)(ciphertext_len - TR01_L3_TAG_SIZE)) {
+    if (out_len != (int)len) {
         LT_LOG_ERROR("AES-GCM encryption length mismatch! Current: %d bytes, expected: %" PRIu32 " bytes", out_len,
-                     ciphertext_len - TR01_L3_TAG_SIZE);
+                     len);
         return LT_CRYPTO_ERR;
     }
 
-    // Finalize encryption.
-    if (!EVP_EncryptFinal_ex(_ctx->aesgcm_encrypt_ctx, ciphertext + out_len, &out_len)) {
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_encrypt_finish(void *ctx, uint8_t *tag, const uint32_t tag_len)
+{
+    lt_ctx_openssl_t *_ctx = (lt_ctx_openssl_t *)ctx;
+    unsigned long err_code;
+    int out_len;
+
+    // Finalize encryption, GCM does not output any data here.
+    if (!EVP_EncryptFinal_ex(_ctx->aesgcm_encrypt_ctx, NULL, &out_len)) {
         err_code = ERR_get_error();
         LT_LOG_ERROR("Failed to finalize AES-GCM encryption, err_code=%lu (%s)", err_code,
                      ERR_error_string(err_code, NULL));
@@ -163,8 +190,7 @@ lt_ret_t lt_aesgcm_encrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len,
     }
 
     // Get the tag.
-    if (!EVP_CIPHER_CTX_ctrl(_ctx->aesgcm_encrypt_ctx, EVP_CTRL_GCM_GET_TAG, TR01_L3_TAG_SIZE,
-                             ciphertext + plaintext_len)) {
+    if (!EVP_CIPHER_CTX_ctrl(_ctx->aesgcm_encrypt_ctx, EVP_CTRL_GCM_GET_TAG, (int)tag_len, tag)) {
         err_code = ERR_get_error();
         LT_LOG_ERROR("Failed to get AES-GCM encryption tag, err_code=%lu (%s)", err_code,
                      ERR_error_string(err_code, NULL));
@@ -174,9 +200,8 @@ lt_ret_t lt_aesgcm_encrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len,
     return LT_OK;
 }
 
-lt_ret_t lt_aesgcm_decrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
-                           const uint32_t add_len, const uint8_t *ciphertext, const uint32_t ciphertext_len,
-                           uint8_t *plaintext, const uint32_t plaintext_len)
+lt_ret_t lt_aesgcm_decrypt_start(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                                 const uint32_t add_len)
 {
     if (iv_len != TR01_L3_IV_SIZE) {
         LT_LOG_ERROR("Invalid AES-GCM IV length: got %" PRIu32 " bytes, expected %d bytes", iv_len, TR01_L3_IV_SIZE);
@@ -202,9 +227,22 @@ lt_ret_t lt_aesgcm_decrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len,
         return LT_CRYPTO_ERR;
     }
 
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_decrypt_update(void *ctx, const uint8_t *ciphertext, uint8_t *plaintext, const uint32_t len)
+{
+    lt_ctx_openssl_t *_ctx = (lt_ctx_openssl_t *)ctx;
+    unsigned long err_code;
+    int out_len;
+
+    // With NULL output, EVP_DecryptUpdate() would take the data as AAD.
+    if (!len) {
+        return LT_OK;
+    }
+
     // Decrypt ciphertext.
-    if (!EVP_DecryptUpdate(_ctx->aesgcm_decrypt_ctx, plaintext, &out_len, ciphertext,
-                           (int)(ciphertext_len - TR01_L3_TAG_SIZE))) {
+    if (!EVP_DecryptUpdate(_ctx->aesgcm_decrypt_ctx, plaintext, &out_len, ciphertext, (int)len)) {
         err_code = ERR_get_error();
         LT_LOG_ERROR("Failed to decrypt AES-GCM ciphertext, err_code=%lu (%s)", err_code,
                      ERR_error_string(err_code, NULL));
@@ -212,23 +250,31 @@ lt_ret_t lt_aesgcm_decrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len,
     }
 
     // Check that all ciphertext data was processed.
-    if (out_len != (int)(plaintext_len)) {
+    if (out_len != (int)len) {
         LT_LOG_ERROR("AES-GCM decryption length mismatch! Current: %d bytes, expected: %" PRIu32 " bytes", out_len,
-                     plaintext_len);
+                     len);
         return LT_CRYPTO_ERR;
     }
 
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_decrypt_finish(void *ctx, const uint8_t *tag, const uint32_t tag_len)
+{
+    lt_ctx_openssl_t *_ctx = (lt_ctx_openssl_t *)ctx;
+    unsigned long err_code;
+    int out_len;
+
     // Set expected tag value.
-    if (!EVP_CIPHER_CTX_ctrl(_ctx->aesgcm_decrypt_ctx, EVP_CTRL_GCM_SET_TAG, TR01_L3_TAG_SIZE,
-                             (void *)(ciphertext + ciphertext_len - TR01_L3_TAG_SIZE))) {
+    if (!EVP_CIPHER_CTX_ctrl(_ctx->aesgcm_decrypt_ctx, EVP_CTRL_GCM_SET_TAG, (int)tag_len, (void *)tag)) {
         err_code = ERR_get_error();
         LT_LOG_ERROR("Failed to set AES-GCM decryption tag, err_code=%lu (%s)", err_code,
                      ERR_error_string(err_code, NULL));
         return LT_CRYPTO_ERR;
     }
 
-    // Finalize decryption.
-    if (EVP_DecryptFinal_ex(_ctx->aesgcm_decrypt_ctx, plaintext + out_len, &out_len) <= 0) {
+    // Finalize decryption, GCM does not output any data here.
+    if (EVP_DecryptFinal_ex(_ctx->aesgcm_decrypt_ctx, NULL, &out_len) <= 0) {
         err_code = ERR_get_error();
         LT_LOG_ERROR("Failed to finalize AES-GCM decryption, err_code=%lu (%s)", err_code,
                      ERR_error_string(err_code, NULL));
@@ -238,6 +284,69 @@ lt_ret_t lt_aesgcm_decrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len,
     return LT_OK;
 }
 
+lt_ret_t lt_aesgcm_decrypt_abort(void *ctx)
+{
+    lt_ctx_openssl_t *_ctx = (lt_ctx_openssl_t *)ctx;
+    const uint8_t zero_iv[TR01_L3_IV_SIZE] = {0};
+    unsigned long err_code;
+
+    // Setting an IV restarts the message, so the state of the unfinished one is dropped and the key is kept.
+    if (!EVP_DecryptInit_ex(_ctx->aesgcm_decrypt_ctx, NULL, NULL, NULL, zero_iv)) {
+        err_code = ERR_get_error();
+        LT_LOG_ERROR("Failed to abort AES-GCM decryption, err_code=%lu (%s)", err_code,
+                     ERR_error_string(err_code, NULL));
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_encrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                           const uint32_t add_len, const uint8_t *plaintext, const uint32_t plaintext_len,
+                           uint8_t *ciphertext, const uint32_t ciphertext_len)
+{
+    if (ciphertext_len != plaintext_len + TR01_L3_TAG_SIZE) {
+        LT_LOG_ERROR("AES-GCM encryption length mismatch! Current: %" PRIu32 " bytes, expected: %" PRIu32 " bytes",
+                     ciphertext_len, plaintext_len + TR01_L3_TAG_SIZE);
+        return LT_PARAM_ERR;
+    }
+
+    lt_ret_t ret = lt_aesgcm_encrypt_start(ctx, iv, iv_len, add, add_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_aesgcm_encrypt_update(ctx, plaintext, ciphertext, plaintext_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    return lt_aesgcm_encrypt_finish(ctx, ciphertext + plaintext_len, TR01_L3_TAG_SIZE);
+}
+
+lt_ret_t lt_aesgcm_decrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                           const uint32_t add_len, const uint8_t *ciphertext, const uint32_t ciphertext_len,
+                           uint8_t *plaintext, const uint32_t plaintext_len)
+{
+    if (ciphertext_len != plaintext_len + TR01_L3_TAG_SIZE) {
+        LT_LOG_ERROR("AES-GCM decryption length mismatch! Current: %" PRIu32 " bytes, expected: %" PRIu32 " bytes",
+                     ciphertext_len, plaintext_len + TR01_L3_TAG_SIZE);
+        return LT_PARAM_ERR;
+    }
+
+    lt_ret_t ret = lt_aesgcm_decrypt_start(ctx, iv, iv_len, add, add_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_aesgcm_decrypt_update(ctx, ciphertext, plaintext, plaintext_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    return lt_aesgcm_decrypt_finish(ctx, ciphertext + plaintext_len, TR01_L3_TAG_SIZE);
+}
+
 lt_ret_t lt_aesgcm_encrypt_deinit(void *ctx)
 {
     lt_ctx_openssl_t *_ctx = (lt_ctx_openssl_t *)ctx;
@@ -0,0 +1,96 @@
+/**
+ * @file lt_openssl_ecdsa_p256.c
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see LICENSE.md in the root directory of this source tree.
+ */
+
+#include <inttypes.h>
+#include <openssl/bn.h>
+#include <openssl/core_names.h>
+#include <openssl/ecdsa.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/params.h>
+#include <stdint.h>
+
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "lt_ecdsa_p256.h"
+
+lt_ret_t lt_ecdsa_p256_verify(const uint8_t *pubkey, const uint8_t *digest, const uint8_t *signature)
+{
+    EVP_PKEY_CTX *ctx = NULL;
+    EVP_PKEY *pub = NULL;
+    ECDSA_SIG *sig = NULL;
+    BIGNUM *r = NULL, *s = NULL;
+    unsigned char *sig_der = NULL;
+    lt_ret_t lt_ret = LT_OK;
+    unsigned long err_code;
+
+    // Create public key EVP_PKEY structure from the uncompressed point.
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_utf8_string(OSSL_PKEY_PARAM_GROUP_NAME, (char *)"prime256v1", 0),
+        OSSL_PARAM_construct_octet_string(OSSL_PKEY_PARAM_PUB_KEY, (void *)pubkey, LT_ECDSA_P256_PUBKEY_LEN),
+        OSSL_PARAM_construct_end()};
+    ctx = EVP_PKEY_CTX_new_from_name(NULL, "EC", NULL);
+    if (!ctx || EVP_PKEY_fromdata_init(ctx) <= 0 || EVP_PKEY_fromdata(ctx, &pub, EVP_PKEY_PUBLIC_KEY, params) <= 0) {
+        err_code = ERR_get_error();
+        LT_LOG_ERROR("Failed to create P-256 public key EVP_PKEY structure, err_code=%lu (%s)", err_code,
+                     ERR_error_string(err_code, NULL));
+        lt_ret = LT_CRYPTO_ERR;
+        goto lt_ecdsa_p256_verify_cleanup;
+    }
+    EVP_PKEY_CTX_free(ctx);
+    ctx = NULL;
+
+    // EVP expects the signature DER encoded.
+    sig = ECDSA_SIG_new();
+    r = BN_bin2bn(signature, LT_ECDSA_P256_SIGNATURE_LEN / 2, NULL);
+    s = BN_bin2bn(signature + LT_ECDSA_P256_SIGNATURE_LEN / 2, LT_ECDSA_P256_SIGNATURE_LEN / 2, NULL);
+    if (!sig || !r || !s || !ECDSA_SIG_set0(sig, r, s)) {
+        err_code = ERR_get_error();
+        LT_LOG_ERROR("Failed to create ECDSA_SIG structure, err_code=%lu (%s)", err_code,
+                     ERR_error_string(err_code, NULL));
+        lt_ret = LT_CRYPTO_ERR;
+        goto lt_ecdsa_p256_verify_cleanup;
+    }
+    // Owned by sig now.
+    r = NULL;
+    s = NULL;
+
+    int sig_der_len = i2d_ECDSA_SIG(sig, &sig_der);
+    if (sig_der_len <= 0) {
+        err_code = ERR_get_error();
+        LT_LOG_ERROR("Failed to encode ECDSA signature, err_code=%lu (%s)", err_code, ERR_error_string(err_code, NULL));
+        lt_ret = LT_CRYPTO_ERR;
+        goto lt_ecdsa_p256_verify_cleanup;
+    }
+
+    // Verify the signature of the digest.
+    ctx = EVP_PKEY_CTX_new(pub, NULL);
+    if (!ctx || EVP_PKEY_verify_init(ctx) <= 0) {
+        err_code = ERR_get_error();
+        LT_LOG_ERROR("Failed to initialize EVP_PKEY_CTX for P-256 verification, err_code=%lu (%s)", err_code,
+                     ERR_error_string(err_code, NULL));
+        lt_ret = LT_CRYPTO_ERR;
+        goto lt_ecdsa_p256_verify_cleanup;
+    }
+
+    if (EVP_PKEY_verify(ctx, sig_der, (size_t)sig_der_len, digest, LT_ECDSA_P256_DIGEST_LEN) != 1) {
+        err_code = ERR_get_error();
+        LT_LOG_ERROR("P-256 signature verification failed, err_code=%lu (%s)", err_code,
+                     ERR_error_string(err_code, NULL));
+        lt_ret = LT_CRYPTO_ERR;
+        goto lt_ecdsa_p256_verify_cleanup;
+    }
+
+lt_ecdsa_p256_verify_cleanup:
+    OPENSSL_free(sig_der);
+    BN_free(r);
+    BN_free(s);
+    ECDSA_SIG_free(sig);
+    EVP_PKEY_free(pub);
+    EVP_PKEY_CTX_free(ctx);
+    return lt_ret;
+}
@@ -5,6 +5,9 @@
  * @license For the license see LICENSE.md in the root directory of this source tree.
  */
 
+#include <stdint.h>
+#include <string.h>
+
 #include "aes/aes.h"
 #include "aes/aesgcm.h"
 #include "libtropic_common.h"
@@ -43,6 +46,11 @@ static lt_ret_t lt_aesgcm_deinit(gcm_ctx *ctx)
     return LT_OK;
 }
 
+bool lt_aesgcm_streaming_supported(void)
+{
+    return true;
+}
+
 lt_ret_t lt_aesgcm_encrypt_init(void *ctx, const uint8_t *key, const uint32_t key_len)
 {
     lt_ctx_trezor_crypto_t *_ctx = (lt_ctx_trezor_crypto_t *)ctx;
@@ -101,6 +109,128 @@ lt_ret_t lt_aesgcm_decrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len,
     return LT_OK;
 }
 
+lt_ret_t lt_aesgcm_encrypt_start(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                                 const uint32_t add_len)
+{
+    lt_ctx_trezor_crypto_t *_ctx = (lt_ctx_trezor_crypto_t *)ctx;
+
+    int ret = gcm_init_message(iv, iv_len, &_ctx->aesgcm_encrypt_ctx);
+    if (ret != RETURN_GOOD) {
+        return LT_CRYPTO_ERR;
+    }
+
+    ret = gcm_auth_header(add, add_len, &_ctx->aesgcm_encrypt_ctx);
+    if (ret != RETURN_GOOD) {
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_encrypt_update(void *ctx, const uint8_t *plaintext, uint8_t *ciphertext, const uint32_t len)
+{
+    lt_ctx_trezor_crypto_t *_ctx = (lt_ctx_trezor_crypto_t *)ctx;
+
+    // Copy plaintext into ciphertext, as Trezor's gcm_encrypt() works in-place
+    if (ciphertext != plaintext) {
+        memcpy(ciphertext, plaintext, len);
+    }
+
+    int ret = gcm_encrypt(ciphertext, len, &_ctx->aesgcm_encrypt_ctx);
+    if (ret != RETURN_GOOD) {
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_encrypt_finish(void *ctx, uint8_t *tag, const uint32_t tag_len)
+{
+    lt_ctx_trezor_crypto_t *_ctx = (lt_ctx_trezor_crypto_t *)ctx;
+
+    int ret = gcm_compute_tag(tag, tag_len, &_ctx->aesgcm_encrypt_ctx);
+    if (ret != RETURN_GOOD) {
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_decrypt_start(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                                 const uint32_t add_len)
+{
+    lt_ctx_trezor_crypto_t *_ctx = (lt_ctx_trezor_crypto_t *)ctx;
+
+    int ret = gcm_init_message(iv, iv_len, &_ctx->aesgcm_decrypt_ctx);
+    if (ret != RETURN_GOOD) {
+        return LT_CRYPTO_ERR;
+    }
+
+    ret = gcm_auth_header(add, add_len, &_ctx->aesgcm_decrypt_ctx);
+    if (ret != RETURN_GOOD) {
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_decrypt_update(void *ctx, const uint8_t *ciphertext, uint8_t *plaintext, const uint32_t len)
+{
+    lt_ctx_trezor_crypto_t *_ctx = (lt_ctx_trezor_crypto_t *)ctx;
+
+    // Copy ciphertext into plaintext, as Trezor's gcm_decrypt() works in-place
+    if (plaintext != ciphertext) {
+        memcpy(plaintext, ciphertext, len);
+    }
+
+    int ret = gcm_decrypt(plaintext, len, &_ctx->aesgcm_decrypt_ctx);
+    if (ret != RETURN_GOOD) {
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_decrypt_finish(void *ctx, const uint8_t *tag, const uint32_t tag_len)
+{
+    lt_ctx_trezor_crypto_t *_ctx = (lt_ctx_trezor_crypto_t *)ctx;
+    uint8_t computed_tag[TR01_L3_TAG_SIZE];
+
+    if (tag_len > sizeof(computed_tag)) {
+        return LT_PARAM_ERR;
+    }
+
+    int ret = gcm_compute_tag(computed_tag, tag_len, &_ctx->aesgcm_decrypt_ctx);
+    if (ret != RETURN_GOOD) {
+        return LT_CRYPTO_ERR;
+    }
+
+    // Compare in constant time, so the position of the first wrong byte is not leaked.
+    uint8_t diff = 0;
+    for (uint32_t i = 0; i < tag_len; i++) {
+        diff |= computed_tag[i] ^ tag[i];
+    }
+    if (diff) {
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_decrypt_abort(void *ctx)
+{
+    lt_ctx_trezor_crypto_t *_ctx = (lt_ctx_trezor_crypto_t *)ctx;
+    const uint8_t zero_iv[TR01_L3_IV_SIZE] = {0};
+
+    // Starting a new message drops the state of the unfinished one, the key schedule is kept.
+    int ret = gcm_init_message(zero_iv, sizeof(zero_iv), &_ctx->aesgcm_decrypt_ctx);
+    if (ret != RETURN_GOOD) {
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
 lt_ret_t lt_aesgcm_encrypt_deinit(void *ctx)
 {
     lt_ctx_trezor_crypto_t *_ctx = (lt_ctx_trezor_crypto_t *)ctx;
@@ -0,0 +1,25 @@
+/**
+ * @file lt_trezor_crypto_ecdsa_p256.c
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see LICENSE.md in the root directory of this source tree.
+ */
+
+#include <stdint.h>
+
+#include "ecdsa.h"
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "lt_ecdsa_p256.h"
+#include "nist256p1.h"
+
+lt_ret_t lt_ecdsa_p256_verify(const uint8_t *pubkey, const uint8_t *digest, const uint8_t *signature)
+{
+    int ret = ecdsa_verify_digest(&nist256p1, pubkey, signature, digest);
+    if (ret != 0) {
+        LT_LOG_ERROR("P-256 signature verification failed, ret=%d", ret);
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
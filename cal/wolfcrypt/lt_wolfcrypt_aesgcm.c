@@ -14,6 +14,7 @@
 
 #include "libtropic_common.h"
 #include "libtropic_logging.h"
+#include "libtropic_macros.h"
 #include "libtropic_wolfcrypt.h"
 #include "lt_aesgcm.h"
 
@@ -69,6 +70,15 @@ static lt_ret_t lt_aesgcm_deinit(lt_aesgcm_ctx_wolfcrypt_t *ctx)
     return LT_OK;
 }
 
+bool lt_aesgcm_streaming_supported(void)
+{
+#ifdef WOLFSSL_AESGCM_STREAM
+    return true;
+#else
+    return false;
+#endif
+}
+
 lt_ret_t lt_aesgcm_encrypt_init(void *ctx, const uint8_t *key, const uint32_t key_len)
 {
     lt_ctx_wolfcrypt_t *_ctx = (lt_ctx_wolfcrypt_t *)ctx;
@@ -121,6 +131,189 @@ lt_ret_t lt_aesgcm_decrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len,
     return LT_OK;
 }
 
+#ifdef WOLFSSL_AESGCM_STREAM
+lt_ret_t lt_aesgcm_encrypt_start(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                                 const uint32_t add_len)
+{
+    lt_ctx_wolfcrypt_t *_ctx = (lt_ctx_wolfcrypt_t *)ctx;
+
+    // Key was already set by wc_AesGcmSetKey(), only IV is set here.
+    int ret = wc_AesGcmInit(&_ctx->aesgcm_encrypt_ctx.ctx, NULL, 0, iv, iv_len);
+    if (ret != 0) {
+        LT_LOG_ERROR("AES-GCM encryption start failed, ret=%d (%s)", ret, wc_GetErrorString(ret));
+        return LT_CRYPTO_ERR;
+    }
+
+    ret = wc_AesGcmEncryptUpdate(&_ctx->aesgcm_encrypt_ctx.ctx, NULL, NULL, 0, add, add_len);
+    if (ret != 0) {
+        LT_LOG_ERROR("AES-GCM encryption of additional data failed, ret=%d (%s)", ret, wc_GetErrorString(ret));
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_encrypt_update(void *ctx, const uint8_t *plaintext, uint8_t *ciphertext, const uint32_t len)
+{
+    lt_ctx_wolfcrypt_t *_ctx = (lt_ctx_wolfcrypt_t *)ctx;
+
+    int ret = wc_AesGcmEncryptUpdate(&_ctx->aesgcm_encrypt_ctx.ctx, ciphertext, plaintext, len, NULL, 0);
+    if (ret != 0) {
+        LT_LOG_ERROR("AES-GCM encryption update failed, ret=%d (%s)", ret, wc_GetErrorString(ret));
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_encrypt_finish(void *ctx, uint8_t *tag, const uint32_t tag_len)
+{
+    lt_ctx_wolfcrypt_t *_ctx = (lt_ctx_wolfcrypt_t *)ctx;
+
+    int ret = wc_AesGcmEncryptFinal(&_ctx->aesgcm_encrypt_ctx.ctx, tag, tag_len);
+    if (ret != 0) {
+        LT_LOG_ERROR("AES-GCM encryption finish failed, ret=%d (%s)", ret, wc_GetErrorString(ret));
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_decrypt_start(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                                 const uint32_t add_len)
+{
+    lt_ctx_wolfcrypt_t *_ctx = (lt_ctx_wolfcrypt_t *)ctx;
+
+    // Key was already set by wc_AesGcmSetKey(), only IV is set here.
+    int ret = wc_AesGcmInit(&_ctx->aesgcm_decrypt_ctx.ctx, NULL, 0, iv, iv_len);
+    if (ret != 0) {
+        LT_LOG_ERROR("AES-GCM decryption start failed, ret=%d (%s)", ret, wc_GetErrorString(ret));
+        return LT_CRYPTO_ERR;
+    }
+
+    ret = wc_AesGcmDecryptUpdate(&_ctx->aesgcm_decrypt_ctx.ctx, NULL, NULL, 0, add, add_len);
+    if (ret != 0) {
+        LT_LOG_ERROR("AES-GCM decryption of additional data failed, ret=%d (%s)", ret, wc_GetErrorString(ret));
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_decrypt_update(void *ctx, const uint8_t *ciphertext, uint8_t *plaintext, const uint32_t len)
+{
+    lt_ctx_wolfcrypt_t *_ctx = (lt_ctx_wolfcrypt_t *)ctx;
+
+    int ret = wc_AesGcmDecryptUpdate(&_ctx->aesgcm_decrypt_ctx.ctx, plaintext, ciphertext, len, NULL, 0);
+    if (ret != 0) {
+        LT_LOG_ERROR("AES-GCM decryption update failed, ret=%d (%s)", ret, wc_GetErrorString(ret));
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_decrypt_finish(void *ctx, const uint8_t *tag, const uint32_t tag_len)
+{
+    lt_ctx_wolfcrypt_t *_ctx = (lt_ctx_wolfcrypt_t *)ctx;
+
+    int ret = wc_AesGcmDecryptFinal(&_ctx->aesgcm_decrypt_ctx.ctx, tag, tag_len);
+    if (ret != 0) {
+        LT_LOG_ERROR("AES-GCM decryption finish failed, ret=%d (%s)", ret, wc_GetErrorString(ret));
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_decrypt_abort(void *ctx)
+{
+    lt_ctx_wolfcrypt_t *_ctx = (lt_ctx_wolfcrypt_t *)ctx;
+    const uint8_t zero_iv[TR01_L3_IV_SIZE] = {0};
+
+    // Starting a new message drops the state of the unfinished one, the key set by wc_AesGcmSetKey() is kept.
+    int ret = wc_AesGcmInit(&_ctx->aesgcm_decrypt_ctx.ctx, NULL, 0, zero_iv, sizeof(zero_iv));
+    if (ret != 0) {
+        LT_LOG_ERROR("AES-GCM decryption abort failed, ret=%d (%s)", ret, wc_GetErrorString(ret));
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+#else
+// WolfCrypt processes AES-GCM messages in parts only when built with WOLFSSL_AESGCM_STREAM,
+// otherwise the one-shot functions are used.
+lt_ret_t lt_aesgcm_encrypt_start(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                                 const uint32_t add_len)
+{
+    LT_UNUSED(ctx);
+    LT_UNUSED(iv);
+    LT_UNUSED(iv_len);
+    LT_UNUSED(add);
+    LT_UNUSED(add_len);
+
+    return LT_NOT_SUPPORTED;
+}
+
+lt_ret_t lt_aesgcm_encrypt_update(void *ctx, const uint8_t *plaintext, uint8_t *ciphertext, const uint32_t len)
+{
+    LT_UNUSED(ctx);
+    LT_UNUSED(plaintext);
+    LT_UNUSED(ciphertext);
+    LT_UNUSED(len);
+
+    return LT_NOT_SUPPORTED;
+}
+
+lt_ret_t lt_aesgcm_encrypt_finish(void *ctx, uint8_t *tag, const uint32_t tag_len)
+{
+    LT_UNUSED(ctx);
+    LT_UNUSED(tag);
+    LT_UNUSED(tag_len);
+
+    return LT_NOT_SUPPORTED;
+}
+
+lt_ret_t lt_aesgcm_decrypt_start(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                                 const uint32_t add_len)
+{
+    LT_UNUSED(ctx);
+    LT_UNUSED(iv);
+    LT_UNUSED(iv_len);
+    LT_UNUSED(add);
+    LT_UNUSED(add_len);
+
+    return LT_NOT_SUPPORTED;
+}
+
+lt_ret_t lt_aesgcm_decrypt_update(void *ctx, const uint8_t *ciphertext, uint8_t *plaintext, const uint32_t len)
+{
+    LT_UNUSED(ctx);
+    LT_UNUSED(ciphertext);
+    LT_UNUSED(plaintext);
+    LT_UNUSED(len);
+
+    return LT_NOT_SUPPORTED;
+}
+
+lt_ret_t lt_aesgcm_decrypt_finish(void *ctx, const uint8_t *tag, const uint32_t tag_len)
+{
+    LT_UNUSED(ctx);
+    LT_UNUSED(tag);
+    LT_UNUSED(tag_len);
+
+    return LT_NOT_SUPPORTED;
+}
+
+lt_ret_t lt_aesgcm_decrypt_abort(void *ctx)
+{
+    LT_UNUSED(ctx);
+
+    // No message can be started, so there is nothing to abort.
+    return LT_OK;
+}
+#endif
+
 lt_ret_t lt_aesgcm_encrypt_deinit(void *ctx)
 {
     lt_ctx_wolfcrypt_t *_ctx = (lt_ctx_wolfcrypt_t *)ctx;
@@ -0,0 +1,56 @@
+/**
+ * @file lt_wolfcrypt_ecdsa_p256.c
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see LICENSE.md in the root directory of this source tree.
+ */
+
+#include <stdint.h>
+#include <wolfssl/wolfcrypt/ecc.h>
+#include <wolfssl/wolfcrypt/error-crypt.h>
+
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "lt_ecdsa_p256.h"
+
+lt_ret_t lt_ecdsa_p256_verify(const uint8_t *pubkey, const uint8_t *digest, const uint8_t *signature)
+{
+    int ret;
+    int verified = 0;
+    lt_ret_t lt_ret = LT_OK;
+    ecc_key key;
+    // wc_ecc_verify_hash() takes the signature DER encoded, so no multi-precision API is needed to pass R and S.
+    uint8_t der_sig[ECC_MAX_SIG_SIZE];
+    word32 der_sig_len = sizeof(der_sig);
+
+    ret = wc_ecc_rs_raw_to_sig(signature, LT_ECDSA_P256_SIGNATURE_LEN / 2, signature + LT_ECDSA_P256_SIGNATURE_LEN / 2,
+                               LT_ECDSA_P256_SIGNATURE_LEN / 2, der_sig, &der_sig_len);
+    if (ret != 0) {
+        LT_LOG_ERROR("Failed to encode P-256 signature, ret=%d (%s)", ret, wc_GetErrorString(ret));
+        return LT_CRYPTO_ERR;
+    }
+
+    ret = wc_ecc_init(&key);
+    if (ret != 0) {
+        LT_LOG_ERROR("Failed to initialize P-256 public key, ret=%d (%s)", ret, wc_GetErrorString(ret));
+        return LT_CRYPTO_ERR;
+    }
+
+    ret = wc_ecc_import_x963_ex(pubkey, LT_ECDSA_P256_PUBKEY_LEN, &key, ECC_SECP256R1);
+    if (ret != 0) {
+        LT_LOG_ERROR("Failed to import P-256 public key, ret=%d (%s)", ret, wc_GetErrorString(ret));
+        lt_ret = LT_CRYPTO_ERR;
+        goto lt_ecdsa_p256_verify_cleanup;
+    }
+
+    ret = wc_ecc_verify_hash(der_sig, der_sig_len, digest, LT_ECDSA_P256_DIGEST_LEN, &verified, &key);
+    if (ret != 0 || verified != 1) {
+        LT_LOG_ERROR("P-256 signature verification failed, ret=%d, verified=%d", ret, verified);
+        lt_ret = LT_CRYPTO_ERR;
+        goto lt_ecdsa_p256_verify_cleanup;
+    }
+
+lt_ecdsa_p256_verify_cleanup:
+    wc_ecc_free(&key);
+    return lt_ret;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file main.c
+ * @brief Benchmark counting the system calls the Linux SPI HAL makes per TROPIC01 command.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <inttypes.h>
+#include <linux/gpio.h>
+#include <linux/spi/spidev.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_mbedtls_v4.h"
+#include "libtropic_port_linux_spi.h"
+#include "psa/crypto.h"
+
+/** Number of times each command is sent. */
+#define BENCHMARK_ROUNDS 100
+
+/** Counters of ioctl() calls, incremented by __wrap_ioctl(). */
+static uint32_t spi_ioctl_cnt;
+static uint32_t gpio_ioctl_cnt;
+
+// The executable is linked with -Wl,--wrap=ioctl, so all ioctl() calls of the HAL go through this function.
+int __real_ioctl(int fd, unsigned long request, ...);
+int __wrap_ioctl(int fd, unsigned long request, ...)
+{
+    va_list args;
+    va_start(args, request);
+    void *arg = va_arg(args, void *);
+    va_end(args);
+
+    if (request == SPI_IOC_MESSAGE(1)) {
+        spi_ioctl_cnt++;
+    }
+    else if (request == GPIO_V2_LINE_SET_VALUES_IOCTL) {
+        gpio_ioctl_cnt++;
+    }
+
+    return __real_ioctl(fd, request, arg);
+}
+
+static double time_diff_us(const struct timespec *start, const struct timespec *end)
+{
+    return (double)(end->tv_sec - start->tv_sec) * 1e6 + (double)(end->tv_nsec - start->tv_nsec) / 1e3;
+}
+
+static lt_ret_t get_riscv_fw_ver(lt_handle_t *h)
+{
+    uint8_t fw_ver[TR01_L2_GET_INFO_RISCV_FW_SIZE];
+    return lt_get_info_riscv_fw_ver(h, fw_ver);
+}
+
+static lt_ret_t get_chip_id(lt_handle_t *h)
+{
+    struct lt_chip_id_t chip_id;
+    return lt_get_info_chip_id(h, &chip_id);
+}
+
+static lt_ret_t get_tr01_mode(lt_handle_t *h)
+{
+    lt_tr01_mode_t mode;
+    return lt_get_tr01_mode(h, &mode);
+}
+
+static int benchmark(lt_handle_t *h, const char *name, lt_ret_t (*cmd)(lt_handle_t *))
+{
+    struct timespec start, end;
+
+    spi_ioctl_cnt = 0;
+    gpio_ioctl_cnt = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        lt_ret_t ret = cmd(h);
+        if (ret != LT_OK) {
+            fprintf(stderr, "%s failed, ret=%s\n", name, lt_ret_verbose(ret));
+            return -1;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    printf("  %-22s %8.2f %8.2f %8.2f %10.1f\n", name, (double)spi_ioctl_cnt / BENCHMARK_ROUNDS,
+           (double)gpio_ioctl_cnt / BENCHMARK_ROUNDS, (double)(spi_ioctl_cnt + gpio_ioctl_cnt) / BENCHMARK_ROUNDS,
+           time_diff_us(&start, &end) / BENCHMARK_ROUNDS);
+
+    return 0;
+}
+
+int main(void)
+{
+    // Cosmetics: Disable buffering to keep output in order.
+    setvbuf(stdout, NULL, _IONBF, 0);
+    setvbuf(stderr, NULL, _IONBF, 0);
+
+    printf("=================================================\n");
+    printf("==== TROPIC01 Linux SPI HAL Syscall Benchmark ===\n");
+    printf("=================================================\n");
+
+    psa_status_t status = psa_crypto_init();
+    if (status != PSA_SUCCESS) {
+        fprintf(stderr, "PSA Crypto initialization failed, status=%d (psa_status_t)\n", status);
+        return -1;
+    }
+
+    lt_handle_t lt_handle = {0};
+    lt_dev_linux_spi_t device = {0};
+
+    // LT_GPIO_DEV_PATH and LT_SPI_DEV_PATH are defined in CMakeLists.txt.
+    int dev_path_len = snprintf(device.gpio_dev, sizeof(device.gpio_dev), "%s", LT_GPIO_DEV_PATH);
+    if (dev_path_len < 0 || (size_t)dev_path_len >= sizeof(device.gpio_dev)) {
+        fprintf(stderr, "Error: LT_GPIO_DEV_PATH is too long for device.gpio_dev buffer (limit is %zu bytes).\n",
+                sizeof(device.gpio_dev));
+        mbedtls_psa_crypto_free();
+        return -1;
+    }
+    dev_path_len = snprintf(device.spi_dev, sizeof(device.spi_dev), "%s", LT_SPI_DEV_PATH);
+    if (dev_path_len < 0 || (size_t)dev_path_len >= sizeof(device.spi_dev)) {
+        fprintf(stderr, "Error: LT_SPI_DEV_PATH is too long for device.spi_dev buffer (limit is %zu bytes).\n",
+                sizeof(device.spi_dev));
+        mbedtls_psa_crypto_free();
+        return -1;
+    }
+
+    device.spi_speed = 5000000;  // 5 MHz (change if needed).
+    device.gpio_cs_num = 25;     // GPIO 25 as on RPi shield.
+#if LT_USE_INT_PIN
+    device.gpio_int_num = 5;  // GPIO 5 as on RPi shield.
+#endif
+    lt_handle.l2.device = &device;
+
+    lt_ctx_mbedtls_v4_t crypto_ctx;
+    lt_handle.l3.crypto_ctx = &crypto_ctx;
+
+    lt_ret_t ret = lt_init(&lt_handle);
+    if (LT_OK != ret) {
+        fprintf(stderr, "Failed to initialize handle, ret=%s\n", lt_ret_verbose(ret));
+        mbedtls_psa_crypto_free();
+        return -1;
+    }
+
+    printf("Read-ahead: %d bytes, rounds: %d\n", LT_LINUX_SPI_READ_AHEAD_LEN, BENCHMARK_ROUNDS);
+    printf("  %-22s %8s %8s %8s %10s\n", "command", "SPI", "GPIO", "total", "time [us]");
+
+    int err = benchmark(&lt_handle, "Get_Info RISC-V FW", get_riscv_fw_ver);
+    if (!err) {
+        err = benchmark(&lt_handle, "Get_Info Chip ID", get_chip_id);
+    }
+    if (!err) {
+        err = benchmark(&lt_handle, "CHIP_STATUS", get_tr01_mode);
+    }
+
+    ret = lt_deinit(&lt_handle);
+    if (LT_OK != ret) {
+        fprintf(stderr, "Failed to deinitialize handle, ret=%s\n", lt_ret_verbose(ret));
+        err = -1;
+    }
+    mbedtls_psa_crypto_free();
+
+    return err;
+}
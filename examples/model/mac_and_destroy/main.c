@@ -554,6 +554,7 @@ int main(void)
     lt_dev_posix_tcp_t device;
     device.addr = inet_addr("127.0.0.1");
     device.port = 28992;
+    device.sock_path = NULL;
     lt_handle.l2.device = &device;
 
     // Generate seed for the PRNG and seed it.
@@ -30,12 +30,14 @@
 // Other
 #include <stdarg.h>
 #include <sys/random.h>
+#include <time.h>
 
 #include "libtropic_common.h"
 #include "libtropic_logging.h"
 #include "libtropic_macros.h"
 #include "libtropic_port.h"
 #include "libtropic_port_linux_spi.h"
+#include "lt_l1.h"
 
 lt_ret_t lt_port_init(lt_l2_state_t *s2)
 {
@@ -188,6 +190,7 @@ lt_ret_t lt_port_spi_csn_low(lt_l2_state_t *s2)
     lt_dev_linux_spi_t *device = (lt_dev_linux_spi_t *)(s2->device);
     struct gpio_v2_line_values values;
 
+    device->rx_pos = 0;
     values.mask = 1;
     values.bits = 0;
     if (ioctl(device->gpioreq_cs.fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &values) < 0) {
@@ -213,24 +216,98 @@ lt_ret_t lt_port_spi_csn_high(lt_l2_state_t *s2)
     return LT_OK;
 }
 
+static lt_ret_t spi_ioctl_transfer(lt_dev_linux_spi_t *device, uint8_t *data, uint16_t length)
+{
+    struct spi_ioc_transfer spi = {
+        .tx_buf = (unsigned long)data,
+        .rx_buf = (unsigned long)data,
+        .len = length,
+        .delay_usecs = 0,
+    };
+
+    if (ioctl(device->spi_fd, SPI_IOC_MESSAGE(1), &spi) < 0) {
+        LT_LOG_ERROR("SPI_IOC_MESSAGE error: %s", strerror(errno));
+        return LT_FAIL;
+    }
+    return LT_OK;
+}
+
 lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_data_length, uint32_t timeout_ms)
 {
     LT_UNUSED(timeout_ms);
     lt_dev_linux_spi_t *device = (lt_dev_linux_spi_t *)(s2->device);
+    uint16_t end = offset + tx_data_length;
 
-    int ret = 0;
-    struct spi_ioc_transfer spi = {
-        .tx_buf = (unsigned long)s2->buff + offset,
-        .rx_buf = (unsigned long)s2->buff + offset,
-        .len = tx_data_length,
-        .delay_usecs = 0,
-    };
+    if (end > TR01_L1_LEN_MAX) {
+        return LT_PARAM_ERR;
+    }
+
+    // Read CHIP_STATUS together with the beginning of the response frame. Chip select stays low between
+    // the transfers, so the following reads of the frame are served from the buffer.
+    if (offset == 0 && s2->buff[0] == TR01_L1_GET_RESPONSE_REQ_ID && tx_data_length < LT_LINUX_SPI_READ_AHEAD_LEN) {
+        end = LT_LINUX_SPI_READ_AHEAD_LEN;
+    }
 
-    ret = ioctl(device->spi_fd, SPI_IOC_MESSAGE(1), &spi);
-    if (ret >= 0) {
+    // Bytes clocked by the read-ahead are already in the buffer.
+    if (offset == 0 || offset > device->rx_pos) {
+        device->rx_pos = offset;
+    }
+    if (end <= device->rx_pos) {
         return LT_OK;
     }
-    return LT_FAIL;
+
+    lt_ret_t ret = spi_ioctl_transfer(device, s2->buff + device->rx_pos, end - device->rx_pos);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    device->rx_pos = end;
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_spi_transfer_into(lt_l2_state_t *s2, uint8_t offset, uint8_t *rx_buff, uint16_t rx_len,
+                                   uint32_t timeout_ms)
+{
+    LT_UNUSED(timeout_ms);
+    lt_dev_linux_spi_t *device = (lt_dev_linux_spi_t *)(s2->device);
+    uint16_t end = offset + rx_len;
+
+    if (end > TR01_L1_LEN_MAX) {
+        return LT_PARAM_ERR;
+    }
+
+    // Bytes clocked by the read-ahead are taken from the buffer, only the rest is received directly.
+    if (offset > device->rx_pos) {
+        device->rx_pos = offset;
+    }
+    uint16_t buffered = lt_min(device->rx_pos, end) - offset;
+    memcpy(rx_buff, s2->buff + offset, buffered);
+    if (end <= device->rx_pos) {
+        return LT_OK;
+    }
+
+    // RSP_CRC follows RSP_DATA, it is clocked into the buffer by the same message.
+    uint16_t crc_len = lt_min((uint16_t)TR01_L2_REQ_RSP_CRC_SIZE, (uint16_t)(TR01_L1_LEN_MAX - end));
+    struct spi_ioc_transfer spi[2] = {
+        {
+            .tx_buf = (unsigned long)(rx_buff + buffered),
+            .rx_buf = (unsigned long)(rx_buff + buffered),
+            .len = end - device->rx_pos,
+        },
+        {
+            .tx_buf = (unsigned long)(s2->buff + end),
+            .rx_buf = (unsigned long)(s2->buff + end),
+            .len = crc_len,
+        },
+    };
+
+    if (ioctl(device->spi_fd, crc_len ? SPI_IOC_MESSAGE(2) : SPI_IOC_MESSAGE(1), spi) < 0) {
+        LT_LOG_ERROR("SPI_IOC_MESSAGE error: %s", strerror(errno));
+        return LT_FAIL;
+    }
+    device->rx_pos = end + crc_len;
+
+    return LT_OK;
 }
 
 lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
@@ -247,6 +324,36 @@ lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
     return LT_OK;
 }
 
+lt_ret_t lt_port_delay_us(lt_l2_state_t *s2, uint32_t us)
+{
+    LT_UNUSED(s2);
+
+    struct timespec ts = {.tv_sec = us / 1000000, .tv_nsec = (long)(us % 1000000) * 1000};
+    // Continue sleeping for the remaining time when interrupted by a signal.
+    while (nanosleep(&ts, &ts) != 0) {
+        if (errno != EINTR) {
+            LT_LOG_ERROR("nanosleep() failed: %s", strerror(errno));
+            return LT_FAIL;
+        }
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_get_time_us(lt_l2_state_t *s2, uint64_t *time_us)
+{
+    LT_UNUSED(s2);
+
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        LT_LOG_ERROR("clock_gettime() failed: %s", strerror(errno));
+        return LT_FAIL;
+    }
+    *time_us = (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+
+    return LT_OK;
+}
+
 lt_ret_t lt_port_random_bytes(lt_l2_state_t *s2, void *buff, size_t count)
 {
     LT_UNUSED(s2);
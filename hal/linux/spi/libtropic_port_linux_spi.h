@@ -10,6 +10,7 @@
  */
 
 #include <linux/gpio.h>
+#include <stdint.h>
 
 #include "libtropic_port.h"
 
@@ -17,6 +18,16 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Number of bytes clocked by the first transfer of a response read.
+ *
+ * When reading a response, CHIP_STATUS is read together with this many bytes of the frame, so a short frame is
+ * received by a single ioctl() and a longer one needs only one more. Set to 1 to clock exactly what is requested.
+ */
+#ifndef LT_LINUX_SPI_READ_AHEAD_LEN
+#define LT_LINUX_SPI_READ_AHEAD_LEN 16
+#endif
+
 /**
  * @brief Device structure for Linux SPI port.
  *
@@ -41,6 +52,8 @@ typedef struct lt_dev_linux_spi_t {
     int spi_fd;
     /** @private @brief GPIO file descriptor. */
     int gpio_fd;
+    /** @private @brief Number of bytes already clocked since chip select was asserted. */
+    uint16_t rx_pos;
     /** @private @brief GPIO request structure for chip select. */
     struct gpio_v2_line_request gpioreq_cs;
 #if LT_USE_INT_PIN
@@ -3,8 +3,8 @@
  * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
  * @brief Port for communication using Generic SPI UAPI with native CS handling and GPIO for interrupt handling.
  *
- * @note As this HAL controls CS using SPI driver natively,  whole buffer is transferred each time, which
- * introduces a small overhead.
+ * @note As this HAL controls CS using SPI driver natively, whole buffer is transferred each time, which
+ * introduces a small overhead, unless `length_adaptive` is enabled in the device structure.
  *
  * @warning This HAL is experimental. It can be modified or removed in the next release without notice.
  *
@@ -34,12 +34,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/random.h>
+#include <time.h>
 
 #include "libtropic_common.h"
 #include "libtropic_logging.h"
 #include "libtropic_macros.h"
 #include "libtropic_port.h"
 #include "libtropic_port_linux_spi_native_cs.h"
+#include "lt_l1.h"
 
 lt_ret_t lt_port_init(lt_l2_state_t *s2)
 {
@@ -49,6 +51,10 @@ lt_ret_t lt_port_init(lt_l2_state_t *s2)
 
     device->frame_in_progress = 0;
     device->frame_completed = 0;
+    device->rsp_received = 0;
+    device->chip_busy = 0;
+    device->cont_rsp_len = 0;
+    memset(device->rsp_len, 0, sizeof(device->rsp_len));
 
 // Initialize file descriptors to -1 so lt_port_deinit() can always execute safely.
 #if LT_USE_INT_PIN
@@ -164,6 +170,55 @@ lt_ret_t lt_port_deinit(lt_l2_state_t *s2)
     return LT_OK;
 }
 
+static lt_ret_t spi_ioctl_transfer(lt_dev_linux_spi_native_cs_t *device, uint8_t *data, uint16_t length)
+{
+    struct spi_ioc_transfer spi = {
+        .tx_buf = (unsigned long)data,
+        .rx_buf = (unsigned long)data,
+        .len = length,
+        .delay_usecs = 0,
+    };
+
+    if (ioctl(device->spi_fd, SPI_IOC_MESSAGE(1), &spi) < 0) {
+        LT_LOG_ERROR("spi_ioctl_transfer: SPI_IOC_MESSAGE failed: %s", strerror(errno));
+        return LT_L1_SPI_ERROR;
+    }
+    return LT_OK;
+}
+
+/**
+ * @brief Returns number of bytes to clock when reading a response, based on what was learned about it.
+ */
+static uint16_t expected_frame_len(const lt_dev_linux_spi_native_cs_t *device)
+{
+    uint8_t rsp_len = device->rsp_received ? device->cont_rsp_len : device->rsp_len[device->req_id];
+
+    if (device->chip_busy || !rsp_len) {
+        return LT_LINUX_SPI_NATIVE_CS_POLL_LEN;
+    }
+    // CHIP_STATUS, STATUS, RSP_LEN, RSP_DATA and CRC.
+    return TR01_L1_CHIP_STATUS_SIZE + 2 + (rsp_len - 1) + 2;
+}
+
+/**
+ * @brief Updates the learned state from the received frame.
+ */
+static void learn_frame_len(lt_dev_linux_spi_native_cs_t *device, const uint8_t *buff)
+{
+    device->chip_busy = !(buff[0] & TR01_L1_CHIP_MODE_READY_bit) || buff[1] == 0xff;
+    if (device->chip_busy) {
+        return;
+    }
+
+    if (device->rsp_received) {
+        device->cont_rsp_len = buff[2] + 1;
+    }
+    else {
+        device->rsp_len[device->req_id] = buff[2] + 1;
+        device->rsp_received = 1;
+    }
+}
+
 lt_ret_t lt_port_spi_csn_low(lt_l2_state_t *s2)
 {
     lt_dev_linux_spi_native_cs_t *device = (lt_dev_linux_spi_native_cs_t *)(s2->device);
@@ -199,20 +254,115 @@ lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_dat
         return LT_OK;
     }
 
-    int ret = 0;
-    struct spi_ioc_transfer spi = {
-        .tx_buf = (unsigned long)s2->buff,
-        .rx_buf = (unsigned long)s2->buff,
-        .len = TR01_L1_LEN_MAX,  // We always read whole buffer at once.
-        .delay_usecs = 0,
-    };
+    // We always read whole buffer at once.
+    lt_ret_t ret = spi_ioctl_transfer(device, s2->buff, TR01_L1_LEN_MAX);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    device->frame_completed = 1;
 
-    ret = ioctl(device->spi_fd, SPI_IOC_MESSAGE(1), &spi);
-    if (ret >= 0) {
-        device->frame_completed = 1;
-        return LT_OK;
+    return LT_OK;
+}
+
+lt_ret_t lt_port_frame_xfer(lt_l2_state_t *s2, lt_port_frame_dir_t dir, uint16_t len, uint32_t timeout_ms)
+{
+    LT_UNUSED(timeout_ms);
+    lt_dev_linux_spi_native_cs_t *device = (lt_dev_linux_spi_native_cs_t *)(s2->device);
+
+    if (len > TR01_L1_LEN_MAX) {
+        return LT_L1_DATA_LEN_ERROR;
     }
-    return LT_L1_SPI_ERROR;
+
+    if (dir == LT_PORT_FRAME_WRITE) {
+        if (s2->buff[0] != TR01_L1_GET_RESPONSE_REQ_ID) {
+            device->req_id = s2->buff[0];
+            device->rsp_received = 0;
+            device->chip_busy = 0;
+        }
+        return spi_ioctl_transfer(device, s2->buff, device->length_adaptive ? len : TR01_L1_LEN_MAX);
+    }
+
+    uint16_t xfer_len = device->length_adaptive ? lt_min(expected_frame_len(device), len) : len;
+    lt_ret_t ret = spi_ioctl_transfer(device, s2->buff, xfer_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    if (!(s2->buff[0] & TR01_L1_CHIP_MODE_ALARM_bit) && (s2->buff[0] & TR01_L1_CHIP_MODE_READY_bit)
+        && s2->buff[1] != 0xff) {
+        // CHIP_STATUS, STATUS, RSP_LEN, RSP_DATA and CRC.
+        uint16_t frame_len = TR01_L1_CHIP_STATUS_SIZE + 2 + s2->buff[2] + 2;
+        if (frame_len > len) {
+            return LT_L1_DATA_LEN_ERROR;
+        }
+        // The frame is longer than expected, read it again.
+        if (frame_len > xfer_len) {
+            s2->buff[0] = TR01_L1_GET_RESPONSE_REQ_ID;
+            ret = spi_ioctl_transfer(device, s2->buff, frame_len);
+            if (ret != LT_OK) {
+                return ret;
+            }
+        }
+    }
+
+    if (device->length_adaptive) {
+        learn_frame_len(device, s2->buff);
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_spi_transfer_iov(lt_l2_state_t *s2, const lt_port_iov_t *iov, uint8_t iov_cnt, uint32_t timeout_ms)
+{
+    LT_UNUSED(timeout_ms);
+    lt_dev_linux_spi_native_cs_t *device = (lt_dev_linux_spi_native_cs_t *)(s2->device);
+    // Without length_adaptive, the frame is padded to the whole buffer by one more transfer.
+    static const uint8_t padding[TR01_L1_LEN_MAX] = {0};
+    struct spi_ioc_transfer spi[LT_LINUX_SPI_NATIVE_CS_IOV_MAX + 1];
+    uint16_t len = 0;
+    unsigned int spi_cnt = 0;
+
+    if (iov_cnt > LT_LINUX_SPI_NATIVE_CS_IOV_MAX) {
+        return LT_NOT_SUPPORTED;
+    }
+
+    // Parts are sent as one SPI message, CS stays asserted between its transfers. MISO is not needed.
+    memset(spi, 0, sizeof(spi));
+    for (uint8_t i = 0; i < iov_cnt; i++) {
+        if (iov[i].len == 0) {
+            continue;
+        }
+        if (iov[i].len > TR01_L1_LEN_MAX - len) {
+            return LT_L1_DATA_LEN_ERROR;
+        }
+        spi[spi_cnt].tx_buf = (unsigned long)iov[i].base;
+        spi[spi_cnt].len = iov[i].len;
+        spi_cnt++;
+        len += iov[i].len;
+    }
+    if (spi_cnt == 0) {
+        return LT_L1_DATA_LEN_ERROR;
+    }
+    if (!device->length_adaptive && len < TR01_L1_LEN_MAX) {
+        spi[spi_cnt].tx_buf = (unsigned long)padding;
+        spi[spi_cnt].len = TR01_L1_LEN_MAX - len;
+        spi_cnt++;
+    }
+
+    // Same as lt_port_frame_xfer() with LT_PORT_FRAME_WRITE, the first byte is REQ_ID.
+    uint8_t req_id = *(const uint8_t *)(uintptr_t)spi[0].tx_buf;
+    if (req_id != TR01_L1_GET_RESPONSE_REQ_ID) {
+        device->req_id = req_id;
+        device->rsp_received = 0;
+        device->chip_busy = 0;
+    }
+
+    if (ioctl(device->spi_fd, SPI_IOC_MESSAGE(spi_cnt), spi) < 0) {
+        LT_LOG_ERROR("lt_port_spi_transfer_iov: SPI_IOC_MESSAGE failed: %s", strerror(errno));
+        return LT_L1_SPI_ERROR;
+    }
+
+    return LT_OK;
 }
 
 lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
@@ -228,6 +378,36 @@ lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
     return LT_OK;
 }
 
+lt_ret_t lt_port_delay_us(lt_l2_state_t *s2, uint32_t us)
+{
+    LT_UNUSED(s2);
+
+    struct timespec ts = {.tv_sec = us / 1000000, .tv_nsec = (long)(us % 1000000) * 1000};
+    // Continue sleeping for the remaining time when interrupted by a signal.
+    while (nanosleep(&ts, &ts) != 0) {
+        if (errno != EINTR) {
+            LT_LOG_ERROR("lt_port_delay_us: nanosleep() failed: %s", strerror(errno));
+            return LT_FAIL;
+        }
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_get_time_us(lt_l2_state_t *s2, uint64_t *time_us)
+{
+    LT_UNUSED(s2);
+
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        LT_LOG_ERROR("lt_port_get_time_us: clock_gettime() failed: %s", strerror(errno));
+        return LT_FAIL;
+    }
+    *time_us = (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+
+    return LT_OK;
+}
+
 lt_ret_t lt_port_random_bytes(lt_l2_state_t *s2, void *buff, size_t count)
 {
     LT_UNUSED(s2);
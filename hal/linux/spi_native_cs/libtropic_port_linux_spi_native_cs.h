@@ -15,12 +15,30 @@
 #include <linux/gpio.h>
 #endif
 
+#include <stdint.h>
+
 #include "libtropic_port.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Number of bytes transferred to probe CHIP_STATUS when the length of the response is not known (CHIP_STATUS,
+ * STATUS and RSP_LEN, so it must be at least 3). Used only with `length_adaptive` enabled.
+ */
+#ifndef LT_LINUX_SPI_NATIVE_CS_POLL_LEN
+#define LT_LINUX_SPI_NATIVE_CS_POLL_LEN 3
+#endif
+
+/**
+ * @brief Maximal number of parts written by lt_port_spi_transfer_iov() in one SPI message, frames with more parts are
+ * left to the copying fallback of Libtropic.
+ */
+#ifndef LT_LINUX_SPI_NATIVE_CS_IOV_MAX
+#define LT_LINUX_SPI_NATIVE_CS_IOV_MAX 4
+#endif
+
 /**
  * @brief Device structure for Linux SPI port with native CS handling.
  *
@@ -32,6 +50,12 @@ typedef struct lt_dev_linux_spi_native_cs_t {
     int spi_speed;
     /** @public @brief Path to the SPI device. */
     char spi_dev[LT_DEVICE_PATH_MAX_LEN];
+    /** @public @brief Non-zero to size each transfer by the frame instead of always transferring TR01_L1_LEN_MAX
+     * bytes. Requests are written with their exact length, CHIP_STATUS is probed with
+     * LT_LINUX_SPI_NATIVE_CS_POLL_LEN bytes and responses are read with the length learned from the previous
+     * response to the same request. If the response is longer, it is read again with the length from RSP_LEN.
+     */
+    int length_adaptive;
 #if LT_USE_INT_PIN
     /** @public @brief Path to the GPIO device. */
     char gpio_dev[LT_DEVICE_PATH_MAX_LEN];
@@ -70,6 +94,18 @@ typedef struct lt_dev_linux_spi_native_cs_t {
      */
     int frame_completed;
 
+    /** @private @brief REQ_ID of the last written L2 Request. */
+    uint8_t req_id;
+    /** @private @brief True if a response to the last L2 Request was already read, so next responses are its
+     * continuation (e.g. chunks of an L3 Result). */
+    uint8_t rsp_received;
+    /** @private @brief True if the last read found TROPIC01 busy. */
+    uint8_t chip_busy;
+    /** @private @brief Learned RSP_LEN + 1 of the first response to each REQ_ID, 0 if not known yet. */
+    uint8_t rsp_len[UINT8_MAX + 1];
+    /** @private @brief Learned RSP_LEN + 1 of the continuation responses, 0 if not known yet. */
+    uint8_t cont_rsp_len;
+
 } lt_dev_linux_spi_native_cs_t;
 
 #ifdef __cplusplus
@@ -8,6 +8,7 @@
 
 #include "libtropic_port_mock.h"
 
+#include <errno.h>
 #include <inttypes.h>
 #include <stdarg.h>
 #include <stdbool.h>
@@ -39,6 +40,17 @@ lt_ret_t lt_mock_hal_reset(lt_l2_state_t *s2)
     dev->frame_in_progress = false;
     dev->frame_bytes_transferred = 0;
 
+    dev->frame_xfer_enabled = false;
+    dev->frame_xfer_count = 0;
+
+    dev->spi_transfer_iov_enabled = false;
+    dev->spi_transfer_iov_count = 0;
+
+    dev->spi_transfer_into_enabled = false;
+    dev->spi_transfer_into_count = 0;
+
+    dev->request_log_count = 0;
+
     return LT_OK;
 }
 
@@ -69,6 +81,117 @@ lt_ret_t lt_mock_hal_enqueue_response(lt_l2_state_t *s2, const uint8_t *data, co
     return LT_OK;
 }
 
+lt_ret_t lt_mock_hal_enable_frame_xfer(lt_l2_state_t *s2, const bool enable)
+{
+    if (!s2) {
+        return LT_PARAM_ERR;
+    }
+
+    lt_dev_mock_t *dev = (lt_dev_mock_t *)s2->device;
+    dev->frame_xfer_enabled = enable;
+
+    return LT_OK;
+}
+
+size_t lt_mock_hal_get_frame_xfer_count(const lt_l2_state_t *s2)
+{
+    if (!s2) {
+        return 0;
+    }
+
+    return ((const lt_dev_mock_t *)s2->device)->frame_xfer_count;
+}
+
+lt_ret_t lt_mock_hal_enable_spi_transfer_iov(lt_l2_state_t *s2, const bool enable)
+{
+    if (!s2) {
+        return LT_PARAM_ERR;
+    }
+
+    lt_dev_mock_t *dev = (lt_dev_mock_t *)s2->device;
+    dev->spi_transfer_iov_enabled = enable;
+
+    return LT_OK;
+}
+
+size_t lt_mock_hal_get_spi_transfer_iov_count(const lt_l2_state_t *s2)
+{
+    if (!s2) {
+        return 0;
+    }
+
+    return ((const lt_dev_mock_t *)s2->device)->spi_transfer_iov_count;
+}
+
+lt_ret_t lt_mock_hal_enable_spi_transfer_into(lt_l2_state_t *s2, const bool enable)
+{
+    if (!s2) {
+        return LT_PARAM_ERR;
+    }
+
+    lt_dev_mock_t *dev = (lt_dev_mock_t *)s2->device;
+    dev->spi_transfer_into_enabled = enable;
+
+    return LT_OK;
+}
+
+size_t lt_mock_hal_get_spi_transfer_into_count(const lt_l2_state_t *s2)
+{
+    if (!s2) {
+        return 0;
+    }
+
+    return ((const lt_dev_mock_t *)s2->device)->spi_transfer_into_count;
+}
+
+size_t lt_mock_hal_get_request_count(const lt_l2_state_t *s2)
+{
+    if (!s2) {
+        return 0;
+    }
+
+    return ((const lt_dev_mock_t *)s2->device)->request_log_count;
+}
+
+const mock_mosi_data_t *lt_mock_hal_get_request(const lt_l2_state_t *s2, const size_t index)
+{
+    if (!s2) {
+        return NULL;
+    }
+
+    const lt_dev_mock_t *dev = (const lt_dev_mock_t *)s2->device;
+    if (index >= dev->request_log_count || index >= MOCK_REQUEST_LOG_DEPTH) {
+        return NULL;
+    }
+
+    return &dev->request_log[index];
+}
+
+/**
+ * @brief Stores the next part of L2 Request into the request log.
+ *
+ * @param start True if the part starts a new request.
+ */
+static void log_request(lt_dev_mock_t *dev, const uint8_t *data, const size_t len, const bool start)
+{
+    if (start) {
+        dev->request_log_count++;
+        if (dev->request_log_count <= MOCK_REQUEST_LOG_DEPTH) {
+            dev->request_log[dev->request_log_count - 1].len = 0;
+        }
+    }
+    if (dev->request_log_count == 0 || dev->request_log_count > MOCK_REQUEST_LOG_DEPTH) {
+        return;
+    }
+
+    mock_mosi_data_t *req = &dev->request_log[dev->request_log_count - 1];
+    if (len > sizeof(req->data) - req->len) {
+        return;
+    }
+    memcpy(req->data + req->len, data, len);
+    req->len += len;
+}
+
 // Platform API implementation ------------------------------------------------
 
 lt_ret_t lt_port_init(lt_l2_state_t *s2)
@@ -160,6 +283,11 @@ lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_len
         LT_LOG_DEBUG("Mock HAL: SPI Transfer length exceeds mocked response length.");
     }
 
+    // Frames starting with other REQ_ID than Get_Response are L2 Requests.
+    if (tx_len != 0 && dev->frame_bytes_transferred == 0 && s2->buff[offset] != TR01_L1_GET_RESPONSE_REQ_ID) {
+        log_request(dev, s2->buff + offset, tx_len, true);
+    }
+
     memcpy(s2->buff + offset, r->data + dev->frame_bytes_transferred, tx_len);
     dev->frame_bytes_transferred += tx_len;
 
@@ -172,6 +300,108 @@ lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_len
     return LT_OK;
 }
 
+lt_ret_t lt_port_spi_transfer_into(lt_l2_state_t *s2, uint8_t offset, uint8_t *rx_buff, uint16_t rx_len,
+                                   uint32_t timeout_ms)
+{
+    LT_UNUSED(timeout_ms);
+    lt_dev_mock_t *dev = (lt_dev_mock_t *)(s2->device);
+
+    if (!dev->spi_transfer_into_enabled) {
+        return LT_NOT_SUPPORTED;
+    }
+    dev->spi_transfer_into_count++;
+
+    if (!dev->frame_in_progress) {
+        LT_LOG_ERROR("Mock HAL: SPI Transfer called while no frame in progress!");
+        return LT_FAIL;
+    }
+
+    if (dev->mock_queue_count == 0) {
+        LT_LOG_ERROR("Mock HAL: no response queued!");
+        return LT_FAIL;
+    }
+
+    if (rx_len + offset > TR01_L1_LEN_MAX) {
+        LT_LOG_ERROR("Mock HAL: SPI Transfer exceeds L1 buffer size!");
+        return LT_L1_DATA_LEN_ERROR;
+    }
+
+    // Same as lt_port_spi_transfer(), only the destination differs.
+    mock_miso_data_t *r = &dev->mock_queue[dev->mock_queue_head];
+    memcpy(rx_buff, r->data + dev->frame_bytes_transferred, rx_len);
+    dev->frame_bytes_transferred += rx_len;
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_frame_xfer(lt_l2_state_t *s2, lt_port_frame_dir_t dir, uint16_t len, uint32_t timeout_ms)
+{
+    lt_dev_mock_t *dev = (lt_dev_mock_t *)(s2->device);
+
+    if (!dev->frame_xfer_enabled) {
+        return LT_NOT_SUPPORTED;
+    }
+    dev->frame_xfer_count++;
+
+    // Frame is transferred from the queued response the same way as by the separate calls.
+    lt_ret_t ret = lt_port_spi_csn_low(s2);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_port_spi_transfer(s2, 0, dir == LT_PORT_FRAME_WRITE ? len : 1, timeout_ms);
+    if (ret == LT_OK && dir == LT_PORT_FRAME_READ && !(s2->buff[0] & TR01_L1_CHIP_MODE_ALARM_bit)
+        && (s2->buff[0] & TR01_L1_CHIP_MODE_READY_bit)) {
+        ret = lt_port_spi_transfer(s2, 1, 2, timeout_ms);
+        if (ret == LT_OK && s2->buff[1] != 0xff) {
+            if (TR01_L1_CHIP_STATUS_SIZE + 2 + s2->buff[2] + 2 > len) {
+                ret = LT_L1_DATA_LEN_ERROR;
+            }
+            else {
+                ret = lt_port_spi_transfer(s2, 3, s2->buff[2] + 2, timeout_ms);
+            }
+        }
+    }
+
+    lt_ret_t ret_csn = lt_port_spi_csn_high(s2);
+
+    return ret != LT_OK ? ret : ret_csn;
+}
+
+lt_ret_t lt_port_spi_transfer_iov(lt_l2_state_t *s2, const lt_port_iov_t *iov, uint8_t iov_cnt, uint32_t timeout_ms)
+{
+    LT_UNUSED(timeout_ms);
+    lt_dev_mock_t *dev = (lt_dev_mock_t *)(s2->device);
+
+    if (!dev->spi_transfer_iov_enabled) {
+        return LT_NOT_SUPPORTED;
+    }
+    dev->spi_transfer_iov_count++;
+
+    lt_ret_t ret = lt_port_spi_csn_low(s2);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    // Parts are only logged, the queued response (CHIP_STATUS) is discarded by CSN high.
+    for (uint8_t i = 0; i < iov_cnt; i++) {
+        if (iov[i].len == 0) {
+            continue;
+        }
+        if (dev->frame_bytes_transferred + iov[i].len > TR01_L1_LEN_MAX) {
+            LT_LOG_ERROR("Mock HAL: SPI Transfer exceeds L1 buffer size!");
+            ret = LT_L1_DATA_LEN_ERROR;
+            break;
+        }
+        log_request(dev, iov[i].base, iov[i].len, dev->frame_bytes_transferred == 0);
+        dev->frame_bytes_transferred += iov[i].len;
+    }
+
+    lt_ret_t ret_csn = lt_port_spi_csn_high(s2);
+
+    return ret != LT_OK ? ret : ret_csn;
+}
+
 lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
 {
     LT_UNUSED(s2);
@@ -185,6 +415,36 @@ lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
     return LT_OK;
 }
 
+lt_ret_t lt_port_delay_us(lt_l2_state_t *s2, uint32_t us)
+{
+    LT_UNUSED(s2);
+
+    struct timespec ts = {.tv_sec = us / 1000000, .tv_nsec = (long)(us % 1000000) * 1000};
+    // Continue sleeping for the remaining time when interrupted by a signal.
+    while (nanosleep(&ts, &ts) != 0) {
+        if (errno != EINTR) {
+            LT_LOG_ERROR("nanosleep() failed: %s", strerror(errno));
+            return LT_FAIL;
+        }
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_get_time_us(lt_l2_state_t *s2, uint64_t *time_us)
+{
+    LT_UNUSED(s2);
+
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        LT_LOG_ERROR("clock_gettime() failed: %s", strerror(errno));
+        return LT_FAIL;
+    }
+    *time_us = (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+
+    return LT_OK;
+}
+
 lt_ret_t lt_port_random_bytes(lt_l2_state_t *s2, void *buff, size_t count)
 {
     LT_UNUSED(s2);
@@ -26,8 +26,20 @@ typedef struct mock_miso_data_t {
     uint8_t data[TR01_L1_LEN_MAX];
 } mock_miso_data_t;
 
-/// @brief Depth of the mock response queue.
-#define MOCK_QUEUE_DEPTH 16
+/// @brief Depth of the mock response queue (enough for the maximal Ping, whose L3 Command and L3 Result are split into
+/// 17 chunks each).
+#define MOCK_QUEUE_DEPTH 64
+
+/// @brief Number of L2 Requests stored in the request log.
+#define MOCK_REQUEST_LOG_DEPTH 4
+
+/**
+ * @brief L2 Request frame written by Libtropic, as seen on the MOSI line.
+ */
+typedef struct mock_mosi_data_t {
+    size_t len;
+    uint8_t data[TR01_L1_LEN_MAX];
+} mock_mosi_data_t;
 
 /**
  * @brief Device structure for Mock HAL port.
@@ -46,6 +58,28 @@ typedef struct lt_dev_mock_t {
     bool frame_in_progress;
     /** @private @brief Number of bytes transferred in the current frame so far. */
     size_t frame_bytes_transferred;
+
+    /** @private @brief Flag indicating if lt_port_frame_xfer() is implemented (otherwise returns LT_NOT_SUPPORTED). */
+    bool frame_xfer_enabled;
+    /** @private @brief Number of frames transferred by lt_port_frame_xfer(). */
+    size_t frame_xfer_count;
+
+    /** @private @brief Flag indicating if lt_port_spi_transfer_iov() is implemented (otherwise returns
+     * LT_NOT_SUPPORTED). */
+    bool spi_transfer_iov_enabled;
+    /** @private @brief Number of frames written by lt_port_spi_transfer_iov(). */
+    size_t spi_transfer_iov_count;
+
+    /** @private @brief Flag indicating if lt_port_spi_transfer_into() is implemented (otherwise returns
+     * LT_NOT_SUPPORTED). */
+    bool spi_transfer_into_enabled;
+    /** @private @brief Number of calls of lt_port_spi_transfer_into(). */
+    size_t spi_transfer_into_count;
+
+    /** @private @brief First L2 Requests written since the last reset, Get_Response requests are not logged. */
+    mock_mosi_data_t request_log[MOCK_REQUEST_LOG_DEPTH];
+    /** @private @brief Number of L2 Requests written since the last reset, including those not stored. */
+    size_t request_log_count;
 } lt_dev_mock_t;
 
 // Test control API -----------------------------------------------------
@@ -69,6 +103,77 @@ lt_ret_t lt_mock_hal_reset(lt_l2_state_t *s2);
  */
 lt_ret_t lt_mock_hal_enqueue_response(lt_l2_state_t *s2, const uint8_t *data, const size_t len);
 
+/**
+ * @brief Makes lt_port_frame_xfer() transfer whole frames, or return LT_NOT_SUPPORTED as ports without it do.
+ *
+ * @details Disabled by default and by lt_mock_hal_reset().
+ *
+ * @param s2 L2 state holding the mock device.
+ * @param enable True to implement lt_port_frame_xfer(), false to make it unsupported.
+ * @return LT_OK on success, LT_PARAM_ERR otherwise.
+ */
+lt_ret_t lt_mock_hal_enable_frame_xfer(lt_l2_state_t *s2, const bool enable);
+
+/**
+ * @brief Number of frames transferred by lt_port_frame_xfer() since the last reset.
+ *
+ * @param s2 L2 state holding the mock device.
+ * @return Number of frames, 0 if `s2` is NULL.
+ */
+size_t lt_mock_hal_get_frame_xfer_count(const lt_l2_state_t *s2);
+
+/**
+ * @brief Makes lt_port_spi_transfer_iov() write gathered parts, or return LT_NOT_SUPPORTED as ports without it do.
+ *
+ * @details Disabled by default and by lt_mock_hal_reset().
+ *
+ * @param s2 L2 state holding the mock device.
+ * @param enable True to implement lt_port_spi_transfer_iov(), false to make it unsupported.
+ * @return LT_OK on success, LT_PARAM_ERR otherwise.
+ */
+lt_ret_t lt_mock_hal_enable_spi_transfer_iov(lt_l2_state_t *s2, const bool enable);
+
+/**
+ * @brief Number of frames written by lt_port_spi_transfer_iov() since the last reset.
+ *
+ * @param s2 L2 state holding the mock device.
+ * @return Number of frames, 0 if `s2` is NULL.
+ */
+size_t lt_mock_hal_get_spi_transfer_iov_count(const lt_l2_state_t *s2);
+
+/**
+ * @brief Makes lt_port_spi_transfer_into() receive into the given buffer, or return LT_NOT_SUPPORTED as ports without
+ * it do.
+ *
+ * @details Disabled by default and by lt_mock_hal_reset().
+ *
+ * @param s2 L2 state holding the mock device.
+ * @param enable True to implement lt_port_spi_transfer_into(), false to make it unsupported.
+ * @return LT_OK on success, LT_PARAM_ERR otherwise.
+ */
+lt_ret_t lt_mock_hal_enable_spi_transfer_into(lt_l2_state_t *s2, const bool enable);
+
+/**
+ * @brief Number of calls of lt_port_spi_transfer_into() since the last reset.
+ *
+ * @param s2 L2 state holding the mock device.
+ * @return Number of calls, 0 if `s2` is NULL.
+ */
+size_t lt_mock_hal_get_spi_transfer_into_count(const lt_l2_state_t *s2);
+
+/**
+ * @brief Number of L2 Requests written since the last reset (Get_Response requests are not counted).
+ */
+size_t lt_mock_hal_get_request_count(const lt_l2_state_t *s2);
+
+/**
+ * @brief Returns L2 Request logged since the last reset.
+ *
+ * @param index Index of the request, only the first MOCK_REQUEST_LOG_DEPTH requests are stored.
+ * @return Logged request or NULL if it is not stored.
+ */
+const mock_mosi_data_t *lt_mock_hal_get_request(const lt_l2_state_t *s2, const size_t index);
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,12 +11,15 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <netinet/tcp.h>
 #include <stdarg.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -76,19 +79,101 @@ static lt_ret_t send_all(const int socket_fd, const uint8_t *buffer, const size_
 }
 
 /**
- * @brief Send and receive data to/from the TCP port.
+ * @brief Asks the kernel to acknowledge received TCP segments immediately.
+ *
+ * Linux clears TCP_QUICKACK on its own, so it is set again after each reception. Failure is not fatal, it only costs
+ * latency.
+ *
+ * @param dev TCP HAL Device structure
+ */
+static void set_quickack(lt_dev_posix_tcp_t *dev)
+{
+#ifdef TCP_QUICKACK
+    int one = 1;
+    if (dev->is_tcp && setsockopt(dev->socket_fd, IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one)) != 0) {
+        LT_LOG_WARN("Could not set TCP_QUICKACK: %s (%d).", strerror(errno), errno);
+    }
+#else
+    LT_UNUSED(dev);
+#endif
+}
+
+/**
+ * @brief Receives one message into the reception buffer.
+ *
+ * Bytes are received into the persistent `rx_stream` as they come, so recv() is called only when the message is not
+ * already there.
+ *
+ * @param dev TCP HAL Device structure
+ * @param rx_payload_length_ptr Pointer to the length of the received payload (excluding tag and length fields)
+ * @return LT_OK on success, LT_FAIL otherwise
+ */
+static lt_ret_t receive_message(lt_dev_posix_tcp_t *dev, int *rx_payload_length_ptr)
+{
+    for (int i = 0; i <= LT_TCP_RX_ATTEMPTS; i++) {
+        const uint8_t *msg = dev->rx_stream + dev->rx_stream_pos;
+        size_t nb_bytes_buffered = dev->rx_stream_len - dev->rx_stream_pos;
+
+        if (nb_bytes_buffered >= LT_TCP_TAG_AND_LENGTH_SIZE) {
+            memcpy(dev->rx_buffer.buff, msg, LT_TCP_TAG_AND_LENGTH_SIZE);
+            LT_LOG_DEBUG("Length field: %" PRIu16 ".", dev->rx_buffer.len);
+            if (dev->rx_buffer.len > LT_TCP_MAX_PAYLOAD_LEN) {
+                LT_LOG_ERROR("Payload of %" PRIu16 " bytes does not fit the buffer.", dev->rx_buffer.len);
+                return LT_FAIL;
+            }
+
+            size_t nb_bytes_msg = LT_TCP_TAG_AND_LENGTH_SIZE + dev->rx_buffer.len;
+            if (nb_bytes_buffered >= nb_bytes_msg) {
+                memcpy(dev->rx_buffer.buff, msg, nb_bytes_msg);
+                dev->rx_stream_pos += nb_bytes_msg;
+                if (dev->rx_stream_pos == dev->rx_stream_len) {
+                    dev->rx_stream_pos = 0;
+                    dev->rx_stream_len = 0;
+                }
+                if (rx_payload_length_ptr != NULL) {
+                    *rx_payload_length_ptr = dev->rx_buffer.len;
+                }
+                return LT_OK;
+            }
+        }
+
+        // Move the incomplete message to the beginning, so the largest message always fits.
+        if (dev->rx_stream_pos != 0) {
+            memmove(dev->rx_stream, msg, nb_bytes_buffered);
+            dev->rx_stream_pos = 0;
+            dev->rx_stream_len = nb_bytes_buffered;
+        }
+
+        LT_LOG_DEBUG("Receiving data from target: attempt #%d.", i);
+        ssize_t nb_bytes_received = recv(dev->socket_fd, dev->rx_stream + dev->rx_stream_len,
+                                         LT_TCP_RX_STREAM_LEN - dev->rx_stream_len, 0);
+        if (nb_bytes_received < 0) {
+            LT_LOG_ERROR("Receive failed: %s (%d).", strerror(errno), errno);
+            return LT_FAIL;
+        }
+        else if (nb_bytes_received == 0) {
+            LT_LOG_ERROR("Connection closed by the server.");
+            return LT_FAIL;
+        }
+        dev->rx_stream_len += nb_bytes_received;
+        set_quickack(dev);
+    }
+
+    LT_LOG_ERROR("Message not received after %d attempts.", LT_TCP_RX_ATTEMPTS + 1);
+
+    return LT_FAIL;
+}
+
+/**
+ * @brief Send data to the TCP port and receive the response, without checking its tag.
  *
  * @param dev TCP HAL Device structure
  * @param tx_payload_length_ptr Pointer to the length of the payload to send (excluding tag and length fields)
  * @param rx_payload_length_ptr Pointer to the length of the payload to receive (excluding tag and length fields)
  * @return LT_OK on success, LT_FAIL otherwise
  */
-static lt_ret_t communicate(lt_dev_posix_tcp_t *dev, int *tx_payload_length_ptr, int *rx_payload_length_ptr)
+static lt_ret_t exchange(lt_dev_posix_tcp_t *dev, int *tx_payload_length_ptr, int *rx_payload_length_ptr)
 {
-    int nb_bytes_received;
-    int nb_bytes_received_total = 0;
-    int nb_bytes_to_receive = LT_TCP_TAG_AND_LENGTH_SIZE;
-    uint8_t *rx_ptr = dev->rx_buffer.buff;
     // number of bytes to send
     int nb_bytes_to_send = LT_TCP_TAG_AND_LENGTH_SIZE;
 
@@ -103,47 +188,21 @@ static lt_ret_t communicate(lt_dev_posix_tcp_t *dev, int *tx_payload_length_ptr,
         return LT_FAIL;
     }
 
-    // receive data
     LT_LOG_DEBUG("- Receiving data from target.");
-    nb_bytes_received = recv(dev->socket_fd, dev->rx_buffer.buff, LT_TCP_MAX_RECV_SIZE, 0);
-
-    if (nb_bytes_received < 0) {
-        LT_LOG_ERROR("Receive failed: %s (%d).", strerror(errno), errno);
-        return LT_FAIL;
-    }
-    else if (nb_bytes_received < nb_bytes_to_receive) {
-        LT_LOG_ERROR("At least %d bytes are expected: %d.", nb_bytes_to_receive, nb_bytes_received);
-        return LT_FAIL;
-    }
-
-    LT_LOG_DEBUG("Length field: %" PRIu16 ".", dev->rx_buffer.len);
-    nb_bytes_to_receive += dev->rx_buffer.len;
-    nb_bytes_received_total += nb_bytes_received;
-    LT_LOG_DEBUG("Received %d bytes out of %d expected.", nb_bytes_received_total, nb_bytes_to_receive);
-
-    if (nb_bytes_received_total < nb_bytes_to_receive) {
-        rx_ptr += nb_bytes_received;
-
-        for (int i = 0; i < LT_TCP_RX_ATTEMPTS; i++) {
-            LT_LOG_DEBUG("Attempting to receive remaining bytes: attempt #%d.", i);
-            nb_bytes_received = recv(dev->socket_fd, dev->rx_buffer.buff, LT_TCP_MAX_RECV_SIZE, 0);
-
-            if (nb_bytes_received < 0) {
-                LT_LOG_ERROR("Receive failed: %s (%d).", strerror(errno), errno);
-                return LT_FAIL;
-            }
-
-            nb_bytes_received_total += nb_bytes_received;
-            if (nb_bytes_received_total >= nb_bytes_to_receive) {
-                LT_LOG_DEBUG("Received %d bytes in total.", nb_bytes_received_total);
-                break;
-            }
-            rx_ptr += nb_bytes_received;
-        }
-    }
+    return receive_message(dev, rx_payload_length_ptr);
+}
 
-    if (nb_bytes_received_total != nb_bytes_to_receive) {
-        LT_LOG_ERROR("Received %d bytes in total instead of %d.", nb_bytes_received_total, nb_bytes_to_receive);
+/**
+ * @brief Send and receive data to/from the TCP port.
+ *
+ * @param dev TCP HAL Device structure
+ * @param tx_payload_length_ptr Pointer to the length of the payload to send (excluding tag and length fields)
+ * @param rx_payload_length_ptr Pointer to the length of the payload to receive (excluding tag and length fields)
+ * @return LT_OK on success, LT_FAIL otherwise
+ */
+static lt_ret_t communicate(lt_dev_posix_tcp_t *dev, int *tx_payload_length_ptr, int *rx_payload_length_ptr)
+{
+    if (exchange(dev, tx_payload_length_ptr, rx_payload_length_ptr) != LT_OK) {
         return LT_FAIL;
     }
 
@@ -164,20 +223,87 @@ static lt_ret_t communicate(lt_dev_posix_tcp_t *dev, int *tx_payload_length_ptr,
     }
 
     LT_LOG_DEBUG("Rx tag and tx tag match: %" PRIu8 ".", dev->rx_buffer.tag);
-    if (rx_payload_length_ptr != NULL) {
-        *rx_payload_length_ptr = nb_bytes_received_total - LT_TCP_TAG_AND_LENGTH_SIZE;
+
+    return LT_OK;
+}
+
+/**
+ * @brief Detects whether the server supports LT_TCP_TAG_SPI_TRANSACTION by sending a transaction without segments.
+ *
+ * @param dev TCP HAL Device structure
+ * @return LT_OK on success (also when the tag is not supported), LT_FAIL otherwise
+ */
+static lt_ret_t probe_transaction(lt_dev_posix_tcp_t *dev)
+{
+    int payload_length = 0;
+
+    dev->transaction_supported = false;
+    dev->tx_buffer.tag = LT_TCP_TAG_SPI_TRANSACTION;
+
+    if (exchange(dev, &payload_length, NULL) != LT_OK) {
+        return LT_FAIL;
+    }
+
+    if (dev->rx_buffer.tag == LT_TCP_TAG_SPI_TRANSACTION) {
+        dev->transaction_supported = true;
+        LT_LOG_DEBUG("Server supports SPI transactions.");
+    }
+    else if ((lt_posix_tcp_tag_t)dev->rx_buffer.tag == LT_TCP_TAG_INVALID
+             || (lt_posix_tcp_tag_t)dev->rx_buffer.tag == LT_TCP_TAG_UNSUPPORTED) {
+        LT_LOG_DEBUG("Server does not support SPI transactions, using separate SPI tags.");
+    }
+    else {
+        LT_LOG_ERROR("Expected tag %" PRIu8 ", received %" PRIu8 ".", dev->tx_buffer.tag, dev->rx_buffer.tag);
+        return LT_FAIL;
     }
 
     return LT_OK;
 }
 
-lt_ret_t lt_port_init(lt_l2_state_t *s2)
+/**
+ * @brief Transfers one segment within one chip select assertion using LT_TCP_TAG_SPI_TRANSACTION.
+ *
+ * @param s2 Structure holding l2 state
+ * @param flags Segment flags (LT_TCP_SEGMENT_FLAG_*)
+ * @param len Number of bytes from `s2->buff` to transfer (upper bound for LT_TCP_SEGMENT_FLAG_L1_RESPONSE)
+ * @param rx_len_ptr Number of received bytes stored into `s2->buff`
+ * @return LT_OK on success, LT_FAIL otherwise
+ */
+static lt_ret_t transaction(lt_l2_state_t *s2, uint8_t flags, uint16_t len, uint16_t *rx_len_ptr)
 {
     lt_dev_posix_tcp_t *dev = (lt_dev_posix_tcp_t *)(s2->device);
+    int tx_payload_length = LT_TCP_SEGMENT_HEADER_SIZE + len;
+    int rx_payload_length;
 
-    bzero(dev->tx_buffer.buff, LT_TCP_MAX_BUFFER_LEN);
-    bzero(dev->rx_buffer.buff, LT_TCP_MAX_BUFFER_LEN);
+    dev->tx_buffer.tag = LT_TCP_TAG_SPI_TRANSACTION;
+    dev->tx_buffer.payload[0] = flags;
+    dev->tx_buffer.payload[1] = len & 0x00ff;
+    dev->tx_buffer.payload[2] = (len & 0xff00) >> 8;
+    memcpy(&dev->tx_buffer.payload[LT_TCP_SEGMENT_HEADER_SIZE], s2->buff, len);
+
+    if (communicate(dev, &tx_payload_length, &rx_payload_length) != LT_OK) {
+        return LT_FAIL;
+    }
+
+    if (rx_payload_length > len) {
+        LT_LOG_ERROR("Received %d bytes in transaction of %" PRIu16 " bytes.", rx_payload_length, len);
+        return LT_FAIL;
+    }
+
+    memcpy(s2->buff, &dev->rx_buffer.payload, rx_payload_length);
+    *rx_len_ptr = (uint16_t)rx_payload_length;
+
+    return LT_OK;
+}
 
+/**
+ * @brief Connects to the model server through TCP and disables delays of small segments.
+ *
+ * @param dev TCP HAL Device structure
+ * @return LT_OK on success, LT_FAIL otherwise
+ */
+static lt_ret_t connect_tcp(lt_dev_posix_tcp_t *dev)
+{
     // Create socket
     dev->socket_fd = socket(AF_INET, SOCK_STREAM, 0);
     if (dev->socket_fd < 0) {
@@ -185,6 +311,7 @@ lt_ret_t lt_port_init(lt_l2_state_t *s2)
         return LT_FAIL;
     }
     LT_LOG_DEBUG("Socket created.");
+    dev->is_tcp = true;
 
     // Server information
     struct sockaddr_in server;
@@ -200,8 +327,79 @@ lt_ret_t lt_port_init(lt_l2_state_t *s2)
         close(dev->socket_fd);
         return LT_FAIL;
     }
+
+    // Every message waits for its response, so there is nothing to coalesce and Nagle's algorithm only adds latency.
+    int one = 1;
+    if (setsockopt(dev->socket_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) != 0) {
+        LT_LOG_WARN("Could not set TCP_NODELAY: %s (%d).", strerror(errno), errno);
+    }
+    set_quickack(dev);
+
+    return LT_OK;
+}
+
+/**
+ * @brief Connects to the model server through a Unix domain socket.
+ *
+ * @param dev TCP HAL Device structure
+ * @return LT_OK on success, LT_FAIL otherwise
+ */
+static lt_ret_t connect_unix(lt_dev_posix_tcp_t *dev)
+{
+    const char *path = dev->sock_path;
+    if (strncmp(path, LT_TCP_UNIX_PREFIX, strlen(LT_TCP_UNIX_PREFIX)) == 0) {
+        path += strlen(LT_TCP_UNIX_PREFIX);
+    }
+
+    struct sockaddr_un server;
+    memset(&server, 0, sizeof(server));
+    server.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(server.sun_path)) {
+        LT_LOG_ERROR("Socket path is too long: %s.", path);
+        return LT_FAIL;
+    }
+    strcpy(server.sun_path, path);
+
+    // Create socket
+    dev->socket_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (dev->socket_fd < 0) {
+        LT_LOG_ERROR("Could not create socket: %s (%d).", strerror(errno), errno);
+        return LT_FAIL;
+    }
+    LT_LOG_DEBUG("Socket created.");
+    dev->is_tcp = false;
+
+    // Connect to the server
+    LT_LOG_DEBUG("Connecting to %s.", path);
+    if (connect(dev->socket_fd, (struct sockaddr *)(&server), sizeof(server)) < 0) {
+        LT_LOG_ERROR("Could not connect: %s (%d).", strerror(errno), errno);
+        close(dev->socket_fd);
+        return LT_FAIL;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_init(lt_l2_state_t *s2)
+{
+    lt_dev_posix_tcp_t *dev = (lt_dev_posix_tcp_t *)(s2->device);
+
+    bzero(dev->tx_buffer.buff, LT_TCP_MAX_BUFFER_LEN);
+    bzero(dev->rx_buffer.buff, LT_TCP_MAX_BUFFER_LEN);
+    dev->rx_stream_pos = 0;
+    dev->rx_stream_len = 0;
+
+    lt_ret_t ret = (dev->sock_path != NULL) ? connect_unix(dev) : connect_tcp(dev);
+    if (ret != LT_OK) {
+        return ret;
+    }
     LT_LOG_DEBUG("Connected to the server.");
 
+    if (probe_transaction(dev) != LT_OK) {
+        close(dev->socket_fd);
+        return LT_FAIL;
+    }
+
     return LT_OK;
 }
 
@@ -267,6 +465,51 @@ lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_dat
     return LT_OK;
 }
 
+lt_ret_t lt_port_frame_xfer(lt_l2_state_t *s2, lt_port_frame_dir_t dir, uint16_t len, uint32_t timeout_ms)
+{
+    LT_UNUSED(timeout_ms);
+    lt_dev_posix_tcp_t *dev = (lt_dev_posix_tcp_t *)(s2->device);
+    uint16_t rx_len;
+
+    if (!dev->transaction_supported) {
+        return LT_NOT_SUPPORTED;
+    }
+
+    if (len > TR01_L1_LEN_MAX) {
+        return LT_L1_DATA_LEN_ERROR;
+    }
+
+    LT_LOG_DEBUG("-- Transferring frame through SPI bus.");
+
+    if (dir == LT_PORT_FRAME_WRITE) {
+        if (transaction(s2, 0, len, &rx_len) != LT_OK) {
+            return LT_FAIL;
+        }
+        if (rx_len != len) {
+            LT_LOG_ERROR("Received %" PRIu16 " bytes instead of %" PRIu16 ".", rx_len, len);
+            return LT_FAIL;
+        }
+        return LT_OK;
+    }
+
+    if (transaction(s2, LT_TCP_SEGMENT_FLAG_L1_RESPONSE, len, &rx_len) != LT_OK) {
+        return LT_FAIL;
+    }
+    if (rx_len < TR01_L1_CHIP_STATUS_SIZE) {
+        LT_LOG_ERROR("CHIP_STATUS not received.");
+        return LT_FAIL;
+    }
+
+    // The server stops after CHIP_STATUS when there is no frame to read, so STATUS and RSP_LEN were received only when
+    // the chip is ready. The frame then ends after RSP_CRC, unless STATUS tells there is no response.
+    if (rx_len >= TR01_L1_CHIP_STATUS_SIZE + 2 && s2->buff[1] != 0xff
+        && TR01_L1_CHIP_STATUS_SIZE + 2 + s2->buff[2] + 2 > rx_len) {
+        return LT_L1_DATA_LEN_ERROR;
+    }
+
+    return LT_OK;
+}
+
 lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
 {
     lt_dev_posix_tcp_t *dev = (lt_dev_posix_tcp_t *)(s2->device);
@@ -274,14 +517,45 @@ lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
     LT_LOG_DEBUG("-- Waiting for the target.");
     dev->tx_buffer.tag = LT_TCP_TAG_WAIT;
     int payload_length = sizeof(uint32_t);
-    dev->rx_buffer.payload[0] = ms & 0x000000ff;
-    dev->rx_buffer.payload[1] = (ms & 0x0000ff00) >> 8;
-    dev->rx_buffer.payload[2] = (ms & 0x00ff0000) >> 16;
-    dev->rx_buffer.payload[3] = (ms & 0xff000000) >> 24;
+    dev->tx_buffer.payload[0] = ms & 0x000000ff;
+    dev->tx_buffer.payload[1] = (ms & 0x0000ff00) >> 8;
+    dev->tx_buffer.payload[2] = (ms & 0x00ff0000) >> 16;
+    dev->tx_buffer.payload[3] = (ms & 0xff000000) >> 24;
 
     return communicate(dev, &payload_length, NULL);
 }
 
+lt_ret_t lt_port_delay_us(lt_l2_state_t *s2, uint32_t us)
+{
+    LT_UNUSED(s2);
+
+    // The model wait tag has only ms resolution, so short waits are done locally without a round trip.
+    struct timespec ts = {.tv_sec = us / 1000000, .tv_nsec = (long)(us % 1000000) * 1000};
+    // Continue sleeping for the remaining time when interrupted by a signal.
+    while (nanosleep(&ts, &ts) != 0) {
+        if (errno != EINTR) {
+            LT_LOG_ERROR("nanosleep() failed: %s", strerror(errno));
+            return LT_FAIL;
+        }
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_get_time_us(lt_l2_state_t *s2, uint64_t *time_us)
+{
+    LT_UNUSED(s2);
+
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        LT_LOG_ERROR("clock_gettime() failed: %s", strerror(errno));
+        return LT_FAIL;
+    }
+    *time_us = (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+
+    return LT_OK;
+}
+
 lt_ret_t lt_port_random_bytes(lt_l2_state_t *s2, void *buff, size_t count)
 {
     LT_UNUSED(s2);
@@ -10,6 +10,7 @@
  */
 
 #include <netinet/in.h>
+#include <stdbool.h>
 
 #include "libtropic_common.h"
 
@@ -18,12 +19,23 @@ extern "C" {
 #endif
 
 #define LT_TCP_TAG_AND_LENGTH_SIZE (sizeof(uint8_t) + sizeof(uint16_t))
-#define LT_TCP_MAX_PAYLOAD_LEN TR01_L2_MAX_FRAME_SIZE
+/** @brief Size of the flags and length header of each segment in LT_TCP_TAG_SPI_TRANSACTION payload. */
+#define LT_TCP_SEGMENT_HEADER_SIZE (sizeof(uint8_t) + sizeof(uint16_t))
+/**
+ * @brief Segment flag: the segment reads CHIP_STATUS and L2 Response frame, the server stops clocking once the frame
+ * ends (at the same points as lt_port_frame_xfer() describes) and `length` is only the upper bound.
+ */
+#define LT_TCP_SEGMENT_FLAG_L1_RESPONSE 0x01
+#define LT_TCP_MAX_PAYLOAD_LEN (LT_TCP_SEGMENT_HEADER_SIZE + TR01_L1_LEN_MAX)
 #define LT_TCP_MAX_BUFFER_LEN (LT_TCP_TAG_AND_LENGTH_SIZE + LT_TCP_MAX_PAYLOAD_LEN)
 
 #define LT_TCP_TX_ATTEMPTS 3
 #define LT_TCP_RX_ATTEMPTS 3
 #define LT_TCP_MAX_RECV_SIZE (LT_TCP_MAX_PAYLOAD_LEN + LT_TCP_TAG_AND_LENGTH_SIZE)
+/** @brief Size of the persistent receive buffer, messages are parsed out of it without further recv() calls. */
+#define LT_TCP_RX_STREAM_LEN (2 * LT_TCP_MAX_RECV_SIZE)
+/** @brief Prefix accepted in `sock_path` of `lt_dev_posix_tcp_t`. */
+#define LT_TCP_UNIX_PREFIX "unix:"
 
 /** @brief Possible values for `tag` field of `lt_posix_tcp_buffer_t`. */
 typedef enum lt_posix_tcp_tag_t {
@@ -33,6 +45,13 @@ typedef enum lt_posix_tcp_tag_t {
     LT_TCP_TAG_POWER_ON = 0x04,
     LT_TCP_TAG_POWER_OFF = 0x05,
     LT_TCP_TAG_WAIT = 0x06,
+    /**
+     * Whole chip select assertion in one message. The payload is a sequence of segments, each consisting of flags
+     * (uint8_t), length (uint16_t) and `length` MOSI bytes. The server drives chip select low, transfers all segments
+     * and drives chip select high, the response payload contains all MISO bytes. A transaction without segments does
+     * not touch chip select and is used to detect support of this tag.
+     */
+    LT_TCP_TAG_SPI_TRANSACTION = 0x07,
     LT_TCP_TAG_RESET_TARGET = 0x10,
     LT_TCP_TAG_INVALID = 0xfd,
     LT_TCP_TAG_UNSUPPORTED = 0xfe,
@@ -61,11 +80,27 @@ typedef struct lt_dev_posix_tcp_t {
     in_addr_t addr;
     /** @public @brief Port of the model server. */
     in_port_t port;
+    /**
+     * @public @brief Path of the model server's Unix domain socket, optionally prefixed with `unix:`. NULL to connect
+     * through TCP to `addr` and `port`, which are ignored otherwise. Must stay valid until the handle is
+     * deinitialized.
+     */
+    const char *sock_path;
 
     /** @private @brief Socket file descriptor. */
     int socket_fd;
-    /** @private @brief Reception buffer. */
+    /** @private @brief Socket is a TCP socket (TCP_QUICKACK is renewed after each reception). */
+    bool is_tcp;
+    /** @private @brief Server supports LT_TCP_TAG_SPI_TRANSACTION, detected in lt_port_init(). */
+    bool transaction_supported;
+    /** @private @brief Reception buffer, holds the last received message. */
     struct lt_posix_tcp_buffer_t rx_buffer;
+    /** @private @brief Bytes received from the socket, not parsed yet are from `rx_stream_pos` to `rx_stream_len`. */
+    uint8_t rx_stream[LT_TCP_RX_STREAM_LEN];
+    /** @private @brief Position of the first unparsed byte in `rx_stream`. */
+    size_t rx_stream_pos;
+    /** @private @brief Number of valid bytes in `rx_stream`. */
+    size_t rx_stream_len;
     /** @private @brief Emission buffer. */
     struct lt_posix_tcp_buffer_t tx_buffer;
 } lt_dev_posix_tcp_t;
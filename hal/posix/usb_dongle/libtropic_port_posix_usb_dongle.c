@@ -16,6 +16,7 @@
 #include <fcntl.h>
 #include <inttypes.h>
 #include <limits.h>
+#include <poll.h>
 #include <stdarg.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -30,6 +31,7 @@
 #include "libtropic_logging.h"
 #include "libtropic_macros.h"
 #include "libtropic_port.h"
+#include "libtropic_port_posix_usb_dongle_termios2.h"
 
 #if LT_USE_INT_PIN
 #error "Interrupt PIN not supported in the USB dongle port!"
@@ -52,43 +54,161 @@
  *
  * @return Returns 0 on success, or -1 on error.
  */
-static int write_port(int fd, uint8_t *buffer, size_t size)
+static int write_port(int fd, const uint8_t *buffer, size_t size)
 {
-    ssize_t written_bytes = write(fd, buffer, size);
-    if (written_bytes != (ssize_t)size) {
-        LT_LOG_ERROR("Failed to write to port, written_bytes=%zd.", written_bytes);
-        return -1;
+    size_t written = 0;
+    while (written < size) {
+        ssize_t written_bytes = write(fd, buffer + written, size - written);
+        if (written_bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LT_LOG_ERROR("Failed to write to port: %s (%d).", strerror(errno), errno);
+            return -1;
+        }
+        written += written_bytes;
     }
     return 0;
 }
 
 /**
- * @brief Reads data from a serial port (specified by fd).
+ * @brief Reads exactly `size` bytes from a serial port (specified by fd).
  *
- * @note  Returns after all the desired bytes have been read, or if there is a timeout or other error.
+ * @note  Waits with poll() until the bytes are available, so it returns as soon as the last byte arrives. Fails if no
+ *        byte arrives for LT_USB_DONGLE_READ_TIMEOUT_MS.
  *
  * @param fd        The file descriptor to read from.
  * @param buffer    Pointer to the buffer where the read data will be stored.
- * @param size      The maximum number of bytes to read into the buffer.
+ * @param size      The number of bytes to read into the buffer.
  *
- * @return Returns the number of bytes actually read on success, or -1 on error.
+ * @return Returns 0 on success, or -1 on error or timeout.
  */
-static ssize_t read_port(int fd, uint8_t *buffer, size_t size)
+static int read_port(int fd, uint8_t *buffer, size_t size)
 {
     size_t received = 0;
     while (received < size) {
+        struct pollfd pfd = {.fd = fd, .events = POLLIN};
+        int ready = poll(&pfd, 1, LT_USB_DONGLE_READ_TIMEOUT_MS);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LT_LOG_ERROR("Failed to poll port: %s (%d).", strerror(errno), errno);
+            return -1;
+        }
+        if (ready == 0) {
+            LT_LOG_ERROR("Timeout, received %zu bytes instead of %zu.", received, size);
+            return -1;
+        }
+
         ssize_t read_bytes = read(fd, buffer + received, size - received);
         if (read_bytes < 0) {
-            LT_LOG_ERROR("Failed to read from port, read_bytes=%zd.", read_bytes);
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            LT_LOG_ERROR("Failed to read from port: %s (%d).", strerror(errno), errno);
             return -1;
         }
         if (read_bytes == 0) {
-            // Timeout.
-            break;
+            LT_LOG_ERROR("Port closed, received %zu bytes instead of %zu.", received, size);
+            return -1;
         }
         received += read_bytes;
     }
-    return received;
+    return 0;
+}
+
+/**
+ * @brief Sends a command in binary framing and receives the status and `len` MISO bytes.
+ *
+ * @param fd    File descriptor of the port
+ * @param cmd   One of LT_USB_DONGLE_BIN_CMD_*
+ * @param data  MOSI bytes, overwritten by MISO bytes
+ * @param len   Number of bytes in `data`
+ *
+ * @return Returns 0 on success, or -1 on error.
+ */
+static int binary_command(int fd, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    uint8_t frame[LT_USB_DONGLE_BIN_HEADER_SIZE + TR01_L1_LEN_MAX];
+
+    frame[0] = cmd;
+    frame[1] = len & 0xff;
+    frame[2] = len >> 8;
+    if (len != 0) {
+        memcpy(frame + LT_USB_DONGLE_BIN_HEADER_SIZE, data, len);
+    }
+    if (write_port(fd, frame, LT_USB_DONGLE_BIN_HEADER_SIZE + len) != 0) {
+        return -1;
+    }
+
+    // Status and MISO bytes.
+    if (read_port(fd, frame, 1 + len) != 0) {
+        return -1;
+    }
+    if (frame[0] != LT_USB_DONGLE_BIN_STATUS_OK) {
+        LT_LOG_ERROR("Dongle returned status 0x%02" PRIX8 ".", frame[0]);
+        return -1;
+    }
+    if (len != 0) {
+        memcpy(data, frame + 1, len);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Converts a hex digit to its value.
+ *
+ * @param c  Hex digit (both cases are accepted)
+ *
+ * @return Value of the digit, or -1 if `c` is not a hex digit.
+ */
+static int hex_value(uint8_t c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief Returns the termios constant for a standard baud rate.
+ *
+ * @param baud_rate  Baud rate in bits per second
+ *
+ * @return termios speed constant, or B0 if the rate is not a standard one.
+ */
+static speed_t standard_speed(uint32_t baud_rate)
+{
+    switch (baud_rate) {
+        case 4800:
+            return B4800;
+        case 9600:
+            return B9600;
+        case 19200:
+            return B19200;
+        case 38400:
+            return B38400;
+#ifdef B57600
+        case 57600:
+            return B57600;
+#endif
+        case 115200:
+            return B115200;
+#ifdef B230400
+        case 230400:
+            return B230400;
+#endif
+        default:
+            return B0;
+    }
 }
 
 lt_ret_t lt_port_init(lt_l2_state_t *s2)
@@ -124,34 +244,13 @@ lt_ret_t lt_port_init(lt_l2_state_t *s2)
     options.c_oflag &= ~(ONLCR | OCRNL);
     options.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
 
-    // Set up timeouts: Calls to read() will return as soon as there is
-    // at least one byte available or when 100 ms has passed.
-    options.c_cc[VTIME] = 1;
+    // read() returns immediately with the bytes available, waiting is done by poll().
+    options.c_cc[VTIME] = 0;
     options.c_cc[VMIN] = 0;
 
-    // This code only supports certain standard baud rates. Supporting
-    // non-standard baud rates should be possible but takes more work.
-    switch (device->baud_rate) {
-        case 4800:
-            cfsetospeed(&options, B4800);
-            break;
-        case 9600:
-            cfsetospeed(&options, B9600);
-            break;
-        case 19200:
-            cfsetospeed(&options, B19200);
-            break;
-        case 38400:
-            cfsetospeed(&options, B38400);
-            break;
-        case 115200:
-            cfsetospeed(&options, B115200);
-            break;
-        default:
-            LT_LOG_WARN("Baud rate %" PRIu32 " is not supported, using 9600.\n", device->baud_rate);
-            cfsetospeed(&options, B9600);
-            break;
-    }
+    // Rates other than the standard ones are set through termios2 afterwards.
+    speed_t speed = standard_speed(device->baud_rate);
+    cfsetospeed(&options, (speed != B0) ? speed : B9600);
     cfsetispeed(&options, cfgetospeed(&options));
 
     result = tcsetattr(device->fd, TCSANOW, &options);
@@ -161,6 +260,10 @@ lt_ret_t lt_port_init(lt_l2_state_t *s2)
         return LT_FAIL;
     }
 
+    if (speed == B0 && lt_usb_dongle_set_custom_baud_rate(device->fd, device->baud_rate) != 0) {
+        LT_LOG_WARN("Baud rate %" PRIu32 " is not supported, using 9600.", device->baud_rate);
+    }
+
     return LT_OK;
 }
 
@@ -186,6 +289,36 @@ lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
     return LT_OK;
 }
 
+lt_ret_t lt_port_delay_us(lt_l2_state_t *s2, uint32_t us)
+{
+    LT_UNUSED(s2);
+
+    struct timespec ts = {.tv_sec = us / 1000000, .tv_nsec = (long)(us % 1000000) * 1000};
+    // Continue sleeping for the remaining time when interrupted by a signal.
+    while (nanosleep(&ts, &ts) != 0) {
+        if (errno != EINTR) {
+            LT_LOG_ERROR("nanosleep() failed: %s", strerror(errno));
+            return LT_FAIL;
+        }
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_get_time_us(lt_l2_state_t *s2, uint64_t *time_us)
+{
+    LT_UNUSED(s2);
+
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        LT_LOG_ERROR("clock_gettime() failed: %s", strerror(errno));
+        return LT_FAIL;
+    }
+    *time_us = (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+
+    return LT_OK;
+}
+
 lt_ret_t lt_port_random_bytes(lt_l2_state_t *s2, void *buff, size_t count)
 {
     LT_UNUSED(s2);
@@ -222,14 +355,20 @@ lt_ret_t lt_port_spi_csn_high(lt_l2_state_t *s2)
 {
     lt_dev_posix_usb_dongle_t *device = (lt_dev_posix_usb_dongle_t *)s2->device;
 
-    uint8_t cs_high[] = "CS=0\n";  // Yes, CS=0 really means that CSN is low
+    if (device->framing == LT_USB_DONGLE_FRAMING_BINARY) {
+        if (binary_command(device->fd, LT_USB_DONGLE_BIN_CMD_CSN_HIGH, NULL, 0) != 0) {
+            return LT_L1_SPI_ERROR;
+        }
+        return LT_OK;
+    }
+
+    const uint8_t cs_high[] = "CS=0\n";  // Yes, CS=0 really means that CSN is low
     if (write_port(device->fd, cs_high, 5) != 0) {
         return LT_L1_SPI_ERROR;
     }
 
     uint8_t buff[4];
-    int read_bytes = read_port(device->fd, buff, 4);
-    if (read_bytes != 4) {
+    if (read_port(device->fd, buff, 4) != 0) {
         return LT_L1_SPI_ERROR;
     }
 
@@ -249,10 +388,19 @@ lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_dat
         return LT_L1_DATA_LEN_ERROR;
     }
 
+    if (device->framing == LT_USB_DONGLE_FRAMING_BINARY) {
+        if (binary_command(device->fd, LT_USB_DONGLE_BIN_CMD_TRANSFER, s2->buff + offset, tx_data_length) != 0) {
+            return LT_L1_SPI_ERROR;
+        }
+        return LT_OK;
+    }
+
     // Bytes from handle which are about to be sent are encoded as chars and stored to buffered_chars.
-    uint8_t buffered_chars[LT_USB_DONGLE_SPI_TRANSFER_BUFF_SIZE_MAX] = {0};
+    static const char hex_digits[] = "0123456789ABCDEF";
+    uint8_t buffered_chars[LT_USB_DONGLE_SPI_TRANSFER_BUFF_SIZE_MAX];
     for (int i = 0; i < tx_data_length; i++) {
-        sprintf((char *)(buffered_chars + i * 2), "%02" PRIX8, s2->buff[i + offset]);
+        buffered_chars[i * 2] = hex_digits[s2->buff[i + offset] >> 4];
+        buffered_chars[i * 2 + 1] = hex_digits[s2->buff[i + offset] & 0x0f];
     }
 
     // Control characters to keep CS LOW (they are expected by USB dongle, see the top of this file
@@ -265,15 +413,19 @@ lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_dat
         return LT_L1_SPI_ERROR;
     }
 
-    lt_port_delay(s2, LT_USB_DONGLE_READ_WRITE_DELAY);
-
-    int read_bytes = read_port(device->fd, buffered_chars, (2 * tx_data_length) + 2);
-    if (read_bytes != ((2 * tx_data_length) + 2)) {
+    // Received bytes are hex encoded as well, followed by CR LF.
+    if (read_port(device->fd, buffered_chars, (2 * tx_data_length) + 2) != 0) {
         return LT_L1_SPI_ERROR;
     }
 
     for (size_t count = 0; count < tx_data_length; count++) {
-        sscanf((char *)&buffered_chars[count * 2], "%02" SCNx8, &s2->buff[count + offset]);
+        int high = hex_value(buffered_chars[count * 2]);
+        int low = hex_value(buffered_chars[count * 2 + 1]);
+        if (high < 0 || low < 0) {
+            LT_LOG_ERROR("Invalid character received from the dongle.");
+            return LT_L1_SPI_ERROR;
+        }
+        s2->buff[count + offset] = (uint8_t)((high << 4) | low);
     }
 
     return LT_OK;
@@ -15,8 +15,32 @@
 extern "C" {
 #endif
 
-#define LT_USB_DONGLE_READ_WRITE_DELAY 10
-#define LT_USB_DONGLE_SPI_TRANSFER_BUFF_SIZE_MAX ((TR01_L1_LEN_MAX * 2) + 1)
+/** @brief Maximum time to wait for the next byte from the dongle. */
+#define LT_USB_DONGLE_READ_TIMEOUT_MS 100
+#define LT_USB_DONGLE_SPI_TRANSFER_BUFF_SIZE_MAX ((TR01_L1_LEN_MAX * 2) + 2)
+
+/**
+ * @defgroup lt_usb_dongle_binary Binary framing
+ * @brief Each request is a command byte, little endian uint16_t length and `length` MOSI bytes. The dongle answers with
+ * a status byte followed by `length` MISO bytes.
+ * @{
+ */
+/** @brief Transfers the data with CSN driven low, CSN stays low afterwards. */
+#define LT_USB_DONGLE_BIN_CMD_TRANSFER 0x01
+/** @brief Drives CSN high, length is 0. */
+#define LT_USB_DONGLE_BIN_CMD_CSN_HIGH 0x02
+/** @brief Status byte of a successful command. */
+#define LT_USB_DONGLE_BIN_STATUS_OK 0x00
+#define LT_USB_DONGLE_BIN_HEADER_SIZE 3
+/** @} */
+
+/** @brief Framing of the messages exchanged with the dongle. */
+typedef enum lt_usb_dongle_framing_t {
+    /** @brief Hex encoded text lines, supported by all TS1302 firmware versions. */
+    LT_USB_DONGLE_FRAMING_TEXT = 0,
+    /** @brief Binary frames (see @ref lt_usb_dongle_binary), the dongle firmware has to support them. */
+    LT_USB_DONGLE_FRAMING_BINARY
+} lt_usb_dongle_framing_t;
 
 /**
  * @brief Device structure for USB Dongle POSIX port.
@@ -27,8 +51,10 @@ extern "C" {
 typedef struct lt_dev_posix_usb_dongle_t {
     /** @public @brief Path to USB UART device. */
     char dev_path[LT_DEVICE_PATH_MAX_LEN];
-    /** @public @brief UART baudrate. */
+    /** @public @brief UART baudrate, rates other than the standard ones are supported on Linux. */
     uint32_t baud_rate;
+    /** @public @brief Framing of the messages, text by default. */
+    lt_usb_dongle_framing_t framing;
 
     /** @private @brief UART device file descriptor. */
     int fd;
@@ -0,0 +1,38 @@
+/**
+ * @file libtropic_port_posix_usb_dongle_termios2.c
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ * @brief Arbitrary baud rates for the USB UART Dongle port (internal to the port).
+ *
+ * @license For the license see LICENSE.md in the root directory of this source tree.
+ */
+
+#include "libtropic_port_posix_usb_dongle_termios2.h"
+
+#ifdef __linux__
+#include <asm/termbits.h>
+#include <sys/ioctl.h>
+
+int lt_usb_dongle_set_custom_baud_rate(int fd, uint32_t baud_rate)
+{
+    struct termios2 options;
+
+    if (ioctl(fd, TCGETS2, &options) != 0) {
+        return -1;
+    }
+
+    options.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+    options.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+    options.c_ispeed = baud_rate;
+    options.c_ospeed = baud_rate;
+
+    return ioctl(fd, TCSETS2, &options);
+}
+#else
+int lt_usb_dongle_set_custom_baud_rate(int fd, uint32_t baud_rate)
+{
+    (void)fd;
+    (void)baud_rate;
+
+    return -1;
+}
+#endif
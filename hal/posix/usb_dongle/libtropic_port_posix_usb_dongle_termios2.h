@@ -0,0 +1,33 @@
+#ifndef LIBTROPIC_PORT_POSIX_USB_DONGLE_TERMIOS2_H
+#define LIBTROPIC_PORT_POSIX_USB_DONGLE_TERMIOS2_H
+
+/**
+ * @file libtropic_port_posix_usb_dongle_termios2.h
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ * @brief Arbitrary baud rates for the USB UART Dongle port (internal to the port).
+ *
+ * @license For the license see LICENSE.md in the root directory of this source tree.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Sets any baud rate using `termios2` and `BOTHER`. Kept in a separate file, because `<asm/termbits.h>`
+ * cannot be included together with `<termios.h>`.
+ *
+ * @param fd         File descriptor of an already configured serial port
+ * @param baud_rate  Baud rate in bits per second
+ *
+ * @return 0 on success, -1 on error or if not supported on this platform.
+ */
+int lt_usb_dongle_set_custom_baud_rate(int fd, uint32_t baud_rate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBTROPIC_PORT_POSIX_USB_DONGLE_TERMIOS2_H
@@ -67,6 +67,34 @@ lt_ret_t lt_deinit(lt_handle_t *h);
  */
 lt_ret_t lt_get_tr01_mode(lt_handle_t *h, lt_tr01_mode_t *mode);
 
+#ifdef LT_ADAPTIVE_POLLING
+/**
+ * @brief Copies out the processing times learned by the adaptive polling.
+ * @note The model can be stored and passed to lt_set_poll_model() later, e.g. after a restart of the host.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param[out] model  Buffer for `LT_POLL_MODEL_SIZE` entries
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_get_poll_model(const lt_handle_t *h, lt_poll_stat_t *model);
+
+/**
+ * @brief Replaces processing times used by the adaptive polling.
+ * @note Pass `NULL` to forget all learned processing times.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param model       `LT_POLL_MODEL_SIZE` entries previously obtained by lt_get_poll_model(), or `NULL`
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_set_poll_model(lt_handle_t *h, const lt_poll_stat_t *model);
+#endif
+
 /**
  * @brief Read out PKI chain from TROPIC01's Certificate Store
  *
@@ -92,6 +120,53 @@ lt_ret_t lt_get_info_cert_store(lt_handle_t *h, struct lt_cert_store_t *store);
  */
 lt_ret_t lt_get_st_pub(const struct lt_cert_store_t *store, uint8_t *stpub);
 
+/**
+ * @brief Reads ST_Pub from TROPIC01's Certificate Store without reading the whole store
+ *
+ * @details Blocks of the Certificate Store are parsed as they are received and no more blocks are requested once
+ * ST_Pub is complete. No buffers for the certificates are needed. Use lt_get_info_cert_store() and lt_get_st_pub()
+ * if the certificates are needed too.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param stpub       When the function executes successfully, TROPIC01's STPUB of length `TR01_STPUB_LEN` will be
+ * written into this buffer
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_get_info_st_pub(lt_handle_t *h, uint8_t *stpub);
+
+#ifdef LT_ECDSA_P256_VERIFY
+/**
+ * @brief Verifies the chain of TROPIC01's Certificate Store up to the trusted root certificate
+ *
+ * @details The root certificate in the store must be identical to `root_cert`. Then each certificate, from TROPIC01
+ * CA down to the device certificate, must be issued by the next one in the store (issuer matches subject) and signed
+ * by it with ECDSA P-256 and SHA-256. Validity periods and extensions are not checked, as the host may not know the
+ * current time.
+ *
+ * With `cache`, certificates found in it are not verified again, so for a chip whose device certificate was already
+ * seen, only the digests of the certificates are computed, and for a new chip with known intermediate certificates
+ * only the device certificate signature is verified. Newly verified certificates are added to the cache.
+ *
+ * @note Compiled only with LT_ECDSA_P256_VERIFY, needs lt_ecdsa_p256_verify() from the CAL.
+ *
+ * @param h              Handle for communication with TROPIC01 (only its CAL context is used)
+ * @param store          Certificate store, e.g. read by lt_get_info_cert_store()
+ * @param root_cert      Trusted root certificate (DER)
+ * @param root_cert_len  Length of `root_cert`
+ * @param cache          Cache of verified certificates, can be NULL
+ *
+ * @retval            LT_OK The chain is valid
+ * @retval            LT_CERT_CHAIN_INVALID The chain does not lead to the trusted root or a signature is not valid
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_cert_chain_verify(lt_handle_t *h, const struct lt_cert_store_t *store, const uint8_t *root_cert,
+                              const uint16_t root_cert_len, lt_cert_chain_cache_t *cache);
+#endif
+
 //--------------------------------------------------------------------------------------------------------------------//
 /** @brief Maximal size of returned CHIP ID */
 #define TR01_L2_GET_INFO_CHIP_ID_SIZE 128
@@ -187,6 +262,51 @@ lt_ret_t lt_session_start(lt_handle_t *h, const uint8_t *stpub, const lt_pkey_in
  */
 lt_ret_t lt_session_abort(lt_handle_t *h);
 
+/**
+ * @brief Sets pool of pre-generated ephemeral keys used by lt_session_start() and lt_out__session_start().
+ * @details The X25519 key pair which each Secure Session handshake needs is then taken from the pool instead of being
+ * generated before the Handshake_Req is sent. The key pair is removed from the pool and zeroed there, so it is used
+ * only once. When the pool is empty, the key pair is generated as without the pool.
+ *
+ * The pool is owned by the caller and can be shared by several handles. Fill it with lt_eph_key_pool_refill() when
+ * the host is idle. Libtropic does no locking: the pool must not be refilled while a session is being started with it.
+ *
+ * @note lt_init() unsets the pool, so call this function after it.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param pool        Pool of ephemeral keys (zero-initialized when empty), or `NULL` to stop using it
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_eph_key_pool_set(lt_handle_t *h, lt_eph_key_pool_t *pool);
+
+/**
+ * @brief Generates ephemeral key pairs into the pool until it is full or `max_count` pairs are generated.
+ * @note Each key pair costs one X25519 scalar multiplication, so `max_count` bounds the time spent by one call.
+ *
+ * @param h           Handle whose port provides random bytes
+ * @param pool        Pool of ephemeral keys
+ * @param max_count   Maximal number of key pairs to generate
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_eph_key_pool_refill(lt_handle_t *h, lt_eph_key_pool_t *pool, const uint8_t max_count);
+
+/**
+ * @brief Securely zeroes all key pairs left in the pool.
+ *
+ * @param pool        Pool of ephemeral keys
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_eph_key_pool_clear(lt_eph_key_pool_t *pool);
+
 /**
  * @brief Puts TROPIC01 into sleep
  *
@@ -549,6 +669,85 @@ lt_ret_t lt_ecc_key_erase(lt_handle_t *h, const lt_ecc_slot_t ecc_slot);
 lt_ret_t lt_ecc_ecdsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *msg, const uint32_t msg_len,
                            uint8_t *rs);
 
+/**
+ * @brief Performs ECDSA sign of a SHA-256 digest with a private ECC key stored in TROPIC01
+ *
+ * The digest is signed as it is, the message is not needed and nothing is hashed on the host. The signature is the
+ * same as lt_ecc_ecdsa_sign() returns for the message whose digest it is.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param ecc_slot    Slot containing a private key, TR01_ECC_SLOT_0 - TR01_ECC_SLOT_31
+ * @param digest      SHA-256 digest of the message (TR01_ECDSA_SIGN_DIGEST_LENGTH)
+ * @param rs          Buffer for storing a signature in a form of R and S bytes (should always have length 64B)
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_ecc_ecdsa_sign_digest(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *digest, uint8_t *rs);
+
+/**
+ * @brief Starts ECDSA sign of a message which is passed in chunks by lt_ecc_ecdsa_sign_update()
+ *
+ * The message is hashed with SHA-256 on the host as it is passed, only its digest is sent to TROPIC01 by
+ * lt_ecc_ecdsa_sign_final(), so the message does not need to be in memory as a whole.
+ *
+ * @note The SHA-256 context of the CAL is used until lt_ecc_ecdsa_sign_final() or lt_ecc_ecdsa_sign_abort(). Until
+ * then, lt_ecc_ecdsa_sign(), starting a Secure Session and lt_cert_chain_verify() return LT_SHA256_BUSY. Other L3
+ * Commands can be executed meanwhile.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param ecc_slot    Slot containing a private key, TR01_ECC_SLOT_0 - TR01_ECC_SLOT_31
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_SHA256_BUSY Another message is being hashed
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_ecc_ecdsa_sign_init(lt_handle_t *h, const lt_ecc_slot_t ecc_slot);
+
+/**
+ * @brief Hashes the next chunk of the message started by lt_ecc_ecdsa_sign_init()
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param chunk       Chunk of the message
+ * @param chunk_len   Length of the chunk, can be 0
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_PARAM_ERR No message is being hashed
+ * @retval            other Hashing failed and was aborted, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_ecc_ecdsa_sign_update(lt_handle_t *h, const uint8_t *chunk, const uint32_t chunk_len);
+
+/**
+ * @brief Signs the digest of the message passed by lt_ecc_ecdsa_sign_update() with ECDSA_Sign
+ *
+ * The signature is the same as lt_ecc_ecdsa_sign() returns for the whole message. The hashing ends even if the
+ * function fails.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param rs          Buffer for storing a signature in a form of R and S bytes (should always have length 64B)
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_ecc_ecdsa_sign_final(lt_handle_t *h, uint8_t *rs);
+
+/**
+ * @brief Aborts hashing of the message started by lt_ecc_ecdsa_sign_init() and releases the SHA-256 context
+ *
+ * @note Called by lt_deinit(). Does nothing if no message is being hashed.
+ *
+ * @param h           Handle for communication with TROPIC01
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_ecc_ecdsa_sign_abort(lt_handle_t *h);
+
 /**
  * @brief Performs EdDSA sign of a message with a private ECC key stored in TROPIC01
  *
@@ -565,6 +764,105 @@ lt_ret_t lt_ecc_ecdsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const u
 lt_ret_t lt_ecc_eddsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *msg, const uint16_t msg_len,
                            uint8_t *rs);
 
+/**
+ * @brief Sets up an empty batch of messages to be signed with one signature
+ *
+ * @param batch       Batch to set up
+ * @param nodes       Storage for the Merkle tree, must have LT_MERKLE_BATCH_NODES(max_count) nodes
+ * @param max_count   Maximal number of messages in the batch, 1 - LT_MERKLE_BATCH_MAX_COUNT
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_PARAM_ERR Invalid parameters
+ */
+lt_ret_t lt_merkle_batch_init(lt_merkle_batch_t *batch, uint8_t (*nodes)[LT_MERKLE_NODE_LEN], const uint16_t max_count);
+
+/**
+ * @brief Hashes a message into the next leaf of the batch
+ *
+ * @details The leaf is SHA-256(0x00 || message), as in Certificate Transparency (RFC 6962), so a leaf can never be
+ * taken for an inner node. The message is not needed once it is added.
+ *
+ * @param h           Handle for communication with TROPIC01, only its CAL context is used
+ * @param batch       Batch which is not signed yet
+ * @param msg         Message
+ * @param msg_len     Length of the message
+ * @param index       Set to the index of the message in the batch, can be NULL
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_PARAM_ERR Invalid parameters, the batch is full or already signed
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_merkle_batch_add(lt_handle_t *h, lt_merkle_batch_t *batch, const uint8_t *msg, const uint32_t msg_len,
+                             uint16_t *index);
+
+/**
+ * @brief Builds the Merkle tree of the batch and signs its root with a key stored in TROPIC01
+ *
+ * @details Inner nodes are SHA-256(0x01 || left || right), a node without a sibling is moved to the upper level
+ * unchanged, so the root equals the Merkle Tree Hash of RFC 6962. The whole batch costs one L3 Command which signs
+ * SHA-256(LT_MERKLE_ROOT_TAG || count || root), with the number of messages as 2B big-endian: with
+ * lt_ecc_ecdsa_sign_digest() for a P-256 key and with lt_ecc_eddsa_sign() as a 32B message for an Ed25519 key. The
+ * bare root is never signed, so a signature of any other message cannot pass as a signature of a batch. The signature
+ * of each message is then given by lt_merkle_batch_proof().
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param batch       Batch with at least one message
+ * @param ecc_slot    Slot containing a private key, TR01_ECC_SLOT_0 - TR01_ECC_SLOT_31
+ * @param curve       Curve of the key in the slot
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_merkle_batch_sign(lt_handle_t *h, lt_merkle_batch_t *batch, const lt_ecc_slot_t ecc_slot,
+                              const lt_ecc_curve_type_t curve);
+
+/**
+ * @brief Creates proof that a message is included in the signed batch
+ *
+ * @param batch       Signed batch
+ * @param index       Index of the message in the batch
+ * @param proof       Proof with the path to the root, the root and its signature
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_PARAM_ERR Invalid parameters or the batch is not signed
+ */
+lt_ret_t lt_merkle_batch_proof(const lt_merkle_batch_t *batch, const uint16_t index, lt_merkle_proof_t *proof);
+
+/**
+ * @brief Empties the batch, so new messages can be added
+ *
+ * @param batch       Batch
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_PARAM_ERR Invalid parameters
+ */
+lt_ret_t lt_merkle_batch_reset(lt_merkle_batch_t *batch);
+
+/**
+ * @brief Verifies that a message is included in the signed root of the proof and optionally the root signature
+ *
+ * @note Does not communicate with TROPIC01. Verification of the signature needs LT_ECDSA_P256_VERIFY (otherwise
+ * LT_NOT_SUPPORTED is returned when `pubkey` is given) and is supported for P-256 keys only; signature of an Ed25519 key has to be verified by the caller over the digest
+ * described at lt_merkle_batch_sign().
+ *
+ * @param h           Handle, only its CAL context is used
+ * @param msg         Message
+ * @param msg_len     Length of the message
+ * @param proof       Proof created by lt_merkle_batch_proof()
+ * @param pubkey      Public key of the signing key as read by lt_ecc_key_read() (TR01_CURVE_P256_PUBKEY_LEN), or NULL
+ * to verify only the inclusion
+ *
+ * @retval            LT_OK The message is included in the root and the signature is valid
+ * @retval            LT_MERKLE_PROOF_INVALID The message is not included in the root or the signature is not valid
+ * @retval            LT_NOT_SUPPORTED Signature of the curve cannot be verified
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_merkle_proof_verify(lt_handle_t *h, const uint8_t *msg, const uint32_t msg_len,
+                                const lt_merkle_proof_t *proof, const uint8_t *pubkey);
+
 /**
  * @brief Initializes monotonic counter of a given index
  *
@@ -728,6 +1026,54 @@ lt_ret_t lt_write_whole_I_config(lt_handle_t *h, const struct lt_config_t *confi
 lt_ret_t lt_verify_chip_and_start_secure_session(lt_handle_t *h, const uint8_t *shipriv, const uint8_t *shipub,
                                                  const lt_pkey_index_t pkey_index);
 
+/**
+ * @brief Reads identity of TROPIC01 (serial number, FW versions, certificate store and STPub) into a record, which
+ * can be stored by the host and passed to lt_verify_chip_and_start_secure_session_cached() later.
+ *
+ * @note Storing the record (file, mmap, flash, ...) is up to the caller, the record is plain data of a fixed size.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param identity    Record to fill, left invalid if the function fails
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_chip_identity_read(lt_handle_t *h, lt_chip_identity_t *identity);
+
+/**
+ * @brief Same as lt_verify_chip_and_start_secure_session(), but takes STPub from the cached chip identity.
+ *
+ * Only the chip ID is read from the chip and its serial number is compared with the one in the record. If they match
+ * and the record is valid, the Secure Session is started with the cached STPub right away. Otherwise, the record is
+ * read again from the chip with lt_chip_identity_read() and `identity_updated` is set, so the caller knows it has to
+ * store the record again.
+ *
+ * The handshake itself proves that TROPIC01 owns the private key to the cached STPub. If it fails with LT_CRYPTO_ERR
+ * while using a cached record (e.g. the chip was re-provisioned with the same serial number), the record is
+ * invalidated and read again from the chip, `identity_updated` is set and the handshake is retried once if STPub
+ * changed.
+ *
+ * @warning FW versions in the record are the ones read when the record was filled. While the serial number matches,
+ * they are not read again, so they are stale after a FW update. Call lt_chip_identity_read() after updating the FW,
+ * or read the versions from the chip when they matter. Same as lt_verify_chip_and_start_secure_session(), the
+ * certificate chain is not verified.
+ *
+ * @param h                 Handle for communication with TROPIC01
+ * @param shipriv           Host's private pairing key for the slot `pkey_index`
+ * @param shipub            Host's public pairing key for the slot `pkey_index`
+ * @param pkey_index        Pairing key index
+ * @param identity          Cached chip identity (may be zeroed or invalid, it is read from the chip then)
+ * @param identity_updated  Set to true if `identity` was read from the chip again
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_verify_chip_and_start_secure_session_cached(lt_handle_t *h, const uint8_t *shipriv, const uint8_t *shipub,
+                                                        const lt_pkey_index_t pkey_index,
+                                                        lt_chip_identity_t *identity, bool *identity_updated);
+
 /**
  * @brief Prints bytes in hex format to the given output buffer.
  *
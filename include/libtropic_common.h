@@ -205,16 +205,67 @@ typedef enum lt_tr01_mode_t {
 } lt_tr01_mode_t;
 
 //--------------------------------------------------------------------------------------------------------------------//
+/** @brief Poll key identifying an L2 Request, see lt_poll_stat_t. */
+#define LT_POLL_KEY_L2(req_id) ((uint16_t)(0x0100u | (uint8_t)(req_id)))
+/** @brief Poll key identifying an L3 Command, see lt_poll_stat_t. */
+#define LT_POLL_KEY_L3(cmd_id) ((uint16_t)(0x0200u | (uint8_t)(cmd_id)))
+
+#ifdef LT_ADAPTIVE_POLLING
+/** @brief Number of L2 Requests and L3 Commands whose processing time is learned by the adaptive polling. */
+#ifndef LT_POLL_MODEL_SIZE
+#define LT_POLL_MODEL_SIZE 16
+#endif
+
+/**
+ * @brief Learned processing time of one L2 Request or L3 Command.
+ *
+ * @note Entries are plain data, so the whole model can be stored and restored later (see lt_get_poll_model() and
+ *       lt_set_poll_model()).
+ */
+typedef struct lt_poll_stat_t {
+    /** @brief LT_POLL_KEY_L2() or LT_POLL_KEY_L3() of the tracked request, 0 for an unused entry. */
+    uint16_t key;
+    /** @brief Number of measured responses (saturates at UINT16_MAX). */
+    uint16_t samples;
+    /** @brief Smoothed time until the response was ready [us]. */
+    uint32_t mean_us;
+    /** @brief Smoothed mean deviation of the time until the response was ready [us]. */
+    uint32_t dev_us;
+} lt_poll_stat_t;
+#endif
+
 typedef struct lt_l2_state_t {
     void *device;
     uint8_t buff[TR01_L1_CHIP_STATUS_SIZE + TR01_L2_MAX_FRAME_SIZE];
     bool startup_req_sent;
+    uint16_t rsp_crc;   // CRC16 of the last response, computed by lt_l1_read() while the frame is being received.
+    uint16_t poll_key;  // LT_POLL_KEY_L2()/LT_POLL_KEY_L3() of the request whose response is read next, 0 if unknown.
+    // L3 state whose L3 Command is encrypted chunk by chunk while lt_l2_send_encrypted_cmd() sends it, NULL if the
+    // L3 Command was already encrypted as a whole.
+    struct lt_l3_state_t *pending_encryption;
+    // L3 state whose L3 Result is decrypted chunk by chunk while lt_l2_recv_encrypted_res() receives it into its L3
+    // buffer, NULL if the L3 Result is only received and lt_l3_decrypt_response() decrypts it as a whole.
+    struct lt_l3_state_t *res_decryption;
+#ifdef LT_ADAPTIVE_POLLING
+    lt_poll_stat_t poll_model[LT_POLL_MODEL_SIZE];
+#endif
 } lt_l2_state_t;
 
+/**
+ * @brief Size of the L3 buffer with LT_L3_STREAMING.
+ * @details The largest L3 packet which is never streamed is the Random_Value_Get Result (2 B RES_SIZE, 259 B
+ * ciphertext and 16 B tag). It is larger than one L2 chunk, so each streamed chunk fits into the buffer too.
+ */
+#define LT_L3_STREAMING_BUFF_SIZE 277u
+
 // #define LT_SIZE_OF_L3_BUFF (1000)
 #ifndef LT_SIZE_OF_L3_BUFF
+#if LT_L3_STREAMING
+#define LT_SIZE_OF_L3_BUFF LT_L3_STREAMING_BUFF_SIZE
+#else
 #define LT_SIZE_OF_L3_BUFF TR01_L3_PACKET_MAX_SIZE
 #endif
+#endif
 
 /**
  * @brief Used to indicate whether the Secure Session is on or off.
@@ -225,8 +276,20 @@ typedef enum lt_secure_session_status_t {
     LT_SECURE_SESSION_OFF = 0
 } lt_secure_session_status_t;
 
+/**
+ * @brief Progress of decrypting L3 Result chunk by chunk while it is received.
+ *
+ */
+typedef enum lt_l3_res_decryption_t {
+    LT_L3_RES_DECRYPTION_NONE = 0,  /**< Nothing received yet, or decrypted as a whole by lt_l3_decrypt_response(). */
+    LT_L3_RES_DECRYPTION_STARTED,   /**< Part of the ciphertext was decrypted in place, the tag is not verified yet. */
+    LT_L3_RES_DECRYPTION_SKIPPED,   /**< Not decrypted while received, lt_l3_decrypt_response() decrypts it. */
+    LT_L3_RES_DECRYPTION_DONE       /**< Decrypted in place and the tag verified. */
+} lt_l3_res_decryption_t;
+
 typedef struct lt_l3_state_t {
     enum lt_secure_session_status_t session_status;
+    lt_l3_res_decryption_t res_decryption_status; /**< Progress of decrypting the L3 Result in the buffer */
     uint8_t encryption_IV[TR01_L3_IV_SIZE];
     uint8_t decryption_IV[TR01_L3_IV_SIZE];
     void *crypto_ctx;
@@ -238,6 +301,22 @@ typedef struct lt_l3_state_t {
     uint8_t buff[LT_SIZE_OF_L3_BUFF] __attribute__((aligned(16)));
 #endif
     uint16_t buff_len; /**< Length of the buffer */
+    bool cmd_reserved; /**< L3 Command was reserved by an 'lt_out__*_reserve' function and waits for lt_out__commit() */
+    /** Pool of pre-generated ephemeral keys used by lt_out__session_start(), NULL if none is set */
+    struct lt_eph_key_pool_t *eph_key_pool;
+    /** Message of ECDSA signature is being hashed in the SHA-256 context, see lt_ecc_ecdsa_sign_init() */
+    bool ecdsa_sign_hashing;
+    uint8_t ecdsa_sign_slot; /**< ECC slot of the signature whose message is being hashed */
+#if LT_L3_STREAMING
+    /** Payload at the end of the L3 Command which is sent from the caller's buffer, NULL if it is in `buff` */
+    const uint8_t *cmd_payload;
+    uint16_t cmd_payload_offset; /**< Offset of `cmd_payload` in the L3 packet */
+    /** Caller's buffer for the payload at the end of the L3 Result, NULL if it is received into `buff` */
+    uint8_t *res_payload;
+    uint16_t res_payload_offset;  /**< Offset of the payload in the L3 packet, 0 if the L3 Result has none */
+    uint16_t res_payload_max_len; /**< Size of `res_payload` */
+    uint16_t res_payload_len;     /**< Length of the payload of the received L3 Result */
+#endif
 } lt_l3_state_t;
 
 /** @brief Length of key used by AES256. */
@@ -392,9 +471,19 @@ typedef enum lt_ret_t {
     LT_CERT_ITEM_NOT_FOUND = 45,
     /** @brief The nonce has reached its maximum value. */
     LT_NONCE_OVERFLOW = 46,
+    /** @brief Optional function is not implemented by the port or the CAL. */
+    LT_NOT_SUPPORTED = 47,
+    /** @brief Certificate chain does not lead to the trusted root or a certificate signature is not valid. */
+    LT_CERT_CHAIN_INVALID = 48,
+    /** @brief SHA-256 context of the CAL is hashing a message started by lt_ecc_ecdsa_sign_init(). */
+    LT_SHA256_BUSY = 49,
+    /** @brief Message is not included in the signed Merkle root, or the signature of the root is not valid. */
+    LT_MERKLE_PROOF_INVALID = 50,
+    /** @brief All slots of `lt_l3_queue_t` are taken, lt_l3_queue_poll() has to take a result first. */
+    LT_L3_QUEUE_FULL = 51,
 
     /** @brief Special helper value used to signalize the last enum value, used in lt_ret_verbose. */
-    LT_RET_T_LAST_VALUE = 47
+    LT_RET_T_LAST_VALUE = 52
 } lt_ret_t;
 
 #define LT_TR01_REBOOT_DELAY_MS 250
@@ -718,6 +807,60 @@ typedef struct lt_host_eph_keys_t {
     uint8_t ehpub[32];  /**< Host MCU ephemeral public key. */
 } lt_host_eph_keys_t;
 
+/** @brief Number of ephemeral key pairs held by `lt_eph_key_pool_t`. */
+#ifndef LT_EPH_KEY_POOL_SIZE
+#define LT_EPH_KEY_POOL_SIZE 4
+#endif
+
+/**
+ * @brief Pool of Host MCU ephemeral keys generated ahead of the Secure Session handshake.
+ * @details Each key pair is used only once and zeroed as soon as it is taken. See lt_eph_key_pool_set().
+ */
+typedef struct lt_eph_key_pool_t {
+    lt_host_eph_keys_t keys[LT_EPH_KEY_POOL_SIZE]; /**< Ready key pairs, the first `count` entries are valid. */
+    uint8_t count;                                 /**< Number of ready key pairs. */
+} lt_eph_key_pool_t;
+
+/** @brief Number of L3 Commands held by `lt_l3_queue_t`. */
+#ifndef LT_L3_QUEUE_SIZE
+#define LT_L3_QUEUE_SIZE 8
+#endif
+
+/**
+ * @brief Step of an L3 Command submitted to `lt_l3_queue_t`.
+ * @details Called with the `ctx` given to lt_l3_queue_submit(). The `out` step calls one of the 'lt_out__' functions
+ * (or a 'lt_out__*_reserve' function and lt_out__commit()), the `in` step the matching 'lt_in__' function.
+ */
+typedef lt_ret_t (*lt_l3_queue_step_t)(lt_handle_t *h, void *ctx);
+
+/** @brief L3 Command submitted to `lt_l3_queue_t`. */
+typedef struct lt_l3_queue_cmd_t {
+    lt_l3_queue_step_t out; /**< Prepares the L3 Command in the L3 buffer */
+    lt_l3_queue_step_t in;  /**< Decodes the L3 Result from the L3 buffer */
+    void *ctx;              /**< Caller's data of the L3 Command, passed to `out` and `in` */
+    lt_ret_t ret;           /**< Return code of the L3 Command once it is done */
+} lt_l3_queue_cmd_t;
+
+/**
+ * @brief Queue of L3 Commands executed in order, see lt_l3_queue_submit() and lt_l3_queue_poll().
+ *
+ * @details Commands `[head, head + done)` are done and wait for lt_l3_queue_poll(), the next one is executed by
+ * TROPIC01 if `in_flight` is set. Without LT_L3_STREAMING, the one after it may already be encrypted in `next`.
+ */
+typedef struct lt_l3_queue_t {
+    lt_l3_queue_cmd_t cmds[LT_L3_QUEUE_SIZE]; /**< Ring of submitted L3 Commands */
+    uint8_t head;                             /**< Index of the oldest L3 Command */
+    uint8_t count;                            /**< Number of submitted L3 Commands whose result was not polled */
+    uint8_t done;                             /**< Number of done L3 Commands from `head` on */
+    bool in_flight;                           /**< L3 Command after the done ones was sent, its L3 Result is awaited */
+#if !LT_L3_STREAMING
+    bool next_ready; /**< L3 Command after the one in flight is encrypted in `next`, or failed to be prepared */
+    uint16_t next_poll_key; /**< LT_POLL_KEY_L3() of the L3 Command in `next` */
+    /** Encrypted L3 Command after the one in flight */
+    uint8_t next[LT_SIZE_OF_L3_BUFF] __attribute__((aligned(16)));
+#endif
+} lt_l3_queue_t;
+
 /** @brief Length of key used in X25519 function.
  *
  * ECDH uses X25519 function with Curve25519 -> 32 bytes. See "Variables" section in GLOSSARY in TROPIC01 datasheet.
@@ -751,6 +894,74 @@ typedef struct lt_host_eph_keys_t {
 #define TR01_EHPRIV_LEN TR01_X25519_KEY_LEN
 /** @brief Length of Host MCU ephemeral public key */
 #define TR01_EHPUB_LEN TR01_X25519_KEY_LEN
+
+//--------------------------------------------------------------------------------------------------------------------//
+/** @brief Magic number at the start of `lt_chip_identity_t` ("LTID" when stored on a little endian host). */
+#define LT_CHIP_IDENTITY_MAGIC 0x4449544CUL
+/** @brief Version of the `lt_chip_identity_t` layout, bumped whenever the layout changes. */
+#define LT_CHIP_IDENTITY_VERSION 1
+
+/**
+ * @brief Identity of TROPIC01 cached by the host to speed up the Secure Session bring-up.
+ *
+ * @details The record has a fixed size, contains no pointers and has no padding, so it can be written to a file as it
+ * is and mapped back with mmap() (or kept in flash). Multi-byte fields are in host byte order; a record written on a
+ * host with different endianness is rejected because of the magic number. See lt_chip_identity_read() and
+ * lt_verify_chip_and_start_secure_session_cached().
+ */
+typedef struct lt_chip_identity_t {
+    uint32_t magic;                                       /**< LT_CHIP_IDENTITY_MAGIC */
+    uint16_t version;                                     /**< LT_CHIP_IDENTITY_VERSION */
+    uint16_t crc;                                         /**< CRC16 of all following fields */
+    struct lt_ser_num_t ser_num;                          /**< Serial number, key of the record */
+    uint8_t riscv_fw_ver[TR01_L2_GET_INFO_RISCV_FW_SIZE]; /**< RISC-V FW version at the time of reading, may be stale */
+    uint8_t spect_fw_ver[TR01_L2_GET_INFO_SPECT_FW_SIZE]; /**< SPECT FW version at the time of reading, may be stale */
+    uint8_t stpub[TR01_STPUB_LEN];                        /**< STPub parsed from the device certificate */
+    uint16_t cert_len[LT_NUM_CERTIFICATES];               /**< Lengths of the certificates */
+    /** Certificates from the certificate store, each in its own fixed-size slot. */
+    uint8_t certs[LT_NUM_CERTIFICATES][TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE];
+} lt_chip_identity_t;
+
+// clang-format off
+/** \cond */
+LT_STATIC_ASSERT(
+    ( sizeof(struct lt_chip_identity_t) )
+    ==
+    (
+        LT_MEMBER_SIZE(struct lt_chip_identity_t, magic) +
+        LT_MEMBER_SIZE(struct lt_chip_identity_t, version) +
+        LT_MEMBER_SIZE(struct lt_chip_identity_t, crc) +
+        LT_MEMBER_SIZE(struct lt_chip_identity_t, ser_num) +
+        LT_MEMBER_SIZE(struct lt_chip_identity_t, riscv_fw_ver) +
+        LT_MEMBER_SIZE(struct lt_chip_identity_t, spect_fw_ver) +
+        LT_MEMBER_SIZE(struct lt_chip_identity_t, stpub) +
+        LT_MEMBER_SIZE(struct lt_chip_identity_t, cert_len) +
+        LT_MEMBER_SIZE(struct lt_chip_identity_t, certs)
+    )
+)
+/** \endcond */
+// clang-format on
+
+//--------------------------------------------------------------------------------------------------------------------//
+/** @brief Length of certificate digests (SHA-256) in `lt_cert_chain_cache_t`. */
+#define LT_CERT_CHAIN_DIGEST_LEN 32
+/** @brief Number of verified certificates remembered by `lt_cert_chain_cache_t`. */
+#define LT_CERT_CHAIN_CACHE_SIZE 8
+
+/**
+ * @brief Digests of certificates already verified by lt_cert_chain_verify().
+ *
+ * @details A certificate is remembered once the chain from it up to the trusted root was verified, so later chains
+ * containing it are verified only below it. The cache belongs to one trusted root and is emptied when used with
+ * another one. Zero-initialized cache is empty. Like `lt_chip_identity_t`, it is plain data and can be stored by the
+ * host between runs.
+ */
+typedef struct lt_cert_chain_cache_t {
+    uint8_t root_digest[LT_CERT_CHAIN_DIGEST_LEN];                     /**< Digest of the trusted root */
+    uint8_t digests[LT_CERT_CHAIN_CACHE_SIZE][LT_CERT_CHAIN_DIGEST_LEN]; /**< Digests of verified certificates */
+    uint8_t count;                                                     /**< Number of valid entries in `digests` */
+    uint8_t next;                                                      /**< Entry replaced when the cache is full */
+} lt_cert_chain_cache_t;
 //--------------------------------------------------------------------------------------------------------------------//
 /** @brief Basic sleep mode */
 #define TR01_L2_SLEEP_KIND_SLEEP 0x05
@@ -893,6 +1104,53 @@ typedef enum lt_ecc_key_origin_t { TR01_CURVE_GENERATED = 1, TR01_CURVE_STORED }
 /** @brief Length of the EC signature (RS) for both ECDSA and EDDSA. */
 #define TR01_ECDSA_EDDSA_SIGNATURE_LENGTH 64
 
+/** @brief Length of the SHA-256 digest signed by ECDSA_Sign. */
+#define TR01_ECDSA_SIGN_DIGEST_LENGTH 32
+
+//--------------------------------------------------------------------------------------------------------------------//
+/** @brief Length of a node of the Merkle tree built by lt_merkle_batch_sign() (SHA-256 digest). */
+#define LT_MERKLE_NODE_LEN 32
+/** @brief Domain separation tag of the digest signed by lt_merkle_batch_sign(), hashed without the terminating NUL. */
+#define LT_MERKLE_ROOT_TAG "LT-MERKLE-ROOT"
+/** @brief Maximal number of messages in one `lt_merkle_batch_t`. */
+#define LT_MERKLE_BATCH_MAX_COUNT UINT16_MAX
+/** @brief Maximal number of nodes in the path of `lt_merkle_proof_t`, enough for LT_MERKLE_BATCH_MAX_COUNT messages. */
+#define LT_MERKLE_PATH_MAX_LEN 16
+/** @brief Number of nodes the storage of a batch of at most `max_count` messages must have. */
+#define LT_MERKLE_BATCH_NODES(max_count) (2 * (uint32_t)(max_count) + LT_MERKLE_PATH_MAX_LEN)
+
+/**
+ * @brief Batch of messages signed with one signature of the root of their Merkle tree, see lt_merkle_batch_sign().
+ *
+ * @details Set up by lt_merkle_batch_init() with storage provided by the caller. Messages are hashed into the leaves
+ * as they are added, the upper levels of the tree are built into the rest of the storage when the batch is signed.
+ */
+typedef struct lt_merkle_batch_t {
+    uint8_t (*nodes)[LT_MERKLE_NODE_LEN]; /**< Leaves followed by the upper levels of the tree */
+    uint16_t max_count;                   /**< Maximal number of messages, `nodes` has LT_MERKLE_BATCH_NODES() */
+    uint16_t count;                       /**< Number of added messages */
+    bool is_signed;                       /**< Root is signed, no message can be added until lt_merkle_batch_reset() */
+    lt_ecc_curve_type_t curve;            /**< Curve of the key which signed the root */
+    uint8_t root[LT_MERKLE_NODE_LEN];     /**< Root of the tree */
+    uint8_t root_sig[TR01_ECDSA_EDDSA_SIGNATURE_LENGTH]; /**< Signature of the root, see lt_merkle_batch_sign() */
+} lt_merkle_batch_t;
+
+/**
+ * @brief Proof that a message is included in a signed batch, created by lt_merkle_batch_proof() and verified by
+ * lt_merkle_proof_verify().
+ *
+ * @details Plain data, can be sent to the verifier together with the message.
+ */
+typedef struct lt_merkle_proof_t {
+    uint16_t index;                                       /**< Index of the message in the batch */
+    uint16_t count;                                       /**< Number of messages in the batch */
+    uint8_t path_len;                                     /**< Number of valid nodes in `path` */
+    lt_ecc_curve_type_t curve;                            /**< Curve of the key which signed the root */
+    uint8_t path[LT_MERKLE_PATH_MAX_LEN][LT_MERKLE_NODE_LEN]; /**< Siblings on the path from the leaf to the root */
+    uint8_t root[LT_MERKLE_NODE_LEN];                     /**< Root of the tree */
+    uint8_t root_sig[TR01_ECDSA_EDDSA_SIGNATURE_LENGTH];  /**< Signature of the root, see lt_merkle_batch_sign() */
+} lt_merkle_proof_t;
+
 //--------------------------------------------------------------------------------------------------------------------//
 /** @brief Maximal allowed value of the monotonic counter. */
 #define TR01_MCOUNTER_VALUE_MAX 0xFFFFFFFE
@@ -61,7 +61,8 @@ lt_ret_t lt_l2_receive(lt_l2_state_t *s2);
 /**
  * @brief Sends content of encrypted L3 command's buffer over Layer 2.
  *
- * Data are sent from handle's `l3_buff`.
+ * Data are sent from handle's `l3_buff`. If the L3 Command was left to be encrypted chunk by chunk (see
+ * `lt_l2_state_t.pending_encryption`), each chunk is encrypted in place right before it is sent.
  * @note Use only after secure session was established with `lt_session_start()`.
  *
  * @param s2          Structure holding l2 state
@@ -76,7 +77,9 @@ lt_ret_t lt_l2_send_encrypted_cmd(lt_l2_state_t *s2, uint8_t *buff, uint16_t buf
 /**
  * @brief Receives encrypted L3 response over Layer 2.
  *
- * Data are received into handle's l3_buff.
+ * Data are received into handle's l3_buff. If the CAL can decrypt in parts (see `lt_l2_state_t.res_decryption`), each
+ * chunk is decrypted in place as soon as it is received and the tag is verified with the last one, so
+ * `lt_l3_decrypt_response()` only checks the result.
  * @note Use only after secure session was established with `lt_session_start()`.
  *
  * @param s2          Structure holding l2 state
@@ -11,6 +11,25 @@
  * Sending and receiving data is done through L2 layer, which is not covered by this module and user is expected to call
  * lt_l2_send() at the point when data is ready to be sent to TROPIC01.
  *
+ * When the CAL supports AES-GCM in parts, 'lt_out__' functions only start the encryption of the L3 Command and it is
+ * encrypted chunk by chunk by lt_l2_send_encrypted_cmd() while being sent, so the L3 buffer must be sent by it.
+ *
+ * With LT_L3_STREAMING, the L3 buffer holds only LT_L3_STREAMING_BUFF_SIZE bytes. Messages passed to lt_out__ping(),
+ * lt_out__r_mem_data_write() and lt_out__ecc_eddsa_sign() are then sent right from the caller's buffer (it must stay
+ * valid until lt_l2_send_encrypted_cmd() returns) and lt_l3_res_payload_into() has to be called before
+ * lt_l2_recv_encrypted_res() for Ping and R_Mem_Data_Read, to receive their data right into the caller's buffer. Such
+ * L3 Commands are encrypted and received in parts, so their 'lt_out__' functions return LT_NOT_SUPPORTED without
+ * sending anything if the CAL cannot do that.
+ *
+ * Ping, R_Mem_Data_Write, ECC_Key_Store and EDDSA_Sign can also be built in place: the 'lt_out__*_reserve' function
+ * fills the other fields and returns a pointer to the payload's place in the L3 buffer, the caller writes the payload
+ * there (e.g. reads it from a file) and lt_out__commit() then encrypts the L3 Command instead of the 'lt_out__' function.
+ * The matching 'lt_in__' function decodes the L3 Result as usual.
+ *
+ * Several L3 Commands can be passed to a queue (lt_l3_queue_submit()) as pairs of steps calling the 'lt_out__' and
+ * 'lt_in__' functions. The queue prepares and encrypts the next L3 Command while TROPIC01 executes the previous one and
+ * lt_l3_queue_poll() returns the results in order.
+ *
  * For more information have a look into `libtropic.c`, how separate calls are used in a single call.
  * @{
  */
@@ -64,6 +83,30 @@ lt_ret_t lt_out__session_start(lt_handle_t *h, const lt_pkey_index_t pkey_index,
 lt_ret_t lt_in__session_start(lt_handle_t *h, const uint8_t *stpub, const lt_pkey_index_t pkey_index,
                               const uint8_t *shipriv, const uint8_t *shipub, lt_host_eph_keys_t *host_eph_keys);
 
+/**
+ * @brief Sets the buffer which the payload of the next L3 Result is received into with LT_L3_STREAMING.
+ *
+ * Call it after lt_out__ping() or lt_out__r_mem_data_read() and before lt_l2_recv_encrypted_res(), then pass the same
+ * buffer to lt_in__ping() or lt_in__r_mem_data_read(). The payload is stored only if it might not fit into the L3
+ * buffer, otherwise and without LT_L3_STREAMING the function does nothing.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param buff        Buffer for the payload
+ * @param max_len     Size of the buffer
+ * @return            LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_l3_res_payload_into(lt_handle_t *h, uint8_t *buff, const uint16_t max_len);
+
+/**
+ * @brief Encrypts L3 Command built in the L3 buffer by one of the 'lt_out__*_reserve' functions.
+ * @note Used for separate L3 communication, for more information read info at the top
+ * of this file.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @return            LT_OK if success, LT_PARAM_ERR if no L3 Command was reserved, otherwise returns other error code.
+ */
+lt_ret_t lt_out__commit(lt_handle_t *h);
+
 /**
  * @brief Encodes Ping command payload.
  * @note Used for separate L3 communication, for more information read info at the top
@@ -76,6 +119,19 @@ lt_ret_t lt_in__session_start(lt_handle_t *h, const uint8_t *stpub, const lt_pke
  */
 lt_ret_t lt_out__ping(lt_handle_t *h, const uint8_t *msg_out, const uint16_t msg_len);
 
+/**
+ * @brief Encodes Ping command without its message and reserves place for it in the L3 buffer.
+ * @note Used for separate L3 communication, for more information read info at the top
+ * of this file.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param msg_len     Length of sent message
+ * @param msg_out     Set to the place of the message in the L3 buffer, to be filled before lt_out__commit()
+ * @return            LT_OK if success, LT_L3_BUFFER_TOO_SMALL if the L3 Command does not fit into the L3 buffer,
+ *                    otherwise returns other error code.
+ */
+lt_ret_t lt_out__ping_reserve(lt_handle_t *h, const uint16_t msg_len, uint8_t **msg_out);
+
 /**
  * @brief Decodes Ping result payload.
  * @note Used for separate L3 communication, for more information read info at the top
@@ -275,6 +331,22 @@ lt_ret_t lt_in__i_config_read(lt_handle_t *h, uint32_t *obj);
 lt_ret_t lt_out__r_mem_data_write(lt_handle_t *h, const uint16_t udata_slot, const uint8_t *data,
                                   const uint16_t data_size);
 
+/**
+ * @brief Encodes R_Mem_Data_Write command without its data and reserves place for them in the L3 buffer.
+ * @note Used for separate L3 communication, for more information read info
+ * at the top of this file.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param udata_slot  Memory's slot to be written
+ * @param data_size   Size of data to be written (valid range given by macros `TR01_R_MEM_DATA_SIZE_MIN` and
+ * `TR01_R_MEM_DATA_SIZE_MAX`)
+ * @param data        Set to the place of the data in the L3 buffer, to be filled before lt_out__commit()
+ * @return            LT_OK if success, LT_L3_BUFFER_TOO_SMALL if the L3 Command does not fit into the L3 buffer,
+ *                    otherwise returns other error code.
+ */
+lt_ret_t lt_out__r_mem_data_write_reserve(lt_handle_t *h, const uint16_t udata_slot, const uint16_t data_size,
+                                          uint8_t **data);
+
 /**
  * @brief Decodes R_Mem_Data_Write result payload.
  * @note Used for separate L3 communication, for more information read info
@@ -389,6 +461,20 @@ lt_ret_t lt_in__ecc_key_generate(lt_handle_t *h);
 lt_ret_t lt_out__ecc_key_store(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc_curve_type_t curve,
                                const uint8_t *key);
 
+/**
+ * @brief Encodes ECC_Key_Store command without its key and reserves place for it in the L3 buffer.
+ * @note Used for separate L3 communication, for more information read info at
+ * the top of this file.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param slot        ECC key slot to store key in
+ * @param curve       ECC curve type to use for key storage
+ * @param key         Set to the place of the 32B key in the L3 buffer, to be filled before lt_out__commit()
+ * @return            LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_out__ecc_key_store_reserve(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc_curve_type_t curve,
+                                       uint8_t **key);
+
 /**
  * @brief Decodes ECC_Key_Store result payload.
  * @note Used for separate L3 communication, for more information read info at
@@ -461,6 +547,28 @@ lt_ret_t lt_in__ecc_key_erase(lt_handle_t *h);
  */
 lt_ret_t lt_out__ecc_ecdsa_sign(lt_handle_t *h, const lt_ecc_slot_t slot, const uint8_t *msg, const uint32_t msg_len);
 
+/**
+ * @brief Encodes ECDSA_Sign command payload with a SHA-256 digest computed by the caller.
+ * @note Used for separate L3 communication, for more information read info
+ * at the top of this file. The result is decoded by lt_in__ecc_ecdsa_sign().
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param slot        ECC key slot to use for signing
+ * @param digest      SHA-256 digest of the message to sign (32B)
+ * @return            LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_out__ecc_ecdsa_sign_digest(lt_handle_t *h, const lt_ecc_slot_t slot, const uint8_t *digest);
+
+/**
+ * @brief Encodes ECDSA_Sign command payload with the digest of the message hashed by lt_ecc_ecdsa_sign_update().
+ * @note Used for separate L3 communication, for more information read info
+ * at the top of this file. The hashing started by lt_ecc_ecdsa_sign_init() ends even if the function fails.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @return            LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_out__ecc_ecdsa_sign_final(lt_handle_t *h);
+
 /**
  * @brief Decodes ECDSA_Sign result payload.
  * @note Used for separate L3 communication, for more information read info at
@@ -486,6 +594,21 @@ lt_ret_t lt_in__ecc_ecdsa_sign(lt_handle_t *h, uint8_t *rs);
 lt_ret_t lt_out__ecc_eddsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *msg,
                                 const uint16_t msg_len);
 
+/**
+ * @brief Encodes EDDSA_Sign command without its message and reserves place for it in the L3 buffer.
+ * @note Used for separate L3 communication, for more information read info
+ * at the top of this file.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param ecc_slot    ECC key slot to use for signing
+ * @param msg_len     Length of the message
+ * @param msg         Set to the place of the message in the L3 buffer, to be filled before lt_out__commit()
+ * @return            LT_OK if success, LT_L3_BUFFER_TOO_SMALL if the L3 Command does not fit into the L3 buffer,
+ *                    otherwise returns other error code.
+ */
+lt_ret_t lt_out__ecc_eddsa_sign_reserve(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint16_t msg_len,
+                                        uint8_t **msg);
+
 /**
  * @brief Decodes EDDSA_Sign result payload.
  * @note Used for separate L3 communication, for more information read info at
@@ -589,6 +712,51 @@ lt_ret_t lt_out__mac_and_destroy(lt_handle_t *h, lt_mac_and_destroy_slot_t slot,
  */
 lt_ret_t lt_in__mac_and_destroy(lt_handle_t *h, uint8_t *data_in);
 
+/**
+ * @brief Initializes an empty queue of L3 Commands.
+ *
+ * @param q           Queue to initialize
+ * @return            LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_l3_queue_init(lt_l3_queue_t *q);
+
+/**
+ * @brief Adds an L3 Command to the queue.
+ *
+ * The `out` step calls one of the 'lt_out__' functions (with LT_L3_STREAMING also lt_l3_res_payload_into() if needed),
+ * the `in` step calls the matching 'lt_in__' function. The L3 buffer must not be used by the steps otherwise.
+ *
+ * If no L3 Command is executed by TROPIC01, this one is prepared and sent right away. If one is, this one is prepared
+ * and encrypted aside (without LT_L3_STREAMING) if it is the next to be sent, so it can be sent as soon as the L3
+ * Result of the previous one is received.
+ *
+ * @note No other L3 Command can be used with the handle until all results are taken by lt_l3_queue_poll().
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param q           Queue
+ * @param out         Step preparing the L3 Command
+ * @param in          Step decoding the L3 Result
+ * @param ctx         Caller's data passed to both steps and returned by lt_l3_queue_poll()
+ * @return            LT_OK if submitted (errors of the L3 Command are returned by lt_l3_queue_poll()),
+ *                    LT_L3_QUEUE_FULL if the queue is full, otherwise returns other error code.
+ */
+lt_ret_t lt_l3_queue_submit(lt_handle_t *h, lt_l3_queue_t *q, const lt_l3_queue_step_t out, const lt_l3_queue_step_t in,
+                            void *ctx);
+
+/**
+ * @brief Takes the result of the oldest L3 Command in the queue, waiting for its L3 Result if needed.
+ *
+ * The next L3 Command is sent before returning, so TROPIC01 executes it while the caller handles this result.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param q           Queue
+ * @param ctx         Set to `ctx` of the L3 Command, can be NULL
+ * @param cmd_ret     Set to the return code of the L3 Command: of its `out` step, sending, receiving or `in` step
+ * @return            LT_OK if a result was taken, LT_PARAM_ERR if the queue is empty, otherwise returns other error
+ *                    code.
+ */
+lt_ret_t lt_l3_queue_poll(lt_handle_t *h, lt_l3_queue_t *q, void **ctx, lt_ret_t *cmd_ret);
+
 /** @} */  // end of group_libtropic_l3
 
 #ifdef __cplusplus
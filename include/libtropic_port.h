@@ -5,7 +5,8 @@
  * @defgroup group_port_functions 7. HAL Interface
  * @brief Functions defined for each supported platform.
  * @details Function used by host platform during hardware-specific operations. Check 'hal/' folder to see what is
- * supported. All of these functions have to be impemented by the port for libtropic to work.
+ * supported. All of these functions have to be impemented by the port for libtropic to work, except the ones marked as
+ * optional.
  *
  * @{
  */
@@ -84,6 +85,95 @@ lt_ret_t lt_port_spi_csn_high(lt_l2_state_t *s2);
  */
 lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_len, uint32_t timeout_ms);
 
+/**
+ * @brief Platform defined function for SPI transfer storing received bytes into a buffer given by Libtropic instead of
+ * `s2->buff`, so L2 Response data can be received directly into L3 buffer.
+ * @note Optional, Libtropic provides a weak default which returns LT_NOT_SUPPORTED, Libtropic then uses
+ * lt_port_spi_transfer() and copies the data.
+ *
+ * Called between lt_port_spi_csn_low() and lt_port_spi_csn_high() in place of lt_port_spi_transfer() for bytes
+ * `offset` to `offset + rx_len - 1` of the frame. Transmitted bytes are not significant.
+ *
+ * @param s2          Structure holding l2 state
+ * @param offset      Offset of the received bytes in the frame
+ * @param rx_buff     Buffer for the received bytes
+ * @param rx_len      Number of bytes to receive
+ * @param timeout_ms  Timeout
+ *
+ * @retval            LT_OK            Function executed successfully
+ * @retval            LT_NOT_SUPPORTED Port does not implement it, no bytes were transferred
+ * @retval            LT_FAIL          Function did not execute successully
+ */
+lt_ret_t lt_port_spi_transfer_into(lt_l2_state_t *s2, uint8_t offset, uint8_t *rx_buff, uint16_t rx_len,
+                                   uint32_t timeout_ms);
+
+/**
+ * @brief Direction of a frame transferred by lt_port_frame_xfer().
+ */
+typedef enum lt_port_frame_dir_t {
+    /** @brief Write L2 Request frame. */
+    LT_PORT_FRAME_WRITE = 0,
+    /** @brief Read CHIP_STATUS and L2 Response frame, if there is one. */
+    LT_PORT_FRAME_READ
+} lt_port_frame_dir_t;
+
+/**
+ * @brief Platform defined function transferring a whole frame within one chip select assertion, for transports where
+ * each lt_port_spi_* call costs a round trip.
+ * @note Optional, Libtropic provides a weak default which returns LT_NOT_SUPPORTED, Libtropic then uses
+ * lt_port_spi_csn_low(), lt_port_spi_transfer() and lt_port_spi_csn_high().
+ *
+ * With LT_PORT_FRAME_WRITE, the first `len` bytes of `s2->buff` are transferred and overwritten by the received bytes
+ * (CHIP_STATUS is in `s2->buff[0]`).
+ *
+ * With LT_PORT_FRAME_READ, `s2->buff[0]` contains Get_Response REQ_ID. It is transferred together with the following
+ * bytes and the frame is received into `s2->buff`, while its length is discovered:
+ *  - CHIP_STATUS, if READY bit is not set or ALARM bit is set, the transfer ends,
+ *  - STATUS and RSP_LEN, if STATUS is 0xFF (no response), the transfer ends,
+ *  - RSP_DATA and RSP_CRC (`RSP_LEN + 2` bytes).
+ *
+ * @param s2          Structure holding l2 state
+ * @param dir         Frame direction
+ * @param len         Length of the written frame, or max length of the read frame including CHIP_STATUS
+ * @param timeout_ms  Timeout
+ *
+ * @retval            LT_OK                Function executed successfully
+ * @retval            LT_L1_DATA_LEN_ERROR Read frame would be longer than `len`
+ * @retval            LT_NOT_SUPPORTED     Port does not implement frame transfers
+ * @retval            LT_FAIL              Function did not execute successully
+ */
+lt_ret_t lt_port_frame_xfer(lt_l2_state_t *s2, lt_port_frame_dir_t dir, uint16_t len, uint32_t timeout_ms);
+
+/**
+ * @brief One contiguous part of data transferred by lt_port_spi_transfer_iov().
+ */
+typedef struct lt_port_iov_t {
+    /** @brief Start of the part. */
+    const uint8_t *base;
+    /** @brief Length of the part in bytes. */
+    uint16_t len;
+} lt_port_iov_t;
+
+/**
+ * @brief Platform defined function writing L2 Request frame gathered from several buffers, so Libtropic does not
+ * have to copy the frame into `s2->buff` first.
+ * @note Optional, Libtropic provides a weak default which returns LT_NOT_SUPPORTED, Libtropic then copies the parts
+ * into `s2->buff` and writes the frame as usual.
+ *
+ * The parts are transferred in order, as one frame within one chip select assertion, which the port drives itself.
+ * Received bytes are discarded, `s2->buff` is not touched.
+ *
+ * @param s2          Structure holding l2 state
+ * @param iov         Parts of the frame, their total length is at most TR01_L1_LEN_MAX
+ * @param iov_cnt     Number of parts
+ * @param timeout_ms  Timeout
+ *
+ * @retval            LT_OK            Function executed successfully
+ * @retval            LT_NOT_SUPPORTED Port does not implement gathered transfers
+ * @retval            LT_FAIL          Function did not execute successully
+ */
+lt_ret_t lt_port_spi_transfer_iov(lt_l2_state_t *s2, const lt_port_iov_t *iov, uint8_t iov_cnt, uint32_t timeout_ms);
+
 /**
  * @brief Platform defined function for delay, specifies what host platform should do when libtropic's functions need
  * some delay.
@@ -96,6 +186,28 @@ lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_len
  */
 lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms);
 
+/**
+ * @brief Platform defined function for delay with microsecond resolution.
+ * @note Optional, Libtropic provides a weak default which rounds the delay up to whole milliseconds and calls
+ * lt_port_delay().
+ * @param s2          Structure holding l2 state
+ * @param us          Time to wait in microseconds
+ * @retval            LT_OK   Function executed successfully
+ * @retval            LT_FAIL Function did not execute successully
+ */
+lt_ret_t lt_port_delay_us(lt_l2_state_t *s2, uint32_t us);
+
+/**
+ * @brief Platform defined function returning monotonic time in microseconds.
+ * @note Optional, Libtropic provides a weak default which returns LT_FAIL, Libtropic then estimates the time from the
+ * delays it requested.
+ * @param s2          Structure holding l2 state
+ * @param time_us     Current time in microseconds, counted from an arbitrary point in the past
+ * @retval            LT_OK   Function executed successfully
+ * @retval            LT_FAIL Function did not execute successully or the platform has no monotonic clock
+ */
+lt_ret_t lt_port_get_time_us(lt_l2_state_t *s2, uint64_t *time_us);
+
 #if LT_USE_INT_PIN
 /**
  * @brief Platform defined function used to specify reading of an interrupt pin, used as a signal that chip has a
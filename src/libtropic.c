@@ -22,6 +22,7 @@
 #include "libtropic_macros.h"
 #include "libtropic_port.h"
 #include "lt_asn1_der.h"
+#include "lt_crc16.h"
 #include "lt_crypto_common.h"
 #include "lt_hkdf.h"
 #include "lt_l1.h"
@@ -53,6 +54,12 @@ lt_ret_t lt_init(lt_handle_t *h)
     h->l3.session_status = LT_SECURE_SESSION_OFF;
     ret = lt_l1_init(&h->l2);
     h->l2.startup_req_sent = false;
+    h->l2.pending_encryption = NULL;
+    h->l2.res_decryption = NULL;
+    h->l3.res_decryption_status = LT_L3_RES_DECRYPTION_NONE;
+    h->l3.cmd_reserved = false;
+    h->l3.eph_key_pool = NULL;
+    h->l3.ecdsa_sign_hashing = false;
     if (ret != LT_OK) {
         return ret;
     }
@@ -94,6 +101,10 @@ lt_ret_t lt_deinit(lt_handle_t *h)
 
     lt_l3_invalidate_host_session_data(&h->l3);
 
+    // Release the SHA-256 context if a streamed ECDSA signature was not finished.
+    lt_ret_t ret_unused = lt_ecc_ecdsa_sign_abort(h);
+    LT_UNUSED(ret_unused);
+
     lt_ret_t ret = lt_l1_deinit(&h->l2);
     if (ret != LT_OK) {
         return ret;
@@ -152,6 +163,35 @@ lt_ret_t lt_get_tr01_mode(lt_handle_t *h, lt_tr01_mode_t *mode)
     return LT_L1_CHIP_BUSY;
 }
 
+#ifdef LT_ADAPTIVE_POLLING
+lt_ret_t lt_get_poll_model(const lt_handle_t *h, lt_poll_stat_t *model)
+{
+    if (!h || !model) {
+        return LT_PARAM_ERR;
+    }
+
+    memcpy(model, h->l2.poll_model, sizeof(h->l2.poll_model));
+
+    return LT_OK;
+}
+
+lt_ret_t lt_set_poll_model(lt_handle_t *h, const lt_poll_stat_t *model)
+{
+    if (!h) {
+        return LT_PARAM_ERR;
+    }
+
+    if (model) {
+        memcpy(h->l2.poll_model, model, sizeof(h->l2.poll_model));
+    }
+    else {
+        memset(h->l2.poll_model, 0, sizeof(h->l2.poll_model));
+    }
+
+    return LT_OK;
+}
+#endif
+
 lt_ret_t lt_get_info_cert_store(lt_handle_t *h, struct lt_cert_store_t *store)
 {
     if (!h || !store) {
@@ -266,6 +306,81 @@ lt_ret_t lt_get_st_pub(const struct lt_cert_store_t *store, uint8_t *stpub)
     return asn1der_find_object(head, len, LT_OBJ_ID_CURVEX25519, stpub, TR01_STPUB_LEN, LT_ASN1DER_CROP_PREFIX);
 }
 
+lt_ret_t lt_get_info_st_pub(lt_handle_t *h, uint8_t *stpub)
+{
+    if (!h || !stpub) {
+        return LT_PARAM_ERR;
+    }
+
+    // Setup a request pointer to l2 buffer with request data
+    struct lt_l2_get_info_req_t *p_l2_req = (struct lt_l2_get_info_req_t *)h->l2.buff;
+
+    // Setup a request pointer to l2 buffer with response data
+    struct lt_l2_get_info_rsp_t *p_l2_resp = (struct lt_l2_get_info_rsp_t *)h->l2.buff;
+
+    // Device certificate is the first one in the store, so it is parsed block by block as it comes
+    struct lt_asn1der_stream_t parser = {0};
+    lt_ret_t ret = LT_OK;
+
+    for (int i = 0; i < (TR01_L2_GET_INFO_REQ_CERT_SIZE_TOTAL / TR01_GET_INFO_BLOCK_LEN); i++) {
+        p_l2_req->req_id = TR01_L2_GET_INFO_REQ_ID;
+        p_l2_req->req_len = TR01_L2_GET_INFO_REQ_LEN;
+        p_l2_req->object_id = TR01_L2_GET_INFO_REQ_OBJECT_ID_X509_CERTIFICATE;
+        p_l2_req->block_index = i;
+
+        ret = lt_l2_send(&h->l2);
+        if (ret != LT_OK) {
+            return ret;
+        }
+
+        ret = lt_l2_receive(&h->l2);
+        if (ret != LT_OK) {
+            return ret;
+        }
+
+        if (TR01_GET_INFO_BLOCK_LEN != (p_l2_resp->rsp_len)) {
+            return LT_L2_RSP_LEN_ERROR;
+        }
+
+        uint8_t *head = p_l2_resp->object;
+        uint16_t available = TR01_GET_INFO_BLOCK_LEN;
+
+        // Parse the header - only length of the device certificate is needed
+        if (i == 0) {
+            if (head[0] != LT_CERT_STORE_VERSION || head[1] != LT_NUM_CERTIFICATES) {
+                return LT_CERT_STORE_INVALID;
+            }
+
+            uint16_t device_cert_len = ((uint16_t)head[2] << 8) | head[3];
+            if (device_cert_len > TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE) {
+                return LT_CERT_STORE_INVALID;
+            }
+            asn1der_stream_init(&parser, device_cert_len, LT_OBJ_ID_CURVEX25519, stpub, TR01_STPUB_LEN,
+                                LT_ASN1DER_CROP_PREFIX);
+
+            head += 2 + 2 * LT_NUM_CERTIFICATES;
+            available -= 2 + 2 * LT_NUM_CERTIFICATES;
+        }
+
+        uint16_t to_feed = parser.len - parser.past;
+        if (to_feed > available) {
+            to_feed = available;
+        }
+
+        ret = asn1der_stream_feed(&parser, head, to_feed);
+        if (ret != LT_OK) {
+            return ret;
+        }
+
+        // No more L2 requests once STPub is complete or the device certificate ends
+        if (parser.found || parser.past == parser.len) {
+            break;
+        }
+    }
+
+    return asn1der_stream_finish(&parser);
+}
+
 lt_ret_t lt_get_info_chip_id(lt_handle_t *h, struct lt_chip_id_t *chip_id)
 {
     if (!h || !chip_id) {
@@ -444,6 +559,52 @@ cleanup:
     return ret;
 }
 
+lt_ret_t lt_eph_key_pool_set(lt_handle_t *h, lt_eph_key_pool_t *pool)
+{
+    if (!h || (pool && pool->count > LT_EPH_KEY_POOL_SIZE)) {
+        return LT_PARAM_ERR;
+    }
+
+    h->l3.eph_key_pool = pool;
+
+    return LT_OK;
+}
+
+lt_ret_t lt_eph_key_pool_refill(lt_handle_t *h, lt_eph_key_pool_t *pool, const uint8_t max_count)
+{
+    if (!h || !pool || pool->count > LT_EPH_KEY_POOL_SIZE) {
+        return LT_PARAM_ERR;
+    }
+
+    for (uint8_t i = 0; i < max_count && pool->count < LT_EPH_KEY_POOL_SIZE; i++) {
+        lt_host_eph_keys_t *keys = &pool->keys[pool->count];
+
+        lt_ret_t ret = lt_random_bytes(h, keys->ehpriv, sizeof(keys->ehpriv));
+        if (ret == LT_OK) {
+            ret = lt_X25519_scalarmult(keys->ehpriv, keys->ehpub);
+        }
+        if (ret != LT_OK) {
+            lt_secure_memzero(keys, sizeof(lt_host_eph_keys_t));
+            return ret;
+        }
+
+        pool->count++;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_eph_key_pool_clear(lt_eph_key_pool_t *pool)
+{
+    if (!pool) {
+        return LT_PARAM_ERR;
+    }
+
+    lt_secure_memzero(pool, sizeof(lt_eph_key_pool_t));
+
+    return LT_OK;
+}
+
 lt_ret_t lt_session_abort(lt_handle_t *h)
 {
     if (!h) {
@@ -522,6 +683,10 @@ lt_ret_t lt_reboot(lt_handle_t *h, const lt_startup_id_t startup_id)
     p_l2_req->req_len = TR01_L2_STARTUP_REQ_LEN;
     p_l2_req->startup_id = startup_id;
 
+    // TROPIC01 starts rebooting when it processes the request, so the reboot delay is counted from now.
+    uint64_t start_us;
+    bool start_valid = (lt_l1_get_time_us(&h->l2, &start_us) == LT_OK);
+
     lt_ret_t ret = lt_l2_send(&h->l2);
     h->l2.startup_req_sent = true;
     if (ret != LT_OK) {
@@ -538,7 +703,16 @@ lt_ret_t lt_reboot(lt_handle_t *h, const lt_startup_id_t startup_id)
         return LT_L2_RSP_LEN_ERROR;
     }
 
-    ret = lt_l1_delay(&h->l2, LT_TR01_REBOOT_DELAY_MS);
+    // Wait only for the rest of the reboot delay if the port provides monotonic time.
+    uint64_t now_us;
+    if (start_valid && lt_l1_get_time_us(&h->l2, &now_us) == LT_OK && now_us >= start_us) {
+        uint64_t elapsed_us = now_us - start_us;
+        uint64_t delay_us = (uint64_t)LT_TR01_REBOOT_DELAY_MS * 1000;
+        ret = (elapsed_us < delay_us) ? lt_l1_delay_us(&h->l2, (uint32_t)(delay_us - elapsed_us)) : LT_OK;
+    }
+    else {
+        ret = lt_l1_delay(&h->l2, LT_TR01_REBOOT_DELAY_MS);
+    }
     if (ret != LT_OK) {
         return ret;
     }
@@ -813,6 +987,11 @@ lt_ret_t lt_ping(lt_handle_t *h, const uint8_t *msg_out, uint8_t *msg_in, const
         return ret;
     }
 
+    ret = lt_l3_res_payload_into(h, msg_in, msg_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
         return ret;
@@ -1089,6 +1268,11 @@ lt_ret_t lt_r_mem_data_read(lt_handle_t *h, const uint16_t udata_slot, uint8_t *
         return ret;
     }
 
+    ret = lt_l3_res_payload_into(h, data, data_max_size);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
         return ret;
@@ -1300,6 +1484,115 @@ lt_ret_t lt_ecc_ecdsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const u
     return lt_in__ecc_ecdsa_sign(h, rs);
 }
 
+lt_ret_t lt_ecc_ecdsa_sign_digest(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *digest, uint8_t *rs)
+{
+    if (!h || !digest || !rs || (ecc_slot > TR01_ECC_SLOT_31)) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+
+    lt_ret_t ret = lt_out__ecc_ecdsa_sign_digest(h, ecc_slot, digest);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_ECDSA_SIGN_RES_PACKET_SIZE));
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    return lt_in__ecc_ecdsa_sign(h, rs);
+}
+
+lt_ret_t lt_ecc_ecdsa_sign_init(lt_handle_t *h, const lt_ecc_slot_t ecc_slot)
+{
+    if (!h || (ecc_slot > TR01_ECC_SLOT_31)) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+    if (h->l3.ecdsa_sign_hashing) {
+        return LT_SHA256_BUSY;
+    }
+
+    lt_ret_t ret = lt_sha256_init(h->l3.crypto_ctx);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_sha256_start(h->l3.crypto_ctx);
+    if (ret != LT_OK) {
+        lt_ret_t ret_unused = lt_sha256_deinit(h->l3.crypto_ctx);
+        LT_UNUSED(ret_unused);
+        return ret;
+    }
+
+    h->l3.ecdsa_sign_slot = ecc_slot;
+    h->l3.ecdsa_sign_hashing = true;
+
+    return LT_OK;
+}
+
+lt_ret_t lt_ecc_ecdsa_sign_update(lt_handle_t *h, const uint8_t *chunk, const uint32_t chunk_len)
+{
+    if (!h || (!chunk && chunk_len) || !h->l3.ecdsa_sign_hashing) {
+        return LT_PARAM_ERR;
+    }
+
+    lt_ret_t ret = lt_sha256_update(h->l3.crypto_ctx, chunk, chunk_len);
+    if (ret != LT_OK) {
+        lt_ret_t ret_unused = lt_ecc_ecdsa_sign_abort(h);
+        LT_UNUSED(ret_unused);
+    }
+
+    return ret;
+}
+
+lt_ret_t lt_ecc_ecdsa_sign_final(lt_handle_t *h, uint8_t *rs)
+{
+    if (!h || !rs || !h->l3.ecdsa_sign_hashing) {
+        return LT_PARAM_ERR;
+    }
+
+    lt_ret_t ret = lt_out__ecc_ecdsa_sign_final(h);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_ECDSA_SIGN_RES_PACKET_SIZE));
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    return lt_in__ecc_ecdsa_sign(h, rs);
+}
+
+lt_ret_t lt_ecc_ecdsa_sign_abort(lt_handle_t *h)
+{
+    if (!h) {
+        return LT_PARAM_ERR;
+    }
+    if (!h->l3.ecdsa_sign_hashing) {
+        return LT_OK;
+    }
+
+    h->l3.ecdsa_sign_hashing = false;
+
+    return lt_sha256_deinit(h->l3.crypto_ctx);
+}
+
 lt_ret_t lt_ecc_eddsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *msg, const uint16_t msg_len,
                            uint8_t *rs)
 {
@@ -1483,7 +1776,12 @@ static const char *lt_ret_strs[] = {"LT_OK",
                                     "LT_CERT_STORE_INVALID",
                                     "LT_CERT_UNSUPPORTED",
                                     "LT_CERT_ITEM_NOT_FOUND",
-                                    "LT_NONCE_OVERFLOW"};
+                                    "LT_NONCE_OVERFLOW",
+                                    "LT_NOT_SUPPORTED",
+                                    "LT_CERT_CHAIN_INVALID",
+                                    "LT_SHA256_BUSY",
+                                    "LT_MERKLE_PROOF_INVALID",
+                                    "LT_L3_QUEUE_FULL"};
 
 const char *lt_ret_verbose(lt_ret_t ret)
 {
@@ -1634,36 +1932,149 @@ lt_ret_t lt_verify_chip_and_start_secure_session(lt_handle_t *h, const uint8_t *
         return ret;
     }
 
-    // Read certificate store
-    uint8_t cert_ese[TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE] = {0};
-    uint8_t cert_xxxx[TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE] = {0};
-    uint8_t cert_tr01[TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE] = {0};
-    uint8_t cert_root[TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE] = {0};
+    // Extract STPub, the certificate store is read only until STPub is complete
+    uint8_t stpub[TR01_STPUB_LEN] = {0};
+    ret = lt_get_info_st_pub(h, stpub);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_session_start(h, stpub, pkey_index, shipriv, shipub);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    return LT_OK;
+}
+
+/**
+ * @brief Computes CRC16 of the cached chip identity over all fields following the `crc` field.
+ */
+static uint16_t lt_chip_identity_crc(const lt_chip_identity_t *identity)
+{
+    return crc16_finish(crc16_update(LT_CRC16_INITIAL_VAL, (const uint8_t *)&identity->ser_num,
+                                     sizeof(lt_chip_identity_t) - offsetof(lt_chip_identity_t, ser_num)));
+}
+
+/**
+ * @brief Checks that the cached chip identity is a complete record in the current layout.
+ */
+static bool lt_chip_identity_valid(const lt_chip_identity_t *identity)
+{
+    return (identity->magic == LT_CHIP_IDENTITY_MAGIC) && (identity->version == LT_CHIP_IDENTITY_VERSION)
+           && (identity->crc == lt_chip_identity_crc(identity));
+}
+
+/**
+ * @brief Reads the rest of the chip identity, once the chip ID is already known.
+ *
+ * @details The record is zeroed first and sealed with magic number and CRC only when all reads succeed, so it is never
+ * left valid with partial contents.
+ */
+static lt_ret_t lt_chip_identity_fill(lt_handle_t *h, const struct lt_chip_id_t *chip_id,
+                                      lt_chip_identity_t *identity)
+{
+    memset(identity, 0, sizeof(lt_chip_identity_t));
+    memcpy(&identity->ser_num, &chip_id->ser_num, sizeof(struct lt_ser_num_t));
+
+    lt_ret_t ret = lt_get_info_riscv_fw_ver(h, identity->riscv_fw_ver);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_get_info_spect_fw_ver(h, identity->spect_fw_ver);
+    if (ret != LT_OK) {
+        return ret;
+    }
 
     struct lt_cert_store_t cert_store
         = {.cert_len = {0, 0, 0, 0},
            .buf_len = {TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE, TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE,
                        TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE, TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE},
-           .certs = {cert_ese, cert_xxxx, cert_tr01, cert_root}};
+           .certs = {identity->certs[LT_CERT_KIND_DEVICE], identity->certs[LT_CERT_KIND_XXXX],
+                     identity->certs[LT_CERT_KIND_TROPIC01], identity->certs[LT_CERT_KIND_TROPIC_ROOT]}};
 
     ret = lt_get_info_cert_store(h, &cert_store);
     if (ret != LT_OK) {
         return ret;
     }
+    memcpy(identity->cert_len, cert_store.cert_len, sizeof(identity->cert_len));
 
-    // Extract STPub
-    uint8_t stpub[TR01_STPUB_LEN] = {0};
-    ret = lt_get_st_pub(&cert_store, stpub);
+    ret = lt_get_st_pub(&cert_store, identity->stpub);
     if (ret != LT_OK) {
         return ret;
     }
 
-    ret = lt_session_start(h, stpub, pkey_index, shipriv, shipub);
+    identity->magic = LT_CHIP_IDENTITY_MAGIC;
+    identity->version = LT_CHIP_IDENTITY_VERSION;
+    identity->crc = lt_chip_identity_crc(identity);
+
+    return LT_OK;
+}
+
+lt_ret_t lt_chip_identity_read(lt_handle_t *h, lt_chip_identity_t *identity)
+{
+    if (!h || !identity) {
+        return LT_PARAM_ERR;
+    }
+
+    struct lt_chip_id_t chip_id = {0};
+    lt_ret_t ret = lt_get_info_chip_id(h, &chip_id);
     if (ret != LT_OK) {
         return ret;
     }
 
-    return LT_OK;
+    return lt_chip_identity_fill(h, &chip_id, identity);
+}
+
+lt_ret_t lt_verify_chip_and_start_secure_session_cached(lt_handle_t *h, const uint8_t *shipriv, const uint8_t *shipub,
+                                                        const lt_pkey_index_t pkey_index,
+                                                        lt_chip_identity_t *identity, bool *identity_updated)
+{
+    if (!h || !shipriv || !shipub || (pkey_index > TR01_PAIRING_KEY_SLOT_INDEX_3) || !identity || !identity_updated) {
+        return LT_PARAM_ERR;
+    }
+
+    *identity_updated = false;
+
+    // The chip ID is a single Get_Info block, so it is always read to check that the record belongs to this chip
+    struct lt_chip_id_t chip_id = {0};
+    lt_ret_t ret = lt_get_info_chip_id(h, &chip_id);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    if (!lt_chip_identity_valid(identity)
+        || memcmp(&identity->ser_num, &chip_id.ser_num, sizeof(struct lt_ser_num_t)) != 0) {
+        ret = lt_chip_identity_fill(h, &chip_id, identity);
+        if (ret != LT_OK) {
+            return ret;
+        }
+        *identity_updated = true;
+    }
+
+    // The handshake succeeds only if the chip owns the private key to the cached STPub
+    ret = lt_session_start(h, identity->stpub, pkey_index, shipriv, shipub);
+    if (ret != LT_CRYPTO_ERR || *identity_updated) {
+        return ret;
+    }
+
+    // Authentication tag of the handshake did not match, the cached STPub may be stale (e.g. chip re-provisioned
+    // with the same serial number). The record is read again and the handshake is retried once if STPub changed.
+    uint8_t cached_stpub[TR01_STPUB_LEN];
+    memcpy(cached_stpub, identity->stpub, TR01_STPUB_LEN);
+
+    lt_ret_t ret_fill = lt_chip_identity_fill(h, &chip_id, identity);
+    if (ret_fill != LT_OK) {
+        return ret_fill;
+    }
+    *identity_updated = true;
+
+    if (memcmp(cached_stpub, identity->stpub, TR01_STPUB_LEN) == 0) {
+        return ret;
+    }
+
+    return lt_session_start(h, identity->stpub, pkey_index, shipriv, shipub);
 }
 
 lt_ret_t lt_print_bytes(const uint8_t *bytes, const size_t bytes_cnt, char *out_buf, const size_t out_buf_size)
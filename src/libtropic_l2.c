@@ -17,6 +17,7 @@
 #include "lt_l1.h"
 #include "lt_l2_api_structs.h"
 #include "lt_l2_frame_check.h"
+#include "lt_l3_process.h"
 
 /** Safety number - limit number of loops during l3 chunks reception. TROPIC01 divides data into 128B
  *  chunks, length of L3 buffer is (2 + 4096 + 16).
@@ -32,6 +33,7 @@ lt_ret_t lt_l2_send(lt_l2_state_t *s2)
     }
 
     add_crc(s2->buff);
+    s2->poll_key = LT_POLL_KEY_L2(s2->buff[TR01_L2_REQ_ID_OFFSET]);
 
     uint8_t len = s2->buff[1];
 
@@ -55,7 +57,7 @@ lt_ret_t lt_l2_resend_response(lt_l2_state_t *s2)
         return ret;
     }
 
-    return lt_l2_frame_check(s2->buff);
+    return lt_l2_frame_check(s2);
 }
 
 lt_ret_t lt_l2_receive(lt_l2_state_t *s2)
@@ -78,7 +80,7 @@ lt_ret_t lt_l2_receive(lt_l2_state_t *s2)
         return LT_OK;
     }
 
-    ret = lt_l2_frame_check(s2->buff);
+    ret = lt_l2_frame_check(s2);
 
     if ((ret == LT_L2_CRC_ERR) || (ret == LT_L2_GEN_ERR)) {
         // There was an error when checking received data.
@@ -96,12 +98,129 @@ lt_ret_t lt_l2_receive(lt_l2_state_t *s2)
     return ret;
 }
 
+#if LT_L3_STREAMING
+/**
+ * @brief Sends L3 Command whose payload is left in the caller's buffer (LT_L3_STREAMING).
+ *
+ * Each chunk is gathered and encrypted right in the L1 buffer, so it is encrypted only after the previous one was
+ * acknowledged.
+ *
+ * @param s2          Structure holding l2 state
+ * @param s3          L3 state whose L3 Command is sent
+ * @param packet_size Size of the L3 packet
+ * @return            LT_OK if success, otherwise returns other error code.
+ */
+static lt_ret_t lt_l2_send_streamed_cmd(lt_l2_state_t *s2, lt_l3_state_t *s3, const uint16_t packet_size)
+{
+    struct lt_l2_encrypted_cmd_req_t *req = (struct lt_l2_encrypted_cmd_req_t *)s2->buff;
+
+    // Chunks are acknowledged right away, polling according to the L3 Command is used only for its L3 Result.
+    uint16_t poll_key = s2->poll_key;
+    s2->poll_key = 0;
+
+    lt_ret_t ret = LT_OK;
+    for (uint16_t offset = 0; offset < packet_size;) {
+        uint16_t chunk_len = packet_size - offset;
+        if (chunk_len > TR01_L2_CHUNK_MAX_DATA_SIZE) {
+            chunk_len = TR01_L2_CHUNK_MAX_DATA_SIZE;
+        }
+
+        req->req_id = TR01_L2_ENCRYPTED_CMD_REQ_ID;
+        req->req_len = (uint8_t)chunk_len;
+        ret = lt_l3_encrypt_request_chunk(s3, req->l3_chunk, offset, chunk_len);
+        if (ret != LT_OK) {
+            goto cleanup;
+        }
+        add_crc(req);
+        offset += chunk_len;
+
+        ret = lt_l1_write(s2, TR01_L2_REQ_ID_SIZE + TR01_L2_REQ_RSP_LEN_SIZE + chunk_len + TR01_L2_REQ_RSP_CRC_SIZE,
+                          LT_L1_TIMEOUT_MS_DEFAULT);
+        if (ret != LT_OK) {
+            goto cleanup;
+        }
+
+        ret = lt_l1_read(s2, TR01_L1_LEN_MAX, LT_L1_TIMEOUT_MS_DEFAULT);
+        if (ret != LT_OK) {
+            goto cleanup;
+        }
+
+        ret = lt_l2_frame_check(s2);
+        if (ret != LT_OK && ret != LT_L2_REQ_CONT) {
+            goto cleanup;
+        }
+    }
+    ret = LT_OK;
+
+cleanup:
+    s2->poll_key = poll_key;
+
+    return ret;
+}
+
+/**
+ * @brief Receives L3 Result whose payload goes to the caller's buffer (LT_L3_STREAMING).
+ *
+ * Each chunk is left in the L1 buffer, decrypted there and scattered into the L3 buffer and the caller's buffer.
+ *
+ * @param s2          Structure holding l2 state
+ * @param s3          L3 state whose L3 Result is received
+ * @return            LT_OK if success, otherwise returns other error code.
+ */
+static lt_ret_t lt_l2_recv_streamed_res(lt_l2_state_t *s2, lt_l3_state_t *s3)
+{
+    struct lt_l2_encrypted_cmd_rsp_t *resp = (struct lt_l2_encrypted_cmd_rsp_t *)s2->buff;
+    uint16_t offset = 0;
+    lt_ret_t ret = LT_FAIL;
+
+    for (uint16_t loops = 0; loops < LT_L2_RECV_ENC_RES_MAX_LOOPS; loops++) {
+        ret = lt_l1_read(s2, TR01_L1_LEN_MAX, LT_L1_TIMEOUT_MS_DEFAULT);
+        if (ret != LT_OK) {
+            goto discard;
+        }
+
+        // Prevent receiving more data than is the max size of L3 packet.
+        if (offset + resp->rsp_len > TR01_L3_PACKET_MAX_SIZE) {
+            ret = LT_L2_RSP_LEN_ERROR;
+            goto discard;
+        }
+
+        ret = lt_l2_frame_check(s2);
+        if (ret != LT_OK && ret != LT_L2_RES_CONT) {
+            goto discard;
+        }
+
+        lt_ret_t dec_ret = lt_l3_decrypt_response_chunk(s3, resp->l3_chunk, offset, resp->rsp_len);
+        if (dec_ret != LT_OK) {
+            return dec_ret;
+        }
+
+        if (ret == LT_OK) {
+            // This was last l2 frame of l3 packet
+            return LT_OK;
+        }
+        offset += resp->rsp_len;
+    }
+    ret = LT_FAIL;
+
+discard:
+    // Payload decrypted from the previous chunks was not authenticated.
+    lt_l3_res_stream_discard(s3);
+
+    return ret;
+}
+#endif
+
 lt_ret_t lt_l2_send_encrypted_cmd(lt_l2_state_t *s2, uint8_t *buff, uint16_t buff_len)
 {
     if (!s2 || !buff) {
         return LT_PARAM_ERR;
     }
 
+    // The L3 Command left to be encrypted chunk by chunk is sent only once, even if sending fails.
+    lt_l3_state_t *pending_encryption = s2->pending_encryption;
+    s2->pending_encryption = NULL;
+
     int ret = LT_FAIL;
 
     // There is l3 payload in passed buffer.
@@ -115,15 +234,18 @@ lt_ret_t lt_l2_send_encrypted_cmd(lt_l2_state_t *s2, uint8_t *buff, uint16_t buf
         LT_LOG_ERROR("Packet size %" PRIu16 "exceeds maximum L3 packet size %u", packet_size, TR01_L3_PACKET_MAX_SIZE);
         return LT_L3_DATA_LEN_ERROR;
     }
+#if LT_L3_STREAMING
+    if (pending_encryption && pending_encryption->cmd_payload) {
+        return lt_l2_send_streamed_cmd(s2, pending_encryption, packet_size);
+    }
+#endif
+
     // Prevent sending more data than is the size of passed buffer.
     if (packet_size > buff_len) {
         LT_LOG_ERROR("Packet size %" PRIu16 "exceeds L3 buffer size %" PRIu16, packet_size, buff_len);
         return LT_PARAM_ERR;
     }
 
-    // Setup a request pointer to l2 buffer, which is placed in handle
-    struct lt_l2_encrypted_cmd_req_t *req = (struct lt_l2_encrypted_cmd_req_t *)s2->buff;
-
     // Calculate number of chunks to send.
     // First, get the number of full chunks.
     uint16_t full_chunk_num = (packet_size / TR01_L2_CHUNK_MAX_DATA_SIZE);
@@ -135,40 +257,78 @@ lt_ret_t lt_l2_send_encrypted_cmd(lt_l2_state_t *s2, uint8_t *buff, uint16_t buf
 
     uint16_t buff_offset = 0;
 
+    // Chunks are acknowledged right away, polling according to the L3 Command is used only for its L3 Result.
+    uint16_t poll_key = s2->poll_key;
+    s2->poll_key = 0;
+
+    if (pending_encryption) {
+        ret = lt_l3_encrypt_request_part(pending_encryption, buff, 0,
+                                         chunk_num == 1 ? last_chunk_len : TR01_L2_CHUNK_MAX_DATA_SIZE);
+        if (ret != LT_OK) {
+            goto cleanup;
+        }
+    }
+
     // Split encrypted buffer into chunks and proceed them into l2 transfers:
     for (int i = 0; i < chunk_num; i++) {
-        req->req_id = TR01_L2_ENCRYPTED_CMD_REQ_ID;
+        uint8_t req_hdr[TR01_L2_REQ_ID_SIZE + TR01_L2_REQ_RSP_LEN_SIZE];
+        uint8_t req_crc[TR01_L2_REQ_RSP_CRC_SIZE];
+
+        req_hdr[0] = TR01_L2_ENCRYPTED_CMD_REQ_ID;
         // If the currently processed chunk is the last one, get its length (may be shorter than L2_CHUNK_MAX_DATA_SIZE)
         if (i == (chunk_num - 1)) {
-            req->req_len = last_chunk_len;
+            req_hdr[1] = last_chunk_len;
         }
         else {
-            req->req_len = TR01_L2_CHUNK_MAX_DATA_SIZE;
+            req_hdr[1] = TR01_L2_CHUNK_MAX_DATA_SIZE;
         }
-        memcpy(req->l3_chunk, buff + buff_offset, req->req_len);
-        buff_offset += req->req_len;  // Move offset for next chunk
-        add_crc(req);
+
+        // The chunk is sent straight from l3 buff, only header and CRC are kept aside.
+        uint16_t crc = crc16_update(LT_CRC16_INITIAL_VAL, req_hdr, sizeof(req_hdr));
+        crc = crc16_finish(crc16_update(crc, buff + buff_offset, req_hdr[1]));
+        req_crc[0] = crc >> 8;
+        req_crc[1] = crc & 0x00FF;
+
+        const lt_port_iov_t req_iov[] = {
+            {.base = req_hdr, .len = sizeof(req_hdr)},
+            {.base = buff + buff_offset, .len = req_hdr[1]},
+            {.base = req_crc, .len = sizeof(req_crc)},
+        };
+        buff_offset += req_hdr[1];  // Move offset for next chunk
 
         // Send l2 request cointaining a chunk from l3 buff
-        ret = lt_l1_write(s2, 2 + req->req_len + 2, LT_L1_TIMEOUT_MS_DEFAULT);
+        ret = lt_l1_write_iov(s2, req_iov, sizeof(req_iov) / sizeof(req_iov[0]), LT_L1_TIMEOUT_MS_DEFAULT);
         if (ret != LT_OK) {
-            return ret;
+            goto cleanup;
+        }
+
+        // The next chunk is encrypted while TROPIC01 processes this one, before the response is polled for.
+        if (pending_encryption && i < (chunk_num - 1)) {
+            ret = lt_l3_encrypt_request_part(pending_encryption, buff, buff_offset,
+                                             i == (chunk_num - 2) ? last_chunk_len : TR01_L2_CHUNK_MAX_DATA_SIZE);
+            if (ret != LT_OK) {
+                goto cleanup;
+            }
         }
 
         // Read a response on this l2 request
         ret = lt_l1_read(s2, TR01_L1_LEN_MAX, LT_L1_TIMEOUT_MS_DEFAULT);
         if (ret != LT_OK) {
-            return ret;
+            goto cleanup;
         }
 
         // Check status byte of this frame
-        ret = lt_l2_frame_check(s2->buff);
+        ret = lt_l2_frame_check(s2);
         if (ret != LT_OK && ret != LT_L2_REQ_CONT) {
-            return ret;
+            goto cleanup;
         }
     }
+    ret = LT_OK;
+
+cleanup:
+    s2->poll_key = poll_key;
 
-    return LT_OK;
+    return ret;
 }
 
 lt_ret_t lt_l2_recv_encrypted_res(lt_l2_state_t *s2, uint8_t *buff, uint16_t max_len)
@@ -179,6 +339,12 @@ lt_ret_t lt_l2_recv_encrypted_res(lt_l2_state_t *s2, uint8_t *buff, uint16_t max
         return LT_PARAM_ERR;
     }
 
+#if LT_L3_STREAMING
+    if (s2->res_decryption && s2->res_decryption->res_payload && buff == s2->res_decryption->buff) {
+        return lt_l2_recv_streamed_res(s2, s2->res_decryption);
+    }
+#endif
+
     int ret = LT_FAIL;
     // Setup a response pointer to l2 buffer, which is placed in handle
     struct lt_l2_encrypted_cmd_rsp_t *resp = (struct lt_l2_encrypted_cmd_rsp_t *)s2->buff;
@@ -189,35 +355,50 @@ lt_ret_t lt_l2_recv_encrypted_res(lt_l2_state_t *s2, uint8_t *buff, uint16_t max
     uint16_t loops = 0;
 
     do {
-        /* Get one l2 frame of a device's response */
-        ret = lt_l1_read(s2, TR01_L1_LEN_MAX, LT_L1_TIMEOUT_MS_DEFAULT);
+        /* Get one l2 frame of a device's response, its data go right to the certain offset of l3 buffer */
+        ret = lt_l1_read_into(s2, TR01_L1_LEN_MAX, buff + offset, max_len - offset, LT_L1_TIMEOUT_MS_DEFAULT);
         if (ret != LT_OK) {
-            return ret;
+            goto abort;
         }
 
         // Prevent receiving more data then is compiled size of l3 buffer
         if (offset + resp->rsp_len > max_len) {
-            return LT_L2_RSP_LEN_ERROR;
+            ret = LT_L2_RSP_LEN_ERROR;
+            goto abort;
         }
 
         // Check status byte of this frame
-        ret = lt_l2_frame_check(s2->buff);
+        ret = lt_l2_frame_check(s2);
+
+        // CRC of the chunk is checked now, so it can be decrypted while TROPIC01 prepares the next one.
+        if ((ret == LT_OK || ret == LT_L2_RES_CONT) && s2->res_decryption) {
+            lt_ret_t dec_ret = lt_l3_decrypt_response_part(s2->res_decryption, buff, offset, resp->rsp_len);
+            if (dec_ret != LT_OK) {
+                return dec_ret;
+            }
+        }
+
         switch (ret) {
             case LT_L2_RES_CONT:
-                // Copy content of l2 into certain offset of l3 buffer
-                memcpy(buff + offset, (struct l2_encrypted_rsp_t *)resp->l3_chunk, resp->rsp_len);
                 offset += resp->rsp_len;
                 loops++;
                 break;
             case LT_OK:
-                // This was last l2 frame of l3 packet, copy it and return
-                memcpy(buff + offset, (struct l2_encrypted_rsp_t *)resp->l3_chunk, resp->rsp_len);
+                // This was last l2 frame of l3 packet
                 return LT_OK;
             default:
                 // Any other L2 packet's status is not expected
-                return ret;
+                goto abort;
         }
     } while (loops < LT_L2_RECV_ENC_RES_MAX_LOOPS);
 
-    return LT_FAIL;
+    ret = LT_FAIL;
+
+abort:
+    // Chunks already decrypted in place were not authenticated, they must not stay in l3 buffer.
+    if (s2->res_decryption) {
+        lt_l3_res_decryption_abort(s2->res_decryption);
+    }
+
+    return ret;
 }
@@ -28,26 +28,139 @@
 #include "lt_sha256.h"
 #include "lt_x25519.h"
 
+/**
+ * @brief Encrypts L3 Command prepared in the L3 buffer.
+ *
+ * If the CAL can encrypt in parts, only the encryption is started here and each chunk is encrypted by
+ * lt_l2_send_encrypted_cmd() right before it is sent, the next one while TROPIC01 processes the previous one.
+ * The L3 Result is then decrypted by lt_l2_recv_encrypted_res() while it is received, if the CAL supports it.
+ *
+ * @note L3 Command ID is remembered in the L2 state, so polling for the L3 Result can use its learned processing time.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @return            LT_OK if success, otherwise returns other error code.
+ */
+static lt_ret_t lt_l3_encrypt_cmd(lt_handle_t *h)
+{
+    const struct lt_l3_gen_frame_t *p_frame = (const struct lt_l3_gen_frame_t *)h->l3.buff;
+    h->l2.poll_key = LT_POLL_KEY_L3(p_frame->data[0]);
+    h->l2.pending_encryption = NULL;
+    h->l2.res_decryption = &h->l3;
+    h->l3.res_decryption_status = LT_L3_RES_DECRYPTION_NONE;
+    h->l3.cmd_reserved = false;
+#if LT_L3_STREAMING
+    // Payloads of the previous L3 Command and its L3 Result must not be used for this one.
+    if (TR01_L3_SIZE_SIZE + p_frame->cmd_size + TR01_L3_TAG_SIZE <= h->l3.buff_len) {
+        h->l3.cmd_payload = NULL;
+    }
+    h->l3.res_payload = NULL;
+    h->l3.res_payload_offset = 0;
+#endif
+
+    lt_ret_t ret = lt_l3_encrypt_request_start(&h->l3);
+    if (ret == LT_NOT_SUPPORTED) {
+#if LT_L3_STREAMING
+        // Payload left in the caller's buffer can only be encrypted in parts.
+        if (h->l3.cmd_payload) {
+            return LT_NOT_SUPPORTED;
+        }
+#endif
+        return lt_l3_encrypt_request(&h->l3);
+    }
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    h->l2.pending_encryption = &h->l3;
+
+    return LT_OK;
+}
+
+lt_ret_t lt_l3_res_payload_into(lt_handle_t *h, uint8_t *buff, const uint16_t max_len)
+{
+    if (!h || !buff) {
+        return LT_PARAM_ERR;
+    }
+
+#if LT_L3_STREAMING
+    if (h->l3.res_payload_offset != 0) {
+        h->l3.res_payload = buff;
+        h->l3.res_payload_max_len = max_len;
+    }
+#else
+    LT_UNUSED(max_len);
+#endif
+
+    return LT_OK;
+}
+
+/**
+ * @brief Reserves space for the payload of the L3 Command whose fields are already in the L3 buffer.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param offset      Offset of the payload in the L3 packet
+ * @param len         Length of the payload
+ * @param payload     Set to the payload's place in the L3 buffer
+ * @return            LT_OK if success, LT_L3_BUFFER_TOO_SMALL if the L3 Command does not fit into the L3 buffer.
+ */
+static lt_ret_t lt_l3_cmd_reserve(lt_handle_t *h, const uint16_t offset, const uint16_t len, uint8_t **payload)
+{
+    if ((uint32_t)offset + len + TR01_L3_TAG_SIZE > h->l3.buff_len) {
+        return LT_L3_BUFFER_TOO_SMALL;
+    }
+
+    *payload = h->l3.buff + offset;
+    h->l3.cmd_reserved = true;
+
+    return LT_OK;
+}
+
+lt_ret_t lt_out__commit(lt_handle_t *h)
+{
+    if (!h || !h->l3.cmd_reserved) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
+        h->l3.cmd_reserved = false;
+        return LT_HOST_NO_SESSION;
+    }
+
+    return lt_l3_encrypt_cmd(h);
+}
+
 lt_ret_t lt_out__session_start(lt_handle_t *h, const lt_pkey_index_t pkey_index, lt_host_eph_keys_t *host_eph_keys)
 {
     if (!h || (pkey_index > TR01_PAIRING_KEY_SLOT_INDEX_3) || !host_eph_keys) {
         return LT_PARAM_ERR;
     }
+    // The handshake hash is computed in the SHA-256 context.
+    if (h->l3.ecdsa_sign_hashing) {
+        return LT_SHA256_BUSY;
+    }
 
     // Remove any previous session data and init IVs.
     // In case we reuse handle and use separate l3 buffer, we need to ensure that IV's are zeroed,
     // because on session start we expect IV's to be 0. It does not hurt to zero them anyway on session start.
     lt_l3_invalidate_host_session_data(&h->l3);
 
-    // Create ephemeral host keys
-    lt_ret_t ret = lt_random_bytes(h, host_eph_keys->ehpriv, sizeof(host_eph_keys->ehpriv));
-    if (ret != LT_OK) {
-        return ret;
+    // Take ephemeral host keys from the pool, the pool's copy is destroyed so they are never used twice.
+    lt_eph_key_pool_t *pool = h->l3.eph_key_pool;
+    if (pool && pool->count > 0 && pool->count <= LT_EPH_KEY_POOL_SIZE) {
+        pool->count--;
+        memcpy(host_eph_keys, &pool->keys[pool->count], sizeof(lt_host_eph_keys_t));
+        lt_secure_memzero(&pool->keys[pool->count], sizeof(lt_host_eph_keys_t));
     }
+    else {
+        // Create ephemeral host keys
+        lt_ret_t ret = lt_random_bytes(h, host_eph_keys->ehpriv, sizeof(host_eph_keys->ehpriv));
+        if (ret != LT_OK) {
+            return ret;
+        }
 
-    ret = lt_X25519_scalarmult(host_eph_keys->ehpriv, host_eph_keys->ehpub);
-    if (ret != LT_OK) {
-        return ret;
+        ret = lt_X25519_scalarmult(host_eph_keys->ehpriv, host_eph_keys->ehpub);
+        if (ret != LT_OK) {
+            return ret;
+        }
     }
 
     // Setup a request pointer to l2 buffer, which is placed in handle
@@ -68,6 +181,9 @@ lt_ret_t lt_in__session_start(lt_handle_t *h, const uint8_t *stpub, const lt_pke
     if (!h || !stpub || (pkey_index > TR01_PAIRING_KEY_SLOT_INDEX_3) || !shipriv || !shipub || !host_eph_keys) {
         return LT_PARAM_ERR;
     }
+    if (h->l3.ecdsa_sign_hashing) {
+        return LT_SHA256_BUSY;
+    }
 
     // Remove any previous session data and init IVs.
     // In case we reuse handle and use separate l3 buffer, we need to ensure that IV's are zeroed,
@@ -285,9 +401,12 @@ sha256_cleanup:
     return ret;
 }
 
-lt_ret_t lt_out__ping(lt_handle_t *h, const uint8_t *msg_out, const uint16_t msg_len)
+/**
+ * @brief Checks arguments of Ping and fills its fields into the L3 buffer.
+ */
+static lt_ret_t lt_l3_ping_cmd_fill(lt_handle_t *h, const uint16_t msg_len)
 {
-    if (!h || !msg_out || (msg_len > TR01_PING_LEN_MAX)) {
+    if (!h || (msg_len > TR01_PING_LEN_MAX)) {
         return LT_PARAM_ERR;
     }
     if (h->l3.session_status != LT_SECURE_SESSION_ON) {
@@ -300,9 +419,47 @@ lt_ret_t lt_out__ping(lt_handle_t *h, const uint8_t *msg_out, const uint16_t msg
     // Fill l3 buffer
     p_l3_cmd->cmd_size = msg_len + TR01_L3_PING_CMD_SIZE_MIN;
     p_l3_cmd->cmd_id = TR01_L3_PING_CMD_ID;
-    memcpy(p_l3_cmd->data_in, msg_out, msg_len);
 
-    return lt_l3_encrypt_request(&h->l3);
+    return LT_OK;
+}
+
+lt_ret_t lt_out__ping(lt_handle_t *h, const uint8_t *msg_out, const uint16_t msg_len)
+{
+    if (!msg_out) {
+        return LT_PARAM_ERR;
+    }
+    lt_ret_t ret = lt_l3_ping_cmd_fill(h, msg_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_l3_res_payload_check(&h->l3, offsetof(struct lt_l3_ping_res_t, data_out), msg_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    lt_l3_cmd_payload_set(&h->l3, offsetof(struct lt_l3_ping_cmd_t, data_in), msg_out, msg_len);
+
+    ret = lt_l3_encrypt_cmd(h);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    lt_l3_res_payload_expect(&h->l3, offsetof(struct lt_l3_ping_res_t, data_out), msg_len);
+
+    return LT_OK;
+}
+
+lt_ret_t lt_out__ping_reserve(lt_handle_t *h, const uint16_t msg_len, uint8_t **msg_out)
+{
+    if (!msg_out) {
+        return LT_PARAM_ERR;
+    }
+    lt_ret_t ret = lt_l3_ping_cmd_fill(h, msg_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    // Ping Result has the same size as the Command, so it is received into the L3 buffer as well.
+    return lt_l3_cmd_reserve(h, offsetof(struct lt_l3_ping_cmd_t, data_in), msg_len, msg_out);
 }
 
 lt_ret_t lt_in__ping(lt_handle_t *h, uint8_t *msg_in, const uint16_t msg_len)
@@ -328,9 +485,7 @@ lt_ret_t lt_in__ping(lt_handle_t *h, uint8_t *msg_in, const uint16_t msg_len)
         return LT_L3_RES_SIZE_ERROR;
     }
 
-    memcpy(msg_in, p_l3_res->data_out, msg_len);
-
-    return LT_OK;
+    return lt_l3_res_payload_copy(&h->l3, msg_in, offsetof(struct lt_l3_ping_res_t, data_out), msg_len);
 }
 
 lt_ret_t lt_out__pairing_key_write(lt_handle_t *h, const uint8_t *pairing_pub, const uint8_t slot)
@@ -351,7 +506,7 @@ lt_ret_t lt_out__pairing_key_write(lt_handle_t *h, const uint8_t *pairing_pub, c
     p_l3_cmd->slot = slot;
     memcpy(p_l3_cmd->s_hipub, pairing_pub, sizeof(p_l3_cmd->s_hipub));
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__pairing_key_write(lt_handle_t *h)
@@ -397,7 +552,7 @@ lt_ret_t lt_out__pairing_key_read(lt_handle_t *h, const uint8_t slot)
     p_l3_cmd->cmd_id = TR01_L3_PAIRING_KEY_READ_CMD_ID;
     p_l3_cmd->slot = slot;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__pairing_key_read(lt_handle_t *h, uint8_t *pubkey)
@@ -446,7 +601,7 @@ lt_ret_t lt_out__pairing_key_invalidate(lt_handle_t *h, const uint8_t slot)
     // cmd data
     p_l3_cmd->slot = slot;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__pairing_key_invalidate(lt_handle_t *h)
@@ -530,7 +685,7 @@ lt_ret_t lt_out__r_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t
     p_l3_cmd->address = (uint16_t)addr;
     p_l3_cmd->value = obj;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__r_config_write(lt_handle_t *h)
@@ -576,7 +731,7 @@ lt_ret_t lt_out__r_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t a
     p_l3_cmd->cmd_id = TR01_L3_R_CONFIG_READ_CMD_ID;
     p_l3_cmd->address = (uint16_t)addr;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__r_config_read(lt_handle_t *h, uint32_t *obj)
@@ -623,7 +778,7 @@ lt_ret_t lt_out__r_config_erase(lt_handle_t *h)
     p_l3_cmd->cmd_size = TR01_L3_R_CONFIG_ERASE_CMD_SIZE;
     p_l3_cmd->cmd_id = TR01_L3_R_CONFIG_ERASE_CMD_ID;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__r_config_erase(lt_handle_t *h)
@@ -670,7 +825,7 @@ lt_ret_t lt_out__i_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t
     p_l3_cmd->address = (uint16_t)addr;
     p_l3_cmd->bit_index = bit_index;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__i_config_write(lt_handle_t *h)
@@ -716,7 +871,7 @@ lt_ret_t lt_out__i_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t a
     p_l3_cmd->cmd_id = TR01_L3_I_CONFIG_READ_CMD_ID;
     p_l3_cmd->address = (uint16_t)addr;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__i_config_read(lt_handle_t *h, uint32_t *obj)
@@ -747,10 +902,12 @@ lt_ret_t lt_in__i_config_read(lt_handle_t *h, uint32_t *obj)
     return LT_OK;
 }
 
-lt_ret_t lt_out__r_mem_data_write(lt_handle_t *h, const uint16_t udata_slot, const uint8_t *data,
-                                  const uint16_t data_size)
+/**
+ * @brief Checks arguments of R_Mem_Data_Write and fills its fields into the L3 buffer.
+ */
+static lt_ret_t lt_l3_r_mem_data_write_cmd_fill(lt_handle_t *h, const uint16_t udata_slot, const uint16_t data_size)
 {
-    if (!h || !data || data_size < TR01_R_MEM_DATA_SIZE_MIN || data_size > h->tr01_attrs.r_mem_udata_slot_size_max
+    if (!h || data_size < TR01_R_MEM_DATA_SIZE_MIN || data_size > h->tr01_attrs.r_mem_udata_slot_size_max
         || (udata_slot > TR01_R_MEM_DATA_SLOT_MAX)) {
         return LT_PARAM_ERR;
     }
@@ -765,9 +922,37 @@ lt_ret_t lt_out__r_mem_data_write(lt_handle_t *h, const uint16_t udata_slot, con
     p_l3_cmd->cmd_size = data_size + 4;
     p_l3_cmd->cmd_id = TR01_L3_R_MEM_DATA_WRITE_CMD_ID;
     p_l3_cmd->udata_slot = udata_slot;
-    memcpy(p_l3_cmd->data, data, data_size);
 
-    return lt_l3_encrypt_request(&h->l3);
+    return LT_OK;
+}
+
+lt_ret_t lt_out__r_mem_data_write(lt_handle_t *h, const uint16_t udata_slot, const uint8_t *data,
+                                  const uint16_t data_size)
+{
+    if (!data) {
+        return LT_PARAM_ERR;
+    }
+    lt_ret_t ret = lt_l3_r_mem_data_write_cmd_fill(h, udata_slot, data_size);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    lt_l3_cmd_payload_set(&h->l3, offsetof(struct lt_l3_r_mem_data_write_cmd_t, data), data, data_size);
+
+    return lt_l3_encrypt_cmd(h);
+}
+
+lt_ret_t lt_out__r_mem_data_write_reserve(lt_handle_t *h, const uint16_t udata_slot, const uint16_t data_size,
+                                          uint8_t **data)
+{
+    if (!data) {
+        return LT_PARAM_ERR;
+    }
+    lt_ret_t ret = lt_l3_r_mem_data_write_cmd_fill(h, udata_slot, data_size);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    return lt_l3_cmd_reserve(h, offsetof(struct lt_l3_r_mem_data_write_cmd_t, data), data_size, data);
 }
 
 lt_ret_t lt_in__r_mem_data_write(lt_handle_t *h)
@@ -813,7 +998,21 @@ lt_ret_t lt_out__r_mem_data_read(lt_handle_t *h, const uint16_t udata_slot)
     p_l3_cmd->cmd_id = TR01_L3_R_MEM_DATA_READ_CMD_ID;
     p_l3_cmd->udata_slot = udata_slot;
 
-    return lt_l3_encrypt_request(&h->l3);
+    lt_ret_t ret = lt_l3_res_payload_check(&h->l3, offsetof(struct lt_l3_r_mem_data_read_res_t, data),
+                                           h->tr01_attrs.r_mem_udata_slot_size_max);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l3_encrypt_cmd(h);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    lt_l3_res_payload_expect(&h->l3, offsetof(struct lt_l3_r_mem_data_read_res_t, data),
+                             h->tr01_attrs.r_mem_udata_slot_size_max);
+
+    return LT_OK;
 }
 
 lt_ret_t lt_in__r_mem_data_read(lt_handle_t *h, uint8_t *data, const uint16_t data_max_size, uint16_t *data_read_size)
@@ -853,9 +1052,7 @@ lt_ret_t lt_in__r_mem_data_read(lt_handle_t *h, uint8_t *data, const uint16_t da
         return LT_PARAM_ERR;
     }
 
-    memcpy(data, p_l3_res->data, *data_read_size);
-
-    return LT_OK;
+    return lt_l3_res_payload_copy(&h->l3, data, offsetof(struct lt_l3_r_mem_data_read_res_t, data), *data_read_size);
 }
 
 lt_ret_t lt_out__r_mem_data_erase(lt_handle_t *h, const uint16_t udata_slot)
@@ -875,7 +1072,7 @@ lt_ret_t lt_out__r_mem_data_erase(lt_handle_t *h, const uint16_t udata_slot)
     p_l3_cmd->cmd_id = TR01_L3_R_MEM_DATA_ERASE_CMD_ID;
     p_l3_cmd->udata_slot = udata_slot;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__r_mem_data_erase(lt_handle_t *h)
@@ -921,7 +1118,7 @@ lt_ret_t lt_out__random_value_get(lt_handle_t *h, const uint16_t rnd_bytes_cnt)
     p_l3_cmd->cmd_id = TR01_L3_RANDOM_VALUE_GET_CMD_ID;
     p_l3_cmd->n_bytes = rnd_bytes_cnt;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__random_value_get(lt_handle_t *h, uint8_t *rnd_bytes, const uint16_t rnd_bytes_cnt)
@@ -974,7 +1171,7 @@ lt_ret_t lt_out__ecc_key_generate(lt_handle_t *h, const lt_ecc_slot_t slot, cons
     p_l3_cmd->slot = (uint8_t)slot;
     p_l3_cmd->curve = (uint8_t)curve;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__ecc_key_generate(lt_handle_t *h)
@@ -1003,10 +1200,12 @@ lt_ret_t lt_in__ecc_key_generate(lt_handle_t *h)
     return LT_OK;
 }
 
-lt_ret_t lt_out__ecc_key_store(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc_curve_type_t curve,
-                               const uint8_t *key)
+/**
+ * @brief Checks arguments of ECC_Key_Store and fills its fields into the L3 buffer.
+ */
+static lt_ret_t lt_l3_ecc_key_store_cmd_fill(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc_curve_type_t curve)
 {
-    if (!h || (slot > TR01_ECC_SLOT_31) || ((curve != TR01_CURVE_P256) && (curve != TR01_CURVE_ED25519)) || !key) {
+    if (!h || (slot > TR01_ECC_SLOT_31) || ((curve != TR01_CURVE_P256) && (curve != TR01_CURVE_ED25519))) {
         return LT_PARAM_ERR;
     }
     if (h->l3.session_status != LT_SECURE_SESSION_ON) {
@@ -1021,9 +1220,38 @@ lt_ret_t lt_out__ecc_key_store(lt_handle_t *h, const lt_ecc_slot_t slot, const l
     p_l3_cmd->cmd_id = TR01_L3_ECC_KEY_STORE_CMD_ID;
     p_l3_cmd->slot = slot;
     p_l3_cmd->curve = curve;
+
+    return LT_OK;
+}
+
+lt_ret_t lt_out__ecc_key_store(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc_curve_type_t curve,
+                               const uint8_t *key)
+{
+    if (!key) {
+        return LT_PARAM_ERR;
+    }
+    lt_ret_t ret = lt_l3_ecc_key_store_cmd_fill(h, slot, curve);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    struct lt_l3_ecc_key_store_cmd_t *p_l3_cmd = (struct lt_l3_ecc_key_store_cmd_t *)h->l3.buff;
     memcpy(p_l3_cmd->k, key, TR01_CURVE_PRIVKEY_LEN);
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
+}
+
+lt_ret_t lt_out__ecc_key_store_reserve(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc_curve_type_t curve,
+                                       uint8_t **key)
+{
+    if (!key) {
+        return LT_PARAM_ERR;
+    }
+    lt_ret_t ret = lt_l3_ecc_key_store_cmd_fill(h, slot, curve);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    return lt_l3_cmd_reserve(h, offsetof(struct lt_l3_ecc_key_store_cmd_t, k), TR01_CURVE_PRIVKEY_LEN, key);
 }
 
 lt_ret_t lt_in__ecc_key_store(lt_handle_t *h)
@@ -1069,7 +1297,7 @@ lt_ret_t lt_out__ecc_key_read(lt_handle_t *h, const lt_ecc_slot_t slot)
     p_l3_cmd->cmd_id = TR01_L3_ECC_KEY_READ_CMD_ID;
     p_l3_cmd->slot = slot;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__ecc_key_read(lt_handle_t *h, uint8_t *key, const uint8_t key_max_size, lt_ecc_curve_type_t *curve,
@@ -1149,7 +1377,7 @@ lt_ret_t lt_out__ecc_key_erase(lt_handle_t *h, const lt_ecc_slot_t slot)
     p_l3_cmd->cmd_id = TR01_L3_ECC_KEY_ERASE_CMD_ID;
     p_l3_cmd->slot = slot;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__ecc_key_erase(lt_handle_t *h)
@@ -1178,6 +1406,25 @@ lt_ret_t lt_in__ecc_key_erase(lt_handle_t *h)
     return LT_OK;
 }
 
+LT_STATIC_ASSERT(LT_MEMBER_SIZE(struct lt_l3_ecdsa_sign_cmd_t, msg_hash) == TR01_ECDSA_SIGN_DIGEST_LENGTH)
+
+/**
+ * @brief Fills ECDSA_Sign with the hash of the message into the L3 buffer and encrypts it.
+ */
+static lt_ret_t lt_l3_ecdsa_sign_cmd_encrypt(lt_handle_t *h, const lt_ecc_slot_t slot, const uint8_t *msg_hash)
+{
+    // Pointer to access l3 buffer when it contains command data
+    struct lt_l3_ecdsa_sign_cmd_t *p_l3_cmd = (struct lt_l3_ecdsa_sign_cmd_t *)h->l3.buff;
+
+    // Fill l3 buffer
+    p_l3_cmd->cmd_size = TR01_L3_ECDSA_SIGN_CMD_SIZE;
+    p_l3_cmd->cmd_id = TR01_L3_ECDSA_SIGN_CMD_ID;
+    p_l3_cmd->slot = slot;
+    memcpy(p_l3_cmd->msg_hash, msg_hash, sizeof(p_l3_cmd->msg_hash));
+
+    return lt_l3_encrypt_cmd(h);
+}
+
 lt_ret_t lt_out__ecc_ecdsa_sign(lt_handle_t *h, const lt_ecc_slot_t slot, const uint8_t *msg, const uint32_t msg_len)
 {
     if (!h || (slot > TR01_ECC_SLOT_31) || !msg) {
@@ -1186,9 +1433,12 @@ lt_ret_t lt_out__ecc_ecdsa_sign(lt_handle_t *h, const lt_ecc_slot_t slot, const
     if (h->l3.session_status != LT_SECURE_SESSION_ON) {
         return LT_HOST_NO_SESSION;
     }
+    if (h->l3.ecdsa_sign_hashing) {
+        return LT_SHA256_BUSY;
+    }
 
     // Prepare hash of a message
-    uint8_t msg_hash[32] = {0};
+    uint8_t msg_hash[TR01_ECDSA_SIGN_DIGEST_LENGTH] = {0};
     lt_ret_t ret;
     lt_ret_t ret_unused;
 
@@ -1210,16 +1460,51 @@ lt_ret_t lt_out__ecc_ecdsa_sign(lt_handle_t *h, const lt_ecc_slot_t slot, const
         goto sha256_cleanup;
     }
 
-    // Pointer to access l3 buffer when it contains command data
-    struct lt_l3_ecdsa_sign_cmd_t *p_l3_cmd = (struct lt_l3_ecdsa_sign_cmd_t *)h->l3.buff;
+    ret = lt_l3_ecdsa_sign_cmd_encrypt(h, slot, msg_hash);
 
-    // Fill l3 buffer
-    p_l3_cmd->cmd_size = TR01_L3_ECDSA_SIGN_CMD_SIZE;
-    p_l3_cmd->cmd_id = TR01_L3_ECDSA_SIGN_CMD_ID;
-    p_l3_cmd->slot = slot;
-    memcpy(p_l3_cmd->msg_hash, msg_hash, sizeof(p_l3_cmd->msg_hash));
+sha256_cleanup:
+    ret_unused = lt_sha256_deinit(h->l3.crypto_ctx);
+    lt_secure_memzero(msg_hash, sizeof(msg_hash));
+    LT_UNUSED(ret_unused);
 
-    ret = lt_l3_encrypt_request(&h->l3);
+    return ret;
+}
+
+lt_ret_t lt_out__ecc_ecdsa_sign_digest(lt_handle_t *h, const lt_ecc_slot_t slot, const uint8_t *digest)
+{
+    if (!h || (slot > TR01_ECC_SLOT_31) || !digest) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+
+    return lt_l3_ecdsa_sign_cmd_encrypt(h, slot, digest);
+}
+
+lt_ret_t lt_out__ecc_ecdsa_sign_final(lt_handle_t *h)
+{
+    if (!h || !h->l3.ecdsa_sign_hashing) {
+        return LT_PARAM_ERR;
+    }
+
+    uint8_t msg_hash[TR01_ECDSA_SIGN_DIGEST_LENGTH] = {0};
+    lt_ret_t ret;
+    lt_ret_t ret_unused;
+
+    // The hashing ends here in any case, the caller starts again with lt_ecc_ecdsa_sign_init().
+    h->l3.ecdsa_sign_hashing = false;
+    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
+        ret = LT_HOST_NO_SESSION;
+        goto sha256_cleanup;
+    }
+
+    ret = lt_sha256_finish(h->l3.crypto_ctx, msg_hash);
+    if (ret != LT_OK) {
+        goto sha256_cleanup;
+    }
+
+    ret = lt_l3_ecdsa_sign_cmd_encrypt(h, h->l3.ecdsa_sign_slot, msg_hash);
 
 sha256_cleanup:
     ret_unused = lt_sha256_deinit(h->l3.crypto_ctx);
@@ -1258,10 +1543,12 @@ lt_ret_t lt_in__ecc_ecdsa_sign(lt_handle_t *h, uint8_t *rs)
     return LT_OK;
 }
 
-lt_ret_t lt_out__ecc_eddsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *msg,
-                                const uint16_t msg_len)
+/**
+ * @brief Checks arguments of EDDSA_Sign and fills its fields into the L3 buffer.
+ */
+static lt_ret_t lt_l3_eddsa_sign_cmd_fill(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint16_t msg_len)
 {
-    if (!h || !msg || (msg_len > TR01_L3_EDDSA_SIGN_CMD_MSG_LEN_MAX) || (ecc_slot > TR01_ECC_SLOT_31)) {
+    if (!h || (msg_len > TR01_L3_EDDSA_SIGN_CMD_MSG_LEN_MAX) || (ecc_slot > TR01_ECC_SLOT_31)) {
         return LT_PARAM_ERR;
     }
     if (h->l3.session_status != LT_SECURE_SESSION_ON) {
@@ -1275,9 +1562,37 @@ lt_ret_t lt_out__ecc_eddsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, co
     p_l3_cmd->cmd_size = TR01_L3_EDDSA_SIGN_CMD_SIZE_MIN + msg_len;
     p_l3_cmd->cmd_id = TR01_L3_EDDSA_SIGN_CMD_ID;
     p_l3_cmd->slot = ecc_slot;
-    memcpy(p_l3_cmd->msg, msg, msg_len);
 
-    return lt_l3_encrypt_request(&h->l3);
+    return LT_OK;
+}
+
+lt_ret_t lt_out__ecc_eddsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *msg,
+                                const uint16_t msg_len)
+{
+    if (!msg) {
+        return LT_PARAM_ERR;
+    }
+    lt_ret_t ret = lt_l3_eddsa_sign_cmd_fill(h, ecc_slot, msg_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    lt_l3_cmd_payload_set(&h->l3, offsetof(struct lt_l3_eddsa_sign_cmd_t, msg), msg, msg_len);
+
+    return lt_l3_encrypt_cmd(h);
+}
+
+lt_ret_t lt_out__ecc_eddsa_sign_reserve(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint16_t msg_len,
+                                        uint8_t **msg)
+{
+    if (!msg) {
+        return LT_PARAM_ERR;
+    }
+    lt_ret_t ret = lt_l3_eddsa_sign_cmd_fill(h, ecc_slot, msg_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    return lt_l3_cmd_reserve(h, offsetof(struct lt_l3_eddsa_sign_cmd_t, msg), msg_len, msg);
 }
 
 lt_ret_t lt_in__ecc_eddsa_sign(lt_handle_t *h, uint8_t *rs)
@@ -1328,7 +1643,7 @@ lt_ret_t lt_out__mcounter_init(lt_handle_t *h, const enum lt_mcounter_index_t mc
     p_l3_cmd->mcounter_index = mcounter_index;
     p_l3_cmd->mcounter_val = mcounter_value;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__mcounter_init(lt_handle_t *h)
@@ -1374,7 +1689,7 @@ lt_ret_t lt_out__mcounter_update(lt_handle_t *h, const enum lt_mcounter_index_t
     p_l3_cmd->cmd_id = TR01_L3_MCOUNTER_UPDATE_CMD_ID;
     p_l3_cmd->mcounter_index = mcounter_index;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__mcounter_update(lt_handle_t *h)
@@ -1420,7 +1735,7 @@ lt_ret_t lt_out__mcounter_get(lt_handle_t *h, const enum lt_mcounter_index_t mco
     p_l3_cmd->cmd_id = TR01_L3_MCOUNTER_GET_CMD_ID;
     p_l3_cmd->mcounter_index = mcounter_index;
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__mcounter_get(lt_handle_t *h, uint32_t *mcounter_value)
@@ -1469,7 +1784,7 @@ lt_ret_t lt_out__mac_and_destroy(lt_handle_t *h, lt_mac_and_destroy_slot_t slot,
     p_l3_cmd->slot = slot;
     memcpy(p_l3_cmd->data_in, data_out, TR01_MAC_AND_DESTROY_DATA_SIZE);
 
-    return lt_l3_encrypt_request(&h->l3);
+    return lt_l3_encrypt_cmd(h);
 }
 
 lt_ret_t lt_in__mac_and_destroy(lt_handle_t *h, uint8_t *data_in)
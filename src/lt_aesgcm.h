@@ -73,6 +73,106 @@ lt_ret_t lt_aesgcm_decrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len,
                            const uint32_t add_len, const uint8_t *ciphertext, const uint32_t ciphertext_len,
                            uint8_t *plaintext, const uint32_t plaintext_len) __attribute__((warn_unused_result));
 
+/**
+ * @brief Tells whether the backend can process AES-GCM messages in parts.
+ * @note Without it, the `_start`, `_update` and `_finish` functions return LT_NOT_SUPPORTED and only one-shot
+ *       `lt_aesgcm_encrypt` and `lt_aesgcm_decrypt` can be used.
+ *
+ * @return                  true if messages can be processed in parts, otherwise false.
+ */
+bool lt_aesgcm_streaming_supported(void);
+
+/**
+ * @brief Starts encryption of a message processed in parts, expects initialized context with valid keys.
+ *
+ * The plaintext is then passed by `lt_aesgcm_encrypt_update` calls and the message is ended by
+ * `lt_aesgcm_encrypt_finish`. Until then, no other encryption can be done with the context.
+ *
+ * @param ctx               AES-GCM context structure
+ * @param iv                Initialization vector
+ * @param iv_len            Length of the initialization vector
+ * @param add               Additional data
+ * @param add_len           Length of additional data
+ * @return                  LT_OK if success, LT_NOT_SUPPORTED if the backend cannot process messages in parts
+ *                          (one-shot `lt_aesgcm_encrypt` has to be used instead), otherwise other error code.
+ */
+lt_ret_t lt_aesgcm_encrypt_start(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                                 const uint32_t add_len) __attribute__((warn_unused_result));
+
+/**
+ * @brief Encrypts next part of the message started by `lt_aesgcm_encrypt_start`.
+ * @note Parts can be of any length. Plaintext and ciphertext can be the same buffer, but must not overlap otherwise.
+ *
+ * @param ctx               AES-GCM context structure
+ * @param plaintext         Input plaintext buffer
+ * @param ciphertext        Output ciphertext buffer
+ * @param len               Length of the part in bytes
+ * @return                  LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_aesgcm_encrypt_update(void *ctx, const uint8_t *plaintext, uint8_t *ciphertext, const uint32_t len)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Ends the message started by `lt_aesgcm_encrypt_start` and computes its tag.
+ *
+ * @param ctx               AES-GCM context structure
+ * @param tag               Buffer for the tag
+ * @param tag_len           Length of the tag
+ * @return                  LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_aesgcm_encrypt_finish(void *ctx, uint8_t *tag, const uint32_t tag_len) __attribute__((warn_unused_result));
+
+/**
+ * @brief Starts decryption of a message processed in parts, expects initialized context with valid keys.
+ *
+ * The ciphertext is then passed by `lt_aesgcm_decrypt_update` calls and the message is ended by
+ * `lt_aesgcm_decrypt_finish`, which verifies the tag. Until then, no other decryption can be done with the context.
+ * @warning Decrypted parts are not authenticated before `lt_aesgcm_decrypt_finish` succeeds.
+ *
+ * @param ctx               AES-GCM context structure
+ * @param iv                Initialization vector
+ * @param iv_len            Length of the initialization vector
+ * @param add               Additional data
+ * @param add_len           Length of additional data
+ * @return                  LT_OK if success, LT_NOT_SUPPORTED if the backend cannot process messages in parts
+ *                          (one-shot `lt_aesgcm_decrypt` has to be used instead), otherwise other error code.
+ */
+lt_ret_t lt_aesgcm_decrypt_start(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                                 const uint32_t add_len) __attribute__((warn_unused_result));
+
+/**
+ * @brief Decrypts next part of the message started by `lt_aesgcm_decrypt_start`.
+ * @note Parts can be of any length. Ciphertext and plaintext can be the same buffer, but must not overlap otherwise.
+ *
+ * @param ctx               AES-GCM context structure
+ * @param ciphertext        Input ciphertext buffer (without tag)
+ * @param plaintext         Output plaintext buffer
+ * @param len               Length of the part in bytes
+ * @return                  LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_aesgcm_decrypt_update(void *ctx, const uint8_t *ciphertext, uint8_t *plaintext, const uint32_t len)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Ends the message started by `lt_aesgcm_decrypt_start` and verifies its tag.
+ *
+ * @param ctx               AES-GCM context structure
+ * @param tag               Expected tag
+ * @param tag_len           Length of the tag
+ * @return                  LT_OK if the tag matches, otherwise returns other error code.
+ */
+lt_ret_t lt_aesgcm_decrypt_finish(void *ctx, const uint8_t *tag, const uint32_t tag_len)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Ends the message started by `lt_aesgcm_decrypt_start` without verifying its tag.
+ * @note Used when the rest of the message cannot be received. Key stays set, so the next message can be started.
+ *
+ * @param ctx               AES-GCM context structure
+ * @return                  LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_aesgcm_decrypt_abort(void *ctx) __attribute__((warn_unused_result));
+
 /**
  * @brief Deinitializes AES-GCM encryption context.
  * @warning Implementation can assume that `lt_crypto_ctx_init` was called before, but must not assume that
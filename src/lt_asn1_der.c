@@ -286,3 +286,537 @@ lt_ret_t asn1der_find_object(const uint8_t *stream, uint16_t len, int32_t obj_id
 
     return LT_OK;
 }
+
+/*******************************************************************************
+ * Streaming parser
+ *******************************************************************************/
+
+/** Parts of an object, in the order they come in the stream. */
+enum lt_asn1der_stream_state_t {
+    LT_ASN1DER_STREAM_TAG = 0,
+    LT_ASN1DER_STREAM_LEN,
+    LT_ASN1DER_STREAM_LEN_LONG,
+    LT_ASN1DER_STREAM_VALUE,
+};
+
+/**
+ * @brief Checks whether objects of the given type can be searched for.
+ *
+ * @param tag       Object type
+ *
+ * @returns true if the object can be sampled after matching OBJECT_IDENTIFIER
+ */
+static bool tag_sampleable(const uint8_t tag)
+{
+    switch (tag) {
+        case LT_ASN1DER_BOOLEAN:
+        case LT_ASN1DER_INTEGER:
+        case LT_ASN1DER_STRING_BIT:
+        case LT_ASN1DER_STRING_OCTET:
+        case LT_ASN1DER_STRING_NULL:
+        case LT_ASN1DER_STRING_UTF8:
+        case LT_ASN1DER_STRING_PRINTABLE:
+        case LT_ASN1DER_UTC_TIME:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Closes all SEQUENCEs ending at the current position.
+ *
+ * @param s         Parser state
+ */
+static void stream_close_sequences(struct lt_asn1der_stream_t *s)
+{
+    while (s->depth > 0 && s->ends[s->depth - 1] == s->past) {
+        s->depth--;
+    }
+}
+
+/**
+ * @brief Processes the value of the current object once all its bytes were passed.
+ *
+ * @param s         Parser state
+ */
+static void stream_end_value(struct lt_asn1der_stream_t *s)
+{
+    if (s->tag == LT_ASN1DER_OBJECT_IDENTIFIER && s->obj_len >= 3) {
+        uint32_t obj_id = (((uint32_t)s->obj_id[0]) << 16) | (((uint32_t)s->obj_id[1]) << 8) | ((uint32_t)s->obj_id[2]);
+        if (s->obj_id_searched == obj_id) {
+            s->sample_next = true;
+        }
+    }
+    else if (s->sampling) {
+        s->sampling = false;
+        s->sample_next = false;
+        s->found = true;
+    }
+
+    s->state = LT_ASN1DER_STREAM_TAG;
+    stream_close_sequences(s);
+}
+
+/**
+ * @brief Starts processing of the current object once its tag and length were parsed.
+ *
+ * @param s         Parser state
+ *
+ * @returns LT_OK if sucessfully, error code otherwise
+ */
+static lt_ret_t stream_begin_value(struct lt_asn1der_stream_t *s)
+{
+    uint16_t parent_end = (s->depth > 0) ? s->ends[s->depth - 1] : s->len;
+
+    if (s->obj_len > parent_end - s->past) {
+        LT_LOG_ERROR("ASN1 DER Parsing error: Object at %" PRIu16 " of length %" PRIu16 " exceeds its parent",
+                     s->past, s->obj_len);
+        return LT_CERT_STORE_INVALID;
+    }
+
+    if (s->tag == LT_ASN1DER_SEQUENCE) {
+        if (s->depth >= LT_ASN1DER_STREAM_DEPTH_MAX) {
+            LT_LOG_ERROR("ASN1 DER Parsing error: Unsupported nesting of SEQUENCEs");
+            return LT_CERT_UNSUPPORTED;
+        }
+        s->ends[s->depth++] = s->past + s->obj_len;
+        s->state = LT_ASN1DER_STREAM_TAG;
+        stream_close_sequences(s);
+        return LT_OK;
+    }
+
+    s->sampling = s->sample_next && tag_sampleable(s->tag);
+    s->obj_past = 0;
+    s->state = LT_ASN1DER_STREAM_VALUE;
+    if (s->obj_len == 0) {
+        stream_end_value(s);
+    }
+
+    return LT_OK;
+}
+
+/**
+ * @brief Processes one byte of the current object value.
+ *
+ * @param s         Parser state
+ * @param b         Byte of the value
+ */
+static void stream_value_byte(struct lt_asn1der_stream_t *s, const uint8_t b)
+{
+    if (s->tag == LT_ASN1DER_OBJECT_IDENTIFIER) {
+        if (s->obj_past < sizeof(s->obj_id)) {
+            s->obj_id[s->obj_past] = b;
+        }
+    }
+    else if (s->sbuf_len >= s->obj_len) {
+        s->sbuf[s->obj_past] = b;
+    }
+    else if (s->crop_kind == LT_ASN1DER_CROP_PREFIX) {
+        uint16_t n_crop_bytes = s->obj_len - s->sbuf_len;
+        if (s->obj_past >= n_crop_bytes) {
+            s->sbuf[s->obj_past - n_crop_bytes] = b;
+        }
+    }
+    else if (s->obj_past < s->sbuf_len) {
+        s->sbuf[s->obj_past] = b;
+    }
+}
+
+void asn1der_stream_init(struct lt_asn1der_stream_t *s, uint16_t len, int32_t obj_id, uint8_t *buf, int buf_len,
+                         enum lt_asn1der_crop_kind_t crop_kind)
+{
+    memset(s, 0, sizeof(struct lt_asn1der_stream_t));
+    s->len = len;
+    s->state = LT_ASN1DER_STREAM_TAG;
+    s->obj_id_searched = obj_id;
+    s->sbuf = buf;
+    s->sbuf_len = buf_len;
+    s->crop_kind = crop_kind;
+}
+
+lt_ret_t asn1der_stream_feed(struct lt_asn1der_stream_t *s, const uint8_t *chunk, uint16_t chunk_len)
+{
+    if (s->found) {
+        return LT_OK;
+    }
+
+    if (chunk_len > s->len - s->past) {
+        LT_LOG_ERROR("ASN1 DER Parsing error: Byte stream longer than %" PRIu16, s->len);
+        return LT_CERT_STORE_INVALID;
+    }
+
+    uint16_t i = 0;
+    while (i < chunk_len && !s->found) {
+        if (s->state == LT_ASN1DER_STREAM_VALUE && s->tag != LT_ASN1DER_OBJECT_IDENTIFIER && !s->sampling) {
+            // Nothing to look at in this value, skip as much of it as is in the chunk.
+            uint16_t n = s->obj_len - s->obj_past;
+            if (n > chunk_len - i) {
+                n = chunk_len - i;
+            }
+            i += n;
+            s->past += n;
+            s->obj_past += n;
+            if (s->obj_past == s->obj_len) {
+                stream_end_value(s);
+            }
+            continue;
+        }
+
+        uint8_t b = chunk[i++];
+        s->past++;
+        lt_ret_t rv = LT_OK;
+
+        switch (s->state) {
+            case LT_ASN1DER_STREAM_TAG:
+                s->tag = b;
+                s->state = LT_ASN1DER_STREAM_LEN;
+                break;
+
+            case LT_ASN1DER_STREAM_LEN:
+                if (b < 0x80) {
+                    s->obj_len = b;
+                    rv = stream_begin_value(s);
+                }
+                else {
+                    s->len_bytes = b ^ 0x80;
+                    if (s->len_bytes == 0 || s->len_bytes > 2) {
+                        LT_LOG_ERROR("ASN1 DER Parsing error: Unsupported length: %" PRIu8 " bytes", s->len_bytes);
+                        return LT_CERT_UNSUPPORTED;
+                    }
+                    s->obj_len = 0;
+                    s->state = LT_ASN1DER_STREAM_LEN_LONG;
+                }
+                break;
+
+            case LT_ASN1DER_STREAM_LEN_LONG:
+                s->obj_len = (s->obj_len << 8) | b;
+                if (--s->len_bytes == 0) {
+                    rv = stream_begin_value(s);
+                }
+                break;
+
+            case LT_ASN1DER_STREAM_VALUE:
+                stream_value_byte(s, b);
+                if (++s->obj_past == s->obj_len) {
+                    stream_end_value(s);
+                }
+                break;
+
+            default:
+                return LT_FAIL;
+        }
+
+        if (rv != LT_OK) {
+            return rv;
+        }
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t asn1der_stream_finish(const struct lt_asn1der_stream_t *s)
+{
+    if (s->found) {
+        return LT_OK;
+    }
+
+    if (s->past != s->len || s->state != LT_ASN1DER_STREAM_TAG || s->depth != 0) {
+        LT_LOG_ERROR("ASN1 DER Parsing error: Incomplete byte stream. Past: %" PRIu16 ", len: %" PRIu16, s->past,
+                     s->len);
+        return LT_CERT_STORE_INVALID;
+    }
+
+    return LT_CERT_ITEM_NOT_FOUND;
+}
+
+/*******************************************************************************
+ * Indexed parser
+ *******************************************************************************/
+
+/**
+ * @brief Returns offset right after the value of an indexed object.
+ *
+ * @param idx       Index
+ * @param node      Index of the node
+ */
+static uint16_t index_node_end(const struct lt_asn1der_index_t *idx, const uint16_t node)
+{
+    return idx->nodes[node].offset + idx->nodes[node].len;
+}
+
+/**
+ * @brief Finds n-th child of a certificate object and checks its type.
+ *
+ * @param idx       Index of the certificate
+ * @param parent    Index of the parent node
+ * @param n         Order of the child
+ * @param tag       Expected type of the child
+ * @param child     Index of the child node
+ *
+ * @returns LT_OK if sucessfully, LT_CERT_STORE_INVALID if the child is missing or of other type
+ */
+static lt_ret_t cert_child(const struct lt_asn1der_index_t *idx, const uint16_t parent, const uint16_t n,
+                           const uint8_t tag, uint16_t *child)
+{
+    if (asn1der_index_child(idx, parent, n, child) != LT_OK || idx->nodes[*child].tag != tag) {
+        LT_LOG_ERROR("ASN1 DER Parsing error: Certificate does not have object 0x%" PRIx8 " at position %" PRIu16,
+                     tag, n);
+        return LT_CERT_STORE_INVALID;
+    }
+
+    return LT_OK;
+}
+
+/**
+ * @brief Returns view of BIT STRING content without the unused bits byte.
+ *
+ * @param idx       Index of the certificate
+ * @param node      Index of the BIT STRING node
+ * @param view      View of the content
+ *
+ * @returns LT_OK if sucessfully, LT_CERT_STORE_INVALID if the BIT STRING is not made of whole bytes
+ */
+static lt_ret_t cert_bit_string(const struct lt_asn1der_index_t *idx, const uint16_t node,
+                                struct lt_asn1der_view_t *view)
+{
+    asn1der_index_value(idx, node, view);
+    if (view->len == 0 || view->data[0] != 0) {
+        LT_LOG_ERROR("ASN1 DER Parsing error: BIT STRING at %" PRIu16 " is not made of whole bytes",
+                     idx->nodes[node].offset);
+        return LT_CERT_STORE_INVALID;
+    }
+    view->data++;
+    view->len--;
+
+    return LT_OK;
+}
+
+lt_ret_t asn1der_index_build(struct lt_asn1der_index_t *idx, const uint8_t *stream, uint16_t len,
+                             struct lt_asn1der_node_t *nodes, uint16_t max_count)
+{
+    idx->stream = stream;
+    idx->len = len;
+    idx->count = 0;
+    idx->max_count = max_count;
+    idx->nodes = nodes;
+
+    uint16_t pos = 0;
+    uint16_t parent = LT_ASN1DER_NO_PARENT;
+
+    while (pos < len) {
+        uint16_t start = pos;
+        uint16_t parent_end = (parent == LT_ASN1DER_NO_PARENT) ? len : index_node_end(idx, parent);
+
+        if (parent_end - pos < 2) {
+            LT_LOG_ERROR("ASN1 DER Parsing error: Incomplete object at %" PRIu16, pos);
+            return LT_CERT_STORE_INVALID;
+        }
+
+        uint8_t tag = stream[pos++];
+        if ((tag & 0x1F) == 0x1F) {
+            LT_LOG_ERROR("ASN1 DER Parsing error: Unsupported multi-byte tag at %" PRIu16, start);
+            return LT_CERT_UNSUPPORTED;
+        }
+
+        uint16_t obj_len = stream[pos++];
+        if (obj_len >= 0x80) {
+            uint8_t n_bytes = obj_len ^ 0x80;
+            if (n_bytes == 0 || n_bytes > 2) {
+                LT_LOG_ERROR("ASN1 DER Parsing error: Unsupported length: %" PRIu8 " bytes", n_bytes);
+                return LT_CERT_UNSUPPORTED;
+            }
+            if (n_bytes > parent_end - pos) {
+                LT_LOG_ERROR("ASN1 DER Parsing error: Incomplete object at %" PRIu16, start);
+                return LT_CERT_STORE_INVALID;
+            }
+            obj_len = 0;
+            for (uint8_t i = 0; i < n_bytes; i++) {
+                obj_len = (obj_len << 8) | stream[pos++];
+            }
+        }
+
+        if (obj_len > parent_end - pos) {
+            LT_LOG_ERROR("ASN1 DER Parsing error: Object at %" PRIu16 " of length %" PRIu16 " exceeds its parent",
+                         start, obj_len);
+            return LT_CERT_STORE_INVALID;
+        }
+
+        if (idx->count >= max_count) {
+            LT_LOG_ERROR("ASN1 DER Parsing error: More than %" PRIu16 " objects", max_count);
+            return LT_CERT_UNSUPPORTED;
+        }
+
+        struct lt_asn1der_node_t *node = &nodes[idx->count];
+        node->offset = pos;
+        node->len = obj_len;
+        node->parent = parent;
+        node->tag = tag;
+        node->hdr_len = pos - start;
+
+        if (tag & LT_ASN1DER_CONSTRUCTED) {
+            parent = idx->count;
+        }
+        else {
+            pos += obj_len;
+        }
+        idx->count++;
+
+        // Close all objects ending here, their children were indexed.
+        while (parent != LT_ASN1DER_NO_PARENT && pos == index_node_end(idx, parent)) {
+            parent = nodes[parent].parent;
+        }
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t asn1der_index_child(const struct lt_asn1der_index_t *idx, uint16_t parent, uint16_t n, uint16_t *child)
+{
+    uint16_t i = 0;
+    uint16_t end = idx->len;
+
+    if (parent != LT_ASN1DER_NO_PARENT) {
+        if (parent >= idx->count) {
+            return LT_PARAM_ERR;
+        }
+        i = parent + 1;
+        end = index_node_end(idx, parent);
+    }
+
+    // Children follow the parent, the first node starting past its end is not a descendant.
+    for (; i < idx->count && idx->nodes[i].offset - idx->nodes[i].hdr_len < end; i++) {
+        if (idx->nodes[i].parent != parent) {
+            continue;
+        }
+        if (n == 0) {
+            *child = i;
+            return LT_OK;
+        }
+        n--;
+    }
+
+    return LT_CERT_ITEM_NOT_FOUND;
+}
+
+lt_ret_t asn1der_index_find_object(const struct lt_asn1der_index_t *idx, int32_t obj_id,
+                                   struct lt_asn1der_view_t *view)
+{
+    bool sample_next = false;
+
+    for (uint16_t i = 0; i < idx->count; i++) {
+        const struct lt_asn1der_node_t *node = &idx->nodes[i];
+
+        if (node->tag == LT_ASN1DER_OBJECT_IDENTIFIER && node->len >= 3) {
+            const uint8_t *b = &idx->stream[node->offset];
+            if ((((uint32_t)b[0]) << 16 | ((uint32_t)b[1]) << 8 | ((uint32_t)b[2])) == (uint32_t)obj_id) {
+                sample_next = true;
+            }
+        }
+        else if (sample_next && tag_sampleable(node->tag)) {
+            asn1der_index_value(idx, i, view);
+            return LT_OK;
+        }
+    }
+
+    return LT_CERT_ITEM_NOT_FOUND;
+}
+
+void asn1der_index_value(const struct lt_asn1der_index_t *idx, uint16_t node, struct lt_asn1der_view_t *view)
+{
+    view->data = &idx->stream[idx->nodes[node].offset];
+    view->len = idx->nodes[node].len;
+}
+
+void asn1der_index_encoding(const struct lt_asn1der_index_t *idx, uint16_t node, struct lt_asn1der_view_t *view)
+{
+    view->data = &idx->stream[idx->nodes[node].offset - idx->nodes[node].hdr_len];
+    view->len = idx->nodes[node].hdr_len + idx->nodes[node].len;
+}
+
+lt_ret_t asn1der_cert_field(const struct lt_asn1der_index_t *idx, enum lt_asn1der_cert_field_t field,
+                            struct lt_asn1der_view_t *view)
+{
+    uint16_t cert, tbs, node;
+    lt_ret_t ret = cert_child(idx, LT_ASN1DER_NO_PARENT, 0, LT_ASN1DER_SEQUENCE, &cert);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    switch (field) {
+        case LT_ASN1DER_CERT_SIG_ALG:
+            ret = cert_child(idx, cert, 1, LT_ASN1DER_SEQUENCE, &node);
+            if (ret == LT_OK) {
+                asn1der_index_value(idx, node, view);
+            }
+            return ret;
+
+        case LT_ASN1DER_CERT_SIGNATURE:
+            ret = cert_child(idx, cert, 2, LT_ASN1DER_STRING_BIT, &node);
+            if (ret != LT_OK) {
+                return ret;
+            }
+            return cert_bit_string(idx, node, view);
+
+        case LT_ASN1DER_CERT_TBS:
+        case LT_ASN1DER_CERT_SERIAL:
+        case LT_ASN1DER_CERT_ISSUER:
+        case LT_ASN1DER_CERT_VALIDITY:
+        case LT_ASN1DER_CERT_SUBJECT:
+        case LT_ASN1DER_CERT_PUBKEY:
+            break;
+
+        default:
+            return LT_PARAM_ERR;
+    }
+
+    ret = cert_child(idx, cert, 0, LT_ASN1DER_SEQUENCE, &tbs);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    if (field == LT_ASN1DER_CERT_TBS) {
+        asn1der_index_encoding(idx, tbs, view);
+        return LT_OK;
+    }
+
+    // The version is explicitly tagged [0] and omitted in v1 certificates.
+    uint16_t first = 0;
+    if (asn1der_index_child(idx, tbs, 0, &node) == LT_OK && idx->nodes[node].tag == 0xA0) {
+        first = 1;
+    }
+
+    switch (field) {
+        case LT_ASN1DER_CERT_SERIAL:
+            ret = cert_child(idx, tbs, first, LT_ASN1DER_INTEGER, &node);
+            if (ret == LT_OK) {
+                asn1der_index_value(idx, node, view);
+            }
+            return ret;
+
+        case LT_ASN1DER_CERT_ISSUER:
+        case LT_ASN1DER_CERT_SUBJECT:
+            ret = cert_child(idx, tbs, first + ((field == LT_ASN1DER_CERT_ISSUER) ? 2 : 4), LT_ASN1DER_SEQUENCE, &node);
+            if (ret == LT_OK) {
+                asn1der_index_encoding(idx, node, view);
+            }
+            return ret;
+
+        case LT_ASN1DER_CERT_VALIDITY:
+            ret = cert_child(idx, tbs, first + 3, LT_ASN1DER_SEQUENCE, &node);
+            if (ret == LT_OK) {
+                asn1der_index_value(idx, node, view);
+            }
+            return ret;
+
+        default:  // LT_ASN1DER_CERT_PUBKEY
+            ret = cert_child(idx, tbs, first + 5, LT_ASN1DER_SEQUENCE, &node);
+            if (ret != LT_OK) {
+                return ret;
+            }
+            ret = cert_child(idx, node, 1, LT_ASN1DER_STRING_BIT, &node);
+            if (ret != LT_OK) {
+                return ret;
+            }
+            return cert_bit_string(idx, node, view);
+    }
+}
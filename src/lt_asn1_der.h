@@ -55,6 +55,204 @@ typedef enum lt_asn1der_crop_kind_t { LT_ASN1DER_CROP_SUFFIX, LT_ASN1DER_CROP_PR
 lt_ret_t asn1der_find_object(const uint8_t *stream, uint16_t len, int32_t obj_id, uint8_t *buf, int buf_len,
                              enum lt_asn1der_crop_kind_t crop_kind) __attribute__((warn_unused_result));
 
+/** @brief Maximal nesting of SEQUENCEs supported by the streaming parser. */
+#define LT_ASN1DER_STREAM_DEPTH_MAX 8
+
+/**
+ * @brief State of the streaming ASN1 DER parser
+ *
+ * @details Does the same search as asn1der_find_object(), but the byte stream is passed in arbitrary chunks with
+ *          asn1der_stream_feed(), so it does not have to be held in memory as a whole. Fields are private to the
+ *          parser, except `found` and `past`, which can be read by the caller.
+ */
+typedef struct lt_asn1der_stream_t {
+    uint16_t len;                                /** Length of the whole byte stream */
+    uint16_t past;                               /** Number of bytes processed so far */
+    uint8_t state;                               /** Part of the current object expected next */
+    uint8_t tag;                                 /** Type of the current object */
+    uint8_t len_bytes;                           /** Remaining bytes of the long form length */
+    uint16_t obj_len;                            /** Length of the current object value */
+    uint16_t obj_past;                           /** Number of bytes of the current object value processed */
+    uint8_t obj_id[3];                           /** First 3 bytes of the current OBJECT_IDENTIFIER */
+    uint8_t depth;                               /** Number of open SEQUENCEs */
+    uint16_t ends[LT_ASN1DER_STREAM_DEPTH_MAX];  /** Offsets where the open SEQUENCEs end */
+    uint32_t obj_id_searched;                    /** Target OBJECT_IDENTIFIER (3-byte) to be searched */
+    uint8_t *sbuf;                               /** Buffer where to copy data after OBJECT_IDENTIFIER match */
+    int sbuf_len;                                /** Length of Buffer pointed to by sbuf */
+    enum lt_asn1der_crop_kind_t crop_kind;       /** How to treat objects larger than provided buffer */
+    bool sample_next;                            /** Next object of primitive type is the one to be sampled */
+    bool sampling;                               /** Current object is being sampled */
+    bool found;                                  /** Searched object was sampled, no more data are needed */
+} lt_asn1der_stream_t;
+
+/**
+ * @brief Initializes streaming search of an OBJECT in ASN1 DER encoded stream.
+ *
+ * @param s             Parser state
+ * @param len           Length of the whole byte stream (e.g. length of the certificate)
+ * @param obj_id        3-byte OBJECT_IDENTIFIER to be searched for
+ * @param buf           Buffer where to copy the found object value
+ * @param buf_len       Size of the buffer pointed to by "buf"
+ * @param crop_kind     Same as in asn1der_find_object()
+ */
+void asn1der_stream_init(struct lt_asn1der_stream_t *s, uint16_t len, int32_t obj_id, uint8_t *buf, int buf_len,
+                         enum lt_asn1der_crop_kind_t crop_kind);
+
+/**
+ * @brief Parses next chunk of the byte stream.
+ *
+ * @details Stops in the middle of the chunk once the searched object is sampled, `s->found` is set then and further
+ *          chunks are ignored.
+ *
+ * @param s             Parser state
+ * @param chunk         Next bytes of the stream
+ * @param chunk_len     Number of bytes in "chunk", must not exceed the rest of the stream
+ * @return lt_ret_t     LT_OK if the chunk was parsed successfully
+ *                      LT_CERT_STORE_INVALID if the stream does not contain valid ASN1 syntax
+ *                      LT_CERT_UNSUPPORTED if the ASN1 stream contains features unsupported by this parser
+ */
+lt_ret_t asn1der_stream_feed(struct lt_asn1der_stream_t *s, const uint8_t *chunk, uint16_t chunk_len)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Returns result of the streaming search.
+ *
+ * @param s             Parser state
+ * @return lt_ret_t     LT_OK if the object was found
+ *                      LT_CERT_STORE_INVALID if the stream ended in the middle of an object
+ *                      LT_CERT_ITEM_NOT_FOUND if the whole stream was parsed and the object was not found
+ */
+lt_ret_t asn1der_stream_finish(const struct lt_asn1der_stream_t *s) __attribute__((warn_unused_result));
+
+/** @brief Parent of the nodes at the top level of the indexed stream. */
+#define LT_ASN1DER_NO_PARENT 0xFFFF
+
+/** @brief Tag bit marking constructed objects (SEQUENCE, SET, context-specific [n] wrappers), which hold objects. */
+#define LT_ASN1DER_CONSTRUCTED 0x20
+
+/**
+ * @brief One object (TLV) of the stream indexed by asn1der_index_build()
+ */
+typedef struct lt_asn1der_node_t {
+    uint16_t offset;  /** Offset of the object value in the stream */
+    uint16_t len;     /** Length of the object value */
+    uint16_t parent;  /** Index of the enclosing constructed object, LT_ASN1DER_NO_PARENT at the top level */
+    uint8_t tag;      /** Type of the object */
+    uint8_t hdr_len;  /** Length of the tag and length bytes preceding the value */
+} lt_asn1der_node_t;
+
+/**
+ * @brief Index of all objects in ASN1 DER encoded stream
+ *
+ * @details Nodes are stored in the order of the objects in the stream, so children of a node follow it and precede
+ *          its next sibling. The stream is referenced, not copied, and must outlive the index.
+ */
+typedef struct lt_asn1der_index_t {
+    const uint8_t *stream;            /** Indexed byte stream */
+    uint16_t len;                     /** Length of the byte stream */
+    uint16_t count;                   /** Number of nodes in the index */
+    uint16_t max_count;               /** Capacity of the node array */
+    struct lt_asn1der_node_t *nodes;  /** Node array provided by the caller */
+} lt_asn1der_index_t;
+
+/**
+ * @brief Zero-copy view of a part of the indexed stream
+ */
+typedef struct lt_asn1der_view_t {
+    const uint8_t *data;  /** First byte, points into the indexed stream */
+    uint16_t len;         /** Number of bytes */
+} lt_asn1der_view_t;
+
+/**
+ * @brief Fields of X509 certificate accessible with asn1der_cert_field()
+ */
+typedef enum lt_asn1der_cert_field_t {
+    LT_ASN1DER_CERT_TBS,        /** Whole encoding of TBSCertificate, input of the signature */
+    LT_ASN1DER_CERT_SERIAL,     /** Value of the serial number INTEGER */
+    LT_ASN1DER_CERT_ISSUER,     /** Whole encoding of the issuer Name */
+    LT_ASN1DER_CERT_VALIDITY,   /** Value of the Validity SEQUENCE (notBefore and notAfter) */
+    LT_ASN1DER_CERT_SUBJECT,    /** Whole encoding of the subject Name */
+    LT_ASN1DER_CERT_PUBKEY,     /** Subject public key, without the unused bits byte of the BIT STRING */
+    LT_ASN1DER_CERT_SIG_ALG,    /** Value of the signatureAlgorithm SEQUENCE */
+    LT_ASN1DER_CERT_SIGNATURE,  /** Signature, without the unused bits byte of the BIT STRING */
+} lt_asn1der_cert_field_t;
+
+/**
+ * @brief Parses ASN1 DER encoded stream once and stores position of all its objects to the index.
+ *
+ * @details Objects with constructed tag are descended into, other objects are only indexed. Top level may hold
+ *          several objects, which must cover the whole stream.
+ *
+ * @param idx           Index to build
+ * @param stream        Byte stream to be parsed (e.g. X509 certificate)
+ * @param len           Length of the byte stream
+ * @param nodes         Array for the nodes, one per object in the stream
+ * @param max_count     Number of elements in "nodes"
+ * @return lt_ret_t     LT_OK if sucessfull
+ *                      LT_CERT_STORE_INVALID if the stream does not contain valid ASN1 syntax
+ *                      LT_CERT_UNSUPPORTED if the ASN1 stream contains features unsupported by this parser, or holds
+ *                      more than "max_count" objects
+ */
+lt_ret_t asn1der_index_build(struct lt_asn1der_index_t *idx, const uint8_t *stream, uint16_t len,
+                             struct lt_asn1der_node_t *nodes, uint16_t max_count) __attribute__((warn_unused_result));
+
+/**
+ * @brief Finds n-th child of an indexed object.
+ *
+ * @param idx           Built index
+ * @param parent        Index of the parent node, LT_ASN1DER_NO_PARENT for the top level
+ * @param n             Order of the child, starting from 0
+ * @param child         Index of the child node
+ * @return lt_ret_t     LT_OK if sucessfull
+ *                      LT_CERT_ITEM_NOT_FOUND if the parent has at most "n" children
+ *                      LT_PARAM_ERR if "parent" is not in the index
+ */
+lt_ret_t asn1der_index_child(const struct lt_asn1der_index_t *idx, uint16_t parent, uint16_t n, uint16_t *child)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Same search as asn1der_find_object(), but returns view of the whole found value instead of copying it.
+ *
+ * @param idx           Built index
+ * @param obj_id        3-byte OBJECT_IDENTIFIER to be searched for
+ * @param view          View of the value of the primitive object following the OBJECT_IDENTIFIER
+ * @return lt_ret_t     LT_OK if sucessfull
+ *                      LT_CERT_ITEM_NOT_FOUND if OBJECT_IDENTIFIER with "obj_id" value was not found!
+ */
+lt_ret_t asn1der_index_find_object(const struct lt_asn1der_index_t *idx, int32_t obj_id,
+                                   struct lt_asn1der_view_t *view) __attribute__((warn_unused_result));
+
+/**
+ * @brief Returns view of the value of an indexed object.
+ *
+ * @param idx           Built index
+ * @param node          Index of the node, must be lower than idx->count
+ * @param view          View of the value
+ */
+void asn1der_index_value(const struct lt_asn1der_index_t *idx, uint16_t node, struct lt_asn1der_view_t *view);
+
+/**
+ * @brief Returns view of the whole encoding (tag, length and value) of an indexed object.
+ *
+ * @param idx           Built index
+ * @param node          Index of the node, must be lower than idx->count
+ * @param view          View of the encoding
+ */
+void asn1der_index_encoding(const struct lt_asn1der_index_t *idx, uint16_t node, struct lt_asn1der_view_t *view);
+
+/**
+ * @brief Returns view of a field of X509 certificate indexed with asn1der_index_build().
+ *
+ * @param idx           Index of the certificate
+ * @param field         Field to be returned
+ * @param view          View of the field
+ * @return lt_ret_t     LT_OK if sucessfull
+ *                      LT_CERT_STORE_INVALID if the indexed stream does not have the structure of X509 certificate
+ *                      LT_PARAM_ERR if "field" is not known
+ */
+lt_ret_t asn1der_cert_field(const struct lt_asn1der_index_t *idx, enum lt_asn1der_cert_field_t field,
+                            struct lt_asn1der_view_t *view) __attribute__((warn_unused_result));
+
 #ifdef __cplusplus
 }
 #endif
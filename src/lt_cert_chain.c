@@ -0,0 +1,287 @@
+/**
+ * @file lt_cert_chain.c
+ * @brief Verification of TROPIC01's certificate chain
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see LICENSE.md in the root directory of this source tree.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "lt_asn1_der.h"
+#include "lt_ecdsa_p256.h"
+#include "lt_sha256.h"
+
+/** @brief Maximal number of ASN1 objects in one certificate of the chain. */
+#define LT_CERT_CHAIN_NODES_MAX 96
+
+LT_STATIC_ASSERT(LT_CERT_CHAIN_DIGEST_LEN == LT_SHA256_DIGEST_LENGTH)
+
+/** Value of AlgorithmIdentifier for ecdsa-with-SHA256, without parameters. */
+static const uint8_t alg_ecdsa_with_sha256[] = {0x06, 0x08, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x04, 0x03, 0x02};
+
+/**
+ * @brief Computes SHA-256 digest of the data.
+ *
+ * @param crypto_ctx  CAL context with initialized SHA-256 context
+ * @param data        Data to be hashed
+ * @param len         Length of the data
+ * @param digest      Digest (32B)
+ *
+ * @returns LT_OK if sucessfully, error code otherwise
+ */
+static lt_ret_t cert_chain_digest(void *crypto_ctx, const uint8_t *data, const uint16_t len, uint8_t *digest)
+{
+    lt_ret_t ret = lt_sha256_start(crypto_ctx);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_sha256_update(crypto_ctx, data, len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    return lt_sha256_finish(crypto_ctx, digest);
+}
+
+/**
+ * @brief Checks whether the digest of a verified certificate is in the cache.
+ *
+ * @param cache   Cache, can be NULL
+ * @param digest  Certificate digest
+ *
+ * @returns true if the certificate was already verified
+ */
+static bool cert_chain_cached(const lt_cert_chain_cache_t *cache, const uint8_t *digest)
+{
+    if (!cache) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < cache->count; i++) {
+        if (!memcmp(cache->digests[i], digest, LT_CERT_CHAIN_DIGEST_LEN)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Adds the digest of a verified certificate to the cache, replacing the oldest one when the cache is full.
+ *
+ * @param cache   Cache, can be NULL
+ * @param digest  Certificate digest
+ */
+static void cert_chain_cache_add(lt_cert_chain_cache_t *cache, const uint8_t *digest)
+{
+    if (!cache) {
+        return;
+    }
+
+    memcpy(cache->digests[cache->next], digest, LT_CERT_CHAIN_DIGEST_LEN);
+    cache->next = (cache->next + 1) % LT_CERT_CHAIN_CACHE_SIZE;
+    if (cache->count < LT_CERT_CHAIN_CACHE_SIZE) {
+        cache->count++;
+    }
+}
+
+/**
+ * @brief Decodes ECDSA-Sig-Value (SEQUENCE of INTEGERs r and s) to R || S.
+ *
+ * @param der        DER encoded signature
+ * @param signature  Signature as R || S (64B)
+ *
+ * @returns LT_OK if sucessfully, LT_CERT_STORE_INVALID if the signature is malformed
+ */
+static lt_ret_t cert_chain_signature(const struct lt_asn1der_view_t *der, uint8_t *signature)
+{
+    struct lt_asn1der_node_t nodes[3];
+    struct lt_asn1der_index_t idx;
+
+    lt_ret_t ret = asn1der_index_build(&idx, der->data, der->len, nodes, sizeof(nodes) / sizeof(nodes[0]));
+    if (ret != LT_OK || idx.count != 3 || nodes[0].tag != LT_ASN1DER_SEQUENCE || nodes[1].tag != LT_ASN1DER_INTEGER
+        || nodes[1].parent != 0 || nodes[2].tag != LT_ASN1DER_INTEGER || nodes[2].parent != 0) {
+        LT_LOG_ERROR("Malformed ECDSA signature");
+        return LT_CERT_STORE_INVALID;
+    }
+
+    memset(signature, 0, LT_ECDSA_P256_SIGNATURE_LEN);
+    for (uint16_t i = 1; i <= 2; i++) {
+        struct lt_asn1der_view_t view;
+        asn1der_index_value(&idx, i, &view);
+        // INTEGERs are signed, positive values starting with 1 bit are prefixed with zero.
+        while (view.len > 0 && view.data[0] == 0) {
+            view.data++;
+            view.len--;
+        }
+        if (view.len > LT_ECDSA_P256_SIGNATURE_LEN / 2) {
+            LT_LOG_ERROR("ECDSA signature value too long: %" PRIu16 " bytes", view.len);
+            return LT_CERT_STORE_INVALID;
+        }
+        memcpy(&signature[i * (LT_ECDSA_P256_SIGNATURE_LEN / 2) - view.len], view.data, view.len);
+    }
+
+    return LT_OK;
+}
+
+/**
+ * @brief Verifies that the certificate is issued and signed by the issuer.
+ *
+ * @param crypto_ctx  CAL context with initialized SHA-256 context
+ * @param cert        Certificate to be verified
+ * @param cert_len    Length of the certificate
+ * @param issuer      Issuer certificate
+ * @param issuer_len  Length of the issuer certificate
+ * @param nodes       Nodes for indexing the certificates
+ *
+ * @returns LT_OK if the certificate is valid, error code otherwise
+ */
+static lt_ret_t cert_chain_verify_pair(void *crypto_ctx, const uint8_t *cert, const uint16_t cert_len,
+                                       const uint8_t *issuer, const uint16_t issuer_len,
+                                       struct lt_asn1der_node_t *nodes)
+{
+    struct lt_asn1der_index_t idx;
+    struct lt_asn1der_view_t subject, pubkey, name, alg, tbs, sig_der;
+    uint8_t digest[LT_SHA256_DIGEST_LENGTH];
+    uint8_t signature[LT_ECDSA_P256_SIGNATURE_LEN];
+
+    // Views point into the certificates, so the nodes can be reused for the certificate being verified.
+    lt_ret_t ret = asn1der_index_build(&idx, issuer, issuer_len, nodes, LT_CERT_CHAIN_NODES_MAX);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = asn1der_cert_field(&idx, LT_ASN1DER_CERT_SUBJECT, &subject);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = asn1der_cert_field(&idx, LT_ASN1DER_CERT_PUBKEY, &pubkey);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    if (pubkey.len != LT_ECDSA_P256_PUBKEY_LEN || pubkey.data[0] != 0x04) {
+        LT_LOG_ERROR("Issuer key is not an uncompressed P-256 key");
+        return LT_CERT_UNSUPPORTED;
+    }
+
+    ret = asn1der_index_build(&idx, cert, cert_len, nodes, LT_CERT_CHAIN_NODES_MAX);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = asn1der_cert_field(&idx, LT_ASN1DER_CERT_ISSUER, &name);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    if (name.len != subject.len || memcmp(name.data, subject.data, name.len)) {
+        LT_LOG_ERROR("Certificate issuer does not match subject of the next certificate");
+        return LT_CERT_CHAIN_INVALID;
+    }
+    ret = asn1der_cert_field(&idx, LT_ASN1DER_CERT_SIG_ALG, &alg);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    if (alg.len != sizeof(alg_ecdsa_with_sha256) || memcmp(alg.data, alg_ecdsa_with_sha256, alg.len)) {
+        LT_LOG_ERROR("Unsupported signature algorithm, only ecdsa-with-SHA256 is supported");
+        return LT_CERT_UNSUPPORTED;
+    }
+    ret = asn1der_cert_field(&idx, LT_ASN1DER_CERT_TBS, &tbs);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = asn1der_cert_field(&idx, LT_ASN1DER_CERT_SIGNATURE, &sig_der);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = cert_chain_signature(&sig_der, signature);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = cert_chain_digest(crypto_ctx, tbs.data, tbs.len, digest);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    if (lt_ecdsa_p256_verify(pubkey.data, digest, signature) != LT_OK) {
+        LT_LOG_ERROR("Certificate signature is not valid");
+        return LT_CERT_CHAIN_INVALID;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_cert_chain_verify(lt_handle_t *h, const struct lt_cert_store_t *store, const uint8_t *root_cert,
+                              const uint16_t root_cert_len, lt_cert_chain_cache_t *cache)
+{
+    if (!h || !store || !root_cert) {
+        return LT_PARAM_ERR;
+    }
+    for (int i = 0; i < LT_NUM_CERTIFICATES; i++) {
+        if (!store->certs[i] || store->cert_len[i] > store->buf_len[i]) {
+            return LT_PARAM_ERR;
+        }
+    }
+    if (h->l3.ecdsa_sign_hashing) {
+        return LT_SHA256_BUSY;
+    }
+
+    const uint8_t *root = store->certs[LT_CERT_KIND_TROPIC_ROOT];
+    if (store->cert_len[LT_CERT_KIND_TROPIC_ROOT] != root_cert_len || memcmp(root, root_cert, root_cert_len)) {
+        LT_LOG_ERROR("Root certificate in the certificate store is not the trusted one");
+        return LT_CERT_CHAIN_INVALID;
+    }
+
+    struct lt_asn1der_node_t nodes[LT_CERT_CHAIN_NODES_MAX];
+    uint8_t digests[LT_NUM_CERTIFICATES][LT_SHA256_DIGEST_LENGTH];
+    lt_ret_t ret_unused;
+
+    lt_ret_t ret = lt_sha256_init(h->l3.crypto_ctx);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    for (int i = 0; i < LT_NUM_CERTIFICATES; i++) {
+        ret = cert_chain_digest(h->l3.crypto_ctx, store->certs[i], store->cert_len[i], digests[i]);
+        if (ret != LT_OK) {
+            goto sha256_cleanup;
+        }
+    }
+
+    if (cache) {
+        if (cache->count > LT_CERT_CHAIN_CACHE_SIZE || cache->next >= LT_CERT_CHAIN_CACHE_SIZE
+            || memcmp(cache->root_digest, digests[LT_CERT_KIND_TROPIC_ROOT], LT_CERT_CHAIN_DIGEST_LEN)) {
+            memset(cache, 0, sizeof(lt_cert_chain_cache_t));
+            memcpy(cache->root_digest, digests[LT_CERT_KIND_TROPIC_ROOT], LT_CERT_CHAIN_DIGEST_LEN);
+        }
+    }
+
+    // The chain is already verified from the lowest cached certificate up to the root.
+    int verified = LT_CERT_KIND_TROPIC_ROOT;
+    for (int i = LT_CERT_KIND_DEVICE; i < LT_CERT_KIND_TROPIC_ROOT; i++) {
+        if (cert_chain_cached(cache, digests[i])) {
+            verified = i;
+            break;
+        }
+    }
+
+    for (int i = verified - 1; i >= LT_CERT_KIND_DEVICE; i--) {
+        ret = cert_chain_verify_pair(h->l3.crypto_ctx, store->certs[i], store->cert_len[i], store->certs[i + 1],
+                                     store->cert_len[i + 1], nodes);
+        if (ret != LT_OK) {
+            LT_LOG_ERROR("Verification of certificate %d failed: %s", i, lt_ret_verbose(ret));
+            goto sha256_cleanup;
+        }
+        cert_chain_cache_add(cache, digests[i]);
+    }
+
+sha256_cleanup:
+    ret_unused = lt_sha256_deinit(h->l3.crypto_ctx);
+    LT_UNUSED(ret_unused);
+    return ret;
+}
@@ -9,12 +9,16 @@
  * @license For the license see LICENSE.md in the root directory of this source tree.
  */
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** @brief Initial value of the running CRC16, pass it to the first crc16_update() call. */
+#define LT_CRC16_INITIAL_VAL 0x0000
+
 /**
  * @brief Calculates CRC16 checksum on a buffer
  *
@@ -24,6 +28,27 @@ extern "C" {
  */
 uint16_t crc16(const uint8_t *buf, int16_t size) __attribute__((warn_unused_result));
 
+/**
+ * @brief Folds a buffer into a running CRC16
+ *
+ * @note Allows to compute the checksum of data that arrive in several segments:
+ *       crc16_finish(crc16_update(crc16_update(LT_CRC16_INITIAL_VAL, a, a_len), b, b_len)) equals crc16() of a and b.
+ *
+ * @param crc       Running CRC16 value (LT_CRC16_INITIAL_VAL for the first segment)
+ * @param buf       Buffer with data
+ * @param size      Length of data in buffer
+ * @return          Updated running CRC16 value
+ */
+uint16_t crc16_update(uint16_t crc, const uint8_t *buf, size_t size) __attribute__((warn_unused_result));
+
+/**
+ * @brief Converts running CRC16 into the checksum in the same form as returned by crc16()
+ *
+ * @param crc       Running CRC16 value
+ * @return          CRC16 checksum returned as uint16_t
+ */
+uint16_t crc16_finish(uint16_t crc) __attribute__((warn_unused_result));
+
 /**
  * @brief Takes pointer to filled l2 buffer and adds checksum
  *
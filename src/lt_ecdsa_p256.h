@@ -0,0 +1,45 @@
+#ifndef LT_ECDSA_P256_H
+#define LT_ECDSA_P256_H
+
+/**
+ * @file lt_ecdsa_p256.h
+ * @brief ECDSA on curve P-256 function declarations
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see LICENSE.md in the root directory of this source tree.
+ */
+
+#include <stdint.h>
+
+#include "libtropic_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Length of P-256 public key in uncompressed form (0x04 || X || Y). */
+#define LT_ECDSA_P256_PUBKEY_LEN 65
+/** @brief Length of P-256 signature (R || S). */
+#define LT_ECDSA_P256_SIGNATURE_LEN 64
+/** @brief Length of the signed digest. */
+#define LT_ECDSA_P256_DIGEST_LEN 32
+
+/**
+ * @brief Verifies ECDSA signature of a digest on curve P-256.
+ *
+ * @note Only used by lt_cert_chain_verify() and lt_merkle_proof_verify(), and compiled into the CAL only with
+ *       LT_ECDSA_P256_VERIFY. Without it, the crypto library does not have to support ECDSA P-256.
+ *
+ * @param pubkey     Public key in uncompressed form (65B)
+ * @param digest     Signed digest (32B)
+ * @param signature  Signature as R || S, both big-endian (64B)
+ * @return LT_OK if the signature is valid, otherwise returns other error code.
+ */
+lt_ret_t lt_ecdsa_p256_verify(const uint8_t *pubkey, const uint8_t *digest, const uint8_t *signature)
+    __attribute__((warn_unused_result));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LT_ECDSA_P256_H
@@ -16,6 +16,7 @@
 #include "libtropic_common.h"
 #include "libtropic_logging.h"
 #include "libtropic_macros.h"
+#include "lt_crc16.h"
 #include "lt_port_wrap.h"
 
 #ifdef LT_PRINT_SPI_DATA
@@ -38,7 +39,222 @@ static void print_hex_chunks(const uint8_t *data, uint8_t len, uint8_t dir)
 }
 #endif
 
-lt_ret_t lt_l1_read(lt_l2_state_t *s2, const uint32_t max_len, const uint32_t timeout_ms)
+#ifdef LT_ADAPTIVE_POLLING
+#if LT_USE_INT_PIN
+// Waiting for the INT pin does not count towards the polling budget, lt_l1_read() would not be time bounded.
+#error "LT_ADAPTIVE_POLLING cannot be used together with LT_USE_INT_PIN!"
+#endif
+
+/** Total time lt_l1_read() waits for a response, the same as with the fixed polling. */
+#define LT_L1_POLL_BUDGET_US ((uint32_t)LT_L1_READ_MAX_TRIES * LT_L1_READ_RETRY_DELAY * 1000)
+/** Fixed delay between polls in microseconds. */
+#define LT_L1_POLL_RETRY_DELAY_US ((uint32_t)LT_L1_READ_RETRY_DELAY * 1000)
+/** Number of measured responses needed before the learned processing time is used. */
+#define LT_L1_POLL_MIN_SAMPLES 2
+/** Minimal delay between two polls of CHIP_STATUS. */
+#define LT_L1_POLL_MIN_STEP_US 100u
+
+/** State of polling for one response. */
+typedef struct lt_l1_poll_t {
+    /** Model entry of the request, NULL if the request is not known. */
+    lt_poll_stat_t *stat;
+    /** Time when the polling started, valid only if the port provides monotonic time. */
+    uint64_t start_us;
+    bool start_valid;
+    /** Sum of delays so far. */
+    uint32_t waited_us;
+    /** Delay before the next poll. */
+    uint32_t step_us;
+} lt_l1_poll_t;
+
+static lt_poll_stat_t *lt_l1_poll_stat_get(lt_l2_state_t *s2, const uint16_t key)
+{
+    lt_poll_stat_t *victim = &s2->poll_model[0];
+
+    for (size_t i = 0; i < LT_POLL_MODEL_SIZE; i++) {
+        if (s2->poll_model[i].key == key) {
+            return &s2->poll_model[i];
+        }
+        if (s2->poll_model[i].samples < victim->samples) {
+            victim = &s2->poll_model[i];
+        }
+    }
+
+    // Request not tracked yet, replace the least measured entry.
+    memset(victim, 0, sizeof(*victim));
+    victim->key = key;
+
+    return victim;
+}
+
+static lt_ret_t lt_l1_poll_start(lt_l2_state_t *s2, lt_l1_poll_t *poll)
+{
+    poll->stat = NULL;
+    poll->waited_us = 0;
+    poll->step_us = LT_L1_POLL_RETRY_DELAY_US;
+    poll->start_valid = (lt_l1_get_time_us(s2, &poll->start_us) == LT_OK);
+
+    if (s2->poll_key) {
+        poll->stat = lt_l1_poll_stat_get(s2, s2->poll_key);
+        s2->poll_key = 0;
+    }
+
+    // Without enough history, poll immediately and then with the fixed delay.
+    if (!poll->stat || poll->stat->samples < LT_L1_POLL_MIN_SAMPLES) {
+        return LT_OK;
+    }
+
+    // First poll shortly before the response is expected, then densely around the expected time.
+    uint32_t mean_us = poll->stat->mean_us;
+    uint32_t dev_us = poll->stat->dev_us;
+    uint32_t first_us = mean_us > dev_us ? mean_us - dev_us : 0;
+
+    poll->step_us = lt_max(dev_us / 2, LT_L1_POLL_MIN_STEP_US);
+    poll->step_us = lt_min(poll->step_us, LT_L1_POLL_RETRY_DELAY_US);
+    poll->waited_us = lt_min(first_us, LT_L1_POLL_BUDGET_US / 2);
+    if (poll->waited_us == 0) {
+        return LT_OK;
+    }
+
+    return lt_l1_delay_us(s2, poll->waited_us);
+}
+
+static lt_ret_t lt_l1_poll_delay(lt_l2_state_t *s2, lt_l1_poll_t *poll)
+{
+    uint32_t delay_us = lt_min(poll->step_us, LT_L1_POLL_BUDGET_US - poll->waited_us);
+
+    poll->waited_us += delay_us;
+    // Response takes longer than expected, back off up to the fixed delay.
+    poll->step_us = lt_min(poll->step_us * 2, LT_L1_POLL_RETRY_DELAY_US);
+
+    return lt_l1_delay_us(s2, delay_us);
+}
+
+static void lt_l1_poll_finish(lt_l2_state_t *s2, lt_l1_poll_t *poll)
+{
+    lt_poll_stat_t *stat = poll->stat;
+    if (!stat) {
+        return;
+    }
+
+    // Measure the real time if possible, it includes also the SPI transfers.
+    uint32_t elapsed_us = poll->waited_us;
+    uint64_t now_us;
+    if (poll->start_valid && lt_l1_get_time_us(s2, &now_us) == LT_OK && now_us >= poll->start_us) {
+        elapsed_us = (uint32_t)lt_min(now_us - poll->start_us, (uint64_t)INT32_MAX);
+    }
+    int32_t sample_us = (int32_t)elapsed_us;
+
+    if (stat->samples == 0) {
+        stat->mean_us = sample_us;
+        stat->dev_us = sample_us / 2;
+    }
+    else {
+        // Same estimator as used for TCP retransmission timeout (RFC 6298), gains 1/8 and 1/4.
+        int32_t err_us = sample_us - (int32_t)stat->mean_us;
+        int32_t abs_err_us = err_us < 0 ? -err_us : err_us;
+        stat->mean_us = (uint32_t)((int32_t)stat->mean_us + err_us / 8);
+        stat->dev_us = (uint32_t)((int32_t)stat->dev_us + (abs_err_us - (int32_t)stat->dev_us) / 4);
+    }
+
+    if (stat->samples < UINT16_MAX) {
+        stat->samples++;
+    }
+}
+#endif
+
+/**
+ * @brief Reads CHIP_STATUS and L2 Response frame using lt_l1_spi_* functions, for ports without
+ * lt_port_frame_xfer(). The frame ends at the same points as described there.
+ *
+ * @param s2                 Structure holding l2 state
+ * @param rsp_data           Buffer for RSP_DATA, NULL to receive it into `s2->buff`
+ * @param rsp_data_max_len   Size of `rsp_data`
+ * @param rsp_data_received  Set to true if RSP_DATA was received into `rsp_data`
+ * @param timeout_ms         Timeout
+ * @return                   LT_OK if success, otherwise returns other error code.
+ */
+static lt_ret_t lt_l1_read_frame(lt_l2_state_t *s2, uint8_t *rsp_data, const uint16_t rsp_data_max_len,
+                                 bool *rsp_data_received, const uint32_t timeout_ms)
+{
+    lt_ret_t ret = lt_l1_spi_csn_low(s2);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    // Try to read CHIP_STATUS byte
+    ret = lt_l1_spi_transfer(s2, 0, 1, timeout_ms);
+    if (ret != LT_OK) {
+        lt_ret_t ret_unused = lt_l1_spi_csn_high(s2);
+        LT_UNUSED(ret_unused);  // We don't care about it, we return ret from SPI transfer anyway.
+        return ret;
+    }
+
+    // Response follows only if CHIP_STATUS contains READY bit and TROPIC01 is not in Alarm Mode
+    if ((s2->buff[0] & TR01_L1_CHIP_MODE_ALARM_bit) || !(s2->buff[0] & TR01_L1_CHIP_MODE_READY_bit)) {
+        return lt_l1_spi_csn_high(s2);
+    }
+
+    // receive STATUS byte and length byte
+    ret = lt_l1_spi_transfer(s2, 1, 2, timeout_ms);
+    if (ret != LT_OK) {  // offset 1
+        lt_ret_t ret_unused = lt_l1_spi_csn_high(s2);
+        LT_UNUSED(ret_unused);  // We don't care about it, we return ret from SPI transfer anyway.
+        return ret;
+    }
+
+    // 0xFF received in second byte means that chip has no response to send.
+    if (s2->buff[1] == 0xff) {
+        return lt_l1_spi_csn_high(s2);
+    }
+
+    // STATUS and RSP_LEN are the first bytes covered by the CRC.
+    s2->rsp_crc = crc16_update(LT_CRC16_INITIAL_VAL, s2->buff + 1, 2);
+
+    // Take length information and add 2B for crc bytes
+    uint16_t length = s2->buff[2] + 2;
+    if (length > (TR01_L1_LEN_MAX - 2)) {
+        lt_ret_t ret_unused = lt_l1_spi_csn_high(s2);
+        LT_UNUSED(ret_unused);  // We don't care about it, we return LT_L1_DATA_LEN_ERROR anyway.
+        return LT_L1_DATA_LEN_ERROR;
+    }
+    // Receive RSP_DATA directly into the given buffer, RSP_CRC then stays in the L1 buffer right behind RSP_LEN.
+    uint8_t offset = 3;
+    if (rsp_data && s2->buff[2] != 0 && s2->buff[2] <= rsp_data_max_len) {
+        ret = lt_l1_spi_transfer_into(s2, offset, rsp_data, s2->buff[2], timeout_ms);
+        if (ret == LT_OK) {
+            *rsp_data_received = true;
+            s2->rsp_crc = crc16_update(s2->rsp_crc, rsp_data, s2->buff[2]);
+            offset += s2->buff[2];
+            length = 2;
+        }
+        else if (ret != LT_NOT_SUPPORTED) {
+            lt_ret_t ret_unused = lt_l1_spi_csn_high(s2);
+            LT_UNUSED(ret_unused);  // We don't care about it, we return ret from SPI transfer anyway.
+            return ret;
+        }
+    }
+
+    // Receive the rest of incomming bytes, including crc
+    ret = lt_l1_spi_transfer(s2, offset, length, timeout_ms);
+    if (ret != LT_OK) {
+        lt_ret_t ret_unused = lt_l1_spi_csn_high(s2);
+        LT_UNUSED(ret_unused);  // We don't care about it, we return ret from SPI transfer anyway.
+        return ret;
+    }
+    // Fold RSP_DATA into the CRC, lt_l2_frame_check() then only compares it with the received one.
+    if (!*rsp_data_received) {
+        s2->rsp_crc = crc16_update(s2->rsp_crc, s2->buff + 3, s2->buff[2]);
+    }
+
+    return lt_l1_spi_csn_high(s2);
+}
+
+/**
+ * @brief Implementation of lt_l1_read() and lt_l1_read_into(), `rsp_data` is NULL for lt_l1_read().
+ */
+static lt_ret_t lt_l1_read_common(lt_l2_state_t *s2, const uint32_t max_len, uint8_t *rsp_data,
+                                  const uint16_t rsp_data_max_len, const uint32_t timeout_ms)
 {
 #ifdef LT_REDUNDANT_ARG_CHECK
     if (!s2) {
@@ -50,87 +266,87 @@ lt_ret_t lt_l1_read(lt_l2_state_t *s2, const uint32_t max_len, const uint32_t ti
     if ((max_len < TR01_L1_LEN_MIN) | (max_len > TR01_L1_LEN_MAX)) {
         return LT_PARAM_ERR;
     }
-#else
-    LT_UNUSED(max_len);
 #endif
 
     lt_ret_t ret;
+    const uint16_t frame_max_len = (uint16_t)lt_min(max_len, (uint32_t)TR01_L1_LEN_MAX);
+
+#ifdef LT_ADAPTIVE_POLLING
+    lt_l1_poll_t poll;
+    ret = lt_l1_poll_start(s2, &poll);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    // Polls are not equally spaced, so the total waiting time is limited instead of the number of tries.
+    while (poll.waited_us < LT_L1_POLL_BUDGET_US) {
+#else
     int max_tries = LT_L1_READ_MAX_TRIES;
 
     while (max_tries > 0) {
         max_tries--;
+#endif
 
         s2->buff[0] = TR01_L1_GET_RESPONSE_REQ_ID;
 
-        // Try to read CHIP_STATUS byte
-        ret = lt_l1_spi_csn_low(s2);
-        if (ret != LT_OK) {
-            return ret;
+        // Read the whole frame at once if the port supports it, otherwise by parts.
+        bool rsp_data_received = false;
+        ret = lt_l1_frame_xfer(s2, LT_PORT_FRAME_READ, frame_max_len, timeout_ms);
+        bool frame_xfer = (ret != LT_NOT_SUPPORTED);
+        if (!frame_xfer) {
+            ret = lt_l1_read_frame(s2, rsp_data, rsp_data_max_len, &rsp_data_received, timeout_ms);
         }
-
-        ret = lt_l1_spi_transfer(s2, 0, 1, timeout_ms);
         if (ret != LT_OK) {
-            lt_ret_t ret_unused = lt_l1_spi_csn_high(s2);
-            LT_UNUSED(ret_unused);  // We don't care about it, we return ret from SPI transfer anyway.
             return ret;
         }
 
         // Check ALARM bit of CHIP_STATUS byte
         if (s2->buff[0] & TR01_L1_CHIP_MODE_ALARM_bit) {
-            lt_ret_t ret_unused = lt_l1_spi_csn_high(s2);
             LT_LOG_DEBUG("CHIP_STATUS: 0x%02" PRIX8, s2->buff[0]);
 
 #ifdef LT_RETRIEVE_ALARM_LOG
-            ret_unused = lt_l1_retrieve_alarm_log(s2, timeout_ms);
+            lt_ret_t ret_unused = lt_l1_retrieve_alarm_log(s2, timeout_ms);
+            LT_UNUSED(ret_unused);  // We don't care about it, we return LT_L1_CHIP_ALARM_MODE anyway.
 #endif
 
-            LT_UNUSED(ret_unused);  // We don't care about it, we return LT_L1_CHIP_ALARM_MODE anyway.
             return LT_L1_CHIP_ALARM_MODE;
         }
 
         // Proceed further in case CHIP_STATUS contains READY bit, signalizing that chip is ready to receive request
         if (s2->buff[0] & TR01_L1_CHIP_MODE_READY_bit) {
-            // receive STATUS byte and length byte
-            ret = lt_l1_spi_transfer(s2, 1, 2, timeout_ms);
-            if (ret != LT_OK) {  // offset 1
-                lt_ret_t ret_unused = lt_l1_spi_csn_high(s2);
-                LT_UNUSED(ret_unused);  // We don't care about it, we return ret from SPI transfer anyway.
-                return ret;
-            }
-
             // 0xFF received in second byte means that chip has no response to send.
             if (s2->buff[1] == 0xff) {
-                ret = lt_l1_spi_csn_high(s2);
-                if (ret != LT_OK) {
-                    return ret;
-                }
+#ifdef LT_ADAPTIVE_POLLING
+                ret = lt_l1_poll_delay(s2, &poll);
+#else
                 ret = lt_l1_delay(s2, LT_L1_READ_RETRY_DELAY);
+#endif
                 if (ret != LT_OK) {
                     return ret;
                 }
                 continue;
             }
 
-            // Take length information and add 2B for crc bytes
-            uint16_t length = s2->buff[2] + 2;
-            if (length > (TR01_L1_LEN_MAX - 2)) {
-                lt_ret_t ret_unused = lt_l1_spi_csn_high(s2);
-                LT_UNUSED(ret_unused);  // We don't care about it, we return LT_L1_DATA_LEN_ERROR anyway.
-                return LT_L1_DATA_LEN_ERROR;
+            if (frame_xfer) {
+                // The frame was received at once, fold STATUS, RSP_LEN and RSP_DATA into the CRC now.
+                s2->rsp_crc = crc16_update(LT_CRC16_INITIAL_VAL, s2->buff + 1, s2->buff[2] + 2);
             }
-            // Receive the rest of incomming bytes, including crc
-            ret = lt_l1_spi_transfer(s2, 3, length, timeout_ms);
-            if (ret != LT_OK) {  // offset 3
-                lt_ret_t ret_unused = lt_l1_spi_csn_high(s2);
-                LT_UNUSED(ret_unused);  // We don't care about it, we return ret from SPI transfer anyway.
-                return ret;
+#ifdef LT_PRINT_SPI_DATA
+            if (rsp_data_received) {
+                print_hex_chunks(s2->buff, 3, LT_L1_SPI_DIR_MISO);
+                print_hex_chunks(rsp_data, s2->buff[2], LT_L1_SPI_DIR_MISO);
+                print_hex_chunks(s2->buff + 3 + s2->buff[2], 2, LT_L1_SPI_DIR_MISO);
             }
-            ret = lt_l1_spi_csn_high(s2);
-            if (ret != LT_OK) {
-                return ret;
+            else {
+                print_hex_chunks(s2->buff, s2->buff[2] + 5, LT_L1_SPI_DIR_MISO);
             }
-#ifdef LT_PRINT_SPI_DATA
-            print_hex_chunks(s2->buff, s2->buff[2] + 5, LT_L1_SPI_DIR_MISO);
+#endif
+            // The port could not receive RSP_DATA into the given buffer, copy it there.
+            if (rsp_data && !rsp_data_received && s2->buff[2] <= rsp_data_max_len) {
+                memcpy(rsp_data, s2->buff + 3, s2->buff[2]);
+            }
+#ifdef LT_ADAPTIVE_POLLING
+            lt_l1_poll_finish(s2, &poll);
 #endif
             return LT_OK;
 
@@ -138,14 +354,14 @@ lt_ret_t lt_l1_read(lt_l2_state_t *s2, const uint32_t max_len, const uint32_t ti
             // try it again (until max_tries runs out)
         }
         else {
-            ret = lt_l1_spi_csn_high(s2);
-            if (ret != LT_OK) {
-                return ret;
-            }
             if (s2->buff[0] & TR01_L1_CHIP_MODE_STARTUP_bit) {
                 // INT pin is not implemented in Start-up Mode
                 // So we wait a bit before we poll again for CHIP_STATUS
+#ifdef LT_ADAPTIVE_POLLING
+                ret = lt_l1_poll_delay(s2, &poll);
+#else
                 ret = lt_l1_delay(s2, LT_L1_READ_RETRY_DELAY);
+#endif
                 if (ret != LT_OK) {
                     return ret;
                 }
@@ -157,6 +373,12 @@ lt_ret_t lt_l1_read(lt_l2_state_t *s2, const uint32_t max_len, const uint32_t ti
                 if (ret != LT_OK) {
                     return ret;
                 }
+#elif defined(LT_ADAPTIVE_POLLING)
+                // INT pin not used, delay according to the learned processing time
+                ret = lt_l1_poll_delay(s2, &poll);
+                if (ret != LT_OK) {
+                    return ret;
+                }
 #else
                 // INT pin not used, delay for some time
                 ret = lt_l1_delay(s2, LT_L1_READ_RETRY_DELAY);
@@ -171,6 +393,22 @@ lt_ret_t lt_l1_read(lt_l2_state_t *s2, const uint32_t max_len, const uint32_t ti
     return LT_L1_CHIP_BUSY;
 }
 
+lt_ret_t lt_l1_read(lt_l2_state_t *s2, const uint32_t max_len, const uint32_t timeout_ms)
+{
+    return lt_l1_read_common(s2, max_len, NULL, 0, timeout_ms);
+}
+
+lt_ret_t lt_l1_read_into(lt_l2_state_t *s2, const uint32_t max_len, uint8_t *rsp_data, const uint16_t rsp_data_max_len,
+                         const uint32_t timeout_ms)
+{
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!rsp_data) {
+        return LT_PARAM_ERR;
+    }
+#endif
+    return lt_l1_read_common(s2, max_len, rsp_data, rsp_data_max_len, timeout_ms);
+}
+
 lt_ret_t lt_l1_write(lt_l2_state_t *s2, const uint16_t len, const uint32_t timeout_ms)
 {
 #ifdef LT_REDUNDANT_ARG_CHECK
@@ -187,13 +425,19 @@ lt_ret_t lt_l1_write(lt_l2_state_t *s2, const uint16_t len, const uint32_t timeo
 
     lt_ret_t ret;
 
+#ifdef LT_PRINT_SPI_DATA
+    print_hex_chunks(s2->buff, len, LT_L1_SPI_DIR_MOSI);
+#endif
+    // Write the whole frame at once if the port supports it.
+    ret = lt_l1_frame_xfer(s2, LT_PORT_FRAME_WRITE, len, timeout_ms);
+    if (ret != LT_NOT_SUPPORTED) {
+        return ret;
+    }
+
     ret = lt_l1_spi_csn_low(s2);
     if (ret != LT_OK) {
         return ret;
     }
-#ifdef LT_PRINT_SPI_DATA
-    print_hex_chunks(s2->buff, len, LT_L1_SPI_DIR_MOSI);
-#endif
     ret = lt_l1_spi_transfer(s2, 0, len, timeout_ms);
     if (ret != LT_OK) {
         lt_ret_t ret_unused = lt_l1_spi_csn_high(s2);
@@ -209,6 +453,51 @@ lt_ret_t lt_l1_write(lt_l2_state_t *s2, const uint16_t len, const uint32_t timeo
     return LT_OK;
 }
 
+lt_ret_t lt_l1_write_iov(lt_l2_state_t *s2, const lt_port_iov_t *iov, const uint8_t iov_cnt,
+                         const uint32_t timeout_ms)
+{
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!s2 || !iov) {
+        return LT_PARAM_ERR;
+    }
+    if ((timeout_ms < LT_L1_TIMEOUT_MS_MIN) | (timeout_ms > LT_L1_TIMEOUT_MS_MAX)) {
+        return LT_PARAM_ERR;
+    }
+#endif
+
+    uint16_t len = 0;
+    for (uint8_t i = 0; i < iov_cnt; i++) {
+        if (iov[i].len > TR01_L1_LEN_MAX - len) {
+            return LT_PARAM_ERR;
+        }
+        len += iov[i].len;
+    }
+    if (len < TR01_L1_LEN_MIN) {
+        return LT_PARAM_ERR;
+    }
+
+    lt_ret_t ret = lt_l1_spi_transfer_iov(s2, iov, iov_cnt, timeout_ms);
+    if (ret != LT_NOT_SUPPORTED) {
+#ifdef LT_PRINT_SPI_DATA
+        for (uint8_t i = 0; i < iov_cnt; i++) {
+            print_hex_chunks(iov[i].base, iov[i].len, LT_L1_SPI_DIR_MOSI);
+        }
+#endif
+        return ret;
+    }
+
+    // Port cannot gather the parts, copy them into the L1 buffer. They are printed by lt_l1_write() then.
+    uint16_t offset = 0;
+    for (uint8_t i = 0; i < iov_cnt; i++) {
+        if (iov[i].len != 0) {
+            memcpy(&s2->buff[offset], iov[i].base, iov[i].len);
+            offset += iov[i].len;
+        }
+    }
+
+    return lt_l1_write(s2, len, timeout_ms);
+}
+
 lt_ret_t lt_l1_retrieve_alarm_log(lt_l2_state_t *s2, const uint32_t timeout_ms)
 {
     LT_LOG_DEBUG("Retrieving alarm log from TROPIC01...");
@@ -17,6 +17,7 @@
  */
 
 #include "libtropic_common.h"
+#include "libtropic_port.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -55,6 +56,23 @@ extern "C" {
 lt_ret_t lt_l1_read(lt_l2_state_t *s2, const uint32_t max_len, const uint32_t timeout_ms)
     __attribute__((warn_unused_result));
 
+/**
+ * @brief Reads data from TROPIC01 into host platform, RSP_DATA of the L2 Response frame is stored into `rsp_data`.
+ *
+ * If RSP_LEN does not exceed `rsp_data_max_len`, RSP_DATA is received directly into `rsp_data` when the port
+ * supports it (otherwise it is copied there), and only CHIP_STATUS, STATUS, RSP_LEN and RSP_CRC are stored into
+ * `s2->buff`, at the same positions as by lt_l1_read(). Longer RSP_DATA is left in `s2->buff`.
+ *
+ * @param s2                Structure holding l2 state
+ * @param max_len           Max len of receive buffer
+ * @param rsp_data          Buffer for RSP_DATA
+ * @param rsp_data_max_len  Size of `rsp_data`
+ * @param timeout_ms        Timeout - how long function will wait for response
+ * @return                  LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_l1_read_into(lt_l2_state_t *s2, const uint32_t max_len, uint8_t *rsp_data, const uint16_t rsp_data_max_len,
+                         const uint32_t timeout_ms) __attribute__((warn_unused_result));
+
 /**
  * @brief Writes data from host platform into TROPIC01
  *
@@ -66,6 +84,19 @@ lt_ret_t lt_l1_read(lt_l2_state_t *s2, const uint32_t max_len, const uint32_t ti
 lt_ret_t lt_l1_write(lt_l2_state_t *s2, const uint16_t len, const uint32_t timeout_ms)
     __attribute__((warn_unused_result));
 
+/**
+ * @brief Writes frame gathered from several buffers from host platform into TROPIC01. If the port does not support
+ * gathered transfers, the parts are copied into `s2->buff` and written with lt_l1_write().
+ *
+ * @param s2          Structure holding l2 state
+ * @param iov         Parts of the frame
+ * @param iov_cnt     Number of parts
+ * @param timeout_ms  Timeout
+ * @return            LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_l1_write_iov(lt_l2_state_t *s2, const lt_port_iov_t *iov, const uint8_t iov_cnt,
+                         const uint32_t timeout_ms) __attribute__((warn_unused_result));
+
 /**
  * @brief Retrieves alarm log from TROPIC01.
  *
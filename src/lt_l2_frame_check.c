@@ -11,13 +11,15 @@
 #include "libtropic_common.h"
 #include "lt_crc16.h"
 
-lt_ret_t lt_l2_frame_check(const uint8_t *frame)
+lt_ret_t lt_l2_frame_check(const lt_l2_state_t *s2)
 {
 #ifdef LT_REDUNDANT_ARG_CHECK
-    if (!frame) {
+    if (!s2) {
         return LT_PARAM_ERR;
     }
 #endif
+    const uint8_t *frame = s2->buff;
+
     // Take status, len and crc values from incomming frame
     uint8_t status = frame[1];
     uint8_t len = frame[2];
@@ -27,7 +29,8 @@ lt_ret_t lt_l2_frame_check(const uint8_t *frame)
         // Valid frames, or crc errors in INCOMMING frames are handled here:
         case TR01_L2_STATUS_REQUEST_OK:
         case TR01_L2_STATUS_RESULT_OK:
-            if (frame_crc != crc16(frame + 1, len + 2)) {
+            // CRC of the received frame was already computed by lt_l1_read().
+            if (frame_crc != crc16_finish(s2->rsp_crc)) {
                 return LT_L2_IN_CRC_ERR;
             }
             return LT_OK;
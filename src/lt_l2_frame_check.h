@@ -53,10 +53,12 @@ extern "C" {
 /**
  * @brief Checks if incomming L2 frame is valid
  *
- * @param             frame
+ * @note Frame must be received with lt_l1_read(), which computes its CRC into `s2->rsp_crc`.
+ *
+ * @param s2          Structure holding l2 state with the received frame
  * @return            LT_OK if success, otherwise returns other error code.
  */
-lt_ret_t lt_l2_frame_check(const uint8_t *frame) __attribute__((warn_unused_result));
+lt_ret_t lt_l2_frame_check(const lt_l2_state_t *s2) __attribute__((warn_unused_result));
 
 /** @} */  // end of group_l2_frame_check_functions
 
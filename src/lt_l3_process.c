@@ -16,6 +16,7 @@
 #include "libtropic_common.h"
 #include "libtropic_l2.h"
 #include "libtropic_logging.h"
+#include "libtropic_macros.h"
 #include "lt_aesgcm.h"
 #include "lt_crypto_common.h"
 #include "lt_l1.h"
@@ -47,6 +48,7 @@ static lt_ret_t lt_l3_nonce_increase(uint8_t *nonce)
 void lt_l3_invalidate_host_session_data(lt_l3_state_t *s3)
 {
     s3->session_status = LT_SECURE_SESSION_OFF;
+    s3->res_decryption_status = LT_L3_RES_DECRYPTION_NONE;
 
     lt_secure_memzero(s3->encryption_IV, sizeof(s3->encryption_IV));
     lt_secure_memzero(s3->decryption_IV, sizeof(s3->decryption_IV));
@@ -85,7 +87,7 @@ lt_ret_t lt_l3_encrypt_request(lt_l3_state_t *s3)
     return lt_l3_nonce_increase(s3->encryption_IV);
 }
 
-lt_ret_t lt_l3_decrypt_response(lt_l3_state_t *s3)
+lt_ret_t lt_l3_encrypt_request_start(lt_l3_state_t *s3)
 {
 #ifdef LT_REDUNDANT_ARG_CHECK
     if (!s3) {
@@ -93,27 +95,441 @@ lt_ret_t lt_l3_decrypt_response(lt_l3_state_t *s3)
     }
 #endif
 
-    struct lt_l3_gen_frame_t *p_frame = (struct lt_l3_gen_frame_t *)s3->buff;
+    lt_ret_t ret = lt_aesgcm_encrypt_start(s3->crypto_ctx, s3->encryption_IV, TR01_L3_IV_SIZE, (uint8_t *)"", 0);
+    if (ret == LT_NOT_SUPPORTED) {
+        return ret;
+    }
+    if (ret != LT_OK) {
+        lt_l3_invalidate_host_session_data(s3);
+        return ret;
+    }
 
-    if (p_frame->cmd_size > TR01_L3_RES_CIPHERTEXT_MAX_SIZE) {
+    // The IV is used from now on, so it is never reused even if the L3 Command is not finished.
+    return lt_l3_nonce_increase(s3->encryption_IV);
+}
+
+lt_ret_t lt_l3_encrypt_request_part(lt_l3_state_t *s3, uint8_t *packet, const uint16_t offset, const uint16_t len)
+{
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!s3 || !packet) {
+        return LT_PARAM_ERR;
+    }
+#endif
+
+    // Secure Session might have been aborted since the encryption was started.
+    if (s3->session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+
+    const struct lt_l3_gen_frame_t *p_frame = (const struct lt_l3_gen_frame_t *)packet;
+    const uint32_t data_end = TR01_L3_SIZE_SIZE + p_frame->cmd_size;
+    const uint32_t part_end = (uint32_t)offset + len;
+
+    // Only the ciphertext part of the L3 packet is encrypted, CMD_SIZE is sent as is.
+    uint32_t start = offset > TR01_L3_SIZE_SIZE ? offset : TR01_L3_SIZE_SIZE;
+    uint32_t end = part_end < data_end ? part_end : data_end;
+    lt_ret_t ret = LT_OK;
+    if (start < end) {
+        ret = lt_aesgcm_encrypt_update(s3->crypto_ctx, packet + start, packet + start, end - start);
+    }
+
+    // The tag right follows the ciphertext, so it is computed once its first byte is part of the sent data.
+    if (ret == LT_OK && offset <= data_end && part_end > data_end) {
+        ret = lt_aesgcm_encrypt_finish(s3->crypto_ctx, packet + data_end, TR01_L3_TAG_SIZE);
+    }
+
+    if (ret != LT_OK) {
         lt_l3_invalidate_host_session_data(s3);
-        return LT_L3_RES_SIZE_ERROR;
     }
 
-    // This check makes sure the decryption function does not go past buffer bounds.
-    if (TR01_L3_SIZE_SIZE + p_frame->cmd_size + TR01_L3_TAG_SIZE > s3->buff_len) {
+    return ret;
+}
+
+lt_ret_t lt_l3_decrypt_response_part(lt_l3_state_t *s3, uint8_t *packet, const uint16_t offset, const uint16_t len)
+{
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!s3 || !packet) {
+        return LT_PARAM_ERR;
+    }
+#endif
+
+    if (offset == 0) {
+        s3->res_decryption_status = LT_L3_RES_DECRYPTION_NONE;
+    }
+
+    // L3 Result received elsewhere or already decided to be decrypted as a whole is left to lt_l3_decrypt_response().
+    if (packet != s3->buff || s3->res_decryption_status == LT_L3_RES_DECRYPTION_SKIPPED
+        || s3->res_decryption_status == LT_L3_RES_DECRYPTION_DONE) {
+        return LT_OK;
+    }
+
+    const uint32_t part_end = (uint32_t)offset + len;
+    const struct lt_l3_gen_frame_t *p_frame = (const struct lt_l3_gen_frame_t *)packet;
+
+    if (s3->res_decryption_status == LT_L3_RES_DECRYPTION_NONE) {
+        // Wait for the whole RES_SIZE.
+        if (part_end < TR01_L3_SIZE_SIZE) {
+            return LT_OK;
+        }
+
+        // Invalid sizes are reported by lt_l3_decrypt_response().
+        if (s3->session_status != LT_SECURE_SESSION_ON || p_frame->cmd_size > TR01_L3_RES_CIPHERTEXT_MAX_SIZE
+            || TR01_L3_SIZE_SIZE + p_frame->cmd_size + TR01_L3_TAG_SIZE > s3->buff_len) {
+            s3->res_decryption_status = LT_L3_RES_DECRYPTION_SKIPPED;
+            return LT_OK;
+        }
+
+        lt_ret_t ret = lt_aesgcm_decrypt_start(s3->crypto_ctx, s3->decryption_IV, TR01_L3_IV_SIZE, (uint8_t *)"", 0);
+        if (ret == LT_NOT_SUPPORTED) {
+            s3->res_decryption_status = LT_L3_RES_DECRYPTION_SKIPPED;
+            return LT_OK;
+        }
+        if (ret != LT_OK) {
+            lt_l3_invalidate_host_session_data(s3);
+            return ret;
+        }
+        s3->res_decryption_status = LT_L3_RES_DECRYPTION_STARTED;
+    }
+
+    const uint32_t data_end = TR01_L3_SIZE_SIZE + p_frame->cmd_size;
+
+    // Only the ciphertext part of the L3 packet is decrypted, RES_SIZE is received as is.
+    uint32_t start = offset > TR01_L3_SIZE_SIZE ? offset : TR01_L3_SIZE_SIZE;
+    uint32_t end = part_end < data_end ? part_end : data_end;
+    lt_ret_t ret = LT_OK;
+    if (start < end) {
+        ret = lt_aesgcm_decrypt_update(s3->crypto_ctx, packet + start, packet + start, end - start);
+    }
+
+    // The tag is verified once it was received completely.
+    if (ret == LT_OK && part_end >= data_end + TR01_L3_TAG_SIZE) {
+        ret = lt_aesgcm_decrypt_finish(s3->crypto_ctx, packet + data_end, TR01_L3_TAG_SIZE);
+        if (ret == LT_OK) {
+            s3->res_decryption_status = LT_L3_RES_DECRYPTION_DONE;
+        }
+    }
+
+    if (ret != LT_OK) {
+        lt_l3_invalidate_host_session_data(s3);
+    }
+
+    return ret;
+}
+
+void lt_l3_res_decryption_abort(lt_l3_state_t *s3)
+{
+    if (s3->res_decryption_status != LT_L3_RES_DECRYPTION_STARTED) {
+        return;
+    }
+
+    lt_secure_memzero(s3->buff, s3->buff_len);
+    s3->res_decryption_status = LT_L3_RES_DECRYPTION_NONE;
+
+    if (lt_aesgcm_decrypt_abort(s3->crypto_ctx) != LT_OK) {
+        // The CAL state is unknown now, so the session cannot continue.
         lt_l3_invalidate_host_session_data(s3);
-        return LT_L3_BUFFER_TOO_SMALL;
     }
+}
+
+void lt_l3_cmd_payload_set(lt_l3_state_t *s3, const uint16_t offset, const uint8_t *payload, const uint16_t len)
+{
+#if LT_L3_STREAMING
+    // Payload which does not fit into the L3 buffer together with the tag is sent right from the caller's buffer.
+    if ((uint32_t)offset + len + TR01_L3_TAG_SIZE > s3->buff_len) {
+        s3->cmd_payload = payload;
+        s3->cmd_payload_offset = offset;
+        return;
+    }
+    s3->cmd_payload = NULL;
+#endif
+    memcpy(s3->buff + offset, payload, len);
+}
+
+#if LT_L3_STREAMING
+/**
+ * @brief Returns whether the payload of the L3 Result might not fit into L3 buffer and has to be streamed.
+ */
+static bool lt_l3_res_payload_streamed(const lt_l3_state_t *s3, const uint16_t offset, const uint16_t max_len)
+{
+    return (uint32_t)offset + max_len + TR01_L3_TAG_SIZE > s3->buff_len;
+}
+#endif
+
+void lt_l3_res_payload_expect(lt_l3_state_t *s3, const uint16_t offset, const uint16_t max_len)
+{
+#if LT_L3_STREAMING
+    s3->res_payload = NULL;
+    s3->res_payload_offset = lt_l3_res_payload_streamed(s3, offset, max_len) ? offset : 0;
+#else
+    LT_UNUSED(s3);
+    LT_UNUSED(offset);
+    LT_UNUSED(max_len);
+#endif
+}
+
+lt_ret_t lt_l3_res_payload_check(lt_l3_state_t *s3, const uint16_t offset, const uint16_t max_len)
+{
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!s3) {
+        return LT_PARAM_ERR;
+    }
+#endif
+
+#if LT_L3_STREAMING
+    if (!lt_l3_res_payload_streamed(s3, offset, max_len)) {
+        return LT_OK;
+    }
+
+    return lt_aesgcm_streaming_supported() ? LT_OK : LT_NOT_SUPPORTED;
+#else
+    LT_UNUSED(s3);
+    LT_UNUSED(offset);
+    LT_UNUSED(max_len);
+
+    return LT_OK;
+#endif
+}
 
-    lt_ret_t ret
-        = lt_aesgcm_decrypt(s3->crypto_ctx, s3->decryption_IV, TR01_L3_IV_SIZE, (uint8_t *)"", 0, p_frame->data,
-                            p_frame->cmd_size + TR01_L3_TAG_SIZE, p_frame->data, p_frame->cmd_size);
+lt_ret_t lt_l3_res_payload_copy(const lt_l3_state_t *s3, uint8_t *dest, const uint16_t offset, const uint16_t len)
+{
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!s3 || !dest) {
+        return LT_PARAM_ERR;
+    }
+#endif
+
+#if LT_L3_STREAMING
+    if (s3->res_payload) {
+        // Bytes not fitting into the caller's buffer were dropped while received.
+        if (len > s3->res_payload_max_len) {
+            return LT_L3_BUFFER_TOO_SMALL;
+        }
+        if (dest != s3->res_payload) {
+            memcpy(dest, s3->res_payload, len);
+        }
+        return LT_OK;
+    }
+#endif
+    memcpy(dest, s3->buff + offset, len);
+
+    return LT_OK;
+}
+
+#if LT_L3_STREAMING
+/**
+ * @brief Intersects part [start, end) of an L3 packet with its region [lo, hi).
+ *
+ * @param from        Start of the intersection
+ * @return            Length of the intersection, 0 if they do not intersect
+ */
+static uint32_t lt_l3_overlap(const uint32_t start, const uint32_t end, const uint32_t lo, const uint32_t hi,
+                              uint32_t *from)
+{
+    *from = start > lo ? start : lo;
+    uint32_t to = end < hi ? end : hi;
+
+    return *from < to ? to - *from : 0;
+}
+
+lt_ret_t lt_l3_encrypt_request_chunk(lt_l3_state_t *s3, uint8_t *chunk, const uint16_t offset, const uint16_t len)
+{
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!s3 || !chunk || !s3->cmd_payload) {
+        return LT_PARAM_ERR;
+    }
+#endif
+
+    // Secure Session might have been aborted since the encryption was started.
+    if (s3->session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+
+    const struct lt_l3_gen_frame_t *p_frame = (const struct lt_l3_gen_frame_t *)s3->buff;
+    const uint32_t payload_start = s3->cmd_payload_offset;
+    const uint32_t data_end = TR01_L3_SIZE_SIZE + p_frame->cmd_size;
+    const uint32_t end = (uint32_t)offset + len;
+    // The tag is computed into the L3 buffer right after the fields preceding the payload.
+    uint8_t *tag = s3->buff + payload_start;
+    uint32_t from, n;
+
+    n = lt_l3_overlap(offset, end, 0, payload_start, &from);
+    if (n) {
+        memcpy(chunk + from - offset, s3->buff + from, n);
+    }
+    n = lt_l3_overlap(offset, end, payload_start, data_end, &from);
+    if (n) {
+        memcpy(chunk + from - offset, s3->cmd_payload + from - payload_start, n);
+    }
+
+    // Only the ciphertext part of the L3 packet is encrypted, CMD_SIZE is sent as is.
+    lt_ret_t ret = LT_OK;
+    n = lt_l3_overlap(offset, end, TR01_L3_SIZE_SIZE, data_end, &from);
+    if (n) {
+        ret = lt_aesgcm_encrypt_update(s3->crypto_ctx, chunk + from - offset, chunk + from - offset, n);
+    }
+    if (ret == LT_OK && offset <= data_end && end > data_end) {
+        ret = lt_aesgcm_encrypt_finish(s3->crypto_ctx, tag, TR01_L3_TAG_SIZE);
+    }
     if (ret != LT_OK) {
         lt_l3_invalidate_host_session_data(s3);
         return ret;
     }
 
+    n = lt_l3_overlap(offset, end, data_end, data_end + TR01_L3_TAG_SIZE, &from);
+    if (n) {
+        memcpy(chunk + from - offset, tag + from - data_end, n);
+    }
+
+    return LT_OK;
+}
+
+void lt_l3_res_stream_discard(lt_l3_state_t *s3)
+{
+    if (s3->res_decryption_status == LT_L3_RES_DECRYPTION_STARTED) {
+        lt_secure_memzero(s3->res_payload, lt_min(s3->res_payload_len, s3->res_payload_max_len));
+        s3->res_decryption_status = LT_L3_RES_DECRYPTION_NONE;
+    }
+}
+
+/**
+ * @brief Invalidates host's session data including the payload streamed into the caller's buffer.
+ *
+ * @param s3          Structure holding l3 state
+ */
+static void lt_l3_res_stream_abort(lt_l3_state_t *s3)
+{
+    lt_l3_res_stream_discard(s3);
+    lt_l3_invalidate_host_session_data(s3);
+}
+
+lt_ret_t lt_l3_decrypt_response_chunk(lt_l3_state_t *s3, uint8_t *chunk, const uint16_t offset, const uint16_t len)
+{
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!s3 || !chunk || !s3->res_payload) {
+        return LT_PARAM_ERR;
+    }
+#endif
+
+    if (s3->session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+
+    struct lt_l3_gen_frame_t *p_frame = (struct lt_l3_gen_frame_t *)s3->buff;
+    const uint32_t payload_start = s3->res_payload_offset;
+    const uint32_t end = (uint32_t)offset + len;
+    lt_ret_t ret;
+
+    if (offset == 0) {
+        s3->res_decryption_status = LT_L3_RES_DECRYPTION_NONE;
+        if (len < TR01_L3_SIZE_SIZE) {
+            lt_l3_invalidate_host_session_data(s3);
+            return LT_L3_RES_SIZE_ERROR;
+        }
+        p_frame->cmd_size = (uint16_t)(chunk[0] | (chunk[1] << 8));
+        if (p_frame->cmd_size > TR01_L3_RES_CIPHERTEXT_MAX_SIZE) {
+            lt_l3_invalidate_host_session_data(s3);
+            return LT_L3_RES_SIZE_ERROR;
+        }
+        const uint32_t data_end = TR01_L3_SIZE_SIZE + p_frame->cmd_size;
+        s3->res_payload_len = data_end > payload_start ? data_end - payload_start : 0;
+
+        ret = lt_aesgcm_decrypt_start(s3->crypto_ctx, s3->decryption_IV, TR01_L3_IV_SIZE, (uint8_t *)"", 0);
+        if (ret != LT_OK) {
+            lt_l3_invalidate_host_session_data(s3);
+            return ret;
+        }
+        s3->res_decryption_status = LT_L3_RES_DECRYPTION_STARTED;
+    }
+    else if (s3->res_decryption_status != LT_L3_RES_DECRYPTION_STARTED) {
+        // More data than RES_SIZE announced.
+        lt_l3_res_stream_abort(s3);
+        return LT_L3_RES_SIZE_ERROR;
+    }
+
+    const uint32_t data_end = TR01_L3_SIZE_SIZE + p_frame->cmd_size;
+    // Fields preceding the payload are kept in the L3 buffer, followed by the tag.
+    const uint32_t fields_end = data_end - s3->res_payload_len;
+    uint8_t *tag = s3->buff + fields_end;
+    uint32_t from, n;
+
+    // The chunk is decrypted in place and then scattered, only the ciphertext part of the L3 packet is decrypted.
+    n = lt_l3_overlap(offset, end, TR01_L3_SIZE_SIZE, data_end, &from);
+    if (n) {
+        ret = lt_aesgcm_decrypt_update(s3->crypto_ctx, chunk + from - offset, chunk + from - offset, n);
+        if (ret != LT_OK) {
+            lt_l3_res_stream_abort(s3);
+            return ret;
+        }
+    }
+
+    n = lt_l3_overlap(offset, end, 0, fields_end, &from);
+    if (n) {
+        memcpy(s3->buff + from, chunk + from - offset, n);
+    }
+    // Bytes of the payload not fitting into the caller's buffer are dropped, lt_in__*() reports it.
+    n = lt_l3_overlap(offset, end, fields_end, lt_min(data_end, payload_start + s3->res_payload_max_len), &from);
+    if (n) {
+        memcpy(s3->res_payload + from - payload_start, chunk + from - offset, n);
+    }
+    n = lt_l3_overlap(offset, end, data_end, data_end + TR01_L3_TAG_SIZE, &from);
+    if (n) {
+        memcpy(tag + from - data_end, chunk + from - offset, n);
+    }
+
+    if (end >= data_end + TR01_L3_TAG_SIZE) {
+        ret = lt_aesgcm_decrypt_finish(s3->crypto_ctx, tag, TR01_L3_TAG_SIZE);
+        if (ret != LT_OK) {
+            lt_l3_res_stream_abort(s3);
+            return ret;
+        }
+        s3->res_decryption_status = LT_L3_RES_DECRYPTION_DONE;
+    }
+
+    return LT_OK;
+}
+#endif
+
+lt_ret_t lt_l3_decrypt_response(lt_l3_state_t *s3)
+{
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!s3) {
+        return LT_PARAM_ERR;
+    }
+#endif
+
+    struct lt_l3_gen_frame_t *p_frame = (struct lt_l3_gen_frame_t *)s3->buff;
+
+    if (p_frame->cmd_size > TR01_L3_RES_CIPHERTEXT_MAX_SIZE) {
+        lt_l3_invalidate_host_session_data(s3);
+        return LT_L3_RES_SIZE_ERROR;
+    }
+
+    lt_ret_t ret;
+    switch (s3->res_decryption_status) {
+        case LT_L3_RES_DECRYPTION_DONE:
+            // Already decrypted and authenticated while it was received.
+            break;
+        case LT_L3_RES_DECRYPTION_STARTED:
+            // The tag was not received.
+            lt_l3_invalidate_host_session_data(s3);
+            return LT_L3_RES_SIZE_ERROR;
+        default:
+            // This check makes sure the decryption function does not go past buffer bounds.
+            if (TR01_L3_SIZE_SIZE + p_frame->cmd_size + TR01_L3_TAG_SIZE > s3->buff_len) {
+                lt_l3_invalidate_host_session_data(s3);
+                return LT_L3_BUFFER_TOO_SMALL;
+            }
+            ret = lt_aesgcm_decrypt(s3->crypto_ctx, s3->decryption_IV, TR01_L3_IV_SIZE, (uint8_t *)"", 0,
+                                    p_frame->data, p_frame->cmd_size + TR01_L3_TAG_SIZE, p_frame->data,
+                                    p_frame->cmd_size);
+            if (ret != LT_OK) {
+                lt_l3_invalidate_host_session_data(s3);
+                return ret;
+            }
+            break;
+    }
+    s3->res_decryption_status = LT_L3_RES_DECRYPTION_NONE;
+
     ret = lt_l3_nonce_increase(s3->decryption_IV);
     if (LT_OK != ret) {
         return ret;
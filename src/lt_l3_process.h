@@ -71,6 +71,160 @@ extern "C" {
  */
 lt_ret_t lt_l3_encrypt_request(lt_l3_state_t *s3) __attribute__((warn_unused_result));
 
+/**
+ * @brief Starts encryption of the L3 Command in L3 buffer, which is then encrypted in parts right before they are sent.
+ * @note The parts are encrypted by `lt_l3_encrypt_request_part()`, the IV is consumed by this function already.
+ *
+ * @param s3          Structure holding l3 state
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_NOT_SUPPORTED The CAL cannot encrypt in parts, `lt_l3_encrypt_request()` has to be used instead
+ * @retval            other Function did not execute successully
+ */
+lt_ret_t lt_l3_encrypt_request_start(lt_l3_state_t *s3) __attribute__((warn_unused_result));
+
+/**
+ * @brief Encrypts a part of the L3 packet started by `lt_l3_encrypt_request_start()` in place.
+ * @note Parts must follow each other from the start of the packet. The tag is computed by the part which contains
+ *       its first byte.
+ *
+ * @param s3          Structure holding l3 state
+ * @param packet      L3 packet whose encryption was started (L3 buffer)
+ * @param offset      Offset of the part in the packet
+ * @param len         Length of the part
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully
+ */
+lt_ret_t lt_l3_encrypt_request_part(lt_l3_state_t *s3, uint8_t *packet, const uint16_t offset, const uint16_t len)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Places payload at the end of the L3 Command prepared in L3 buffer.
+ * @note With LT_L3_STREAMING, payload which does not fit into L3 buffer is left in `payload` and encrypted from there
+ *       chunk by chunk while the L3 Command is sent, so `payload` must stay valid until then.
+ *
+ * @param s3          Structure holding l3 state
+ * @param offset      Offset of the payload in the L3 packet
+ * @param payload     Payload
+ * @param len         Length of the payload
+ */
+void lt_l3_cmd_payload_set(lt_l3_state_t *s3, const uint16_t offset, const uint8_t *payload, const uint16_t len);
+
+/**
+ * @brief Announces that the L3 Result of the L3 Command just prepared ends with a payload.
+ * @note With LT_L3_STREAMING, payload which might not fit into L3 buffer can then be received into the caller's
+ *       buffer given to `lt_l3_res_payload_into()`. Call after the L3 Command is encrypted. Does nothing otherwise.
+ *
+ * @param s3          Structure holding l3 state
+ * @param offset      Offset of the payload in the L3 packet
+ * @param max_len     Maximal length of the payload
+ */
+void lt_l3_res_payload_expect(lt_l3_state_t *s3, const uint16_t offset, const uint16_t max_len);
+
+/**
+ * @brief Checks that the payload announced by `lt_l3_res_payload_expect()` can be received.
+ * @note With LT_L3_STREAMING, payload which might not fit into L3 buffer can only be decrypted in parts. Call before
+ *       the L3 Command is encrypted, so nothing is sent if the CAL cannot do it. Does nothing otherwise.
+ *
+ * @param s3          Structure holding l3 state
+ * @param offset      Offset of the payload in the L3 packet
+ * @param max_len     Maximal length of the payload
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_NOT_SUPPORTED The payload might not fit into L3 buffer and the CAL cannot decrypt in parts
+ * @retval            other Function did not execute successully
+ */
+lt_ret_t lt_l3_res_payload_check(lt_l3_state_t *s3, const uint16_t offset, const uint16_t max_len)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Copies payload of the decrypted L3 Result into `dest`.
+ * @note Payload received into the caller's buffer (LT_L3_STREAMING) is copied from there, or not at all if it is
+ *       `dest`.
+ *
+ * @param s3          Structure holding l3 state
+ * @param dest        Buffer for the payload
+ * @param offset      Offset of the payload in the L3 packet
+ * @param len         Length of the payload
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_L3_BUFFER_TOO_SMALL Part of the payload did not fit into the caller's buffer
+ */
+lt_ret_t lt_l3_res_payload_copy(const lt_l3_state_t *s3, uint8_t *dest, const uint16_t offset, const uint16_t len)
+    __attribute__((warn_unused_result));
+
+#if LT_L3_STREAMING
+/**
+ * @brief Fills a chunk of the L3 packet whose payload is left in the caller's buffer (see `lt_l3_cmd_payload_set()`).
+ * @note Encryption has to be started by `lt_l3_encrypt_request_start()` and chunks must follow each other from the
+ *       start of the packet. The chunk is gathered from L3 buffer and the payload and encrypted in `chunk`.
+ *
+ * @param s3          Structure holding l3 state
+ * @param chunk       Buffer for the chunk
+ * @param offset      Offset of the chunk in the packet
+ * @param len         Length of the chunk
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully
+ */
+lt_ret_t lt_l3_encrypt_request_chunk(lt_l3_state_t *s3, uint8_t *chunk, const uint16_t offset, const uint16_t len)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Decrypts a received chunk of the L3 Result whose payload goes to the caller's buffer (see
+ *        `lt_l3_res_payload_into()`).
+ * @note Chunks must follow each other from the start of the packet, the first one starts the decryption. The chunk is
+ *       decrypted in place, the payload is stored into the caller's buffer and the rest into L3 buffer. The tag is
+ *       verified with the last chunk, `lt_l3_decrypt_response()` then only checks the result.
+ *
+ * @param s3          Structure holding l3 state
+ * @param chunk       Received chunk
+ * @param offset      Offset of the chunk in the packet
+ * @param len         Length of the chunk
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Decryption failed, host's session data (and the payload) were invalidated
+ */
+lt_ret_t lt_l3_decrypt_response_chunk(lt_l3_state_t *s3, uint8_t *chunk, const uint16_t offset, const uint16_t len)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Zeroes the part of the payload already decrypted into the caller's buffer by
+ *        `lt_l3_decrypt_response_chunk()`.
+ * @note Used when receiving the rest of the L3 Result fails, the decrypted part was never authenticated.
+ *
+ * @param s3          Structure holding l3 state
+ */
+void lt_l3_res_stream_discard(lt_l3_state_t *s3);
+#endif
+
+/**
+ * @brief Decrypts a part of the L3 Result received into L3 buffer in place, verifies the tag once it is received.
+ * @note Parts must follow each other from the start of the packet, the first one restarts the decryption. Packets
+ *       received into another buffer, with invalid RES_SIZE or when the CAL cannot decrypt in parts are left to
+ *       `lt_l3_decrypt_response()`, which also finishes the L3 Result decrypted here.
+ *
+ * @param s3          Structure holding l3 state
+ * @param packet      Buffer the L3 Result is received into
+ * @param offset      Offset of the part in the packet
+ * @param len         Length of the part
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Decryption or tag verification failed, host's session data were invalidated
+ */
+lt_ret_t lt_l3_decrypt_response_part(lt_l3_state_t *s3, uint8_t *packet, const uint16_t offset, const uint16_t len)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Discards the L3 Result partly decrypted into L3 buffer by `lt_l3_decrypt_response_part()`.
+ * @note Used when receiving the rest of the L3 Result fails, the decrypted part was never authenticated. L3 buffer is
+ *       zeroed and the decryption is aborted in the CAL.
+ *
+ * @param s3          Structure holding l3 state
+ */
+void lt_l3_res_decryption_abort(lt_l3_state_t *s3);
+
 /**
  * @brief Decrypts response from TROPIC01 and fills L3 buffer with decrypted data.
  * @note This function is used after encrypted l3 payload was received from TROPIC01.
@@ -0,0 +1,209 @@
+/**
+ * @file lt_l3_queue.c
+ * @brief Queue of L3 Commands, the next one is prepared while TROPIC01 executes the previous one
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see LICENSE.md in the root directory of this source tree.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "libtropic_common.h"
+#include "libtropic_l2.h"
+#include "libtropic_l3.h"
+#include "libtropic_macros.h"
+#include "lt_l3_process.h"
+
+/**
+ * @brief Returns the L3 Command `offset` places after the oldest one.
+ */
+static lt_l3_queue_cmd_t *lt_l3_queue_at(lt_l3_queue_t *q, const uint8_t offset)
+{
+    return &q->cmds[(q->head + offset) % LT_L3_QUEUE_SIZE];
+}
+
+/**
+ * @brief Sends the first L3 Command which is not done yet.
+ *
+ * The L3 Command is taken from `next` if it was prepared there, otherwise it is prepared in the L3 buffer now. If it
+ * cannot be prepared or sent, it is done with the error.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param q           Queue
+ * @return            LT_OK if the L3 Command was sent, otherwise returns its error code.
+ */
+static lt_ret_t lt_l3_queue_send_one(lt_handle_t *h, lt_l3_queue_t *q)
+{
+    lt_l3_queue_cmd_t *cmd = lt_l3_queue_at(q, q->done);
+    lt_ret_t ret;
+#if !LT_L3_STREAMING
+    if (q->next_ready) {
+        q->next_ready = false;
+        // Secure Session might have been lost with the previous L3 Result.
+        if ((cmd->ret == LT_OK) && (h->l3.session_status != LT_SECURE_SESSION_ON)) {
+            cmd->ret = LT_HOST_NO_SESSION;
+        }
+        if (cmd->ret != LT_OK) {
+            return cmd->ret;
+        }
+        // Nothing is left to encrypt and the L3 Result is decrypted in the L3 buffer as usual.
+        h->l2.poll_key = q->next_poll_key;
+        h->l2.pending_encryption = NULL;
+        h->l2.res_decryption = &h->l3;
+        h->l3.res_decryption_status = LT_L3_RES_DECRYPTION_NONE;
+        ret = lt_l2_send_encrypted_cmd(&h->l2, q->next, sizeof(q->next));
+    }
+    else
+#endif
+    {
+        ret = cmd->out(h, cmd->ctx);
+        if (ret == LT_OK) {
+            ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
+        }
+    }
+
+    cmd->ret = ret;
+
+    return ret;
+}
+
+/**
+ * @brief Sends the first L3 Command which is not done yet, unless one is already in flight.
+ *
+ * L3 Commands which fail before they are sent are done with the error and the next one is sent instead.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param q           Queue
+ */
+static void lt_l3_queue_send(lt_handle_t *h, lt_l3_queue_t *q)
+{
+    while (!q->in_flight && (q->done < q->count)) {
+        if (lt_l3_queue_send_one(h, q) == LT_OK) {
+            q->in_flight = true;
+        }
+        else {
+            q->done++;
+        }
+    }
+}
+
+/**
+ * @brief Prepares the L3 Command after the one in flight into `next`, while TROPIC01 executes the one in flight.
+ *
+ * The L3 buffer is free until the L3 Result is received, so the L3 Command is built and encrypted there as a whole
+ * and then moved aside. Its IV follows the IV of the L3 Command in flight, as if it was sent after it.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param q           Queue
+ */
+static void lt_l3_queue_prepare_next(lt_handle_t *h, lt_l3_queue_t *q)
+{
+#if LT_L3_STREAMING
+    // The L3 buffer holds only a part of large L3 Commands, there is no room to keep another one aside.
+    LT_UNUSED(h);
+    LT_UNUSED(q);
+#else
+    // Any L3 Command built in the L3 buffer must fit into `next`.
+    if (!q->in_flight || q->next_ready || (q->done + 1 >= q->count) || (h->l3.buff_len > sizeof(q->next))) {
+        return;
+    }
+
+    lt_l3_queue_cmd_t *cmd = lt_l3_queue_at(q, q->done + 1);
+    // Polling for the L3 Result in flight must still use its own learned processing time.
+    uint16_t poll_key = h->l2.poll_key;
+
+    const struct lt_l3_gen_frame_t *p_frame = (const struct lt_l3_gen_frame_t *)h->l3.buff;
+    lt_ret_t ret = cmd->out(h, cmd->ctx);
+    // Encryption started for sending chunk by chunk is finished right away, there is time for it now.
+    if (ret == LT_OK && h->l2.pending_encryption) {
+        h->l2.pending_encryption = NULL;
+        ret = lt_l3_encrypt_request_part(&h->l3, h->l3.buff, 0,
+                                         TR01_L3_SIZE_SIZE + p_frame->cmd_size + TR01_L3_TAG_SIZE);
+    }
+    if (ret == LT_OK) {
+        memcpy(q->next, h->l3.buff, TR01_L3_SIZE_SIZE + p_frame->cmd_size + TR01_L3_TAG_SIZE);
+        q->next_poll_key = h->l2.poll_key;
+    }
+    else {
+        cmd->ret = ret;
+    }
+
+    h->l2.poll_key = poll_key;
+    q->next_ready = true;
+#endif
+}
+
+lt_ret_t lt_l3_queue_init(lt_l3_queue_t *q)
+{
+    if (!q) {
+        return LT_PARAM_ERR;
+    }
+
+    memset(q, 0, sizeof(lt_l3_queue_t));
+
+    return LT_OK;
+}
+
+lt_ret_t lt_l3_queue_submit(lt_handle_t *h, lt_l3_queue_t *q, const lt_l3_queue_step_t out, const lt_l3_queue_step_t in,
+                            void *ctx)
+{
+    if (!h || !q || !out || !in) {
+        return LT_PARAM_ERR;
+    }
+    if (q->count >= LT_L3_QUEUE_SIZE) {
+        return LT_L3_QUEUE_FULL;
+    }
+
+    lt_l3_queue_cmd_t *cmd = lt_l3_queue_at(q, q->count);
+    cmd->out = out;
+    cmd->in = in;
+    cmd->ctx = ctx;
+    cmd->ret = LT_OK;
+    q->count++;
+
+    lt_l3_queue_send(h, q);
+    lt_l3_queue_prepare_next(h, q);
+
+    return LT_OK;
+}
+
+lt_ret_t lt_l3_queue_poll(lt_handle_t *h, lt_l3_queue_t *q, void **ctx, lt_ret_t *cmd_ret)
+{
+    if (!h || !q || !cmd_ret || !q->count) {
+        return LT_PARAM_ERR;
+    }
+
+    if (!q->done) {
+        lt_l3_queue_send(h, q);
+    }
+    if (!q->done) {
+        lt_l3_queue_prepare_next(h, q);
+
+        lt_l3_queue_cmd_t *cmd = lt_l3_queue_at(q, 0);
+        lt_ret_t ret
+            = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, (uint16_t)TR01_L3_PACKET_MAX_SIZE));
+        if (ret == LT_OK) {
+            ret = cmd->in(h, cmd->ctx);
+        }
+        cmd->ret = ret;
+        q->in_flight = false;
+        q->done++;
+    }
+
+    lt_l3_queue_cmd_t *cmd = lt_l3_queue_at(q, 0);
+    *cmd_ret = cmd->ret;
+    if (ctx) {
+        *ctx = cmd->ctx;
+    }
+    q->head = (q->head + 1) % LT_L3_QUEUE_SIZE;
+    q->count--;
+    q->done--;
+
+    // TROPIC01 executes the next L3 Command while the caller handles this result.
+    lt_l3_queue_send(h, q);
+    lt_l3_queue_prepare_next(h, q);
+
+    return LT_OK;
+}
@@ -0,0 +1,342 @@
+/**
+ * @file lt_merkle_batch.c
+ * @brief Signing of message batches with one signature of the root of their Merkle tree
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see LICENSE.md in the root directory of this source tree.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_macros.h"
+#include "lt_ecdsa_p256.h"
+#include "lt_sha256.h"
+
+/** @brief Prefix of hashed leaves, see RFC 6962, section 2.1. */
+#define LT_MERKLE_LEAF_PREFIX 0x00
+/** @brief Prefix of hashed inner nodes, see RFC 6962, section 2.1. */
+#define LT_MERKLE_NODE_PREFIX 0x01
+
+LT_STATIC_ASSERT(LT_MERKLE_NODE_LEN == LT_SHA256_DIGEST_LENGTH)
+LT_STATIC_ASSERT(LT_MERKLE_NODE_LEN == TR01_ECDSA_SIGN_DIGEST_LENGTH)
+LT_STATIC_ASSERT(TR01_CURVE_P256_PUBKEY_LEN + 1 == LT_ECDSA_P256_PUBKEY_LEN)
+
+/**
+ * @brief Computes SHA-256(prefix || data || right).
+ *
+ * @param crypto_ctx  CAL context with initialized SHA-256 context
+ * @param prefix      LT_MERKLE_LEAF_PREFIX or LT_MERKLE_NODE_PREFIX
+ * @param data        Message, or the left node
+ * @param data_len    Length of `data`
+ * @param right       Right node, NULL when hashing a leaf
+ * @param node        Hashed node (32B)
+ *
+ * @returns LT_OK if sucessfully, error code otherwise
+ */
+static lt_ret_t merkle_hash(void *crypto_ctx, const uint8_t prefix, const uint8_t *data, const uint32_t data_len,
+                            const uint8_t *right, uint8_t *node)
+{
+    lt_ret_t ret = lt_sha256_start(crypto_ctx);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_sha256_update(crypto_ctx, &prefix, sizeof(prefix));
+    if (ret != LT_OK) {
+        return ret;
+    }
+    if (data_len) {
+        ret = lt_sha256_update(crypto_ctx, data, data_len);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+    if (right) {
+        ret = lt_sha256_update(crypto_ctx, right, LT_MERKLE_NODE_LEN);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+
+    return lt_sha256_finish(crypto_ctx, node);
+}
+
+/**
+ * @brief Computes the digest which is signed instead of the bare root, SHA-256(LT_MERKLE_ROOT_TAG || count || root).
+ *
+ * The tag keeps an ordinary signature of some message from passing as a signature of a root, and the count (2B,
+ * big-endian) binds the root to the shape of its tree.
+ *
+ * @param crypto_ctx  CAL context with initialized SHA-256 context
+ * @param count       Number of messages in the batch
+ * @param root        Root of the tree
+ * @param digest      Signed digest (32B)
+ *
+ * @returns LT_OK if sucessfully, error code otherwise
+ */
+static lt_ret_t merkle_root_digest(void *crypto_ctx, const uint16_t count, const uint8_t *root, uint8_t *digest)
+{
+    const uint8_t count_be[2] = {(uint8_t)(count >> 8), (uint8_t)count};
+
+    lt_ret_t ret = lt_sha256_start(crypto_ctx);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_sha256_update(crypto_ctx, (const uint8_t *)LT_MERKLE_ROOT_TAG, sizeof(LT_MERKLE_ROOT_TAG) - 1);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_sha256_update(crypto_ctx, count_be, sizeof(count_be));
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_sha256_update(crypto_ctx, root, LT_MERKLE_NODE_LEN);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    return lt_sha256_finish(crypto_ctx, digest);
+}
+
+lt_ret_t lt_merkle_batch_init(lt_merkle_batch_t *batch, uint8_t (*nodes)[LT_MERKLE_NODE_LEN], const uint16_t max_count)
+{
+    if (!batch || !nodes || !max_count) {
+        return LT_PARAM_ERR;
+    }
+
+    memset(batch, 0, sizeof(lt_merkle_batch_t));
+    batch->nodes = nodes;
+    batch->max_count = max_count;
+
+    return LT_OK;
+}
+
+lt_ret_t lt_merkle_batch_add(lt_handle_t *h, lt_merkle_batch_t *batch, const uint8_t *msg, const uint32_t msg_len,
+                             uint16_t *index)
+{
+    if (!h || !batch || !batch->nodes || (!msg && msg_len) || batch->is_signed || batch->count >= batch->max_count) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.ecdsa_sign_hashing) {
+        return LT_SHA256_BUSY;
+    }
+
+    lt_ret_t ret_unused;
+    lt_ret_t ret = lt_sha256_init(h->l3.crypto_ctx);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = merkle_hash(h->l3.crypto_ctx, LT_MERKLE_LEAF_PREFIX, msg, msg_len, NULL, batch->nodes[batch->count]);
+    if (ret != LT_OK) {
+        goto sha256_cleanup;
+    }
+
+    if (index) {
+        *index = batch->count;
+    }
+    batch->count++;
+
+sha256_cleanup:
+    ret_unused = lt_sha256_deinit(h->l3.crypto_ctx);
+    LT_UNUSED(ret_unused);
+    return ret;
+}
+
+lt_ret_t lt_merkle_batch_sign(lt_handle_t *h, lt_merkle_batch_t *batch, const lt_ecc_slot_t ecc_slot,
+                              const lt_ecc_curve_type_t curve)
+{
+    if (!h || !batch || !batch->nodes || !batch->count || batch->is_signed || (ecc_slot > TR01_ECC_SLOT_31)
+        || ((curve != TR01_CURVE_P256) && (curve != TR01_CURVE_ED25519))) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.ecdsa_sign_hashing) {
+        return LT_SHA256_BUSY;
+    }
+
+    lt_ret_t ret_unused;
+    lt_ret_t ret = lt_sha256_init(h->l3.crypto_ctx);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    // Each level is stored right after the one below it, the root is the only node of the last level.
+    uint32_t offset = 0;
+    uint32_t n = batch->count;
+    while (n > 1) {
+        uint8_t (*level)[LT_MERKLE_NODE_LEN] = &batch->nodes[offset];
+        uint8_t (*upper)[LT_MERKLE_NODE_LEN] = &batch->nodes[offset + n];
+        for (uint32_t i = 0; i < n / 2; i++) {
+            ret = merkle_hash(h->l3.crypto_ctx, LT_MERKLE_NODE_PREFIX, level[2 * i], LT_MERKLE_NODE_LEN,
+                              level[2 * i + 1], upper[i]);
+            if (ret != LT_OK) {
+                goto sha256_cleanup;
+            }
+        }
+        if (n % 2) {
+            memcpy(upper[n / 2], level[n - 1], LT_MERKLE_NODE_LEN);
+        }
+        offset += n;
+        n = (n + 1) / 2;
+    }
+    memcpy(batch->root, batch->nodes[offset], LT_MERKLE_NODE_LEN);
+
+    uint8_t digest[LT_MERKLE_NODE_LEN];
+    ret = merkle_root_digest(h->l3.crypto_ctx, batch->count, batch->root, digest);
+    if (ret != LT_OK) {
+        goto sha256_cleanup;
+    }
+
+    ret = lt_sha256_deinit(h->l3.crypto_ctx);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    if (curve == TR01_CURVE_P256) {
+        ret = lt_ecc_ecdsa_sign_digest(h, ecc_slot, digest, batch->root_sig);
+    }
+    else {
+        ret = lt_ecc_eddsa_sign(h, ecc_slot, digest, sizeof(digest), batch->root_sig);
+    }
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    batch->curve = curve;
+    batch->is_signed = true;
+
+    return LT_OK;
+
+sha256_cleanup:
+    ret_unused = lt_sha256_deinit(h->l3.crypto_ctx);
+    LT_UNUSED(ret_unused);
+    return ret;
+}
+
+lt_ret_t lt_merkle_batch_proof(const lt_merkle_batch_t *batch, const uint16_t index, lt_merkle_proof_t *proof)
+{
+    if (!batch || !proof || !batch->is_signed || (index >= batch->count)) {
+        return LT_PARAM_ERR;
+    }
+
+    uint32_t offset = 0;
+    uint32_t n = batch->count;
+    uint32_t i = index;
+    proof->path_len = 0;
+    while (n > 1) {
+        // A node without a sibling has none in the path, it was moved up unchanged.
+        if (i % 2) {
+            memcpy(proof->path[proof->path_len++], batch->nodes[offset + i - 1], LT_MERKLE_NODE_LEN);
+        }
+        else if (i + 1 < n) {
+            memcpy(proof->path[proof->path_len++], batch->nodes[offset + i + 1], LT_MERKLE_NODE_LEN);
+        }
+        offset += n;
+        n = (n + 1) / 2;
+        i /= 2;
+    }
+
+    proof->index = index;
+    proof->count = batch->count;
+    proof->curve = batch->curve;
+    memcpy(proof->root, batch->root, LT_MERKLE_NODE_LEN);
+    memcpy(proof->root_sig, batch->root_sig, sizeof(proof->root_sig));
+
+    return LT_OK;
+}
+
+lt_ret_t lt_merkle_batch_reset(lt_merkle_batch_t *batch)
+{
+    if (!batch) {
+        return LT_PARAM_ERR;
+    }
+
+    batch->count = 0;
+    batch->is_signed = false;
+
+    return LT_OK;
+}
+
+lt_ret_t lt_merkle_proof_verify(lt_handle_t *h, const uint8_t *msg, const uint32_t msg_len,
+                                const lt_merkle_proof_t *proof, const uint8_t *pubkey)
+{
+    if (!h || !proof || (!msg && msg_len) || (proof->path_len > LT_MERKLE_PATH_MAX_LEN)) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.ecdsa_sign_hashing) {
+        return LT_SHA256_BUSY;
+    }
+    if (proof->index >= proof->count) {
+        return LT_MERKLE_PROOF_INVALID;
+    }
+
+    uint8_t node[LT_MERKLE_NODE_LEN];
+    lt_ret_t ret_unused;
+    lt_ret_t ret = lt_sha256_init(h->l3.crypto_ctx);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = merkle_hash(h->l3.crypto_ctx, LT_MERKLE_LEAF_PREFIX, msg, msg_len, NULL, node);
+    if (ret != LT_OK) {
+        goto sha256_cleanup;
+    }
+
+    uint32_t n = proof->count;
+    uint32_t i = proof->index;
+    uint8_t used = 0;
+    while (n > 1) {
+        if ((i % 2) || (i + 1 < n)) {
+            if (used == proof->path_len) {
+                ret = LT_MERKLE_PROOF_INVALID;
+                goto sha256_cleanup;
+            }
+            const uint8_t *sibling = proof->path[used++];
+            if (i % 2) {
+                ret = merkle_hash(h->l3.crypto_ctx, LT_MERKLE_NODE_PREFIX, sibling, LT_MERKLE_NODE_LEN, node, node);
+            }
+            else {
+                ret = merkle_hash(h->l3.crypto_ctx, LT_MERKLE_NODE_PREFIX, node, LT_MERKLE_NODE_LEN, sibling, node);
+            }
+            if (ret != LT_OK) {
+                goto sha256_cleanup;
+            }
+        }
+        n = (n + 1) / 2;
+        i /= 2;
+    }
+
+    if ((used != proof->path_len) || memcmp(node, proof->root, LT_MERKLE_NODE_LEN)) {
+        ret = LT_MERKLE_PROOF_INVALID;
+        goto sha256_cleanup;
+    }
+
+    if (pubkey) {
+        if (proof->curve != TR01_CURVE_P256) {
+            ret = LT_NOT_SUPPORTED;
+            goto sha256_cleanup;
+        }
+#ifdef LT_ECDSA_P256_VERIFY
+        ret = merkle_root_digest(h->l3.crypto_ctx, proof->count, proof->root, node);
+        if (ret != LT_OK) {
+            goto sha256_cleanup;
+        }
+        uint8_t key[LT_ECDSA_P256_PUBKEY_LEN] = {0x04};
+        memcpy(&key[1], pubkey, TR01_CURVE_P256_PUBKEY_LEN);
+        // The digest was signed by lt_ecc_ecdsa_sign_digest() as it is.
+        if (lt_ecdsa_p256_verify(key, node, proof->root_sig) != LT_OK) {
+            ret = LT_MERKLE_PROOF_INVALID;
+        }
+#else
+        ret = LT_NOT_SUPPORTED;
+#endif
+    }
+
+sha256_cleanup:
+    ret_unused = lt_sha256_deinit(h->l3.crypto_ctx);
+    LT_UNUSED(ret_unused);
+    return ret;
+}
@@ -13,6 +13,7 @@
 #include <stdint.h>
 
 #include "libtropic_common.h"
+#include "libtropic_macros.h"
 #include "libtropic_port.h"
 
 lt_ret_t lt_l1_init(lt_l2_state_t *s2)
@@ -65,6 +66,37 @@ lt_ret_t lt_l1_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_len,
     return lt_port_spi_transfer(s2, offset, tx_len, timeout_ms);
 }
 
+lt_ret_t lt_l1_spi_transfer_into(lt_l2_state_t *s2, uint8_t offset, uint8_t *rx_buff, uint16_t rx_len,
+                                 uint32_t timeout_ms)
+{
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!s2 || !rx_buff) {
+        return LT_PARAM_ERR;
+    }
+#endif
+    return lt_port_spi_transfer_into(s2, offset, rx_buff, rx_len, timeout_ms);
+}
+
+lt_ret_t lt_l1_frame_xfer(lt_l2_state_t *s2, lt_port_frame_dir_t dir, uint16_t len, uint32_t timeout_ms)
+{
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!s2) {
+        return LT_PARAM_ERR;
+    }
+#endif
+    return lt_port_frame_xfer(s2, dir, len, timeout_ms);
+}
+
+lt_ret_t lt_l1_spi_transfer_iov(lt_l2_state_t *s2, const lt_port_iov_t *iov, uint8_t iov_cnt, uint32_t timeout_ms)
+{
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!s2 || !iov) {
+        return LT_PARAM_ERR;
+    }
+#endif
+    return lt_port_spi_transfer_iov(s2, iov, iov_cnt, timeout_ms);
+}
+
 lt_ret_t lt_l1_delay(lt_l2_state_t *s2, uint32_t ms)
 {
 #ifdef LT_REDUNDANT_ARG_CHECK
@@ -75,6 +107,26 @@ lt_ret_t lt_l1_delay(lt_l2_state_t *s2, uint32_t ms)
     return lt_port_delay(s2, ms);
 }
 
+lt_ret_t lt_l1_delay_us(lt_l2_state_t *s2, uint32_t us)
+{
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!s2) {
+        return LT_PARAM_ERR;
+    }
+#endif
+    return lt_port_delay_us(s2, us);
+}
+
+lt_ret_t lt_l1_get_time_us(lt_l2_state_t *s2, uint64_t *time_us)
+{
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!s2 || !time_us) {
+        return LT_PARAM_ERR;
+    }
+#endif
+    return lt_port_get_time_us(s2, time_us);
+}
+
 #if LT_USE_INT_PIN
 
 lt_ret_t lt_l1_delay_on_int(lt_l2_state_t *s2, uint32_t ms)
@@ -96,4 +148,53 @@ lt_ret_t lt_random_bytes(lt_handle_t *h, void *buff, size_t count)
     }
 #endif
     return lt_port_random_bytes(&h->l2, buff, count);
-}
\ No newline at end of file
+}
+
+// Default implementations of the optional port functions, overridden by ports which implement them.
+
+__attribute__((weak)) lt_ret_t lt_port_delay_us(lt_l2_state_t *s2, uint32_t us)
+{
+    return lt_port_delay(s2, (us + 999) / 1000);
+}
+
+__attribute__((weak)) lt_ret_t lt_port_get_time_us(lt_l2_state_t *s2, uint64_t *time_us)
+{
+    LT_UNUSED(s2);
+    LT_UNUSED(time_us);
+
+    return LT_FAIL;
+}
+
+__attribute__((weak)) lt_ret_t lt_port_frame_xfer(lt_l2_state_t *s2, lt_port_frame_dir_t dir, uint16_t len,
+                                                  uint32_t timeout_ms)
+{
+    LT_UNUSED(s2);
+    LT_UNUSED(dir);
+    LT_UNUSED(len);
+    LT_UNUSED(timeout_ms);
+
+    return LT_NOT_SUPPORTED;
+}
+
+__attribute__((weak)) lt_ret_t lt_port_spi_transfer_iov(lt_l2_state_t *s2, const lt_port_iov_t *iov, uint8_t iov_cnt,
+                                                        uint32_t timeout_ms)
+{
+    LT_UNUSED(s2);
+    LT_UNUSED(iov);
+    LT_UNUSED(iov_cnt);
+    LT_UNUSED(timeout_ms);
+
+    return LT_NOT_SUPPORTED;
+}
+
+__attribute__((weak)) lt_ret_t lt_port_spi_transfer_into(lt_l2_state_t *s2, uint8_t offset, uint8_t *rx_buff,
+                                                         uint16_t rx_len, uint32_t timeout_ms)
+{
+    LT_UNUSED(s2);
+    LT_UNUSED(offset);
+    LT_UNUSED(rx_buff);
+    LT_UNUSED(rx_len);
+    LT_UNUSED(timeout_ms);
+
+    return LT_NOT_SUPPORTED;
+}
@@ -19,6 +19,7 @@
 #include <stddef.h>
 
 #include "libtropic_common.h"
+#include "libtropic_port.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -69,6 +70,46 @@ lt_ret_t lt_l1_spi_csn_high(lt_l2_state_t *s2) __attribute__((warn_unused_result
 lt_ret_t lt_l1_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_len, uint32_t timeout_ms)
     __attribute__((warn_unused_result));
 
+/**
+ * @brief Does SPI transfer storing received bytes into `rx_buff`. This is wrapper for platform defined function.
+ *
+ * @param s2          Structure holding l2 state
+ * @param offset      Offset of the received bytes in the frame
+ * @param rx_buff     Buffer for the received bytes
+ * @param rx_len      Number of bytes to receive
+ * @param timeout_ms  Timeout
+ * @return            LT_OK if success, LT_NOT_SUPPORTED if the port does not implement it, otherwise returns other
+ *                    error code.
+ */
+lt_ret_t lt_l1_spi_transfer_into(lt_l2_state_t *s2, uint8_t offset, uint8_t *rx_buff, uint16_t rx_len,
+                                 uint32_t timeout_ms) __attribute__((warn_unused_result));
+
+/**
+ * @brief Transfers whole L1 frame. This is wrapper for platform defined function.
+ *
+ * @param s2          Structure holding l2 state
+ * @param dir         Frame direction
+ * @param len         Length of the written frame, or max length of the read frame
+ * @param timeout_ms  Timeout
+ * @return            LT_OK if success, LT_NOT_SUPPORTED if the port does not implement it, otherwise returns other
+ *                    error code.
+ */
+lt_ret_t lt_l1_frame_xfer(lt_l2_state_t *s2, lt_port_frame_dir_t dir, uint16_t len, uint32_t timeout_ms)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Writes L2 Request frame gathered from several buffers. This is wrapper for platform defined function.
+ *
+ * @param s2          Structure holding l2 state
+ * @param iov         Parts of the frame
+ * @param iov_cnt     Number of parts
+ * @param timeout_ms  Timeout
+ * @return            LT_OK if success, LT_NOT_SUPPORTED if the port does not implement it, otherwise returns other
+ *                    error code.
+ */
+lt_ret_t lt_l1_spi_transfer_iov(lt_l2_state_t *s2, const lt_port_iov_t *iov, uint8_t iov_cnt, uint32_t timeout_ms)
+    __attribute__((warn_unused_result));
+
 /**
  * @brief Platform's definition for delay, specifies what host
  *        platform should do when libtropic's functions need some delay.
@@ -80,6 +121,26 @@ lt_ret_t lt_l1_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_len,
  */
 lt_ret_t lt_l1_delay(lt_l2_state_t *s2, uint32_t ms) __attribute__((warn_unused_result));
 
+/**
+ * @brief Platform's definition for delay with microsecond resolution.
+ *        This is wrapper for platform defined function.
+ *
+ * @param s2          Structure holding l2 state
+ * @param us          Time to wait in microseconds
+ * @return            LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_l1_delay_us(lt_l2_state_t *s2, uint32_t us) __attribute__((warn_unused_result));
+
+/**
+ * @brief Platform's monotonic time in microseconds.
+ *        This is wrapper for platform defined function.
+ *
+ * @param s2          Structure holding l2 state
+ * @param time_us     Current time in microseconds
+ * @return            LT_OK if success, LT_FAIL if the platform has no monotonic clock.
+ */
+lt_ret_t lt_l1_get_time_us(lt_l2_state_t *s2, uint64_t *time_us) __attribute__((warn_unused_result));
+
 #if LT_USE_INT_PIN
 /**
  * @brief Specifies what platform should do when waiting for signal from interrupt pin
@@ -67,6 +67,8 @@ int main(void)
     lt_dev_posix_tcp_t device;
     device.addr = inet_addr("127.0.0.1");
     device.port = 28992;
+    // Model server listening on a Unix domain socket, e.g. when many test processes run on one host.
+    device.sock_path = getenv("LT_MODEL_SOCK_PATH");
     lt_handle.l2.device = &device;
 
     // Generate a seed for the PRNG and seed it.
@@ -0,0 +1,233 @@
+/**
+ * @file lt_test_posix_usb_dongle_pty.c
+ * @brief Test of the USB dongle HAL against a dongle emulated on a pseudoterminal.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * The emulated dongle answers both the text and the binary framing, its SPI slave returns each MOSI byte XORed with
+ * PTY_MISO_XOR. Answers are written in two parts to exercise reception of partial messages.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+// posix_openpt(), grantpt(), unlockpt() and ptsname().
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "libtropic_port.h"
+#include "libtropic_port_posix_usb_dongle.h"
+
+#ifdef __linux__
+#include <asm/termbits.h>
+#include <sys/ioctl.h>
+#endif
+
+#define PTY_MISO_XOR 0x5A
+#define PTY_CUSTOM_BAUD_RATE 1000000
+
+#define PTY_CHECK(cond)                                  \
+    do {                                                 \
+        if (!(cond)) {                                   \
+            LT_LOG_ERROR("Check failed: %s", #cond);     \
+            exit(1);                                     \
+        }                                                \
+    } while (0)
+
+/** @brief State of the emulated dongle. */
+typedef struct pty_dongle_t {
+    int master_fd;
+    lt_usb_dongle_framing_t framing;
+    /** Do not answer the next transfer. */
+    volatile bool mute;
+    /** Number of CSN high commands received. */
+    int csn_high_count;
+} pty_dongle_t;
+
+static int read_exact(int fd, uint8_t *buff, size_t len)
+{
+    size_t received = 0;
+    while (received < len) {
+        ssize_t ret = read(fd, buff + received, len - received);
+        if (ret <= 0) {
+            return -1;
+        }
+        received += ret;
+    }
+    return 0;
+}
+
+static void write_split(int fd, const uint8_t *buff, size_t len)
+{
+    size_t first = len / 2;
+    PTY_CHECK(write(fd, buff, first) == (ssize_t)first);
+    usleep(1000);
+    PTY_CHECK(write(fd, buff + first, len - first) == (ssize_t)(len - first));
+}
+
+static int hex_value(uint8_t c)
+{
+    return (c <= '9') ? c - '0' : c - 'A' + 10;
+}
+
+static void serve_text(pty_dongle_t *dongle)
+{
+    uint8_t line[2 * TR01_L1_LEN_MAX + 2];
+    size_t len = 0;
+
+    while (read_exact(dongle->master_fd, &line[len], 1) == 0) {
+        if (line[len++] != '\n') {
+            PTY_CHECK(len < sizeof(line));
+            continue;
+        }
+
+        if (len == 5 && memcmp(line, "CS=0\n", 5) == 0) {
+            dongle->csn_high_count++;
+            write_split(dongle->master_fd, (const uint8_t *)"OK\r\n", 4);
+        }
+        else {
+            PTY_CHECK(len >= 2 && line[len - 2] == 'x');
+            size_t data_len = (len - 2) / 2;
+            static const char hex_digits[] = "0123456789ABCDEF";
+            for (size_t i = 0; i < data_len; i++) {
+                uint8_t miso = (uint8_t)((hex_value(line[2 * i]) << 4) | hex_value(line[2 * i + 1])) ^ PTY_MISO_XOR;
+                line[2 * i] = hex_digits[miso >> 4];
+                line[2 * i + 1] = hex_digits[miso & 0x0f];
+            }
+            line[2 * data_len] = '\r';
+            line[2 * data_len + 1] = '\n';
+            if (dongle->mute) {
+                dongle->mute = false;
+            }
+            else {
+                write_split(dongle->master_fd, line, 2 * data_len + 2);
+            }
+        }
+        len = 0;
+    }
+}
+
+static void serve_binary(pty_dongle_t *dongle)
+{
+    uint8_t frame[LT_USB_DONGLE_BIN_HEADER_SIZE + TR01_L1_LEN_MAX];
+
+    while (read_exact(dongle->master_fd, frame, LT_USB_DONGLE_BIN_HEADER_SIZE) == 0) {
+        uint8_t cmd = frame[0];
+        uint16_t len = frame[1] | (frame[2] << 8);
+        PTY_CHECK(len <= TR01_L1_LEN_MAX);
+        if (read_exact(dongle->master_fd, &frame[1], len) != 0) {
+            return;
+        }
+
+        if (cmd == LT_USB_DONGLE_BIN_CMD_CSN_HIGH) {
+            PTY_CHECK(len == 0);
+            dongle->csn_high_count++;
+        }
+        else {
+            PTY_CHECK(cmd == LT_USB_DONGLE_BIN_CMD_TRANSFER);
+            for (uint16_t i = 0; i < len; i++) {
+                frame[1 + i] ^= PTY_MISO_XOR;
+            }
+        }
+        frame[0] = LT_USB_DONGLE_BIN_STATUS_OK;
+        if (dongle->mute) {
+            dongle->mute = false;
+        }
+        else {
+            write_split(dongle->master_fd, frame, 1 + len);
+        }
+    }
+}
+
+static void *dongle_thread(void *arg)
+{
+    pty_dongle_t *dongle = arg;
+
+    if (dongle->framing == LT_USB_DONGLE_FRAMING_BINARY) {
+        serve_binary(dongle);
+    }
+    else {
+        serve_text(dongle);
+    }
+
+    return NULL;
+}
+
+static void run_case(lt_usb_dongle_framing_t framing, uint32_t baud_rate)
+{
+    LT_LOG_INFO("Framing %d, baud rate %u.", (int)framing, (unsigned)baud_rate);
+
+    pty_dongle_t dongle = {.framing = framing};
+    dongle.master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    PTY_CHECK(dongle.master_fd >= 0);
+    PTY_CHECK(grantpt(dongle.master_fd) == 0);
+    PTY_CHECK(unlockpt(dongle.master_fd) == 0);
+
+    lt_dev_posix_usb_dongle_t device = {0};
+    PTY_CHECK(strlen(ptsname(dongle.master_fd)) < sizeof(device.dev_path));
+    strcpy(device.dev_path, ptsname(dongle.master_fd));
+    device.baud_rate = baud_rate;
+    device.framing = framing;
+    lt_l2_state_t s2 = {0};
+    s2.device = &device;
+
+    PTY_CHECK(lt_port_init(&s2) == LT_OK);
+
+#ifdef __linux__
+    struct termios2 options;
+    PTY_CHECK(ioctl(device.fd, TCGETS2, &options) == 0);
+    PTY_CHECK(options.c_ospeed == baud_rate);
+#endif
+
+    pthread_t thread;
+    PTY_CHECK(pthread_create(&thread, NULL, dongle_thread, &dongle) == 0);
+
+    // Transfers of one byte and of the whole L1 buffer, stored at an offset.
+    uint16_t lens[] = {1, TR01_L1_LEN_MAX - 1};
+    for (size_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        for (uint16_t j = 0; j < lens[i]; j++) {
+            s2.buff[1 + j] = (uint8_t)j;
+        }
+        PTY_CHECK(lt_port_spi_csn_low(&s2) == LT_OK);
+        PTY_CHECK(lt_port_spi_transfer(&s2, 1, lens[i], 0) == LT_OK);
+        PTY_CHECK(lt_port_spi_csn_high(&s2) == LT_OK);
+        for (uint16_t j = 0; j < lens[i]; j++) {
+            PTY_CHECK(s2.buff[1 + j] == ((uint8_t)j ^ PTY_MISO_XOR));
+        }
+    }
+    PTY_CHECK(dongle.csn_high_count == 2);
+
+    // Missing answer is reported after LT_USB_DONGLE_READ_TIMEOUT_MS.
+    dongle.mute = true;
+    PTY_CHECK(lt_port_spi_transfer(&s2, 0, 4, 0) == LT_L1_SPI_ERROR);
+
+    // Reading the master fails once the terminal is closed, which stops the emulated dongle.
+    PTY_CHECK(lt_port_deinit(&s2) == LT_OK);
+    PTY_CHECK(pthread_join(thread, NULL) == 0);
+    PTY_CHECK(close(dongle.master_fd) == 0);
+}
+
+int main(void)
+{
+    LT_UNUSED(setvbuf(stdout, NULL, _IONBF, 0));
+    LT_UNUSED(setvbuf(stderr, NULL, _IONBF, 0));
+
+    run_case(LT_USB_DONGLE_FRAMING_TEXT, 115200);
+    run_case(LT_USB_DONGLE_FRAMING_BINARY, 115200);
+#ifdef __linux__
+    run_case(LT_USB_DONGLE_FRAMING_TEXT, PTY_CUSTOM_BAUD_RATE);
+    run_case(LT_USB_DONGLE_FRAMING_BINARY, PTY_CUSTOM_BAUD_RATE);
+#endif
+
+    LT_LOG_INFO("Test finished!");
+
+    return 0;
+}
@@ -0,0 +1,345 @@
+/**
+ * @file lt_test_posix_tcp_socket.c
+ * @brief Test of the TCP HAL against a model server emulated on a socket.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * The emulated server answers the separate SPI tags and, when enabled, LT_TCP_TAG_SPI_TRANSACTION. Its SPI slave
+ * returns each MOSI byte XORed with SOCKET_MISO_XOR, except for segments with LT_TCP_SEGMENT_FLAG_L1_RESPONSE, which
+ * are answered with the configured CHIP_STATUS and L2 Response frame. Answers are written in two parts to exercise
+ * reception of partial messages. Each received message is counted, so the test checks how many round trips an L1
+ * frame costs. The server listens either on TCP loopback or on a Unix domain socket.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "libtropic_port.h"
+#include "libtropic_port_posix_tcp.h"
+#include "lt_l1.h"
+
+#define SOCKET_MISO_XOR 0x5A
+#define SOCKET_UNIX_PATH_FMT "/tmp/lt_test_posix_tcp_socket.%ld.sock"
+
+#define SOCKET_CHECK(cond)                               \
+    do {                                                 \
+        if (!(cond)) {                                   \
+            LT_LOG_ERROR("Check failed: %s", #cond);     \
+            exit(1);                                     \
+        }                                                \
+    } while (0)
+
+/** @brief State of the emulated model server. */
+typedef struct socket_model_t {
+    int listen_fd;
+    int fd;
+    /** Answer LT_TCP_TAG_SPI_TRANSACTION, otherwise it is rejected as an unknown tag. */
+    bool transactions;
+    /** CHIP_STATUS returned by LT_TCP_SEGMENT_FLAG_L1_RESPONSE segments. */
+    uint8_t chip_status;
+    /** STATUS, RSP_LEN, RSP_DATA and RSP_CRC returned after CHIP_STATUS when the chip is ready. */
+    uint8_t rsp[TR01_L2_MAX_FRAME_SIZE];
+    /** Number of messages received. */
+    int message_count;
+    /** Number of LT_TCP_TAG_SPI_DRIVE_CSN_HIGH messages received. */
+    int csn_high_count;
+} socket_model_t;
+
+static int read_exact(int fd, uint8_t *buff, size_t len)
+{
+    size_t received = 0;
+    while (received < len) {
+        ssize_t ret = read(fd, buff + received, len - received);
+        if (ret <= 0) {
+            return -1;
+        }
+        received += ret;
+    }
+    return 0;
+}
+
+static void write_split(int fd, const uint8_t *buff, size_t len)
+{
+    size_t first = len / 2;
+    SOCKET_CHECK(write(fd, buff, first) == (ssize_t)first);
+    usleep(1000);
+    SOCKET_CHECK(write(fd, buff + first, len - first) == (ssize_t)(len - first));
+}
+
+/**
+ * @brief Answers one segment of LT_TCP_TAG_SPI_TRANSACTION, returns the number of MISO bytes.
+ */
+static uint16_t serve_segment(const socket_model_t *model, uint8_t flags, const uint8_t *mosi, uint16_t len,
+                              uint8_t *miso)
+{
+    if (!(flags & LT_TCP_SEGMENT_FLAG_L1_RESPONSE)) {
+        for (uint16_t i = 0; i < len; i++) {
+            miso[i] = mosi[i] ^ SOCKET_MISO_XOR;
+        }
+        return len;
+    }
+
+    SOCKET_CHECK(len >= TR01_L1_CHIP_STATUS_SIZE && mosi[0] == TR01_L1_GET_RESPONSE_REQ_ID);
+
+    // The frame ends after CHIP_STATUS if the chip is not ready, after RSP_LEN if there is no response.
+    uint16_t frame_len = TR01_L1_CHIP_STATUS_SIZE;
+    if ((model->chip_status & TR01_L1_CHIP_MODE_READY_bit) && !(model->chip_status & TR01_L1_CHIP_MODE_ALARM_bit)) {
+        frame_len += (model->rsp[0] == 0xff) ? 2 : 2 + model->rsp[1] + 2;
+    }
+    if (frame_len > len) {
+        frame_len = len;
+    }
+
+    miso[0] = model->chip_status;
+    memcpy(&miso[TR01_L1_CHIP_STATUS_SIZE], model->rsp, frame_len - TR01_L1_CHIP_STATUS_SIZE);
+
+    return frame_len;
+}
+
+static void serve(socket_model_t *model)
+{
+    uint8_t msg[LT_TCP_MAX_BUFFER_LEN];
+    uint8_t answer[LT_TCP_MAX_BUFFER_LEN];
+
+    while (read_exact(model->fd, msg, LT_TCP_TAG_AND_LENGTH_SIZE) == 0) {
+        uint8_t tag = msg[0];
+        uint16_t len = msg[1] | (msg[2] << 8);
+        SOCKET_CHECK(len <= LT_TCP_MAX_PAYLOAD_LEN);
+        if (read_exact(model->fd, &msg[LT_TCP_TAG_AND_LENGTH_SIZE], len) != 0) {
+            return;
+        }
+        const uint8_t *payload = &msg[LT_TCP_TAG_AND_LENGTH_SIZE];
+        uint8_t *answer_payload = &answer[LT_TCP_TAG_AND_LENGTH_SIZE];
+        uint16_t answer_len = 0;
+
+        model->message_count++;
+        answer[0] = tag;
+        switch (tag) {
+            case LT_TCP_TAG_SPI_DRIVE_CSN_LOW:
+                break;
+            case LT_TCP_TAG_SPI_DRIVE_CSN_HIGH:
+                model->csn_high_count++;
+                break;
+            case LT_TCP_TAG_SPI_SEND:
+                answer_len = serve_segment(model, 0, payload, len, answer_payload);
+                break;
+            case LT_TCP_TAG_SPI_TRANSACTION:
+                if (!model->transactions) {
+                    answer[0] = LT_TCP_TAG_INVALID;
+                    break;
+                }
+                for (uint16_t pos = 0; pos < len;) {
+                    SOCKET_CHECK((size_t)(len - pos) >= LT_TCP_SEGMENT_HEADER_SIZE);
+                    uint8_t flags = payload[pos];
+                    uint16_t segment_len = payload[pos + 1] | (payload[pos + 2] << 8);
+                    pos += LT_TCP_SEGMENT_HEADER_SIZE;
+                    SOCKET_CHECK(len - pos >= segment_len);
+                    answer_len
+                        += serve_segment(model, flags, &payload[pos], segment_len, &answer_payload[answer_len]);
+                    pos += segment_len;
+                }
+                break;
+            default:
+                answer[0] = LT_TCP_TAG_INVALID;
+                break;
+        }
+
+        answer[1] = answer_len & 0xff;
+        answer[2] = answer_len >> 8;
+        write_split(model->fd, answer, LT_TCP_TAG_AND_LENGTH_SIZE + answer_len);
+    }
+}
+
+static void *model_thread(void *arg)
+{
+    socket_model_t *model = arg;
+
+    model->fd = accept(model->listen_fd, NULL, NULL);
+    SOCKET_CHECK(model->fd >= 0);
+    serve(model);
+    SOCKET_CHECK(close(model->fd) == 0);
+
+    return NULL;
+}
+
+/**
+ * @brief Sets the frame returned to Get_Response: STATUS, RSP_LEN, RSP_DATA and RSP_CRC.
+ */
+static void set_response(socket_model_t *model, uint8_t status, uint8_t rsp_len)
+{
+    model->chip_status = TR01_L1_CHIP_MODE_READY_bit;
+    model->rsp[0] = status;
+    model->rsp[1] = rsp_len;
+    for (uint16_t i = 0; i < (uint16_t)rsp_len + 2; i++) {
+        model->rsp[2 + i] = (uint8_t)(0x80 + i);
+    }
+}
+
+/**
+ * @brief Reads a frame with lt_port_frame_xfer() and checks it costs exactly one message.
+ */
+static lt_ret_t read_frame(lt_l2_state_t *s2, socket_model_t *model, uint16_t len)
+{
+    int message_count = model->message_count;
+
+    s2->buff[0] = TR01_L1_GET_RESPONSE_REQ_ID;
+    lt_ret_t ret = lt_port_frame_xfer(s2, LT_PORT_FRAME_READ, len, 0);
+    SOCKET_CHECK(model->message_count == message_count + 1);
+
+    return ret;
+}
+
+/**
+ * @brief Starts listening on TCP loopback and points the device to it.
+ */
+static void listen_tcp(socket_model_t *model, lt_dev_posix_tcp_t *device)
+{
+    model->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    SOCKET_CHECK(model->listen_fd >= 0);
+    struct sockaddr_in server = {.sin_family = AF_INET, .sin_addr.s_addr = inet_addr("127.0.0.1"), .sin_port = 0};
+    SOCKET_CHECK(bind(model->listen_fd, (struct sockaddr *)&server, sizeof(server)) == 0);
+    SOCKET_CHECK(listen(model->listen_fd, 1) == 0);
+    socklen_t server_len = sizeof(server);
+    SOCKET_CHECK(getsockname(model->listen_fd, (struct sockaddr *)&server, &server_len) == 0);
+
+    device->addr = server.sin_addr.s_addr;
+    device->port = ntohs(server.sin_port);
+    device->sock_path = NULL;
+}
+
+/**
+ * @brief Starts listening on a Unix domain socket and points the device to it, `addr` and `port` are left invalid.
+ */
+static void listen_unix(socket_model_t *model, lt_dev_posix_tcp_t *device, char *sock_path, size_t sock_path_size)
+{
+    struct sockaddr_un server = {.sun_family = AF_UNIX};
+    SOCKET_CHECK(snprintf(server.sun_path, sizeof(server.sun_path), SOCKET_UNIX_PATH_FMT, (long)getpid())
+                 < (int)sizeof(server.sun_path));
+    LT_UNUSED(unlink(server.sun_path));
+
+    model->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    SOCKET_CHECK(model->listen_fd >= 0);
+    SOCKET_CHECK(bind(model->listen_fd, (struct sockaddr *)&server, sizeof(server)) == 0);
+    SOCKET_CHECK(listen(model->listen_fd, 1) == 0);
+
+    // The optional prefix is accepted.
+    SOCKET_CHECK(snprintf(sock_path, sock_path_size, "%s%s", LT_TCP_UNIX_PREFIX, server.sun_path)
+                 < (int)sock_path_size);
+    device->addr = 0;
+    device->port = 0;
+    device->sock_path = sock_path;
+}
+
+static void run_case(bool transactions, bool unix_socket)
+{
+    LT_LOG_INFO("Server on %s, %s LT_TCP_TAG_SPI_TRANSACTION.", unix_socket ? "Unix domain socket" : "TCP",
+                transactions ? "supports" : "does not support");
+
+    socket_model_t model = {.transactions = transactions};
+    lt_dev_posix_tcp_t device;
+    char sock_path[sizeof(LT_TCP_UNIX_PREFIX) + sizeof(((struct sockaddr_un *)0)->sun_path)];
+    if (unix_socket) {
+        listen_unix(&model, &device, sock_path, sizeof(sock_path));
+    }
+    else {
+        listen_tcp(&model, &device);
+    }
+
+    pthread_t thread;
+    SOCKET_CHECK(pthread_create(&thread, NULL, model_thread, &model) == 0);
+
+    lt_l2_state_t s2 = {0};
+    s2.device = &device;
+
+    // Support of the transaction tag is detected by one message.
+    SOCKET_CHECK(lt_port_init(&s2) == LT_OK);
+    SOCKET_CHECK(model.message_count == 1);
+
+    if (transactions) {
+        // Writing L2 Request frame costs one round trip.
+        uint16_t len = 12;
+        for (uint16_t j = 0; j < len; j++) {
+            s2.buff[j] = (uint8_t)j;
+        }
+        SOCKET_CHECK(lt_port_frame_xfer(&s2, LT_PORT_FRAME_WRITE, len, 0) == LT_OK);
+        SOCKET_CHECK(model.message_count == 2);
+        for (uint16_t j = 0; j < len; j++) {
+            SOCKET_CHECK(s2.buff[j] == ((uint8_t)j ^ SOCKET_MISO_XOR));
+        }
+
+        // Reading L2 Response frame costs one round trip, the server stops at the end of the frame.
+        set_response(&model, 0x01, 200);
+        SOCKET_CHECK(read_frame(&s2, &model, TR01_L1_LEN_MAX) == LT_OK);
+        SOCKET_CHECK(s2.buff[0] == TR01_L1_CHIP_MODE_READY_bit);
+        SOCKET_CHECK(memcmp(&s2.buff[1], model.rsp, 2 + 200 + 2) == 0);
+
+        // No response yet, the frame ends after RSP_LEN.
+        set_response(&model, 0xff, 0);
+        SOCKET_CHECK(read_frame(&s2, &model, TR01_L1_LEN_MAX) == LT_OK);
+        SOCKET_CHECK(s2.buff[1] == 0xff);
+
+        // Chip busy, the frame ends after CHIP_STATUS.
+        model.chip_status = 0;
+        SOCKET_CHECK(read_frame(&s2, &model, TR01_L1_LEN_MAX) == LT_OK);
+        SOCKET_CHECK(s2.buff[0] == 0);
+
+        // Frame longer than the given length.
+        set_response(&model, 0x01, 100);
+        SOCKET_CHECK(read_frame(&s2, &model, 50) == LT_L1_DATA_LEN_ERROR);
+    }
+    else {
+        // Without the transaction tag, L1 falls back to the separate tags.
+        SOCKET_CHECK(lt_port_frame_xfer(&s2, LT_PORT_FRAME_WRITE, 12, 0) == LT_NOT_SUPPORTED);
+        SOCKET_CHECK(model.message_count == 1);
+    }
+
+    // Separate tags are used as before, one round trip each.
+    int message_count = model.message_count;
+    uint16_t len = TR01_L1_LEN_MAX - 1;
+    for (uint16_t j = 0; j < len; j++) {
+        s2.buff[j] = (uint8_t)j;
+    }
+    SOCKET_CHECK(lt_port_spi_csn_low(&s2) == LT_OK);
+    SOCKET_CHECK(lt_port_spi_transfer(&s2, 1, len, 0) == LT_OK);
+    SOCKET_CHECK(lt_port_spi_csn_high(&s2) == LT_OK);
+    SOCKET_CHECK(model.message_count == message_count + 3);
+    SOCKET_CHECK(model.csn_high_count == 1);
+    for (uint16_t j = 0; j < len; j++) {
+        SOCKET_CHECK(s2.buff[1 + j] == ((uint8_t)j ^ SOCKET_MISO_XOR));
+    }
+
+    // Reading the socket fails once the HAL disconnects, which stops the emulated server.
+    SOCKET_CHECK(lt_port_deinit(&s2) == LT_OK);
+    SOCKET_CHECK(pthread_join(thread, NULL) == 0);
+    SOCKET_CHECK(close(model.listen_fd) == 0);
+    if (unix_socket) {
+        SOCKET_CHECK(unlink(sock_path + strlen(LT_TCP_UNIX_PREFIX)) == 0);
+    }
+}
+
+int main(void)
+{
+    LT_UNUSED(setvbuf(stdout, NULL, _IONBF, 0));
+    LT_UNUSED(setvbuf(stderr, NULL, _IONBF, 0));
+
+    run_case(true, false);
+    run_case(false, false);
+    run_case(true, true);
+    run_case(false, true);
+
+    LT_LOG_INFO("Test finished!");
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file lt_mock_cert_store.c
+ * @brief Certificate store of the mocked TROPIC01 for functional mock tests.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "lt_mock_cert_store.h"
+
+#include "lt_mock_helpers.h"
+
+// clang-format off
+const uint8_t mock_cert_store[MOCK_CERT_STORE_BLOCK_COUNT * MOCK_CERT_STORE_BLOCK_LEN] = {
+    0x01, 0x04, 0x01, 0xb6, 0x01, 0xdc, 0x01, 0xd5, 0x01, 0xe0, 0x30, 0x82, 0x01, 0xb2, 0x30, 0x82,
+    0x01, 0x58, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x08, 0x33, 0x93, 0x88, 0xd4, 0x6f, 0xf9, 0xfb,
+    0xc0, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x40, 0x31,
+    0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x0e, 0x4c, 0x69, 0x62, 0x74, 0x72, 0x6f,
+    0x70, 0x69, 0x63, 0x20, 0x54, 0x65, 0x73, 0x74, 0x31, 0x25, 0x30, 0x23, 0x06, 0x03, 0x55, 0x04,
+    0x03, 0x0c, 0x1c, 0x4c, 0x69, 0x62, 0x74, 0x72, 0x6f, 0x70, 0x69, 0x63, 0x20, 0x54, 0x65, 0x73,
+    0x74, 0x20, 0x54, 0x52, 0x4f, 0x50, 0x49, 0x43, 0x30, 0x31, 0x2d, 0x58, 0x20, 0x43, 0x41, 0x30,
+    0x1e, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x36, 0x32, 0x30, 0x33, 0x32, 0x30, 0x32, 0x5a,
+    0x17, 0x0d, 0x34, 0x35, 0x31, 0x32, 0x31, 0x35, 0x32, 0x30, 0x33, 0x32, 0x30, 0x32, 0x5a, 0x30,
+    0x4b, 0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x0e, 0x4c, 0x69, 0x62, 0x74,
+    0x72, 0x6f, 0x70, 0x69, 0x63, 0x20, 0x54, 0x65, 0x73, 0x74, 0x31, 0x15, 0x30, 0x13, 0x06, 0x03,
+    0x55, 0x04, 0x03, 0x0c, 0x0c, 0x54, 0x52, 0x4f, 0x50, 0x49, 0x43, 0x30, 0x31, 0x20, 0x65, 0x53,
+    0x45, 0x31, 0x19, 0x30, 0x17, 0x06, 0x03, 0x55, 0x04, 0x05, 0x13, 0x10, 0x30, 0x31, 0x32, 0x33,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x30, 0x2a, 0x30, 0x05,
+    0x06, 0x03, 0x2b, 0x65, 0x6e, 0x03, 0x21, 0x00, 0xfd, 0xf5, 0x2e, 0x79, 0xed, 0x92, 0x85, 0x1c,
+    0xd3, 0x17, 0xd5, 0x99, 0x69, 0xa1, 0x5a, 0x18, 0x99, 0x0a, 0x12, 0x34, 0xa0, 0x14, 0x6b, 0xb0,
+    0xc9, 0xf5, 0x3b, 0xa2, 0x1f, 0x56, 0x4f, 0x4e, 0xa3, 0x60, 0x30, 0x5e, 0x30, 0x0c, 0x06, 0x03,
+    0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x02, 0x30, 0x00, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d,
+    0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x03, 0x08, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d,
+    0x0e, 0x04, 0x16, 0x04, 0x14, 0x07, 0xaa, 0xe5, 0xac, 0x6f, 0xaf, 0xed, 0xba, 0x2c, 0xc7, 0x50,
+    0x78, 0xb5, 0x01, 0x01, 0x25, 0x1e, 0x0b, 0x6e, 0x39, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23,
+    0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x45, 0x8d, 0xcd, 0x1c, 0x8e, 0xa7, 0xd7, 0x30, 0x21, 0x05,
+    0x74, 0x37, 0x9a, 0x94, 0x7d, 0x20, 0xd2, 0xef, 0x58, 0xd5, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86,
+    0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x21, 0x00, 0xb7, 0x89,
+    0x99, 0x46, 0x49, 0xa0, 0x2c, 0x1d, 0x68, 0x77, 0xe6, 0x25, 0x57, 0xb9, 0x97, 0x5d, 0x6e, 0x54,
+    0x74, 0x10, 0x02, 0x08, 0xf3, 0x35, 0xf0, 0x62, 0xaa, 0x15, 0x0b, 0x60, 0x58, 0x6b, 0x02, 0x20,
+    0x1e, 0x6e, 0x94, 0xd2, 0x72, 0xd9, 0xba, 0x50, 0xc4, 0x25, 0x6a, 0x76, 0xff, 0x7b, 0x0b, 0x33,
+    0x07, 0x72, 0x89, 0x16, 0xd9, 0x79, 0x4a, 0xe8, 0x74, 0xe1, 0x0e, 0x80, 0xe6, 0x69, 0xfd, 0xa8,
+    0x30, 0x82, 0x01, 0xd8, 0x30, 0x82, 0x01, 0x7d, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x08, 0x2c,
+    0x38, 0xb6, 0xc0, 0x27, 0xfc, 0xba, 0x61, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+    0x04, 0x03, 0x02, 0x30, 0x3e, 0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x0e,
+    0x4c, 0x69, 0x62, 0x74, 0x72, 0x6f, 0x70, 0x69, 0x63, 0x20, 0x54, 0x65, 0x73, 0x74, 0x31, 0x23,
+    0x30, 0x21, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x1a, 0x4c, 0x69, 0x62, 0x74, 0x72, 0x6f, 0x70,
+    0x69, 0x63, 0x20, 0x54, 0x65, 0x73, 0x74, 0x20, 0x54, 0x52, 0x4f, 0x50, 0x49, 0x43, 0x30, 0x31,
+    0x20, 0x43, 0x41, 0x30, 0x1e, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x36, 0x32, 0x30, 0x33,
+    0x32, 0x30, 0x32, 0x5a, 0x17, 0x0d, 0x34, 0x38, 0x30, 0x39, 0x31, 0x30, 0x32, 0x30, 0x33, 0x32,
+    0x30, 0x32, 0x5a, 0x30, 0x40, 0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x0e,
+    0x4c, 0x69, 0x62, 0x74, 0x72, 0x6f, 0x70, 0x69, 0x63, 0x20, 0x54, 0x65, 0x73, 0x74, 0x31, 0x25,
+    0x30, 0x23, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x1c, 0x4c, 0x69, 0x62, 0x74, 0x72, 0x6f, 0x70,
+    0x69, 0x63, 0x20, 0x54, 0x65, 0x73, 0x74, 0x20, 0x54, 0x52, 0x4f, 0x50, 0x49, 0x43, 0x30, 0x31,
+    0x2d, 0x58, 0x20, 0x43, 0x41, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+    0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04,
+    0x19, 0x13, 0x25, 0x52, 0x45, 0xd9, 0xf2, 0x1a, 0x3a, 0x37, 0x3e, 0x78, 0xdc, 0x39, 0xbe, 0x06,
+    0x9a, 0x30, 0x94, 0x1c, 0x8b, 0x30, 0xb2, 0xc0, 0x3b, 0xa0, 0x4c, 0x4b, 0xe8, 0x3a, 0x95, 0x7d,
+    0x0a, 0x2a, 0xab, 0xf5, 0xdd, 0xe9, 0xcb, 0x71, 0x62, 0x8b, 0x5d, 0xe6, 0xb6, 0x59, 0xc3, 0xf9,
+    0x64, 0xee, 0x0d, 0xee, 0x81, 0x76, 0x26, 0x69, 0x1b, 0x22, 0x0a, 0xf9, 0xe6, 0xaa, 0x91, 0xb1,
+    0xa3, 0x63, 0x30, 0x61, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05,
+    0x30, 0x03, 0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04,
+    0x04, 0x03, 0x02, 0x01, 0x06, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14,
+    0x45, 0x8d, 0xcd, 0x1c, 0x8e, 0xa7, 0xd7, 0x30, 0x21, 0x05, 0x74, 0x37, 0x9a, 0x94, 0x7d, 0x20,
+    0xd2, 0xef, 0x58, 0xd5, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80,
+    0x14, 0x12, 0xe5, 0x91, 0xbf, 0x73, 0x00, 0x9d, 0x7f, 0x38, 0x33, 0xaf, 0x2f, 0xbf, 0x78, 0xd8,
+    0x78, 0xbd, 0xf4, 0xd5, 0xc6, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03,
+    0x02, 0x03, 0x49, 0x00, 0x30, 0x46, 0x02, 0x21, 0x00, 0x8b, 0xcb, 0x23, 0x67, 0x95, 0xc8, 0x93,
+    0x59, 0x42, 0xbf, 0x24, 0x60, 0x23, 0x77, 0xfd, 0x37, 0x91, 0x91, 0x39, 0x16, 0xe9, 0x7a, 0x67,
+    0xc6, 0x89, 0xf1, 0x99, 0xed, 0x5a, 0x61, 0x8e, 0xda, 0x02, 0x21, 0x00, 0xad, 0x0f, 0x09, 0x30,
+    0xed, 0x86, 0x61, 0x84, 0x5e, 0xd7, 0xfe, 0x64, 0x57, 0xbf, 0x82, 0x2a, 0x98, 0x67, 0x0c, 0xfc,
+    0x17, 0xa5, 0x04, 0xc4, 0x5a, 0xa7, 0x4e, 0x29, 0x5a, 0xe9, 0x21, 0x17, 0x30, 0x82, 0x01, 0xd1,
+    0x30, 0x82, 0x01, 0x77, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x08, 0x32, 0x8f, 0xfd, 0x75, 0x3e,
+    0xda, 0x49, 0xed, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30,
+    0x3a, 0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x0e, 0x4c, 0x69, 0x62, 0x74,
+    0x72, 0x6f, 0x70, 0x69, 0x63, 0x20, 0x54, 0x65, 0x73, 0x74, 0x31, 0x1f, 0x30, 0x1d, 0x06, 0x03,
+    0x55, 0x04, 0x03, 0x0c, 0x16, 0x4c, 0x69, 0x62, 0x74, 0x72, 0x6f, 0x70, 0x69, 0x63, 0x20, 0x54,
+    0x65, 0x73, 0x74, 0x20, 0x52, 0x6f, 0x6f, 0x74, 0x20, 0x43, 0x41, 0x30, 0x1e, 0x17, 0x0d, 0x32,
+    0x36, 0x31, 0x30, 0x31, 0x36, 0x32, 0x30, 0x33, 0x32, 0x30, 0x32, 0x5a, 0x17, 0x0d, 0x34, 0x38,
+    0x30, 0x39, 0x31, 0x30, 0x32, 0x30, 0x33, 0x32, 0x30, 0x32, 0x5a, 0x30, 0x3e, 0x31, 0x17, 0x30,
+    0x15, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x0e, 0x4c, 0x69, 0x62, 0x74, 0x72, 0x6f, 0x70, 0x69,
+    0x63, 0x20, 0x54, 0x65, 0x73, 0x74, 0x31, 0x23, 0x30, 0x21, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c,
+    0x1a, 0x4c, 0x69, 0x62, 0x74, 0x72, 0x6f, 0x70, 0x69, 0x63, 0x20, 0x54, 0x65, 0x73, 0x74, 0x20,
+    0x54, 0x52, 0x4f, 0x50, 0x49, 0x43, 0x30, 0x31, 0x20, 0x43, 0x41, 0x30, 0x59, 0x30, 0x13, 0x06,
+    0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03,
+    0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0xbf, 0x7c, 0x13, 0xc9, 0x01, 0xf7, 0xf3, 0x87, 0x38, 0x8b,
+    0x6b, 0xe5, 0xb1, 0x47, 0x1c, 0xa5, 0x01, 0xff, 0x15, 0xce, 0xc4, 0xab, 0x8e, 0x5c, 0x32, 0xf0,
+    0x35, 0x90, 0xf6, 0x72, 0x2c, 0x61, 0x80, 0xee, 0x62, 0x91, 0x20, 0x38, 0x5b, 0x72, 0xa6, 0xa8,
+    0xa9, 0x0b, 0x6c, 0xe5, 0x48, 0xe9, 0xf4, 0xc7, 0xbf, 0x5a, 0x9f, 0x47, 0x09, 0xc9, 0x7f, 0xff,
+    0x1a, 0xd4, 0x04, 0xbc, 0x7c, 0x70, 0xa3, 0x63, 0x30, 0x61, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d,
+    0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55,
+    0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x01, 0x06, 0x30, 0x1d, 0x06, 0x03, 0x55,
+    0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x12, 0xe5, 0x91, 0xbf, 0x73, 0x00, 0x9d, 0x7f, 0x38, 0x33,
+    0xaf, 0x2f, 0xbf, 0x78, 0xd8, 0x78, 0xbd, 0xf4, 0xd5, 0xc6, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d,
+    0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x31, 0x20, 0xf8, 0xa2, 0x70, 0xb2, 0x31, 0x37, 0x57,
+    0x29, 0x7b, 0x63, 0xee, 0x36, 0x84, 0xe2, 0x41, 0x0b, 0x60, 0xf9, 0x30, 0x0a, 0x06, 0x08, 0x2a,
+    0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x21, 0x00, 0xc2,
+    0x78, 0x5c, 0x9e, 0x1b, 0x44, 0x83, 0x90, 0xb0, 0xaf, 0xde, 0x7e, 0x38, 0xdd, 0xc2, 0x41, 0x57,
+    0x94, 0x9b, 0x6d, 0x79, 0x7b, 0x33, 0xe5, 0xbf, 0x6c, 0xe8, 0xd0, 0xa0, 0x73, 0xae, 0xb5, 0x02,
+    0x20, 0x1a, 0xe6, 0x9a, 0xcb, 0xc9, 0x26, 0x3e, 0x50, 0x78, 0x7b, 0x57, 0x4a, 0x2a, 0x60, 0xc6,
+    0x31, 0x35, 0x82, 0x4f, 0x7f, 0xd0, 0x3b, 0x5b, 0xf9, 0x6b, 0xe1, 0xb4, 0x54, 0x09, 0x9d, 0x3e,
+    0xd5, 0x30, 0x82, 0x01, 0xdc, 0x30, 0x82, 0x01, 0x81, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x14,
+    0x03, 0xb3, 0x2a, 0x31, 0xac, 0x3d, 0xf4, 0x92, 0x55, 0xe3, 0x93, 0x49, 0x67, 0xf3, 0x3e, 0x83,
+    0xce, 0xc9, 0x81, 0xa4, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02,
+    0x30, 0x3a, 0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x0e, 0x4c, 0x69, 0x62,
+    0x74, 0x72, 0x6f, 0x70, 0x69, 0x63, 0x20, 0x54, 0x65, 0x73, 0x74, 0x31, 0x1f, 0x30, 0x1d, 0x06,
+    0x03, 0x55, 0x04, 0x03, 0x0c, 0x16, 0x4c, 0x69, 0x62, 0x74, 0x72, 0x6f, 0x70, 0x69, 0x63, 0x20,
+    0x54, 0x65, 0x73, 0x74, 0x20, 0x52, 0x6f, 0x6f, 0x74, 0x20, 0x43, 0x41, 0x30, 0x20, 0x17, 0x0d,
+    0x32, 0x36, 0x31, 0x30, 0x31, 0x36, 0x32, 0x30, 0x33, 0x32, 0x30, 0x32, 0x5a, 0x18, 0x0f, 0x32,
+    0x30, 0x35, 0x31, 0x30, 0x36, 0x30, 0x37, 0x32, 0x30, 0x33, 0x32, 0x30, 0x32, 0x5a, 0x30, 0x3a,
+    0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x0e, 0x4c, 0x69, 0x62, 0x74, 0x72,
+    0x6f, 0x70, 0x69, 0x63, 0x20, 0x54, 0x65, 0x73, 0x74, 0x31, 0x1f, 0x30, 0x1d, 0x06, 0x03, 0x55,
+    0x04, 0x03, 0x0c, 0x16, 0x4c, 0x69, 0x62, 0x74, 0x72, 0x6f, 0x70, 0x69, 0x63, 0x20, 0x54, 0x65,
+    0x73, 0x74, 0x20, 0x52, 0x6f, 0x6f, 0x74, 0x20, 0x43, 0x41, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07,
+    0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01,
+    0x07, 0x03, 0x42, 0x00, 0x04, 0xb4, 0xb4, 0x6c, 0x1c, 0x2b, 0x24, 0xb3, 0x09, 0xb5, 0x26, 0x35,
+    0x58, 0x9c, 0x2a, 0xa5, 0x5c, 0x8e, 0xb8, 0xb2, 0x56, 0xa5, 0x0f, 0x00, 0x5d, 0x58, 0xcb, 0xac,
+    0x3b, 0x29, 0x04, 0x54, 0xf8, 0x7d, 0xa1, 0xb9, 0x84, 0x48, 0xe4, 0xef, 0x54, 0x2d, 0x10, 0x46,
+    0xec, 0xf8, 0x08, 0xa2, 0xfd, 0xa7, 0xa2, 0x6d, 0xd6, 0xb2, 0x6b, 0x0c, 0xd4, 0x79, 0x24, 0x68,
+    0x9c, 0x3d, 0x5d, 0x08, 0x3a, 0xa3, 0x63, 0x30, 0x61, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e,
+    0x04, 0x16, 0x04, 0x14, 0x31, 0x20, 0xf8, 0xa2, 0x70, 0xb2, 0x31, 0x37, 0x57, 0x29, 0x7b, 0x63,
+    0xee, 0x36, 0x84, 0xe2, 0x41, 0x0b, 0x60, 0xf9, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04,
+    0x18, 0x30, 0x16, 0x80, 0x14, 0x31, 0x20, 0xf8, 0xa2, 0x70, 0xb2, 0x31, 0x37, 0x57, 0x29, 0x7b,
+    0x63, 0xee, 0x36, 0x84, 0xe2, 0x41, 0x0b, 0x60, 0xf9, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13,
+    0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d,
+    0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x01, 0x06, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86,
+    0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x49, 0x00, 0x30, 0x46, 0x02, 0x21, 0x00, 0xa8, 0x3f,
+    0x03, 0x47, 0x12, 0x58, 0x66, 0x2e, 0xb9, 0x1d, 0x70, 0xe3, 0x78, 0xb4, 0x8f, 0x56, 0x31, 0x25,
+    0x4d, 0x3d, 0xeb, 0x41, 0x0c, 0x19, 0x50, 0x51, 0x7c, 0x73, 0xa5, 0xae, 0x2f, 0xf4, 0x02, 0x21,
+    0x00, 0xb4, 0x37, 0xf7, 0x8e, 0x32, 0xe7, 0xa9, 0x2b, 0x01, 0x71, 0x02, 0xe5, 0xdc, 0x0a, 0x58,
+    0x81, 0xd0, 0x76, 0x5d, 0x08, 0x95, 0x53, 0x37, 0x94, 0x41, 0xe2, 0xc2, 0x2c, 0x25, 0x3e, 0x21,
+    0x0c,
+};
+
+const uint8_t mock_stpriv[TR01_STPRIV_LEN] = {
+    0xb0, 0x0d, 0x50, 0xb4, 0xc1, 0x35, 0xff, 0xfd, 0x2e, 0x1a, 0x96, 0xd1, 0xd0, 0xa9, 0xbb, 0xc4,
+    0x4c, 0xa7, 0xfd, 0xcd, 0x6a, 0xa4, 0x5a, 0xd9, 0xd7, 0x80, 0xd1, 0x1d, 0xdd, 0x2e, 0x92, 0x40,
+};
+
+const uint8_t mock_stpub[TR01_STPUB_LEN] = {
+    0xfd, 0xf5, 0x2e, 0x79, 0xed, 0x92, 0x85, 0x1c, 0xd3, 0x17, 0xd5, 0x99, 0x69, 0xa1, 0x5a, 0x18,
+    0x99, 0x0a, 0x12, 0x34, 0xa0, 0x14, 0x6b, 0xb0, 0xc9, 0xf5, 0x3b, 0xa2, 0x1f, 0x56, 0x4f, 0x4e,
+};
+
+const uint8_t mock_device_cert_2[MOCK_DEVICE_CERT_2_LEN] = {
+    0x30, 0x82, 0x01, 0xbf, 0x30, 0x82, 0x01, 0x64, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x14, 0x21,
+    0xb8, 0xa2, 0xc9, 0xd0, 0x4e, 0xbc, 0xcb, 0x9f, 0x42, 0x8b, 0x45, 0x82, 0x19, 0x43, 0x29, 0x2a,
+    0x27, 0x28, 0x81, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30,
+    0x40, 0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x0e, 0x4c, 0x69, 0x62, 0x74,
+    0x72, 0x6f, 0x70, 0x69, 0x63, 0x20, 0x54, 0x65, 0x73, 0x74, 0x31, 0x25, 0x30, 0x23, 0x06, 0x03,
+    0x55, 0x04, 0x03, 0x0c, 0x1c, 0x4c, 0x69, 0x62, 0x74, 0x72, 0x6f, 0x70, 0x69, 0x63, 0x20, 0x54,
+    0x65, 0x73, 0x74, 0x20, 0x54, 0x52, 0x4f, 0x50, 0x49, 0x43, 0x30, 0x31, 0x2d, 0x58, 0x20, 0x43,
+    0x41, 0x30, 0x1e, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x36, 0x32, 0x30, 0x34, 0x34, 0x32,
+    0x37, 0x5a, 0x17, 0x0d, 0x34, 0x35, 0x31, 0x32, 0x31, 0x35, 0x32, 0x30, 0x34, 0x34, 0x32, 0x37,
+    0x5a, 0x30, 0x4b, 0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x0e, 0x4c, 0x69,
+    0x62, 0x74, 0x72, 0x6f, 0x70, 0x69, 0x63, 0x20, 0x54, 0x65, 0x73, 0x74, 0x31, 0x15, 0x30, 0x13,
+    0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0c, 0x54, 0x52, 0x4f, 0x50, 0x49, 0x43, 0x30, 0x31, 0x20,
+    0x65, 0x53, 0x45, 0x31, 0x19, 0x30, 0x17, 0x06, 0x03, 0x55, 0x04, 0x05, 0x13, 0x10, 0x30, 0x31,
+    0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x41, 0x42, 0x43, 0x44, 0x46, 0x30, 0x30, 0x2a,
+    0x30, 0x05, 0x06, 0x03, 0x2b, 0x65, 0x6e, 0x03, 0x21, 0x00, 0xc3, 0xa1, 0xc0, 0xf2, 0x52, 0x20,
+    0x36, 0xe9, 0x81, 0xcd, 0x7d, 0xf5, 0xc9, 0x87, 0x37, 0xcd, 0x4e, 0x37, 0x71, 0x42, 0xa7, 0xfb,
+    0xd2, 0xb1, 0xd8, 0xeb, 0xb8, 0xd6, 0x56, 0xcb, 0x33, 0x14, 0xa3, 0x60, 0x30, 0x5e, 0x30, 0x0c,
+    0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x02, 0x30, 0x00, 0x30, 0x0e, 0x06, 0x03,
+    0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x03, 0x08, 0x30, 0x1d, 0x06, 0x03,
+    0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x11, 0x3f, 0x75, 0x8f, 0x4a, 0x30, 0x33, 0xf3, 0xf1,
+    0x86, 0x36, 0x36, 0xf3, 0x21, 0xc6, 0xcf, 0xab, 0x19, 0x9b, 0x07, 0x30, 0x1f, 0x06, 0x03, 0x55,
+    0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x45, 0x8d, 0xcd, 0x1c, 0x8e, 0xa7, 0xd7, 0x30,
+    0x21, 0x05, 0x74, 0x37, 0x9a, 0x94, 0x7d, 0x20, 0xd2, 0xef, 0x58, 0xd5, 0x30, 0x0a, 0x06, 0x08,
+    0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x49, 0x00, 0x30, 0x46, 0x02, 0x21, 0x00,
+    0xa0, 0xa6, 0xea, 0xe0, 0x92, 0x21, 0x69, 0x81, 0xa7, 0xe1, 0xab, 0x3d, 0xda, 0x1d, 0x6b, 0xb8,
+    0x8d, 0xe4, 0xd8, 0x4d, 0x9e, 0x7a, 0x2e, 0x49, 0xae, 0x10, 0x50, 0x99, 0x0e, 0xe3, 0xcb, 0x88,
+    0x02, 0x21, 0x00, 0xf9, 0x7f, 0xb7, 0xf3, 0x8c, 0x13, 0xc6, 0x93, 0xc4, 0xf5, 0x66, 0x1f, 0x33,
+    0xad, 0xb9, 0x07, 0xb2, 0xe9, 0x45, 0x31, 0x5a, 0x0f, 0x92, 0x3d, 0x7c, 0xd2, 0x6a, 0x70, 0x39,
+    0xe6, 0x3d, 0xd0,
+};
+// clang-format on
+
+lt_ret_t mock_get_info_cert_store(lt_handle_t *h, const size_t block_count)
+{
+    if (block_count > MOCK_CERT_STORE_BLOCK_COUNT) {
+        return LT_PARAM_ERR;
+    }
+
+    for (size_t i = 0; i < block_count; i++) {
+        lt_ret_t ret = mock_get_info(h, &mock_cert_store[i * MOCK_CERT_STORE_BLOCK_LEN], MOCK_CERT_STORE_BLOCK_LEN);
+        if (LT_OK != ret) {
+            return ret;
+        }
+    }
+
+    return LT_OK;
+}
@@ -0,0 +1,69 @@
+#ifndef LT_MOCK_CERT_STORE_H
+#define LT_MOCK_CERT_STORE_H
+
+/**
+ * @file lt_mock_cert_store.h
+ * @brief Certificate store of the mocked TROPIC01 for functional mock tests.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "libtropic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Length of the Certificate Store header (version, number of certificates and their lengths). */
+#define MOCK_CERT_STORE_HEADER_LEN (2 + 2 * LT_NUM_CERTIFICATES)
+/** @brief Length of the mocked Certificate Store. */
+#define MOCK_CERT_STORE_LEN 1873
+/** @brief Offset in the mocked Certificate Store right after the last byte of STPub. */
+#define MOCK_CERT_STORE_STPUB_END 264
+/** @brief Length of the device certificate of another mocked TROPIC01. */
+#define MOCK_DEVICE_CERT_2_LEN 451
+/** @brief Size of a Get_Info block of the Certificate Store. */
+#define MOCK_CERT_STORE_BLOCK_LEN 128
+/** @brief Number of Get_Info blocks holding the mocked Certificate Store. */
+#define MOCK_CERT_STORE_BLOCK_COUNT ((MOCK_CERT_STORE_LEN + MOCK_CERT_STORE_BLOCK_LEN - 1) / MOCK_CERT_STORE_BLOCK_LEN)
+
+/**
+ * @brief Certificate Store of the mocked TROPIC01, as read by Get_Info.
+ *
+ * @details The certificates form a test PKI unrelated to the Tropic Square one, generated with OpenSSL: self-signed
+ * root CA, TROPIC01 CA and TROPIC01-X CA with ECDSA P-256 keys and SHA-256 signatures, and the device certificate
+ * with the X25519 key STPub. The store is padded with zeroes to whole blocks.
+ */
+extern const uint8_t mock_cert_store[MOCK_CERT_STORE_BLOCK_COUNT * MOCK_CERT_STORE_BLOCK_LEN];
+
+/** @brief STPriv of the mocked TROPIC01, matching STPub in the device certificate. */
+extern const uint8_t mock_stpriv[TR01_STPRIV_LEN];
+
+/** @brief STPub of the mocked TROPIC01. */
+extern const uint8_t mock_stpub[TR01_STPUB_LEN];
+
+/**
+ * @brief Device certificate of another mocked TROPIC01, issued by the same TROPIC01-X CA as the one in
+ * `mock_cert_store`.
+ */
+extern const uint8_t mock_device_cert_2[MOCK_DEVICE_CERT_2_LEN];
+
+/**
+ * @brief Mock replies to Get_Info requests of the first `block_count` blocks of the mocked Certificate Store.
+ *
+ * @param h Pointer to an lt_handle_t to use (for enqueuing).
+ * @param block_count Number of blocks to mock, at most MOCK_CERT_STORE_BLOCK_COUNT.
+ *
+ * @return LT_OK on success, or an appropriate lt_ret_t error code on failure.
+ */
+lt_ret_t mock_get_info_cert_store(lt_handle_t *h, const size_t block_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LT_MOCK_CERT_STORE_H
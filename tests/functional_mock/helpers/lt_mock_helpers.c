@@ -9,17 +9,25 @@
 #include "lt_mock_helpers.h"
 
 #include <memory.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include "libtropic_common.h"
 #include "libtropic_logging.h"
+#include "libtropic_macros.h"
 #include "libtropic_port_mock.h"
 #include "lt_aesgcm.h"
 #include "lt_crc16.h"
+#include "lt_hkdf.h"
 #include "lt_l1.h"
 #include "lt_l2_api_structs.h"
 #include "lt_l2_frame_check.h"
 #include "lt_l3_process.h"
+#include "lt_port_wrap.h"
+#include "lt_secure_memzero.h"
+#include "lt_sha256.h"
+#include "lt_x25519.h"
 
 void add_resp_crc(void *resp_buf)
 {
@@ -112,52 +120,62 @@ lt_ret_t mock_session_abort(lt_handle_t *h)
 
 lt_ret_t mock_l3_result(lt_handle_t *h, const uint8_t *result_plaintext, const size_t result_plaintext_size)
 {
-    uint8_t l2_frame[TR01_L2_MAX_FRAME_SIZE];
+    return mock_l3_result_part(h, result_plaintext, result_plaintext_size, SIZE_MAX);
+}
+
+lt_ret_t mock_l3_result_part(lt_handle_t *h, const uint8_t *result_plaintext, const size_t result_plaintext_size,
+                             const size_t chunk_count)
+{
+    uint8_t packet[TR01_L3_PACKET_MAX_SIZE];
+    uint8_t l2_frame[TR01_L1_LEN_MAX];
 
     size_t packet_size = TR01_L3_SIZE_SIZE + result_plaintext_size + TR01_L3_TAG_SIZE;
-    size_t frame_size = TR01_L1_CHIP_STATUS_SIZE + TR01_L2_STATUS_SIZE + TR01_L2_REQ_RSP_LEN_SIZE + packet_size
-                        + TR01_L2_REQ_RSP_CRC_SIZE;
 
-    if (packet_size > TR01_L2_CHUNK_MAX_DATA_SIZE) {
-        LT_LOG_ERROR("Payloads >%u B not supported due to chunking not implemented.", TR01_L2_CHUNK_MAX_DATA_SIZE);
+    if (packet_size > sizeof(packet)) {
+        LT_LOG_ERROR("Payloads >%zu B not supported.", sizeof(packet) - TR01_L3_SIZE_SIZE - TR01_L3_TAG_SIZE);
         return LT_PARAM_ERR;
     }
 
-    // This will happen only if the internal macros are implemented incorrectly.
-    if (frame_size > TR01_L2_MAX_FRAME_SIZE) {
-        LT_LOG_ERROR("Implementation error! Total frame size won't fit to the buffer. Need at least: %zu", frame_size);
-        return LT_FAIL;
-    }
-
-    l2_frame[TR01_L2_CHIP_STATUS_OFFSET] = TR01_L1_CHIP_MODE_READY_bit;
-    l2_frame[TR01_L2_STATUS_OFFSET] = TR01_L2_STATUS_RESULT_OK;
-    l2_frame[TR01_L2_RSP_LEN_OFFSET] = (uint8_t)packet_size;
-
-    l2_frame[TR01_L2_RSP_DATA_RSP_CRC_OFFSET] = result_plaintext_size;
-    l2_frame[TR01_L2_RSP_DATA_RSP_CRC_OFFSET + 1] = 0x00;
+    packet[0] = result_plaintext_size & 0xFF;
+    packet[1] = result_plaintext_size >> 8;
 
     lt_ret_t ret;
     if (LT_OK
-        != (ret
-            = lt_aesgcm_encrypt(h->l3.crypto_ctx, h->l3.decryption_IV, TR01_L3_IV_SIZE, NULL, 0, result_plaintext,
-                                result_plaintext_size, &l2_frame[TR01_L2_RSP_DATA_RSP_CRC_OFFSET + TR01_L3_SIZE_SIZE],
-                                result_plaintext_size + TR01_L3_TAG_SIZE))) {
+        != (ret = lt_aesgcm_encrypt(h->l3.crypto_ctx, h->l3.decryption_IV, TR01_L3_IV_SIZE, NULL, 0, result_plaintext,
+                                    result_plaintext_size, &packet[TR01_L3_SIZE_SIZE],
+                                    result_plaintext_size + TR01_L3_TAG_SIZE))) {
         LT_LOG_ERROR("Encryption failed! ret=%d", ret);
         return ret;
     }
     // As the mock helpers share CAL interface with Libtropic (simplification), IV is handled in the Libtropic itself ->
     // no need to increment here.
 
-    uint16_t crc
-        = crc16(&l2_frame[TR01_L2_STATUS_OFFSET], TR01_L2_STATUS_SIZE + TR01_L2_REQ_RSP_LEN_SIZE + packet_size);
-    size_t crc_offset = TR01_L2_RSP_DATA_RSP_CRC_OFFSET + packet_size;
-    l2_frame[crc_offset] = crc >> 8;
-    l2_frame[crc_offset + 1] = crc & 0x00FF;
-
-    ret = lt_mock_hal_enqueue_response(&h->l2, l2_frame, frame_size);
-    if (LT_OK != ret) {
-        LT_LOG_ERROR("Failed to enqueue response with L3 Result!");
-        return ret;
+    // Split the packet into L2 Response frames, all but the last one with RESULT_CONT status.
+    for (size_t offset = 0, i = 0; offset < packet_size && i < chunk_count; i++) {
+        size_t chunk_size = packet_size - offset;
+        if (chunk_size > TR01_L2_CHUNK_MAX_DATA_SIZE) {
+            chunk_size = TR01_L2_CHUNK_MAX_DATA_SIZE;
+        }
+        bool last = (offset + chunk_size == packet_size);
+
+        l2_frame[TR01_L2_CHIP_STATUS_OFFSET] = TR01_L1_CHIP_MODE_READY_bit;
+        l2_frame[TR01_L2_STATUS_OFFSET] = last ? TR01_L2_STATUS_RESULT_OK : TR01_L2_STATUS_RESULT_CONT;
+        l2_frame[TR01_L2_RSP_LEN_OFFSET] = (uint8_t)chunk_size;
+        memcpy(&l2_frame[TR01_L2_RSP_DATA_RSP_CRC_OFFSET], &packet[offset], chunk_size);
+
+        uint16_t crc
+            = crc16(&l2_frame[TR01_L2_STATUS_OFFSET], TR01_L2_STATUS_SIZE + TR01_L2_REQ_RSP_LEN_SIZE + chunk_size);
+        size_t crc_offset = TR01_L2_RSP_DATA_RSP_CRC_OFFSET + chunk_size;
+        l2_frame[crc_offset] = crc >> 8;
+        l2_frame[crc_offset + 1] = crc & 0x00FF;
+
+        ret = lt_mock_hal_enqueue_response(&h->l2, l2_frame, crc_offset + TR01_L2_REQ_RSP_CRC_SIZE);
+        if (LT_OK != ret) {
+            LT_LOG_ERROR("Failed to enqueue response with L3 Result!");
+            return ret;
+        }
+
+        offset += chunk_size;
     }
 
     return LT_OK;
@@ -165,34 +183,174 @@ lt_ret_t mock_l3_result(lt_handle_t *h, const uint8_t *result_plaintext, const s
 
 lt_ret_t mock_l3_command_responses(lt_handle_t *h, const size_t chunk_count)
 {
-    if (chunk_count > 1) {
-        LT_LOG_ERROR("Only single chunk supported now!");
-        return LT_PARAM_ERR;
+    for (size_t i = 0; i < chunk_count; i++) {
+        uint8_t chip_ready = TR01_L1_CHIP_MODE_READY_bit;
+        lt_ret_t ret = lt_mock_hal_enqueue_response(&h->l2, &chip_ready, sizeof(chip_ready));
+        if (LT_OK != ret) {
+            LT_LOG_ERROR("Failed to enqueue L3 Command response 1/2 (CHIP_READY).");
+            return ret;
+        }
+
+        // Chip asks for the next chunk, until the last one is written.
+        uint8_t req_ok_frame[5] = {
+            TR01_L1_CHIP_MODE_READY_bit,
+            (i == chunk_count - 1) ? TR01_L2_STATUS_REQUEST_OK : TR01_L2_STATUS_REQUEST_CONT,
+            0x00,  // Zero RSP length
+            0x00,  // | Dummy CRC -- will be calculated later
+            0x00   // |
+        };
+
+        uint16_t crc = crc16(req_ok_frame + 1, 2);
+        req_ok_frame[TR01_L2_RSP_DATA_RSP_CRC_OFFSET] = crc >> 8;
+        req_ok_frame[TR01_L2_RSP_DATA_RSP_CRC_OFFSET + 1] = crc & 0x00FF;
+
+        ret = lt_mock_hal_enqueue_response(&h->l2, req_ok_frame, sizeof(req_ok_frame));
+        if (LT_OK != ret) {
+            LT_LOG_ERROR("Failed to enqueue L3 Command response 2/2 (L2 Response)");
+            return ret;
+        }
     }
 
+    return LT_OK;
+}
+
+lt_ret_t mock_get_info(lt_handle_t *h, const void *object, const uint8_t len)
+{
     uint8_t chip_ready = TR01_L1_CHIP_MODE_READY_bit;
-    lt_ret_t ret = lt_mock_hal_enqueue_response(&h->l2, &chip_ready, sizeof(chip_ready));
-    if (LT_OK != ret) {
-        LT_LOG_ERROR("Failed to enqueue L3 Command response 1/2 (CHIP_READY).");
-        return ret;
+
+    if (len > LT_MEMBER_SIZE(struct lt_l2_get_info_rsp_t, object)) {
+        return LT_PARAM_ERR;
+    }
+
+    if (LT_OK != lt_mock_hal_enqueue_response(&h->l2, &chip_ready, sizeof(chip_ready))) {
+        return LT_FAIL;
+    }
+
+    struct lt_l2_get_info_rsp_t get_info_resp
+        = {.chip_status = TR01_L1_CHIP_MODE_READY_bit, .status = TR01_L2_STATUS_REQUEST_OK, .rsp_len = len};
+    memcpy(get_info_resp.object, object, len);
+    add_resp_crc(&get_info_resp);
+
+    return lt_mock_hal_enqueue_response(&h->l2, (uint8_t *)&get_info_resp, calc_mocked_resp_len(&get_info_resp));
+}
+
+/**
+ * @brief hash = SHA256(hash||data)
+ */
+static lt_ret_t mock_hash_update(lt_handle_t *h, uint8_t *hash, const uint8_t *data, const size_t data_len)
+{
+    lt_ret_t ret = lt_sha256_start(h->l3.crypto_ctx);
+    if (LT_OK == ret) {
+        ret = lt_sha256_update(h->l3.crypto_ctx, hash, LT_SHA256_DIGEST_LENGTH);
+    }
+    if (LT_OK == ret) {
+        ret = lt_sha256_update(h->l3.crypto_ctx, data, data_len);
+    }
+    if (LT_OK == ret) {
+        ret = lt_sha256_finish(h->l3.crypto_ctx, hash);
+    }
+
+    return ret;
+}
+
+lt_ret_t mock_handshake(lt_handle_t *h, const uint8_t *stpriv, const uint8_t *stpub, const uint8_t *shipub,
+                        const lt_pkey_index_t pkey_index, const uint8_t *ehpub)
+{
+    uint8_t protocol_name[32] = {'N', 'o', 'i', 's', 'e', '_', 'K', 'K', '1', '_', '2', '5', '5', '1',  '9',  '_',
+                                 'A', 'E', 'S', 'G', 'C', 'M', '_', 'S', 'H', 'A', '2', '5', '6', 0x00, 0x00, 0x00};
+    struct lt_l2_handshake_rsp_t rsp
+        = {.chip_status = TR01_L1_CHIP_MODE_READY_bit, .status = TR01_L2_STATUS_REQUEST_OK, .rsp_len = 48};
+    uint8_t etpriv[TR01_ETPRIV_LEN];
+    uint8_t hash[LT_SHA256_DIGEST_LENGTH];
+    uint8_t pkey_index_byte = (uint8_t)pkey_index;
+    // Same sizes as in lt_in__session_start(), ck is hashed with its 33 bytes.
+    uint8_t ck[33] = {0}, unused[32] = {0}, kauth[TR01_AES256_KEY_LEN] = {0}, shared_secret[TR01_X25519_KEY_LEN];
+    uint8_t iv[TR01_L3_IV_SIZE] = {0};
+
+    lt_ret_t ret = lt_random_bytes(h, etpriv, sizeof(etpriv));
+    if (LT_OK == ret) {
+        ret = lt_X25519_scalarmult(etpriv, rsp.e_tpub);
+    }
+
+    // h = SHA256(SHA256(...SHA256(protocol_name)||SHiPUB)||STPUB)||EHPUB)||PKEY_INDEX)||ETPUB)
+    if (LT_OK == ret) {
+        ret = lt_sha256_init(h->l3.crypto_ctx);
+    }
+    if (LT_OK == ret) {
+        ret = lt_sha256_start(h->l3.crypto_ctx);
+    }
+    if (LT_OK == ret) {
+        ret = lt_sha256_update(h->l3.crypto_ctx, protocol_name, sizeof(protocol_name));
+    }
+    if (LT_OK == ret) {
+        ret = lt_sha256_finish(h->l3.crypto_ctx, hash);
+    }
+    if (LT_OK == ret) {
+        ret = mock_hash_update(h, hash, shipub, TR01_SHIPUB_LEN);
+    }
+    if (LT_OK == ret) {
+        ret = mock_hash_update(h, hash, stpub, TR01_STPUB_LEN);
+    }
+    if (LT_OK == ret) {
+        ret = mock_hash_update(h, hash, ehpub, TR01_EHPUB_LEN);
+    }
+    if (LT_OK == ret) {
+        ret = mock_hash_update(h, hash, &pkey_index_byte, sizeof(pkey_index_byte));
+    }
+    if (LT_OK == ret) {
+        ret = mock_hash_update(h, hash, rsp.e_tpub, TR01_ETPUB_LEN);
+    }
+    lt_ret_t ret_deinit = lt_sha256_deinit(h->l3.crypto_ctx);
+    if (LT_OK == ret) {
+        ret = ret_deinit;
+    }
+
+    // Same key derivation as in lt_in__session_start(), with the other halves of the X25519 key pairs.
+    if (LT_OK == ret) {
+        ret = lt_X25519(etpriv, ehpub, shared_secret);
+    }
+    if (LT_OK == ret) {
+        ret = lt_hkdf(protocol_name, sizeof(protocol_name), shared_secret, sizeof(shared_secret), 1, ck, unused);
+    }
+    if (LT_OK == ret) {
+        ret = lt_X25519(etpriv, shipub, shared_secret);
+    }
+    if (LT_OK == ret) {
+        ret = lt_hkdf(ck, sizeof(ck), shared_secret, sizeof(shared_secret), 1, ck, unused);
+    }
+    if (LT_OK == ret) {
+        ret = lt_X25519(stpriv, ehpub, shared_secret);
+    }
+    if (LT_OK == ret) {
+        ret = lt_hkdf(ck, sizeof(ck), shared_secret, sizeof(shared_secret), 2, ck, kauth);
     }
 
-    uint8_t req_ok_frame[5] = {
-        TR01_L1_CHIP_MODE_READY_bit, TR01_L2_STATUS_REQUEST_OK,
-        0x00,  // Zero RSP length
-        0x00,  // | Dummy CRC -- will be calculated later
-        0x00   // |
-    };
+    // T_TAUTH = AES-GCM(kAUTH, IV = 0, AAD = h, empty plaintext)
+    if (LT_OK == ret) {
+        ret = lt_aesgcm_encrypt_init(h->l3.crypto_ctx, kauth, sizeof(kauth));
+        if (LT_OK == ret) {
+            ret = lt_aesgcm_encrypt(h->l3.crypto_ctx, iv, sizeof(iv), hash, sizeof(hash), (uint8_t *)"", 0,
+                                    rsp.t_tauth, sizeof(rsp.t_tauth));
+            ret_deinit = lt_aesgcm_encrypt_deinit(h->l3.crypto_ctx);
+            if (LT_OK == ret) {
+                ret = ret_deinit;
+            }
+        }
+    }
 
-    uint16_t crc = crc16(req_ok_frame + 1, 2);
-    req_ok_frame[TR01_L2_RSP_DATA_RSP_CRC_OFFSET] = crc >> 8;
-    req_ok_frame[TR01_L2_RSP_DATA_RSP_CRC_OFFSET + 1] = crc & 0x00FF;
+    lt_secure_memzero(etpriv, sizeof(etpriv));
+    lt_secure_memzero(kauth, sizeof(kauth));
 
-    ret = lt_mock_hal_enqueue_response(&h->l2, req_ok_frame, sizeof(req_ok_frame));
     if (LT_OK != ret) {
-        LT_LOG_ERROR("Failed to enqueue L3 Command response 2/2 (L2 Response)");
+        LT_LOG_ERROR("Failed to compute Handshake_Req reply!");
         return ret;
     }
 
-    return LT_OK;
+    uint8_t chip_ready = TR01_L1_CHIP_MODE_READY_bit;
+    if (LT_OK != lt_mock_hal_enqueue_response(&h->l2, &chip_ready, sizeof(chip_ready))) {
+        return LT_FAIL;
+    }
+    add_resp_crc(&rsp);
+
+    return lt_mock_hal_enqueue_response(&h->l2, (uint8_t *)&rsp, calc_mocked_resp_len(&rsp));
 }
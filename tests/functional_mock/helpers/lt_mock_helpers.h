@@ -87,8 +87,8 @@ lt_ret_t mock_session_abort(lt_handle_t *h);
  * You only need to provide plaintext part (RESULT field + any data if applicable). It will
  * be encrypted, tag will be added and inserted to an appropriate L2 Response frame.
  *
- * @warning Currently only Results that fit to a single chunk are supported, as chunking
- * is not implemented yet.
+ * Results longer than one chunk are split into several L2 Response frames, each of them takes one slot of the mock
+ * response queue.
  *
  * @param h Pointer to an lt_handle_t to use (for encryption and enqueuing).
  * @param result_plaintext Plaintext of the L3 Result data to use.
@@ -98,6 +98,20 @@ lt_ret_t mock_session_abort(lt_handle_t *h);
  */
 lt_ret_t mock_l3_result(lt_handle_t *h, const uint8_t *result_plaintext, const size_t result_plaintext_size);
 
+/**
+ * @brief Same as mock_l3_result(), but only the first `chunk_count` L2 Response frames are mocked, as if the transfer
+ * of the L3 Result broke after them.
+ *
+ * @param h Pointer to an lt_handle_t to use (for encryption and enqueuing).
+ * @param result_plaintext Plaintext of the L3 Result data to use.
+ * @param result_plaintext_size Size of the result_plaintext.
+ * @param chunk_count Number of L2 Response frames to mock.
+ *
+ * @return LT_OK on success, or an appropriate lt_ret_t error code on failure.
+ */
+lt_ret_t mock_l3_result_part(lt_handle_t *h, const uint8_t *result_plaintext, const size_t result_plaintext_size,
+                             const size_t chunk_count);
+
 /**
  * @brief Mock replies to a L3 Command.
  *
@@ -106,12 +120,42 @@ lt_ret_t mock_l3_result(lt_handle_t *h, const uint8_t *result_plaintext, const s
  *   2. reply to Get_Response -> L2 Response with status REQ_OK (last chunk) or REQ_CONT (not the last chunk)
  *
  * @param h Pointer to an lt_handle_t to use (for encryption and enqueuing).
- * @param chunk_count Count of the L3 Command chunks. Only single chunk supported now.
+ * @param chunk_count Count of the L3 Command chunks.
  *
  * @return LT_OK on success, or an appropriate lt_ret_t error code on failure.
  */
 lt_ret_t mock_l3_command_responses(lt_handle_t *h, const size_t chunk_count);
 
+/**
+ * @brief Mock reply to a Get_Info L2 Request.
+ *
+ * @param h Pointer to an lt_handle_t to use (for enqueuing).
+ * @param object Object block returned by TROPIC01.
+ * @param len Length of the object block, at most 128 bytes.
+ *
+ * @return LT_OK on success, or an appropriate lt_ret_t error code on failure.
+ */
+lt_ret_t mock_get_info(lt_handle_t *h, const void *object, const uint8_t len);
+
+/**
+ * @brief Mock reply to the Handshake_Req L2 Request of TROPIC01 owning the given STPriv.
+ *
+ * Unlike mock_session_start(), the Secure Session handshake is done by Libtropic: the reply carries a valid
+ * authentication tag computed on the TROPIC01 side of Noise_KK1. As the tag depends on the host ephemeral key,
+ * Libtropic has to take it from a pool (see lt_eph_key_pool_set()), so it is known in advance.
+ *
+ * @param h Pointer to an lt_handle_t to use (for cryptography and enqueuing).
+ * @param stpriv TROPIC01's X25519 private key.
+ * @param stpub TROPIC01's X25519 public key.
+ * @param shipub Host's public pairing key for the slot `pkey_index`.
+ * @param pkey_index Pairing key index.
+ * @param ehpub Host ephemeral public key, which will be sent in the Handshake_Req.
+ *
+ * @return LT_OK on success, or an appropriate lt_ret_t error code on failure.
+ */
+lt_ret_t mock_handshake(lt_handle_t *h, const uint8_t *stpriv, const uint8_t *stpub, const uint8_t *shipub,
+                        const lt_pkey_index_t pkey_index, const uint8_t *ehpub);
+
 #ifdef __cplusplus
 }
 #endif
@@ -55,6 +55,307 @@ void lt_test_mock_invalid_in_crc(lt_handle_t *h);
  */
 void lt_test_mock_hardware_fail(lt_handle_t *h);
 
+/**
+ * @brief Test for checking the selected CRC16 implementation.
+ *
+ * Test steps:
+ *  1. Verify CRC16 of a known answer vector and of empty input.
+ *  2. Cross-check crc16() against a bitwise reference for all lengths up to TR01_L1_LEN_MAX and 16 alignments.
+ *  3. Verify that crc16_update() gives the same result as crc16() when the input is split into two segments.
+ *  4. Verify that add_crc() appends the checksum in the expected byte order.
+ *
+ * @param h Handle for communication with TROPIC01 (not used)
+ */
+void lt_test_mock_crc16(lt_handle_t *h);
+
+/**
+ * @brief Test for learning of TROPIC01's processing time by the adaptive polling (LT_ADAPTIVE_POLLING).
+ *
+ * Test steps:
+ *  1. Mock initialization, initialize libtropic handle and reset the learned model.
+ *  2. Mock Get_Info with TROPIC01 busy for several polls, verify the first measured processing time.
+ *  3. Repeat Get_Info several times and verify that the learned time stays around the measured one.
+ *  4. Mock Secure Session and Ping with TROPIC01 busy before the L3 Result, verify that the processing time is
+ *     learned for the L3 Command.
+ *  5. Verify that the model can be saved and restored.
+ *  6. Mock Secure Session deinitialization and deinitialize libtropic handle.
+ *
+ * @note The test is skipped if LT_ADAPTIVE_POLLING is not enabled.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_adaptive_polling(lt_handle_t *h);
+
+/**
+ * @brief Test for L1 communication through lt_port_frame_xfer() instead of the separate lt_port_spi_* calls.
+ *
+ * Test steps:
+ *  1. Enable frame transfers in the mock HAL, mock initialization and initialize libtropic handle.
+ *  2. Mock Get_Info with TROPIC01 busy for several polls, verify the response and that each frame was transferred
+ *     at once.
+ *  3. Verify that a response with invalid CRC and a response longer than the L1 buffer are rejected.
+ *  4. Verify that lt_get_tr01_mode() reads CHIP_STATUS in one frame.
+ *  5. Deinitialize libtropic handle.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_frame_xfer(lt_handle_t *h);
+
+/**
+ * @brief Test for writing L3 Command chunks through lt_port_spi_transfer_iov(), without copying them into the L1
+ * buffer.
+ *
+ * Test steps:
+ *  1. Mock initialization and initialize libtropic handle.
+ *  2. Mock R_Mem_Data_Write split into two chunks and write it with gathered transfers disabled in the mock HAL.
+ *  3. Restart the mocked Secure Session, write the same command with gathered transfers enabled.
+ *  4. Verify that all chunks were gathered and that both ways wrote the same valid L2 Requests.
+ *  5. Deinitialize libtropic handle.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_spi_transfer_iov(lt_handle_t *h);
+
+/**
+ * @brief Test for receiving L3 Result chunks directly into the L3 buffer through lt_port_spi_transfer_into().
+ *
+ * Test steps:
+ *  1. Mock initialization, initialize libtropic handle and start mocked Secure Session.
+ *  2. Mock Ping with a message split into three chunks and verify the echoed message, first with RSP_DATA copied from
+ *     the L1 buffer, then received directly into the L3 buffer.
+ *  3. Verify that a chunk with invalid CRC received directly into the L3 buffer is rejected.
+ *  4. Abort Secure Session and deinitialize libtropic handle.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_spi_transfer_into(lt_handle_t *h);
+
+/**
+ * @brief Test for encrypting L3 Command chunk by chunk while it is sent.
+ *
+ * Test steps:
+ *  1. Mock initialization, initialize libtropic handle and start mocked Secure Session.
+ *  2. Encrypt Ping L3 Command as a whole with the current IV to get the expected L3 packet.
+ *  3. Mock Ping split into three chunks, with the tag split between the last two, and verify the echoed message.
+ *  4. Verify that the written chunks carry the expected L3 packet.
+ *  5. Prepare Ping L3 Command, invalidate the session and verify that sending it fails without writing anything.
+ *  6. Deinitialize libtropic handle.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_pipelined_encryption(lt_handle_t *h);
+
+/**
+ * @brief Test for decrypting L3 Result chunk by chunk while it is received.
+ *
+ * Test steps:
+ *  1. Mock initialization, initialize libtropic handle and start mocked Secure Session.
+ *  2. Mock maximal Ping and verify the echoed message, first with the L3 Result decrypted as a whole, then decrypted
+ *     while it is received.
+ *  3. Mock Ping whose L3 Result ends after its first chunk, verify that the decrypted chunk is zeroed in L3 buffer
+ *     and that the next Ping succeeds in the same session.
+ *  4. Mock Ping whose L3 Result has invalid tag and verify that it fails and the session is invalidated.
+ *  5. Deinitialize libtropic handle.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_res_decryption(lt_handle_t *h);
+
+/**
+ * @brief Test for streaming large L3 payloads from/to caller's buffers with LT_L3_STREAMING.
+ *
+ * Skipped if LT_L3_STREAMING is not enabled.
+ *
+ * Test steps:
+ *  1. Verify that the handle fits into 1 KiB.
+ *  2. Mock initialization, initialize libtropic handle and start mocked Secure Session.
+ *  3. Mock Ping split into four chunks, verify the echoed message and that the chunks carry the L3 Command encrypted
+ *     as a whole. Then mock maximal Ping and verify the echoed message.
+ *  4. Mock R_Mem_Data_Write of maximal data and verify its chunks, then mock R_Mem_Data_Read and verify the data.
+ *  5. Mock R_Mem_Data_Read into too small buffer and verify that it fails.
+ *  6. Mock EdDSA_Sign of a message split into three chunks, verify the signature and the chunks.
+ *  7. Mock Ping whose L3 Result breaks after its first chunk and verify that it fails and the message buffer is
+ *     cleared.
+ *  8. Mock Ping whose L3 Result has invalid tag and verify that it fails, the session is invalidated and the message
+ *     buffer is cleared.
+ *  9. Deinitialize libtropic handle.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_l3_streaming(lt_handle_t *h);
+
+/**
+ * @brief Test for building L3 Commands in place with the 'lt_out__*_reserve' functions and lt_out__commit().
+ *
+ * Test steps:
+ *  1. Mock initialization and initialize libtropic handle.
+ *  2. Mock EdDSA_Sign split into two chunks, first copied by lt_out__ecc_eddsa_sign(), then built in place, both in a
+ *     newly started mocked Secure Session. Verify the signature and that both ways write the same L2 Requests.
+ *  3. Mock Ping built in place and verify the echoed message.
+ *  4. Verify that lt_out__commit() fails without a reserved L3 Command and after another L3 Command was encoded.
+ *  5. Verify reservation of the maximal EdDSA_Sign message (fails with LT_L3_STREAMING) and of a too long one.
+ *  6. Reserve Ping, invalidate the session and verify that the commit fails.
+ *  7. Deinitialize libtropic handle.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_l3_reserve(lt_handle_t *h);
+
+/**
+ * @brief Test for taking Secure Session ephemeral keys from a pool of pre-generated keys.
+ *
+ * Test steps:
+ *  1. Mock initialization and initialize libtropic handle.
+ *  2. Refill the pool in steps and verify that it holds valid X25519 key pairs and is not overfilled.
+ *  3. Verify that lt_out__session_start() does not use the pool before it is set.
+ *  4. Set the pool and verify that each lt_out__session_start() takes a different key pair, sends its public key and
+ *     zeroes it in the pool.
+ *  5. Verify that a new key pair is generated when the pool is empty.
+ *  6. Verify that lt_eph_key_pool_clear() zeroes the pool and that lt_init() unsets it.
+ *  7. Deinitialize libtropic handle.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_eph_key_pool(lt_handle_t *h);
+
+/**
+ * @brief Test for starting Secure Session with STPub taken from the cached chip identity.
+ *
+ * Test steps:
+ *  1. Mock initialization and initialize libtropic handle.
+ *  2. Read the chip identity and verify its contents against the mocked chip.
+ *  3. Start Secure Session with the cached identity and verify that only the chip ID is read and the identity is not
+ *     changed.
+ *  4. Start Secure Session with the identity of another chip, a zeroed and a corrupted identity and verify that the
+ *     identity is read again.
+ *  5. Verify that when the handshake fails with a valid identity holding wrong STPub, the identity is read again and
+ *     the handshake is retried, and that it is not retried when STPub did not change.
+ *  6. Verify that a failed read leaves the identity invalid.
+ *  7. Deinitialize libtropic handle.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_chip_identity(lt_handle_t *h);
+
+/**
+ * @brief Test for reading STPub while the Certificate Store is received, without reading the whole store.
+ *
+ * Test steps:
+ *  1. Mock initialization and initialize libtropic handle.
+ *  2. Mock the whole Certificate Store, read STPub with lt_get_info_st_pub() and verify that only the blocks up to the
+ *     end of STPub are read.
+ *  3. Read STPub with lt_get_info_cert_store() and lt_get_st_pub() and verify that it is the same.
+ *  4. Start Secure Session with lt_verify_chip_and_start_secure_session() and verify the number of requests.
+ *  5. Verify that a Certificate Store with unknown version is rejected after the first block.
+ *  6. Parse the device certificate in chunks of all sizes and verify that STPub equals the one found by
+ *     asn1der_find_object().
+ *  7. Verify that a missing object is not found and that a truncated certificate is rejected.
+ *  8. Parse randomly corrupted certificates and verify that only expected errors are returned.
+ *  9. Deinitialize libtropic handle.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_get_info_st_pub(lt_handle_t *h);
+
+/**
+ * @brief Test for the indexed ASN1 DER parser and its zero-copy views of X509 certificates.
+ *
+ * Test steps:
+ *  1. Index all certificates of the mocked Certificate Store, verify the index and the views of their fields, and that
+ *     each certificate is issued by the next one.
+ *  2. Verify that the view of STPub found by OBJECT_IDENTIFIER matches asn1der_find_object().
+ *  3. Verify that unsupported encodings, invalid lengths, non-certificates and truncated certificates are rejected.
+ *  4. Index randomly mutated certificates and verify that the index and all views stay within the stream.
+ *
+ * @param h Handle for communication with TROPIC01 (not used)
+ */
+void lt_test_mock_asn1der_index(lt_handle_t *h);
+
+/**
+ * @brief Test for verification of the certificate chain with and without the cache of verified certificates.
+ *
+ * Test steps:
+ *  1. Initialize handle and verify the chain of the mocked Certificate Store without cache.
+ *  2. Verify that invalid parameters, another trusted root, tampered certificates and swapped intermediate
+ *     certificates are rejected.
+ *  3. Verify the chain with empty cache and verify that signatures of the cached certificates are not verified again.
+ *  4. Verify device certificate of another chip and that only its signature is verified.
+ *  5. Verify that cache of another root or corrupted cache is emptied and that the oldest entry is replaced in full
+ *     cache.
+ *  6. Deinitialize handle.
+ *
+ * @note The test is skipped if LT_ECDSA_P256_VERIFY is not enabled.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_cert_chain(lt_handle_t *h);
+
+/**
+ * @brief Test for ECDSA sign of a message passed in chunks with lt_ecc_ecdsa_sign_init(), _update() and _final().
+ *
+ * Test steps:
+ *  1. Initialize handle, sign a message as a whole and in chunks of several lengths, and verify that the same
+ *     ECDSA_Sign L3 Command is written.
+ *  2. Verify that invalid parameters are rejected and that other users of the SHA-256 context get LT_SHA256_BUSY while
+ *     the message is being hashed.
+ *  3. Verify that aborted hashing, or hashing without Secure Session, cannot be finished.
+ *  4. Sign a large message streamed from a small buffer.
+ *  5. Start hashing and deinitialize handle, verify that the hashing was released.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_ecdsa_sign_stream(lt_handle_t *h);
+
+/**
+ * @brief Test for ECDSA sign of a digest computed by the caller with lt_ecc_ecdsa_sign_digest().
+ *
+ * Test steps:
+ *  1. Initialize handle, sign a message with lt_ecc_ecdsa_sign() and its digest with lt_ecc_ecdsa_sign_digest() and
+ *     with lt_out__ecc_ecdsa_sign_digest(), and verify that the same ECDSA_Sign L3 Command is written.
+ *  2. Verify that the digest can be signed while another message is being hashed.
+ *  3. Verify that invalid parameters are rejected and that Secure Session is needed.
+ *  4. Deinitialize handle.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_ecdsa_sign_digest(lt_handle_t *h);
+
+/**
+ * @brief Test for signing batches of messages with one signature of the root of their Merkle tree.
+ *
+ * Test steps:
+ *  1. Initialize handle, add messages to a batch, sign its root with mocked ECDSA_Sign and verify the root against
+ *     the Merkle Tree Hash of RFC 6962.
+ *  2. Verify proofs and the root signature of all messages, and that modified messages, proofs and signatures are
+ *     rejected.
+ *  3. Verify that a plain ECDSA signature of 0x00 || message is rejected as the signature of a batch of that message.
+ *  4. Sign a batch of one message with mocked EDDSA_Sign and verify its proof.
+ *  5. Sign a batch of 1000 messages with one L3 Command and verify all its proofs.
+ *  6. Deinitialize handle.
+ *
+ * @note Without LT_ECDSA_P256_VERIFY, root signatures are not verified and LT_NOT_SUPPORTED is expected instead.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_merkle_batch(lt_handle_t *h);
+
+/**
+ * @brief Test for the queue of L3 Commands with lt_l3_queue_submit() and lt_l3_queue_poll().
+ *
+ * Test steps:
+ *  1. Initialize handle, execute Ping and Random_Value_Get L3 Commands one by one with mocked L3 Results (one failing
+ *     on TROPIC01, one with invalid parameters).
+ *  2. Execute the same L3 Commands in the queue and check that they were written the same, and that their results
+ *     and return codes came in order.
+ *  3. Check that the next L3 Command was encrypted before the L3 Result of the previous one was received.
+ *  4. Check that an L3 Command prepared aside is not sent after the Secure Session was lost.
+ *  5. Check full and empty queue and invalid parameters.
+ *  6. Deinitialize handle.
+ *
+ * @param h Handle for communication with TROPIC01
+ */
+void lt_test_mock_l3_queue(lt_handle_t *h);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,177 @@
+/**
+ * @file lt_test_mock_adaptive_polling.c
+ * @brief Test for learning of TROPIC01's processing time by the adaptive polling.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "libtropic_port_mock.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_l1.h"
+#include "lt_l2_api_structs.h"
+#include "lt_l2_frame_check.h"
+#include "lt_l3_api_structs.h"
+#include "lt_l3_process.h"
+#include "lt_mock_helpers.h"
+#include "lt_port_wrap.h"
+#include "lt_test_common.h"
+
+#ifdef LT_ADAPTIVE_POLLING
+// Number of CHIP_STATUS polls during which the mocked chip is busy.
+#define BUSY_POLLS 2
+// Number of mocked requests of the same kind.
+#define ROUNDS 4
+// Time waited with the fixed delay before the response is ready.
+#define FIXED_WAIT_US ((uint32_t)BUSY_POLLS * LT_L1_READ_RETRY_DELAY * 1000)
+// Tolerated difference between the real time measured by the mock HAL and the sum of delays.
+#define MAX_OVERHEAD_US ((uint32_t)LT_L1_READ_RETRY_DELAY * 1000)
+
+static lt_ret_t mock_busy_polls(lt_handle_t *h, const int count)
+{
+    uint8_t chip_busy = 0;
+
+    for (int i = 0; i < count; i++) {
+        lt_ret_t ret = lt_mock_hal_enqueue_response(&h->l2, &chip_busy, sizeof(chip_busy));
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+
+    return LT_OK;
+}
+
+static lt_ret_t mock_get_info_riscv_fw_ver(lt_handle_t *h, const int busy_polls)
+{
+    uint8_t chip_ready = TR01_L1_CHIP_MODE_READY_bit;
+    lt_ret_t ret = lt_mock_hal_enqueue_response(&h->l2, &chip_ready, sizeof(chip_ready));
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = mock_busy_polls(h, busy_polls);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    struct lt_l2_get_info_rsp_t get_info_resp = {.chip_status = TR01_L1_CHIP_MODE_READY_bit,
+                                                 .status = TR01_L2_STATUS_REQUEST_OK,
+                                                 .rsp_len = TR01_L2_GET_INFO_RISCV_FW_SIZE,
+                                                 .object = {0x00, 0x00, 0x00, 0x02}};
+    add_resp_crc(&get_info_resp);
+
+    return lt_mock_hal_enqueue_response(&h->l2, (uint8_t *)&get_info_resp, calc_mocked_resp_len(&get_info_resp));
+}
+
+static const lt_poll_stat_t *find_stat(const lt_poll_stat_t *model, const uint16_t key)
+{
+    for (size_t i = 0; i < LT_POLL_MODEL_SIZE; i++) {
+        if (model[i].key == key) {
+            return &model[i];
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+void lt_test_mock_adaptive_polling(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_adaptive_polling()");
+    LT_LOG_INFO("----------------------------------------------");
+
+#ifndef LT_ADAPTIVE_POLLING
+    LT_UNUSED(h);
+    LT_LOG_INFO("LT_ADAPTIVE_POLLING is not enabled, skipping.");
+#else
+    lt_poll_stat_t model[LT_POLL_MODEL_SIZE];
+    lt_poll_stat_t saved_model[LT_POLL_MODEL_SIZE];
+    const lt_poll_stat_t *stat;
+    uint8_t fw_ver[TR01_L2_GET_INFO_RISCV_FW_SIZE];
+
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    LT_LOG_INFO("Forgetting processing times learned during initialization...");
+    LT_TEST_ASSERT(LT_OK, lt_set_poll_model(h, NULL));
+    LT_TEST_ASSERT(LT_OK, lt_get_poll_model(h, model));
+    for (size_t i = 0; i < LT_POLL_MODEL_SIZE; i++) {
+        LT_TEST_ASSERT(0, model[i].key);
+        LT_TEST_ASSERT(0, model[i].samples);
+    }
+
+    LT_LOG_INFO("Mocking Get_Info, chip busy for %d polls...", BUSY_POLLS);
+    LT_TEST_ASSERT(LT_OK, mock_get_info_riscv_fw_ver(h, BUSY_POLLS));
+    LT_TEST_ASSERT(LT_OK, lt_get_info_riscv_fw_ver(h, fw_ver));
+
+    LT_LOG_INFO("Checking that the first measurement is about the time waited with the fixed delay...");
+    LT_TEST_ASSERT(LT_OK, lt_get_poll_model(h, model));
+    stat = find_stat(model, LT_POLL_KEY_L2(TR01_L2_GET_INFO_REQ_ID));
+    LT_TEST_ASSERT(1, stat != NULL);
+    LT_TEST_ASSERT(1, stat->samples);
+    LT_TEST_ASSERT(1, stat->mean_us >= FIXED_WAIT_US && stat->mean_us < FIXED_WAIT_US + MAX_OVERHEAD_US);
+    LT_TEST_ASSERT(stat->mean_us / 2, stat->dev_us);
+
+    LT_LOG_INFO("Mocking %d more Get_Info requests...", ROUNDS - 1);
+    for (int i = 1; i < ROUNDS; i++) {
+        LT_TEST_ASSERT(LT_OK, mock_get_info_riscv_fw_ver(h, BUSY_POLLS));
+        LT_TEST_ASSERT(LT_OK, lt_get_info_riscv_fw_ver(h, fw_ver));
+    }
+
+    LT_LOG_INFO("Checking that the learned time stays around the measured one...");
+    LT_TEST_ASSERT(LT_OK, lt_get_poll_model(h, model));
+    stat = find_stat(model, LT_POLL_KEY_L2(TR01_L2_GET_INFO_REQ_ID));
+    LT_TEST_ASSERT(1, stat != NULL);
+    LT_TEST_ASSERT(ROUNDS, stat->samples);
+    LT_TEST_ASSERT(1, stat->mean_us >= FIXED_WAIT_US / 2);
+    LT_TEST_ASSERT(1, stat->mean_us <= FIXED_WAIT_US * 2);
+
+    LT_LOG_INFO("Setting up session...");
+    uint8_t kcmd[TR01_AES256_KEY_LEN];
+    uint8_t kres[TR01_AES256_KEY_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, kcmd, sizeof(kcmd)));
+    memcpy(kres, kcmd, TR01_AES256_KEY_LEN);
+    LT_TEST_ASSERT(LT_OK, mock_session_start(h, kcmd, kres));
+
+    LT_LOG_INFO("Mocking Ping, chip busy for %d polls before the L3 Result...", BUSY_POLLS);
+    uint8_t ping_msg[] = {'p', 'i', 'n', 'g'};
+    uint8_t ping_in[sizeof(ping_msg)];
+    uint8_t ping_result[] = {TR01_L3_RESULT_OK, 'p', 'i', 'n', 'g'};
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, 1));
+    LT_TEST_ASSERT(LT_OK, mock_busy_polls(h, BUSY_POLLS));
+    LT_TEST_ASSERT(LT_OK, mock_l3_result(h, ping_result, sizeof(ping_result)));
+    LT_TEST_ASSERT(LT_OK, lt_ping(h, ping_msg, ping_in, sizeof(ping_msg)));
+
+    LT_LOG_INFO("Checking that the processing time was learned for the L3 Command, not the L2 Request...");
+    LT_TEST_ASSERT(LT_OK, lt_get_poll_model(h, model));
+    stat = find_stat(model, LT_POLL_KEY_L3(TR01_L3_PING_CMD_ID));
+    LT_TEST_ASSERT(1, stat != NULL);
+    LT_TEST_ASSERT(1, stat->samples);
+    LT_TEST_ASSERT(1, stat->mean_us >= FIXED_WAIT_US && stat->mean_us < FIXED_WAIT_US + MAX_OVERHEAD_US);
+    LT_TEST_ASSERT(1, find_stat(model, LT_POLL_KEY_L2(TR01_L2_ENCRYPTED_CMD_REQ_ID)) == NULL);
+
+    LT_LOG_INFO("Checking that the model can be restored...");
+    memcpy(saved_model, model, sizeof(model));
+    LT_TEST_ASSERT(LT_OK, lt_set_poll_model(h, NULL));
+    LT_TEST_ASSERT(LT_OK, lt_set_poll_model(h, saved_model));
+    LT_TEST_ASSERT(LT_OK, lt_get_poll_model(h, model));
+    LT_TEST_ASSERT(0, memcmp(saved_model, model, sizeof(model)));
+
+    LT_LOG_INFO("Aborting Secure Session");
+    LT_TEST_ASSERT(LT_OK, mock_session_abort(h));
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+#endif
+}
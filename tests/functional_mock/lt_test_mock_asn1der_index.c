@@ -0,0 +1,254 @@
+/**
+ * @file lt_test_mock_asn1der_index.c
+ * @brief Test for the indexed ASN1 DER parser and its views of X509 certificates.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "lt_asn1_der.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_mock_cert_store.h"
+#include "lt_test_common.h"
+
+// Capacity of the index, the certificates of the mocked Certificate Store have less than 100 objects.
+#define MAX_NODES 128
+
+// Number of mutated certificates passed to the parser.
+#define FUZZ_ITERATIONS 4000
+
+// Value of ecdsa-with-SHA256 OBJECT_IDENTIFIER.
+static const uint8_t oid_ecdsa_sha256[] = {0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x04, 0x03, 0x02};
+
+/**
+ * @brief Checks that all nodes lie within their parents and the stream, in the order of the stream.
+ *
+ * @return true if the index is consistent
+ */
+static bool index_consistent(const struct lt_asn1der_index_t *idx)
+{
+    if (idx->count > idx->max_count) {
+        return false;
+    }
+
+    uint16_t prev_start = 0;
+    for (uint16_t i = 0; i < idx->count; i++) {
+        const struct lt_asn1der_node_t *node = &idx->nodes[i];
+        uint32_t start = node->offset - node->hdr_len;
+        uint32_t end = (uint32_t)node->offset + node->len;
+
+        if (node->hdr_len < 2 || start > node->offset || end > idx->len || (i > 0 && start <= prev_start)) {
+            return false;
+        }
+        if (node->parent != LT_ASN1DER_NO_PARENT) {
+            const struct lt_asn1der_node_t *parent = &idx->nodes[node->parent];
+            if (node->parent >= i || !(parent->tag & LT_ASN1DER_CONSTRUCTED) || start < parent->offset
+                || end > (uint32_t)parent->offset + parent->len) {
+                return false;
+            }
+        }
+        prev_start = start;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Checks that the view points into the indexed stream.
+ *
+ * @return true if the view is within the stream
+ */
+static bool view_within(const struct lt_asn1der_index_t *idx, const struct lt_asn1der_view_t *view)
+{
+    return view->data >= idx->stream && view->data + view->len <= idx->stream + idx->len;
+}
+
+void lt_test_mock_asn1der_index(lt_handle_t *h)
+{
+    LT_UNUSED(h);
+
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_asn1der_index()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    const uint8_t *certs[LT_NUM_CERTIFICATES];
+    uint16_t cert_lens[LT_NUM_CERTIFICATES];
+    const uint8_t *head = &mock_cert_store[MOCK_CERT_STORE_HEADER_LEN];
+    for (int i = 0; i < LT_NUM_CERTIFICATES; i++) {
+        certs[i] = head;
+        cert_lens[i] = ((uint16_t)mock_cert_store[2 + 2 * i] << 8) | mock_cert_store[3 + 2 * i];
+        head += cert_lens[i];
+    }
+
+    static struct lt_asn1der_node_t nodes[MAX_NODES];
+    struct lt_asn1der_index_t idx;
+    struct lt_asn1der_view_t view, issuer, subject;
+
+    LT_LOG_INFO("Indexing certificates of the mocked Certificate Store...");
+    for (int i = 0; i < LT_NUM_CERTIFICATES; i++) {
+        LT_TEST_ASSERT(LT_OK, asn1der_index_build(&idx, certs[i], cert_lens[i], nodes, MAX_NODES));
+        LT_TEST_ASSERT(1, index_consistent(&idx));
+        LT_LOG_INFO("Certificate %d: %" PRIu16 " bytes, %" PRIu16 " objects, index of %d bytes", i, cert_lens[i],
+                    idx.count, (int)(idx.count * sizeof(struct lt_asn1der_node_t)));
+
+        // The certificate is the only object at the top level.
+        asn1der_index_encoding(&idx, 0, &view);
+        LT_TEST_ASSERT(1, view.data == certs[i] && view.len == cert_lens[i]);
+        uint16_t child;
+        LT_TEST_ASSERT(LT_OK, asn1der_index_child(&idx, LT_ASN1DER_NO_PARENT, 0, &child));
+        LT_TEST_ASSERT(0, child);
+        LT_TEST_ASSERT(LT_CERT_ITEM_NOT_FOUND, asn1der_index_child(&idx, LT_ASN1DER_NO_PARENT, 1, &child));
+
+        LT_TEST_ASSERT(LT_OK, asn1der_cert_field(&idx, LT_ASN1DER_CERT_TBS, &view));
+        LT_TEST_ASSERT(1, view.data == certs[i] + idx.nodes[0].hdr_len && view.data[0] == LT_ASN1DER_SEQUENCE);
+
+        LT_TEST_ASSERT(LT_OK, asn1der_cert_field(&idx, LT_ASN1DER_CERT_SERIAL, &view));
+        LT_TEST_ASSERT(1, view.len >= 1 && view.len <= 20 && view_within(&idx, &view));
+
+        LT_TEST_ASSERT(LT_OK, asn1der_cert_field(&idx, LT_ASN1DER_CERT_VALIDITY, &view));
+        LT_TEST_ASSERT(LT_ASN1DER_UTC_TIME, view.data[0]);
+
+        LT_TEST_ASSERT(LT_OK, asn1der_cert_field(&idx, LT_ASN1DER_CERT_SIG_ALG, &view));
+        LT_TEST_ASSERT(LT_ASN1DER_OBJECT_IDENTIFIER, view.data[0]);
+        LT_TEST_ASSERT(sizeof(oid_ecdsa_sha256), view.data[1]);
+        LT_TEST_ASSERT(0, memcmp(oid_ecdsa_sha256, &view.data[2], sizeof(oid_ecdsa_sha256)));
+
+        // ECDSA signature is a SEQUENCE of two INTEGERs.
+        LT_TEST_ASSERT(LT_OK, asn1der_cert_field(&idx, LT_ASN1DER_CERT_SIGNATURE, &view));
+        LT_TEST_ASSERT(LT_ASN1DER_SEQUENCE, view.data[0]);
+        LT_TEST_ASSERT(1, view.data + view.len == certs[i] + cert_lens[i]);
+
+        LT_TEST_ASSERT(LT_OK, asn1der_cert_field(&idx, LT_ASN1DER_CERT_PUBKEY, &view));
+        if (i == 0) {
+            LT_TEST_ASSERT(TR01_STPUB_LEN, view.len);
+            LT_TEST_ASSERT(0, memcmp(mock_stpub, view.data, TR01_STPUB_LEN));
+        }
+        else {
+            // Uncompressed P-256 point.
+            LT_TEST_ASSERT(65, view.len);
+            LT_TEST_ASSERT(0x04, view.data[0]);
+        }
+
+        // Each certificate is issued by the next one, the last one is self-signed.
+        LT_TEST_ASSERT(LT_OK, asn1der_cert_field(&idx, LT_ASN1DER_CERT_ISSUER, &issuer));
+        if (i + 1 < LT_NUM_CERTIFICATES) {
+            struct lt_asn1der_index_t next;
+            static struct lt_asn1der_node_t next_nodes[MAX_NODES];
+            LT_TEST_ASSERT(LT_OK, asn1der_index_build(&next, certs[i + 1], cert_lens[i + 1], next_nodes, MAX_NODES));
+            LT_TEST_ASSERT(LT_OK, asn1der_cert_field(&next, LT_ASN1DER_CERT_SUBJECT, &subject));
+        }
+        else {
+            LT_TEST_ASSERT(LT_OK, asn1der_cert_field(&idx, LT_ASN1DER_CERT_SUBJECT, &subject));
+        }
+        LT_TEST_ASSERT(subject.len, issuer.len);
+        LT_TEST_ASSERT(0, memcmp(subject.data, issuer.data, issuer.len));
+
+        LT_TEST_ASSERT(LT_PARAM_ERR, asn1der_cert_field(&idx, (enum lt_asn1der_cert_field_t)0xFF, &view));
+        LT_TEST_ASSERT(LT_PARAM_ERR, asn1der_index_child(&idx, idx.count, 0, &child));
+    }
+
+    LT_LOG_INFO("Comparing search of STPub with asn1der_find_object()...");
+    uint8_t stpub[TR01_STPUB_LEN];
+    LT_TEST_ASSERT(LT_OK, asn1der_index_build(&idx, certs[0], cert_lens[0], nodes, MAX_NODES));
+    LT_TEST_ASSERT(LT_OK, asn1der_index_find_object(&idx, LT_OBJ_ID_CURVEX25519, &view));
+    LT_TEST_ASSERT(LT_OK, asn1der_find_object(certs[0], cert_lens[0], LT_OBJ_ID_CURVEX25519, stpub, TR01_STPUB_LEN,
+                                              LT_ASN1DER_CROP_PREFIX));
+    // The whole BIT STRING is viewed, including the unused bits byte cropped by asn1der_find_object().
+    LT_TEST_ASSERT(TR01_STPUB_LEN + 1, view.len);
+    LT_TEST_ASSERT(0, memcmp(stpub, view.data + 1, TR01_STPUB_LEN));
+    LT_TEST_ASSERT(LT_OK, asn1der_index_build(&idx, certs[1], cert_lens[1], nodes, MAX_NODES));
+    LT_TEST_ASSERT(LT_CERT_ITEM_NOT_FOUND, asn1der_index_find_object(&idx, LT_OBJ_ID_CURVEX25519, &view));
+
+    LT_LOG_INFO("Checking unsupported and invalid encodings...");
+    LT_TEST_ASSERT(LT_CERT_UNSUPPORTED, asn1der_index_build(&idx, certs[0], cert_lens[0], nodes, 16));
+    LT_TEST_ASSERT(16, idx.count);
+    LT_TEST_ASSERT(LT_OK, asn1der_index_build(&idx, certs[0], 0, nodes, MAX_NODES));
+    LT_TEST_ASSERT(0, idx.count);
+    LT_TEST_ASSERT(LT_CERT_STORE_INVALID, asn1der_cert_field(&idx, LT_ASN1DER_CERT_PUBKEY, &view));
+
+    const uint8_t indefinite[] = {0x30, 0x80, 0x02, 0x01, 0x01, 0x00, 0x00};
+    LT_TEST_ASSERT(LT_CERT_UNSUPPORTED, asn1der_index_build(&idx, indefinite, sizeof(indefinite), nodes, MAX_NODES));
+    const uint8_t long_len[] = {0x30, 0x83, 0x00, 0x00, 0x03, 0x02, 0x01, 0x01};
+    LT_TEST_ASSERT(LT_CERT_UNSUPPORTED, asn1der_index_build(&idx, long_len, sizeof(long_len), nodes, MAX_NODES));
+    const uint8_t long_tag[] = {0x30, 0x04, 0x1F, 0x81, 0x01, 0x00};
+    LT_TEST_ASSERT(LT_CERT_UNSUPPORTED, asn1der_index_build(&idx, long_tag, sizeof(long_tag), nodes, MAX_NODES));
+    const uint8_t child_too_long[] = {0x30, 0x03, 0x02, 0x02, 0x01, 0x02, 0x01, 0x01};
+    LT_TEST_ASSERT(LT_CERT_STORE_INVALID,
+                   asn1der_index_build(&idx, child_too_long, sizeof(child_too_long), nodes, MAX_NODES));
+    const uint8_t len_cut[] = {0x30, 0x03, 0x02, 0x82, 0x01};
+    LT_TEST_ASSERT(LT_CERT_STORE_INVALID, asn1der_index_build(&idx, len_cut, sizeof(len_cut), nodes, MAX_NODES));
+
+    // Valid DER, but not a certificate. Empty SEQUENCE at the end has its value offset equal to the parent end.
+    const uint8_t not_cert[] = {0x30, 0x05, 0x02, 0x01, 0x01, 0x30, 0x00};
+    LT_TEST_ASSERT(LT_OK, asn1der_index_build(&idx, not_cert, sizeof(not_cert), nodes, MAX_NODES));
+    LT_TEST_ASSERT(3, idx.count);
+    uint16_t child;
+    LT_TEST_ASSERT(LT_OK, asn1der_index_child(&idx, 0, 1, &child));
+    LT_TEST_ASSERT(2, child);
+    LT_TEST_ASSERT(LT_CERT_ITEM_NOT_FOUND, asn1der_index_child(&idx, 2, 0, &child));
+    LT_TEST_ASSERT(LT_CERT_STORE_INVALID, asn1der_cert_field(&idx, LT_ASN1DER_CERT_SERIAL, &view));
+
+    LT_LOG_INFO("Checking that truncated certificates are rejected...");
+    for (int i = 0; i < LT_NUM_CERTIFICATES; i++) {
+        bool all_rejected = true;
+        for (uint16_t len = 1; len < cert_lens[i]; len++) {
+            all_rejected &= asn1der_index_build(&idx, certs[i], len, nodes, MAX_NODES) == LT_CERT_STORE_INVALID;
+        }
+        LT_TEST_ASSERT(1, all_rejected);
+    }
+
+    LT_LOG_INFO("Parsing %d randomly mutated certificates...", FUZZ_ITERATIONS);
+    static uint8_t mutated[TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE];
+    int parsed = 0;
+    for (int iter = 0; iter < FUZZ_ITERATIONS; iter++) {
+        int i = rand() % LT_NUM_CERTIFICATES;
+        uint16_t len = cert_lens[i];
+        memcpy(mutated, certs[i], len);
+
+        switch (rand() % 4) {
+            case 0:  // Replace a few random bytes.
+                for (int n = 1 + rand() % 4; n > 0; n--) {
+                    mutated[rand() % len] = (uint8_t)rand();
+                }
+                break;
+            case 1:  // Replace a byte in the headers of the first objects, where the lengths are.
+                mutated[rand() % 64] = (uint8_t)rand();
+                break;
+            case 2:  // Random stream of random length.
+                len = 1 + rand() % len;
+                for (uint16_t n = 0; n < len; n++) {
+                    mutated[n] = (uint8_t)rand();
+                }
+                break;
+            default:  // Change the length of a random object by one.
+                mutated[rand() % len] ^= 0x01;
+                len -= rand() % 2;
+                break;
+        }
+
+        bool ok = true;
+        lt_ret_t ret = asn1der_index_build(&idx, mutated, len, nodes, MAX_NODES);
+        if (ret == LT_OK) {
+            parsed++;
+            ok &= index_consistent(&idx);
+            for (int field = LT_ASN1DER_CERT_TBS; field <= LT_ASN1DER_CERT_SIGNATURE; field++) {
+                ret = asn1der_cert_field(&idx, (enum lt_asn1der_cert_field_t)field, &view);
+                ok &= (ret == LT_OK && view_within(&idx, &view)) || ret == LT_CERT_STORE_INVALID;
+            }
+            ret = asn1der_index_find_object(&idx, LT_OBJ_ID_CURVEX25519, &view);
+            ok &= (ret == LT_OK && view_within(&idx, &view)) || ret == LT_CERT_ITEM_NOT_FOUND;
+        }
+        else {
+            ok &= ret == LT_CERT_STORE_INVALID || ret == LT_CERT_UNSUPPORTED;
+        }
+        LT_TEST_ASSERT(1, ok);
+    }
+    LT_LOG_INFO("Mutated certificates indexed: %d of %d", parsed, FUZZ_ITERATIONS);
+}
@@ -0,0 +1,161 @@
+/**
+ * @file lt_test_mock_cert_chain.c
+ * @brief Test for verification of the certificate chain with and without the cache of verified certificates.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_port_mock.h"
+#include "lt_asn1_der.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_mock_cert_store.h"
+#include "lt_mock_helpers.h"
+#include "lt_test_common.h"
+
+// Maximal number of ASN1 objects in one certificate.
+#define MAX_NODES 96
+
+void lt_test_mock_cert_chain(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_cert_chain()");
+    LT_LOG_INFO("----------------------------------------------");
+
+#ifndef LT_ECDSA_P256_VERIFY
+    LT_UNUSED(h);
+    LT_LOG_INFO("LT_ECDSA_P256_VERIFY is not enabled, skipping.");
+#else
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    // Copy the certificates, so they can be tampered with.
+    static uint8_t certs[LT_NUM_CERTIFICATES][TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE];
+    struct lt_cert_store_t store
+        = {.cert_len = {0},
+           .buf_len = {TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE, TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE,
+                       TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE, TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE},
+           .certs = {certs[0], certs[1], certs[2], certs[3]}};
+    const uint8_t *head = &mock_cert_store[MOCK_CERT_STORE_HEADER_LEN];
+    for (int i = 0; i < LT_NUM_CERTIFICATES; i++) {
+        store.cert_len[i] = ((uint16_t)mock_cert_store[2 + 2 * i] << 8) | mock_cert_store[3 + 2 * i];
+        memcpy(certs[i], head, store.cert_len[i]);
+        head += store.cert_len[i];
+    }
+    const uint8_t *root = &mock_cert_store[MOCK_CERT_STORE_HEADER_LEN + store.cert_len[0] + store.cert_len[1]
+                                           + store.cert_len[2]];
+    const uint16_t root_len = store.cert_len[LT_CERT_KIND_TROPIC_ROOT];
+    static uint8_t root_copy[TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE];
+    memcpy(root_copy, root, root_len);
+
+    LT_LOG_INFO("Verifying the chain without cache...");
+    LT_TEST_ASSERT(LT_OK, lt_cert_chain_verify(h, &store, root, root_len, NULL));
+
+    LT_LOG_INFO("Checking invalid parameters...");
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_cert_chain_verify(NULL, &store, root, root_len, NULL));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_cert_chain_verify(h, NULL, root, root_len, NULL));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_cert_chain_verify(h, &store, NULL, root_len, NULL));
+    store.buf_len[LT_CERT_KIND_XXXX] = store.cert_len[LT_CERT_KIND_XXXX] - 1;
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_cert_chain_verify(h, &store, root, root_len, NULL));
+    store.buf_len[LT_CERT_KIND_XXXX] = TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE;
+
+    LT_LOG_INFO("Checking that the chain is rejected with another trusted root...");
+    root_copy[root_len / 2] ^= 0x01;
+    LT_TEST_ASSERT(LT_CERT_CHAIN_INVALID, lt_cert_chain_verify(h, &store, root_copy, root_len, NULL));
+    root_copy[root_len / 2] ^= 0x01;
+    LT_TEST_ASSERT(LT_CERT_CHAIN_INVALID, lt_cert_chain_verify(h, &store, root_copy, root_len - 1, NULL));
+
+    LT_LOG_INFO("Checking that tampered certificates are rejected...");
+    static struct lt_asn1der_node_t nodes[MAX_NODES];
+    for (int i = LT_CERT_KIND_DEVICE; i < LT_CERT_KIND_TROPIC_ROOT; i++) {
+        // Last byte of the signature.
+        certs[i][store.cert_len[i] - 1] ^= 0x01;
+        LT_TEST_ASSERT(LT_CERT_CHAIN_INVALID, lt_cert_chain_verify(h, &store, root, root_len, NULL));
+        certs[i][store.cert_len[i] - 1] ^= 0x01;
+        // Last byte of the serial number, which is signed.
+        struct lt_asn1der_index_t idx;
+        struct lt_asn1der_view_t serial;
+        LT_TEST_ASSERT(LT_OK, asn1der_index_build(&idx, certs[i], store.cert_len[i], nodes, MAX_NODES));
+        LT_TEST_ASSERT(LT_OK, asn1der_cert_field(&idx, LT_ASN1DER_CERT_SERIAL, &serial));
+        uint8_t *serial_last = &certs[i][serial.data - certs[i] + serial.len - 1];
+        *serial_last ^= 0x01;
+        LT_TEST_ASSERT(LT_CERT_CHAIN_INVALID, lt_cert_chain_verify(h, &store, root, root_len, NULL));
+        *serial_last ^= 0x01;
+    }
+    const uint16_t xxxx_len = store.cert_len[LT_CERT_KIND_XXXX];
+    store.certs[LT_CERT_KIND_XXXX] = certs[LT_CERT_KIND_TROPIC01];
+    store.cert_len[LT_CERT_KIND_XXXX] = store.cert_len[LT_CERT_KIND_TROPIC01];
+    store.certs[LT_CERT_KIND_TROPIC01] = certs[LT_CERT_KIND_XXXX];
+    store.cert_len[LT_CERT_KIND_TROPIC01] = xxxx_len;
+    LT_TEST_ASSERT(LT_CERT_CHAIN_INVALID, lt_cert_chain_verify(h, &store, root, root_len, NULL));
+    store.certs[LT_CERT_KIND_TROPIC01] = certs[LT_CERT_KIND_TROPIC01];
+    store.cert_len[LT_CERT_KIND_TROPIC01] = store.cert_len[LT_CERT_KIND_XXXX];
+    store.certs[LT_CERT_KIND_XXXX] = certs[LT_CERT_KIND_XXXX];
+    store.cert_len[LT_CERT_KIND_XXXX] = xxxx_len;
+    LT_TEST_ASSERT(LT_OK, lt_cert_chain_verify(h, &store, root, root_len, NULL));
+
+    LT_LOG_INFO("Verifying the chain with empty cache...");
+    static lt_cert_chain_cache_t cache;
+    memset(&cache, 0, sizeof(cache));
+    LT_TEST_ASSERT(LT_OK, lt_cert_chain_verify(h, &store, root, root_len, &cache));
+    LT_TEST_ASSERT(3, cache.count);
+    LT_TEST_ASSERT(LT_OK, lt_cert_chain_verify(h, &store, root, root_len, &cache));
+    LT_TEST_ASSERT(3, cache.count);
+
+    LT_LOG_INFO("Checking that signatures of a known chip are not verified again...");
+    certs[LT_CERT_KIND_XXXX][store.cert_len[LT_CERT_KIND_XXXX] - 1] ^= 0x01;
+    LT_TEST_ASSERT(LT_OK, lt_cert_chain_verify(h, &store, root, root_len, &cache));
+    LT_TEST_ASSERT(LT_CERT_CHAIN_INVALID, lt_cert_chain_verify(h, &store, root, root_len, NULL));
+    certs[LT_CERT_KIND_XXXX][store.cert_len[LT_CERT_KIND_XXXX] - 1] ^= 0x01;
+
+    LT_LOG_INFO("Checking that only the device certificate of a new chip is verified...");
+    memcpy(certs[LT_CERT_KIND_DEVICE], mock_device_cert_2, MOCK_DEVICE_CERT_2_LEN);
+    store.cert_len[LT_CERT_KIND_DEVICE] = MOCK_DEVICE_CERT_2_LEN;
+    certs[LT_CERT_KIND_DEVICE][MOCK_DEVICE_CERT_2_LEN - 1] ^= 0x01;
+    LT_TEST_ASSERT(LT_CERT_CHAIN_INVALID, lt_cert_chain_verify(h, &store, root, root_len, &cache));
+    LT_TEST_ASSERT(3, cache.count);
+    certs[LT_CERT_KIND_DEVICE][MOCK_DEVICE_CERT_2_LEN - 1] ^= 0x01;
+    // TROPIC01 CA would not verify, but the TROPIC01-X CA it issued is already in the cache.
+    certs[LT_CERT_KIND_TROPIC01][store.cert_len[LT_CERT_KIND_TROPIC01] - 1] ^= 0x01;
+    LT_TEST_ASSERT(LT_CERT_CHAIN_INVALID, lt_cert_chain_verify(h, &store, root, root_len, NULL));
+    LT_TEST_ASSERT(LT_OK, lt_cert_chain_verify(h, &store, root, root_len, &cache));
+    LT_TEST_ASSERT(4, cache.count);
+    certs[LT_CERT_KIND_TROPIC01][store.cert_len[LT_CERT_KIND_TROPIC01] - 1] ^= 0x01;
+
+    LT_LOG_INFO("Checking that cache of another root or corrupted cache is emptied...");
+    cache.root_digest[0] ^= 0x01;
+    LT_TEST_ASSERT(LT_OK, lt_cert_chain_verify(h, &store, root, root_len, &cache));
+    LT_TEST_ASSERT(3, cache.count);
+    cache.count = LT_CERT_CHAIN_CACHE_SIZE + 1;
+    LT_TEST_ASSERT(LT_OK, lt_cert_chain_verify(h, &store, root, root_len, &cache));
+    LT_TEST_ASSERT(3, cache.count);
+    LT_TEST_ASSERT(3, cache.next);
+
+    LT_LOG_INFO("Checking that the oldest certificate is replaced in full cache...");
+    // Digests of certificates of other chips.
+    for (int i = 0; i < LT_CERT_CHAIN_CACHE_SIZE; i++) {
+        memset(cache.digests[i], i + 1, LT_CERT_CHAIN_DIGEST_LEN);
+    }
+    cache.count = LT_CERT_CHAIN_CACHE_SIZE;
+    cache.next = 5;
+    LT_TEST_ASSERT(LT_OK, lt_cert_chain_verify(h, &store, root, root_len, &cache));
+    LT_TEST_ASSERT(LT_CERT_CHAIN_CACHE_SIZE, cache.count);
+    LT_TEST_ASSERT(0, cache.next);
+    LT_TEST_ASSERT(0x05, cache.digests[4][0]);
+    certs[LT_CERT_KIND_XXXX][store.cert_len[LT_CERT_KIND_XXXX] - 1] ^= 0x01;
+    LT_TEST_ASSERT(LT_OK, lt_cert_chain_verify(h, &store, root, root_len, &cache));
+    certs[LT_CERT_KIND_XXXX][store.cert_len[LT_CERT_KIND_XXXX] - 1] ^= 0x01;
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+#endif
+}
@@ -0,0 +1,280 @@
+/**
+ * @file lt_test_mock_chip_identity.c
+ * @brief Test for starting Secure Session with STPub taken from the cached chip identity.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_port_mock.h"
+#include "lt_asn1_der.h"
+#include "lt_crc16.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_mock_helpers.h"
+#include "lt_port_wrap.h"
+#include "lt_test_common.h"
+#include "lt_x25519.h"
+
+// Length of the filler preceding the public key in the mocked device certificate.
+#define DEVICE_CERT_FILLER_LEN 150
+// Length of the mocked device certificate: SEQUENCE { OCTET STRING filler, SEQUENCE { OID }, BIT STRING key }.
+#define DEVICE_CERT_LEN (3 + (3 + DEVICE_CERT_FILLER_LEN) + 7 + (3 + TR01_STPUB_LEN))
+// Length of the other mocked certificates, they are not parsed.
+#define OTHER_CERT_LEN 200
+// Certificate store header: version, number of certificates and their lengths.
+#define CERT_STORE_HEADER_LEN (2 + 2 * LT_NUM_CERTIFICATES)
+#define CERT_STORE_LEN (CERT_STORE_HEADER_LEN + DEVICE_CERT_LEN + (LT_NUM_CERTIFICATES - 1) * OTHER_CERT_LEN)
+#define CERT_STORE_BLOCK_LEN 128
+#define CERT_STORE_BLOCK_COUNT ((CERT_STORE_LEN + CERT_STORE_BLOCK_LEN - 1) / CERT_STORE_BLOCK_LEN)
+
+// Get_Info of chip ID, both FW versions and the certificate store.
+#define IDENTITY_READ_REQUEST_COUNT (3 + CERT_STORE_BLOCK_COUNT)
+
+/**
+ * @brief Identity of the mocked chip and its Secure Session keys.
+ */
+struct mocked_chip_t {
+    struct lt_chip_id_t chip_id;
+    uint8_t riscv_fw_ver[TR01_L2_GET_INFO_RISCV_FW_SIZE];
+    uint8_t spect_fw_ver[TR01_L2_GET_INFO_SPECT_FW_SIZE];
+    uint8_t cert_store[CERT_STORE_BLOCK_COUNT * CERT_STORE_BLOCK_LEN];
+    uint8_t stpriv[TR01_STPRIV_LEN];
+    uint8_t stpub[TR01_STPUB_LEN];
+};
+
+/**
+ * @brief Fills the certificate store with certificates of the given lengths, the device one carrying STPub.
+ */
+static void make_cert_store(lt_handle_t *h, struct mocked_chip_t *chip)
+{
+    const uint16_t cert_len[LT_NUM_CERTIFICATES] = {DEVICE_CERT_LEN, OTHER_CERT_LEN, OTHER_CERT_LEN, OTHER_CERT_LEN};
+    uint8_t *p = chip->cert_store;
+
+    memset(chip->cert_store, 0, sizeof(chip->cert_store));
+    *p++ = LT_CERT_STORE_VERSION;
+    *p++ = LT_NUM_CERTIFICATES;
+    for (int i = 0; i < LT_NUM_CERTIFICATES; i++) {
+        *p++ = cert_len[i] >> 8;
+        *p++ = cert_len[i] & 0xff;
+    }
+
+    const uint8_t der_start[] = {LT_ASN1DER_SEQUENCE, 0x81, DEVICE_CERT_LEN - 3,
+                                 LT_ASN1DER_STRING_OCTET, 0x81, DEVICE_CERT_FILLER_LEN};
+    const uint8_t der_key[] = {LT_ASN1DER_SEQUENCE, 0x05, LT_ASN1DER_OBJECT_IDENTIFIER, 0x03, 0x2B, 0x65, 0x6E,
+                               LT_ASN1DER_STRING_BIT, TR01_STPUB_LEN + 1, 0x00};
+    memcpy(p, der_start, sizeof(der_start));
+    p += sizeof(der_start);
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, p, DEVICE_CERT_FILLER_LEN));
+    p += DEVICE_CERT_FILLER_LEN;
+    memcpy(p, der_key, sizeof(der_key));
+    p += sizeof(der_key);
+    memcpy(p, chip->stpub, TR01_STPUB_LEN);
+    p += TR01_STPUB_LEN;
+
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, p, (LT_NUM_CERTIFICATES - 1) * OTHER_CERT_LEN));
+}
+
+/**
+ * @brief Generates a new mocked chip.
+ */
+static void make_chip(lt_handle_t *h, struct mocked_chip_t *chip)
+{
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, &chip->chip_id, sizeof(chip->chip_id)));
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, chip->riscv_fw_ver, sizeof(chip->riscv_fw_ver)));
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, chip->spect_fw_ver, sizeof(chip->spect_fw_ver)));
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, chip->stpriv, sizeof(chip->stpriv)));
+    LT_TEST_ASSERT(LT_OK, lt_X25519_scalarmult(chip->stpriv, chip->stpub));
+    make_cert_store(h, chip);
+}
+
+/**
+ * @brief Mocks Get_Info requests done by lt_chip_identity_read() after the chip ID.
+ */
+static void mock_identity_read_after_chip_id(lt_handle_t *h, const struct mocked_chip_t *chip)
+{
+    LT_TEST_ASSERT(LT_OK, mock_get_info(h, chip->riscv_fw_ver, TR01_L2_GET_INFO_RISCV_FW_SIZE));
+    LT_TEST_ASSERT(LT_OK, mock_get_info(h, chip->spect_fw_ver, TR01_L2_GET_INFO_SPECT_FW_SIZE));
+    for (size_t i = 0; i < CERT_STORE_BLOCK_COUNT; i++) {
+        LT_TEST_ASSERT(LT_OK, mock_get_info(h, &chip->cert_store[i * CERT_STORE_BLOCK_LEN], CERT_STORE_BLOCK_LEN));
+    }
+}
+
+/**
+ * @brief Mocks all Get_Info requests done by lt_chip_identity_read().
+ */
+static void mock_identity_read(lt_handle_t *h, const struct mocked_chip_t *chip)
+{
+    LT_TEST_ASSERT(LT_OK, mock_get_info(h, &chip->chip_id, TR01_L2_GET_INFO_CHIP_ID_SIZE));
+    mock_identity_read_after_chip_id(h, chip);
+}
+
+/**
+ * @brief Starts Secure Session from the cached identity, with the host ephemeral key taken from a pool.
+ */
+static lt_ret_t session_start_cached(lt_handle_t *h, const struct mocked_chip_t *chip, const uint8_t *shipriv,
+                                     const uint8_t *shipub, const bool expect_identity_read,
+                                     lt_chip_identity_t *identity, bool *identity_updated)
+{
+    static lt_eph_key_pool_t pool;
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_refill(h, &pool, 1));
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_set(h, &pool));
+
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    if (expect_identity_read) {
+        mock_identity_read(h, chip);
+    }
+    else {
+        LT_TEST_ASSERT(LT_OK, mock_get_info(h, &chip->chip_id, TR01_L2_GET_INFO_CHIP_ID_SIZE));
+    }
+    LT_TEST_ASSERT(LT_OK, mock_handshake(h, chip->stpriv, chip->stpub, shipub, TR01_PAIRING_KEY_SLOT_INDEX_0,
+                                         pool.keys[pool.count - 1].ehpub));
+
+    lt_ret_t ret = lt_verify_chip_and_start_secure_session_cached(h, shipriv, shipub, TR01_PAIRING_KEY_SLOT_INDEX_0,
+                                                                  identity, identity_updated);
+    LT_TEST_ASSERT(expect_identity_read ? IDENTITY_READ_REQUEST_COUNT + 1 : 2, lt_mock_hal_get_request_count(&h->l2));
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_set(h, NULL));
+
+    return ret;
+}
+
+/**
+ * @brief Starts Secure Session from a cached identity whose handshake fails, so the identity is read again and the
+ * handshake is retried with the fresh STPub if it changed.
+ */
+static lt_ret_t session_start_cached_retry(lt_handle_t *h, const struct mocked_chip_t *chip, const uint8_t *shipriv,
+                                           const uint8_t *shipub, const bool expect_retry, lt_chip_identity_t *identity,
+                                           bool *identity_updated)
+{
+    static lt_eph_key_pool_t pool;
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_refill(h, &pool, 2));
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_set(h, &pool));
+
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    LT_TEST_ASSERT(LT_OK, mock_get_info(h, &chip->chip_id, TR01_L2_GET_INFO_CHIP_ID_SIZE));
+    LT_TEST_ASSERT(LT_OK, mock_handshake(h, chip->stpriv, chip->stpub, shipub, TR01_PAIRING_KEY_SLOT_INDEX_0,
+                                         pool.keys[pool.count - 1].ehpub));
+    mock_identity_read_after_chip_id(h, chip);
+    if (expect_retry) {
+        LT_TEST_ASSERT(LT_OK, mock_handshake(h, chip->stpriv, chip->stpub, shipub, TR01_PAIRING_KEY_SLOT_INDEX_0,
+                                             pool.keys[pool.count - 2].ehpub));
+    }
+
+    lt_ret_t ret = lt_verify_chip_and_start_secure_session_cached(h, shipriv, shipub, TR01_PAIRING_KEY_SLOT_INDEX_0,
+                                                                  identity, identity_updated);
+    LT_TEST_ASSERT(IDENTITY_READ_REQUEST_COUNT + (expect_retry ? 2 : 1), lt_mock_hal_get_request_count(&h->l2));
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_set(h, NULL));
+
+    return ret;
+}
+
+/**
+ * @brief Checks that the identity matches the mocked chip.
+ */
+static void check_identity(const lt_chip_identity_t *identity, const struct mocked_chip_t *chip)
+{
+    LT_TEST_ASSERT(LT_CHIP_IDENTITY_MAGIC, identity->magic);
+    LT_TEST_ASSERT(LT_CHIP_IDENTITY_VERSION, identity->version);
+    LT_TEST_ASSERT(0, memcmp(&identity->ser_num, &chip->chip_id.ser_num, sizeof(identity->ser_num)));
+    LT_TEST_ASSERT(0, memcmp(identity->riscv_fw_ver, chip->riscv_fw_ver, sizeof(identity->riscv_fw_ver)));
+    LT_TEST_ASSERT(0, memcmp(identity->spect_fw_ver, chip->spect_fw_ver, sizeof(identity->spect_fw_ver)));
+    LT_TEST_ASSERT(0, memcmp(identity->stpub, chip->stpub, sizeof(identity->stpub)));
+
+    LT_TEST_ASSERT(DEVICE_CERT_LEN, identity->cert_len[LT_CERT_KIND_DEVICE]);
+    const uint8_t *cert = &chip->cert_store[CERT_STORE_HEADER_LEN];
+    for (int i = 0; i < LT_NUM_CERTIFICATES; i++) {
+        LT_TEST_ASSERT(0, memcmp(identity->certs[i], cert, identity->cert_len[i]));
+        cert += identity->cert_len[i];
+    }
+}
+
+void lt_test_mock_chip_identity(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_chip_identity()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    static struct mocked_chip_t chip, other_chip;
+    static lt_chip_identity_t identity, identity_copy;
+    uint8_t shipriv[TR01_SHIPRIV_LEN], shipub[TR01_SHIPUB_LEN];
+    bool identity_updated;
+    make_chip(h, &chip);
+    make_chip(h, &other_chip);
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, shipriv, sizeof(shipriv)));
+    LT_TEST_ASSERT(LT_OK, lt_X25519_scalarmult(shipriv, shipub));
+
+    LT_LOG_INFO("Reading chip identity...");
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    mock_identity_read(h, &chip);
+    LT_TEST_ASSERT(LT_OK, lt_chip_identity_read(h, &identity));
+    LT_TEST_ASSERT(IDENTITY_READ_REQUEST_COUNT, lt_mock_hal_get_request_count(&h->l2));
+    check_identity(&identity, &chip);
+
+    LT_LOG_INFO("Starting session with the cached identity...");
+    memcpy(&identity_copy, &identity, sizeof(identity));
+    LT_TEST_ASSERT(LT_OK, session_start_cached(h, &chip, shipriv, shipub, false, &identity, &identity_updated));
+    LT_TEST_ASSERT(false, identity_updated);
+    LT_TEST_ASSERT(LT_SECURE_SESSION_ON, h->l3.session_status);
+    LT_TEST_ASSERT(0, memcmp(&identity_copy, &identity, sizeof(identity)));
+    LT_TEST_ASSERT(LT_OK, mock_session_abort(h));
+
+    LT_LOG_INFO("Starting session with the identity of another chip...");
+    LT_TEST_ASSERT(LT_OK, session_start_cached(h, &other_chip, shipriv, shipub, true, &identity, &identity_updated));
+    LT_TEST_ASSERT(true, identity_updated);
+    LT_TEST_ASSERT(LT_SECURE_SESSION_ON, h->l3.session_status);
+    check_identity(&identity, &other_chip);
+    LT_TEST_ASSERT(LT_OK, mock_session_abort(h));
+
+    LT_LOG_INFO("Starting session with zeroed and corrupted identity...");
+    memset(&identity, 0, sizeof(identity));
+    LT_TEST_ASSERT(LT_OK, session_start_cached(h, &chip, shipriv, shipub, true, &identity, &identity_updated));
+    LT_TEST_ASSERT(true, identity_updated);
+    check_identity(&identity, &chip);
+    LT_TEST_ASSERT(LT_OK, mock_session_abort(h));
+    identity.certs[LT_CERT_KIND_TROPIC_ROOT][0] ^= 0x01;
+    LT_TEST_ASSERT(LT_OK, session_start_cached(h, &chip, shipriv, shipub, true, &identity, &identity_updated));
+    LT_TEST_ASSERT(true, identity_updated);
+    check_identity(&identity, &chip);
+    LT_TEST_ASSERT(LT_OK, mock_session_abort(h));
+
+    LT_LOG_INFO("Checking that a valid record holding wrong STPub is read again and the handshake retried...");
+    memcpy(identity.stpub, other_chip.stpub, TR01_STPUB_LEN);
+    identity.crc = crc16_finish(crc16_update(LT_CRC16_INITIAL_VAL, (const uint8_t *)&identity.ser_num,
+                                             sizeof(identity) - offsetof(lt_chip_identity_t, ser_num)));
+    LT_TEST_ASSERT(LT_OK, session_start_cached_retry(h, &chip, shipriv, shipub, true, &identity, &identity_updated));
+    LT_TEST_ASSERT(true, identity_updated);
+    LT_TEST_ASSERT(LT_SECURE_SESSION_ON, h->l3.session_status);
+    check_identity(&identity, &chip);
+    LT_TEST_ASSERT(LT_OK, mock_session_abort(h));
+
+    LT_LOG_INFO("Checking that the handshake is not retried when STPub did not change...");
+    uint8_t other_shipriv[TR01_SHIPRIV_LEN], other_shipub[TR01_SHIPUB_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, other_shipriv, sizeof(other_shipriv)));
+    LT_TEST_ASSERT(LT_OK, lt_X25519_scalarmult(other_shipriv, other_shipub));
+    LT_TEST_ASSERT(LT_CRYPTO_ERR, session_start_cached_retry(h, &chip, other_shipriv, shipub, false, &identity,
+                                                             &identity_updated));
+    LT_TEST_ASSERT(true, identity_updated);
+    LT_TEST_ASSERT(LT_SECURE_SESSION_OFF, h->l3.session_status);
+    check_identity(&identity, &chip);
+
+    LT_LOG_INFO("Checking that failed read leaves the identity invalid...");
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    LT_TEST_ASSERT(LT_OK, mock_get_info(h, &chip.chip_id, TR01_L2_GET_INFO_CHIP_ID_SIZE));
+    LT_TEST_ASSERT(1, LT_OK != lt_chip_identity_read(h, &identity));
+    LT_TEST_ASSERT(0, identity.magic);
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+}
@@ -0,0 +1,83 @@
+/**
+ * @file lt_test_mock_crc16.c
+ * @brief Cross-check of the selected CRC16 implementation against the bitwise reference.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "lt_crc16.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_test_common.h"
+
+/**
+ * @brief Bitwise CRC16 (poly 0x8005, init 0, no reflection), returned byte-swapped the same way as crc16().
+ */
+static uint16_t crc16_reference(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x8005) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return (uint16_t)(crc << 8 | crc >> 8);
+}
+
+void lt_test_mock_crc16(lt_handle_t *h)
+{
+    LT_UNUSED(h);
+
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_crc16()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    // Alignment of the buffer start matters for the block-based implementations, so add some slack.
+    uint8_t buff[TR01_L1_LEN_MAX + 16];
+    for (size_t i = 0; i < sizeof(buff); i++) {
+        buff[i] = (uint8_t)rand();
+    }
+
+    LT_LOG_INFO("Checking known answer (CRC-16/UMTS of \"123456789\")...");
+    const uint8_t check_str[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    LT_TEST_ASSERT(0xE8FE, crc16(check_str, sizeof(check_str)));
+
+    LT_LOG_INFO("Checking zero and negative lengths...");
+    LT_TEST_ASSERT(0, crc16(buff, 0));
+    LT_TEST_ASSERT(0, crc16(buff, -1));
+
+    LT_LOG_INFO("Cross-checking all lengths up to %d bytes and all alignments against the reference...",
+                TR01_L1_LEN_MAX);
+    for (size_t offset = 0; offset < 16; offset++) {
+        for (size_t len = 0; len <= TR01_L1_LEN_MAX; len++) {
+            LT_TEST_ASSERT(crc16_reference(buff + offset, len), crc16(buff + offset, (int16_t)len));
+        }
+    }
+
+    LT_LOG_INFO("Checking that crc16_update() over split buffer matches crc16()...");
+    for (size_t split = 0; split <= TR01_L2_MAX_FRAME_SIZE; split++) {
+        uint16_t crc = crc16_update(LT_CRC16_INITIAL_VAL, buff, split);
+        crc = crc16_update(crc, buff + split, TR01_L2_MAX_FRAME_SIZE - split);
+        LT_TEST_ASSERT(crc16(buff, TR01_L2_MAX_FRAME_SIZE), crc16_finish(crc));
+    }
+
+    LT_LOG_INFO("Checking add_crc() on a maximal L2 request frame...");
+    uint8_t req[TR01_L2_MAX_FRAME_SIZE];
+    memcpy(req, buff, sizeof(req));
+    req[TR01_L2_REQ_LEN_OFFSET] = TR01_L2_CHUNK_MAX_DATA_SIZE;
+    add_crc(req);
+    uint16_t expected = crc16_reference(req, TR01_L2_CHUNK_MAX_DATA_SIZE + 2);
+    LT_TEST_ASSERT(expected >> 8, req[TR01_L2_CHUNK_MAX_DATA_SIZE + 2]);
+    LT_TEST_ASSERT(expected & 0xFF, req[TR01_L2_CHUNK_MAX_DATA_SIZE + 3]);
+}
@@ -0,0 +1,132 @@
+/**
+ * @file lt_test_mock_ecdsa_sign_digest.c
+ * @brief Test for ECDSA sign of a digest computed by the caller with lt_ecc_ecdsa_sign_digest().
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_l2.h"
+#include "libtropic_l3.h"
+#include "libtropic_logging.h"
+#include "libtropic_port_mock.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_l3_api_structs.h"
+#include "lt_l3_process.h"
+#include "lt_mock_helpers.h"
+#include "lt_port_wrap.h"
+#include "lt_sha256.h"
+#include "lt_test_common.h"
+
+#define MSG_LEN 1000
+
+/**
+ * @brief Mocks a fresh Secure Session and the replies to ECDSA_Sign.
+ *
+ * The Secure Session is started again before each signature, so the encrypted L3 Command is the same if the signed
+ * digest is the same.
+ */
+static void mock_ecdsa_sign(lt_handle_t *h, const uint8_t *kcmd, uint8_t *rs)
+{
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    LT_TEST_ASSERT(LT_OK, mock_session_start(h, kcmd, kcmd));
+    // Padding of the L3 Command is not set by Libtropic, make it the same for all ways.
+    memset(h->l3.buff, 0, h->l3.buff_len);
+
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, 1));
+    uint8_t ecdsa_sign_plaintext[TR01_L3_RESULT_SIZE + 15 + TR01_ECDSA_EDDSA_SIGNATURE_LENGTH] = {TR01_L3_RESULT_OK};
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, rs, TR01_ECDSA_EDDSA_SIGNATURE_LENGTH));
+    memcpy(&ecdsa_sign_plaintext[TR01_L3_RESULT_SIZE + 15], rs, TR01_ECDSA_EDDSA_SIGNATURE_LENGTH);
+    LT_TEST_ASSERT(LT_OK, mock_l3_result(h, ecdsa_sign_plaintext, sizeof(ecdsa_sign_plaintext)));
+}
+
+/**
+ * @brief Checks the returned signature and stores the written L3 Command.
+ */
+static void check_ecdsa_sign(lt_handle_t *h, const uint8_t *rs, const uint8_t *rs_in, mock_mosi_data_t *request)
+{
+    LT_TEST_ASSERT(0, memcmp(rs, rs_in, TR01_ECDSA_EDDSA_SIGNATURE_LENGTH));
+    LT_TEST_ASSERT(1, lt_mock_hal_get_request_count(&h->l2));
+    *request = *lt_mock_hal_get_request(&h->l2, 0);
+}
+
+void lt_test_mock_ecdsa_sign_digest(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_ecdsa_sign_digest()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    uint8_t kcmd[TR01_AES256_KEY_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, kcmd, sizeof(kcmd)));
+    uint8_t msg[MSG_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, msg, sizeof(msg)));
+
+    LT_LOG_INFO("Computing digest of the message...");
+    uint8_t digest[TR01_ECDSA_SIGN_DIGEST_LENGTH];
+    LT_TEST_ASSERT(LT_OK, lt_sha256_init(h->l3.crypto_ctx));
+    LT_TEST_ASSERT(LT_OK, lt_sha256_start(h->l3.crypto_ctx));
+    LT_TEST_ASSERT(LT_OK, lt_sha256_update(h->l3.crypto_ctx, msg, sizeof(msg)));
+    LT_TEST_ASSERT(LT_OK, lt_sha256_finish(h->l3.crypto_ctx, digest));
+    LT_TEST_ASSERT(LT_OK, lt_sha256_deinit(h->l3.crypto_ctx));
+
+    uint8_t rs[TR01_ECDSA_EDDSA_SIGNATURE_LENGTH], rs_in[TR01_ECDSA_EDDSA_SIGNATURE_LENGTH];
+    static mock_mosi_data_t msg_request, digest_request;
+
+    LT_LOG_INFO("Signing the message...");
+    mock_ecdsa_sign(h, kcmd, rs);
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign(h, TR01_ECC_SLOT_7, msg, sizeof(msg), rs_in));
+    check_ecdsa_sign(h, rs, rs_in, &msg_request);
+
+    LT_LOG_INFO("Checking that signing the digest writes the same ECDSA_Sign...");
+    mock_ecdsa_sign(h, kcmd, rs);
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_digest(h, TR01_ECC_SLOT_7, digest, rs_in));
+    check_ecdsa_sign(h, rs, rs_in, &digest_request);
+    LT_TEST_ASSERT(msg_request.len, digest_request.len);
+    LT_TEST_ASSERT(0, memcmp(msg_request.data, digest_request.data, msg_request.len));
+
+    LT_LOG_INFO("Checking the same with the separate L3 API...");
+    mock_ecdsa_sign(h, kcmd, rs);
+    LT_TEST_ASSERT(LT_OK, lt_out__ecc_ecdsa_sign_digest(h, TR01_ECC_SLOT_7, digest));
+    LT_TEST_ASSERT(LT_OK, lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len));
+    LT_TEST_ASSERT(LT_OK, lt_l2_recv_encrypted_res(&h->l2, h->l3.buff,
+                                                   lt_min(h->l3.buff_len, TR01_L3_ECDSA_SIGN_RES_PACKET_SIZE)));
+    LT_TEST_ASSERT(LT_OK, lt_in__ecc_ecdsa_sign(h, rs_in));
+    check_ecdsa_sign(h, rs, rs_in, &digest_request);
+    LT_TEST_ASSERT(msg_request.len, digest_request.len);
+    LT_TEST_ASSERT(0, memcmp(msg_request.data, digest_request.data, msg_request.len));
+
+    LT_LOG_INFO("Checking that the digest can be signed while a message is being hashed...");
+    mock_ecdsa_sign(h, kcmd, rs);
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_init(h, TR01_ECC_SLOT_0));
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_digest(h, TR01_ECC_SLOT_7, digest, rs_in));
+    check_ecdsa_sign(h, rs, rs_in, &digest_request);
+    LT_TEST_ASSERT(0, memcmp(msg_request.data, digest_request.data, msg_request.len));
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_abort(h));
+
+    LT_LOG_INFO("Checking invalid parameters...");
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_ecc_ecdsa_sign_digest(NULL, TR01_ECC_SLOT_0, digest, rs_in));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_ecc_ecdsa_sign_digest(h, TR01_ECC_SLOT_31 + 1, digest, rs_in));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_ecc_ecdsa_sign_digest(h, TR01_ECC_SLOT_0, NULL, rs_in));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_ecc_ecdsa_sign_digest(h, TR01_ECC_SLOT_0, digest, NULL));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_out__ecc_ecdsa_sign_digest(h, TR01_ECC_SLOT_31 + 1, digest));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_out__ecc_ecdsa_sign_digest(h, TR01_ECC_SLOT_0, NULL));
+
+    LT_LOG_INFO("Checking that Secure Session is needed...");
+    LT_TEST_ASSERT(LT_OK, mock_session_abort(h));
+    LT_TEST_ASSERT(LT_HOST_NO_SESSION, lt_ecc_ecdsa_sign_digest(h, TR01_ECC_SLOT_0, digest, rs_in));
+    LT_TEST_ASSERT(LT_HOST_NO_SESSION, lt_out__ecc_ecdsa_sign_digest(h, TR01_ECC_SLOT_0, digest));
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+}
@@ -0,0 +1,162 @@
+/**
+ * @file lt_test_mock_ecdsa_sign_stream.c
+ * @brief Test for ECDSA sign of a message passed in chunks with lt_ecc_ecdsa_sign_init(), _update() and _final().
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_l3.h"
+#include "libtropic_logging.h"
+#include "libtropic_port_mock.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_l3_api_structs.h"
+#include "lt_l3_process.h"
+#include "lt_mock_helpers.h"
+#include "lt_port_wrap.h"
+#include "lt_test_common.h"
+
+#define MSG_LEN 10000
+// Size of the buffer the large message is streamed from and the length of the message.
+#define STREAM_CHUNK_LEN 4096
+#define STREAM_MSG_LEN (16u * 1024 * 1024)
+
+/**
+ * @brief Mocks a fresh Secure Session and the replies to ECDSA_Sign.
+ *
+ * The Secure Session is started again before each signature, so the encrypted L3 Command is the same if the signed
+ * digest is the same.
+ */
+static void mock_ecdsa_sign(lt_handle_t *h, const uint8_t *kcmd, uint8_t *rs)
+{
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    LT_TEST_ASSERT(LT_OK, mock_session_start(h, kcmd, kcmd));
+    // Padding of the L3 Command is not set by Libtropic, make it the same for both ways.
+    memset(h->l3.buff, 0, h->l3.buff_len);
+
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, 1));
+    uint8_t ecdsa_sign_plaintext[TR01_L3_RESULT_SIZE + 15 + TR01_ECDSA_EDDSA_SIGNATURE_LENGTH] = {TR01_L3_RESULT_OK};
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, rs, TR01_ECDSA_EDDSA_SIGNATURE_LENGTH));
+    memcpy(&ecdsa_sign_plaintext[TR01_L3_RESULT_SIZE + 15], rs, TR01_ECDSA_EDDSA_SIGNATURE_LENGTH);
+    LT_TEST_ASSERT(LT_OK, mock_l3_result(h, ecdsa_sign_plaintext, sizeof(ecdsa_sign_plaintext)));
+}
+
+/**
+ * @brief Signs the message, in chunks of given length or as a whole if it is 0, and stores the written L3 Command.
+ */
+static void ecdsa_sign(lt_handle_t *h, const uint8_t *kcmd, const uint8_t *msg, const uint32_t chunk_len,
+                       mock_mosi_data_t *request)
+{
+    uint8_t rs[TR01_ECDSA_EDDSA_SIGNATURE_LENGTH], rs_in[TR01_ECDSA_EDDSA_SIGNATURE_LENGTH];
+    mock_ecdsa_sign(h, kcmd, rs);
+
+    if (chunk_len == 0) {
+        LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign(h, TR01_ECC_SLOT_5, msg, MSG_LEN, rs_in));
+    }
+    else {
+        LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_init(h, TR01_ECC_SLOT_5));
+        for (uint32_t offset = 0; offset < MSG_LEN; offset += chunk_len) {
+            uint32_t len = (MSG_LEN - offset < chunk_len) ? MSG_LEN - offset : chunk_len;
+            LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_update(h, &msg[offset], len));
+            LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_update(h, NULL, 0));
+        }
+        LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_final(h, rs_in));
+    }
+    LT_TEST_ASSERT(0, memcmp(rs, rs_in, sizeof(rs)));
+
+    LT_TEST_ASSERT(1, lt_mock_hal_get_request_count(&h->l2));
+    *request = *lt_mock_hal_get_request(&h->l2, 0);
+}
+
+void lt_test_mock_ecdsa_sign_stream(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_ecdsa_sign_stream()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    uint8_t kcmd[TR01_AES256_KEY_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, kcmd, sizeof(kcmd)));
+    static uint8_t msg[MSG_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, msg, sizeof(msg)));
+
+    LT_LOG_INFO("Signing the whole message...");
+    static mock_mosi_data_t whole, streamed;
+    ecdsa_sign(h, kcmd, msg, 0, &whole);
+
+    LT_LOG_INFO("Checking that the message signed in chunks gives the same ECDSA_Sign...");
+    const uint32_t chunk_lens[] = {1, 63, 64, 1000, MSG_LEN, MSG_LEN + 1};
+    for (size_t i = 0; i < sizeof(chunk_lens) / sizeof(chunk_lens[0]); i++) {
+        LT_LOG_INFO("Chunks of %u bytes", (unsigned)chunk_lens[i]);
+        ecdsa_sign(h, kcmd, msg, chunk_lens[i], &streamed);
+        LT_TEST_ASSERT(whole.len, streamed.len);
+        LT_TEST_ASSERT(0, memcmp(whole.data, streamed.data, whole.len));
+    }
+
+    LT_LOG_INFO("Checking invalid parameters...");
+    uint8_t rs[TR01_ECDSA_EDDSA_SIGNATURE_LENGTH];
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_ecc_ecdsa_sign_init(NULL, TR01_ECC_SLOT_0));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_ecc_ecdsa_sign_init(h, TR01_ECC_SLOT_31 + 1));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_ecc_ecdsa_sign_update(h, msg, 1));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_ecc_ecdsa_sign_final(h, rs));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_out__ecc_ecdsa_sign_final(h));
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_init(h, TR01_ECC_SLOT_0));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_ecc_ecdsa_sign_update(h, NULL, 1));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_ecc_ecdsa_sign_final(h, NULL));
+
+    LT_LOG_INFO("Checking that the SHA-256 context is not used by anything else while hashing...");
+    lt_host_eph_keys_t eph_keys;
+    LT_TEST_ASSERT(LT_SHA256_BUSY, lt_ecc_ecdsa_sign_init(h, TR01_ECC_SLOT_0));
+    LT_TEST_ASSERT(LT_SHA256_BUSY, lt_ecc_ecdsa_sign(h, TR01_ECC_SLOT_0, msg, MSG_LEN, rs));
+    LT_TEST_ASSERT(LT_SHA256_BUSY, lt_out__session_start(h, TR01_PAIRING_KEY_SLOT_INDEX_0, &eph_keys));
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_update(h, msg, MSG_LEN));
+
+    LT_LOG_INFO("Checking that aborted hashing cannot be finished...");
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_abort(h));
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_abort(h));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_ecc_ecdsa_sign_update(h, msg, MSG_LEN));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_ecc_ecdsa_sign_final(h, rs));
+
+    LT_LOG_INFO("Checking that hashing ends when the session is lost before signing...");
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_init(h, TR01_ECC_SLOT_0));
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_update(h, msg, MSG_LEN));
+    LT_TEST_ASSERT(LT_OK, mock_session_abort(h));
+    LT_TEST_ASSERT(LT_HOST_NO_SESSION, lt_ecc_ecdsa_sign_final(h, rs));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_ecc_ecdsa_sign_update(h, msg, MSG_LEN));
+    LT_TEST_ASSERT(LT_HOST_NO_SESSION, lt_ecc_ecdsa_sign_init(h, TR01_ECC_SLOT_0));
+
+    LT_LOG_INFO("Signing %u MiB message streamed from %u B buffer...", STREAM_MSG_LEN / (1024 * 1024),
+                STREAM_CHUNK_LEN);
+    uint8_t rs_in[TR01_ECDSA_EDDSA_SIGNATURE_LENGTH];
+    mock_ecdsa_sign(h, kcmd, rs);
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_init(h, TR01_ECC_SLOT_5));
+    int failed_updates = 0;
+    for (uint32_t offset = 0; offset < STREAM_MSG_LEN; offset += STREAM_CHUNK_LEN) {
+        // Stands for reading the next part of the message into the buffer.
+        memset(msg, (uint8_t)(offset / STREAM_CHUNK_LEN), STREAM_CHUNK_LEN);
+        if (lt_ecc_ecdsa_sign_update(h, msg, STREAM_CHUNK_LEN) != LT_OK) {
+            failed_updates++;
+        }
+    }
+    LT_TEST_ASSERT(0, failed_updates);
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_final(h, rs_in));
+    LT_TEST_ASSERT(0, memcmp(rs, rs_in, sizeof(rs)));
+
+    LT_LOG_INFO("Checking that lt_deinit() releases unfinished hashing...");
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_init(h, TR01_ECC_SLOT_0));
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_update(h, msg, MSG_LEN));
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+    LT_TEST_ASSERT(0, h->l3.ecdsa_sign_hashing);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file lt_test_mock_eph_key_pool.c
+ * @brief Test for taking Secure Session ephemeral keys from a pool of pre-generated keys.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_l3.h"
+#include "libtropic_logging.h"
+#include "libtropic_port_mock.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_l2_api_structs.h"
+#include "lt_mock_helpers.h"
+#include "lt_port_wrap.h"
+#include "lt_secure_memzero.h"
+#include "lt_test_common.h"
+#include "lt_x25519.h"
+
+/**
+ * @brief Checks that the key pair is a valid X25519 key pair.
+ */
+static void check_key_pair(const lt_host_eph_keys_t *keys)
+{
+    uint8_t ehpub[TR01_X25519_KEY_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_X25519_scalarmult(keys->ehpriv, ehpub));
+    LT_TEST_ASSERT(0, memcmp(keys->ehpub, ehpub, sizeof(ehpub)));
+}
+
+/**
+ * @brief Checks that the entry of the pool is zeroed.
+ */
+static void check_zeroed(const lt_host_eph_keys_t *keys)
+{
+    const uint8_t *bytes = (const uint8_t *)keys;
+    for (size_t i = 0; i < sizeof(lt_host_eph_keys_t); i++) {
+        LT_TEST_ASSERT(0, bytes[i]);
+    }
+}
+
+void lt_test_mock_eph_key_pool(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_eph_key_pool()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    static lt_eph_key_pool_t pool;
+    lt_eph_key_pool_t pool_copy;
+    lt_host_eph_keys_t keys;
+    const struct lt_l2_handshake_req_t *p_req = (const struct lt_l2_handshake_req_t *)h->l2.buff;
+
+    LT_LOG_INFO("Refilling the pool in steps...");
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_refill(h, &pool, 1));
+    LT_TEST_ASSERT(1, pool.count);
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_refill(h, &pool, 255));
+    LT_TEST_ASSERT(LT_EPH_KEY_POOL_SIZE, pool.count);
+    for (size_t i = 0; i < LT_EPH_KEY_POOL_SIZE; i++) {
+        check_key_pair(&pool.keys[i]);
+    }
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_refill(h, &pool, 1));
+    LT_TEST_ASSERT(LT_EPH_KEY_POOL_SIZE, pool.count);
+
+    LT_LOG_INFO("Checking that the keys are not taken from the pool before it is set...");
+    LT_TEST_ASSERT(LT_OK, lt_out__session_start(h, TR01_PAIRING_KEY_SLOT_INDEX_0, &keys));
+    LT_TEST_ASSERT(LT_EPH_KEY_POOL_SIZE, pool.count);
+
+    LT_LOG_INFO("Checking that each handshake takes its own key pair from the pool...");
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_set(h, &pool));
+    memcpy(&pool_copy, &pool, sizeof(pool));
+    for (size_t i = LT_EPH_KEY_POOL_SIZE; i > 0; i--) {
+        LT_TEST_ASSERT(LT_OK, lt_out__session_start(h, TR01_PAIRING_KEY_SLOT_INDEX_1, &keys));
+        LT_TEST_ASSERT(i - 1, pool.count);
+        LT_TEST_ASSERT(0, memcmp(&pool_copy.keys[i - 1], &keys, sizeof(keys)));
+        LT_TEST_ASSERT(0, memcmp(p_req->e_hpub, keys.ehpub, TR01_EHPUB_LEN));
+        check_zeroed(&pool.keys[i - 1]);
+    }
+
+    LT_LOG_INFO("Checking that the key pair is generated when the pool is empty...");
+    LT_TEST_ASSERT(LT_OK, lt_out__session_start(h, TR01_PAIRING_KEY_SLOT_INDEX_1, &keys));
+    LT_TEST_ASSERT(0, pool.count);
+    check_key_pair(&keys);
+    for (size_t i = 0; i < LT_EPH_KEY_POOL_SIZE; i++) {
+        LT_TEST_ASSERT(1, memcmp(&pool_copy.keys[i], &keys, sizeof(keys)) != 0);
+    }
+
+    LT_LOG_INFO("Checking that the pool is cleared...");
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_refill(h, &pool, LT_EPH_KEY_POOL_SIZE));
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_clear(&pool));
+    LT_TEST_ASSERT(0, pool.count);
+    for (size_t i = 0; i < LT_EPH_KEY_POOL_SIZE; i++) {
+        check_zeroed(&pool.keys[i]);
+    }
+    lt_secure_memzero(&pool_copy, sizeof(pool_copy));
+    lt_secure_memzero(&keys, sizeof(keys));
+
+    LT_LOG_INFO("Checking that lt_init() unsets the pool...");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+    lt_mock_hal_reset(&h->l2);
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+    LT_TEST_ASSERT(1, h->l3.eph_key_pool == NULL);
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+}
@@ -0,0 +1,86 @@
+/**
+ * @file lt_test_mock_frame_xfer.c
+ * @brief Test for L1 communication through lt_port_frame_xfer().
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_port_mock.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_l1.h"
+#include "lt_l2_api_structs.h"
+#include "lt_l2_frame_check.h"
+#include "lt_mock_helpers.h"
+#include "lt_test_common.h"
+
+// Number of CHIP_STATUS polls during which the mocked chip is busy.
+#define BUSY_POLLS 2
+
+void lt_test_mock_frame_xfer(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_frame_xfer()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    lt_mock_hal_reset(&h->l2);
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_enable_frame_xfer(&h->l2, true));
+
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+    LT_TEST_ASSERT(1, lt_mock_hal_get_frame_xfer_count(&h->l2) > 0);
+
+    LT_LOG_INFO("Mocking Get_Info, chip busy for %d polls...", BUSY_POLLS);
+    uint8_t chip_ready = TR01_L1_CHIP_MODE_READY_bit;
+    uint8_t chip_busy = 0;
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_enqueue_response(&h->l2, &chip_ready, sizeof(chip_ready)));
+    for (int i = 0; i < BUSY_POLLS; i++) {
+        LT_TEST_ASSERT(LT_OK, lt_mock_hal_enqueue_response(&h->l2, &chip_busy, sizeof(chip_busy)));
+    }
+    struct lt_l2_get_info_rsp_t get_info_resp = {.chip_status = TR01_L1_CHIP_MODE_READY_bit,
+                                                 .status = TR01_L2_STATUS_REQUEST_OK,
+                                                 .rsp_len = TR01_L2_GET_INFO_RISCV_FW_SIZE,
+                                                 .object = {0x04, 0x03, 0x02, 0x01}};
+    add_resp_crc(&get_info_resp);
+    LT_TEST_ASSERT(
+        LT_OK, lt_mock_hal_enqueue_response(&h->l2, (uint8_t *)&get_info_resp, calc_mocked_resp_len(&get_info_resp)));
+
+    LT_LOG_INFO("Checking that the request and each poll are transferred as one frame...");
+    size_t frame_xfer_count = lt_mock_hal_get_frame_xfer_count(&h->l2);
+    uint8_t fw_ver[TR01_L2_GET_INFO_RISCV_FW_SIZE];
+    LT_TEST_ASSERT(LT_OK, lt_get_info_riscv_fw_ver(h, fw_ver));
+    LT_TEST_ASSERT(0, memcmp(fw_ver, get_info_resp.object, sizeof(fw_ver)));
+    LT_TEST_ASSERT(1 + BUSY_POLLS + 1, lt_mock_hal_get_frame_xfer_count(&h->l2) - frame_xfer_count);
+
+    LT_LOG_INFO("Checking response with invalid CRC...");
+    get_info_resp.object[0] ^= 0x01;
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_enqueue_response(&h->l2, &chip_ready, sizeof(chip_ready)));
+    LT_TEST_ASSERT(
+        LT_OK, lt_mock_hal_enqueue_response(&h->l2, (uint8_t *)&get_info_resp, calc_mocked_resp_len(&get_info_resp)));
+    LT_TEST_ASSERT(LT_L2_IN_CRC_ERR, lt_get_info_riscv_fw_ver(h, fw_ver));
+
+    LT_LOG_INFO("Checking response longer than the L1 buffer...");
+    uint8_t too_long_resp[] = {TR01_L1_CHIP_MODE_READY_bit, TR01_L2_STATUS_REQUEST_OK, TR01_L2_CHUNK_MAX_DATA_SIZE + 1};
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_enqueue_response(&h->l2, &chip_ready, sizeof(chip_ready)));
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_enqueue_response(&h->l2, too_long_resp, sizeof(too_long_resp)));
+    LT_TEST_ASSERT(LT_L1_DATA_LEN_ERROR, lt_get_info_riscv_fw_ver(h, fw_ver));
+
+    LT_LOG_INFO("Checking CHIP_STATUS read by lt_get_tr01_mode()...");
+    lt_tr01_mode_t mode;
+    frame_xfer_count = lt_mock_hal_get_frame_xfer_count(&h->l2);
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_enqueue_response(&h->l2, &chip_ready, sizeof(chip_ready)));
+    LT_TEST_ASSERT(LT_OK, lt_get_tr01_mode(h, &mode));
+    LT_TEST_ASSERT(LT_TR01_APPLICATION, mode);
+    LT_TEST_ASSERT(1, lt_mock_hal_get_frame_xfer_count(&h->l2) - frame_xfer_count);
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+}
@@ -0,0 +1,168 @@
+/**
+ * @file lt_test_mock_get_info_st_pub.c
+ * @brief Test for reading STPub while the Certificate Store is received, without reading the whole store.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_port_mock.h"
+#include "lt_asn1_der.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_mock_cert_store.h"
+#include "lt_mock_helpers.h"
+#include "lt_port_wrap.h"
+#include "lt_test_common.h"
+#include "lt_x25519.h"
+
+// Blocks of the mocked Certificate Store up to the end of STPub.
+#define STPUB_BLOCK_COUNT ((MOCK_CERT_STORE_STPUB_END + MOCK_CERT_STORE_BLOCK_LEN - 1) / MOCK_CERT_STORE_BLOCK_LEN)
+
+// Number of randomly corrupted device certificates passed to the streaming parser.
+#define CORRUPTION_ITERATIONS 2000
+
+// OBJECT_IDENTIFIER of Ed25519, which is not in the device certificate.
+#define OBJ_ID_ED25519 0x2B6570
+
+/**
+ * @brief Parses the device certificate from the mocked Certificate Store in chunks of the given size.
+ *
+ * @return Result of asn1der_stream_feed() or asn1der_stream_finish()
+ */
+static lt_ret_t parse_streamed(const uint8_t *cert, const uint16_t cert_len, const uint16_t chunk_len,
+                               const int32_t obj_id, uint8_t *stpub, struct lt_asn1der_stream_t *parser)
+{
+    asn1der_stream_init(parser, cert_len, obj_id, stpub, TR01_STPUB_LEN, LT_ASN1DER_CROP_PREFIX);
+
+    for (uint16_t offset = 0; offset < cert_len && !parser->found; offset += chunk_len) {
+        uint16_t n = (cert_len - offset < chunk_len) ? cert_len - offset : chunk_len;
+        lt_ret_t ret = asn1der_stream_feed(parser, &cert[offset], n);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+
+    return asn1der_stream_finish(parser);
+}
+
+void lt_test_mock_get_info_st_pub(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_get_info_st_pub()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    const uint8_t *device_cert = &mock_cert_store[MOCK_CERT_STORE_HEADER_LEN];
+    const uint16_t device_cert_len = ((uint16_t)mock_cert_store[2] << 8) | mock_cert_store[3];
+    const uint16_t stpub_end = MOCK_CERT_STORE_STPUB_END - MOCK_CERT_STORE_HEADER_LEN;
+    uint8_t stpub[TR01_STPUB_LEN];
+
+    LT_LOG_INFO("Reading STPub while the Certificate Store is received...");
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    LT_TEST_ASSERT(LT_OK, mock_get_info_cert_store(h, MOCK_CERT_STORE_BLOCK_COUNT));
+    memset(stpub, 0, sizeof(stpub));
+    LT_TEST_ASSERT(LT_OK, lt_get_info_st_pub(h, stpub));
+    LT_TEST_ASSERT(0, memcmp(mock_stpub, stpub, TR01_STPUB_LEN));
+    LT_TEST_ASSERT(STPUB_BLOCK_COUNT, lt_mock_hal_get_request_count(&h->l2));
+
+    LT_LOG_INFO("Reading STPub from the whole Certificate Store...");
+    static uint8_t certs[LT_NUM_CERTIFICATES][TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE];
+    struct lt_cert_store_t store
+        = {.cert_len = {0},
+           .buf_len = {TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE, TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE,
+                       TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE, TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE},
+           .certs = {certs[0], certs[1], certs[2], certs[3]}};
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    LT_TEST_ASSERT(LT_OK, mock_get_info_cert_store(h, MOCK_CERT_STORE_BLOCK_COUNT));
+    LT_TEST_ASSERT(LT_OK, lt_get_info_cert_store(h, &store));
+    LT_TEST_ASSERT(MOCK_CERT_STORE_BLOCK_COUNT, lt_mock_hal_get_request_count(&h->l2));
+    memset(stpub, 0, sizeof(stpub));
+    LT_TEST_ASSERT(LT_OK, lt_get_st_pub(&store, stpub));
+    LT_TEST_ASSERT(0, memcmp(mock_stpub, stpub, TR01_STPUB_LEN));
+    LT_LOG_INFO("Get_Info requests: %d while received, %d for the whole store", STPUB_BLOCK_COUNT,
+                MOCK_CERT_STORE_BLOCK_COUNT);
+
+    LT_LOG_INFO("Starting Secure Session with lt_verify_chip_and_start_secure_session()...");
+    static lt_eph_key_pool_t pool;
+    struct lt_chip_id_t chip_id = {0};
+    uint8_t fw_ver[TR01_L2_GET_INFO_RISCV_FW_SIZE] = {0x00, 0x00, 0x00, 0x02};
+    uint8_t shipriv[TR01_SHIPRIV_LEN], shipub[TR01_SHIPUB_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, shipriv, sizeof(shipriv)));
+    LT_TEST_ASSERT(LT_OK, lt_X25519_scalarmult(shipriv, shipub));
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_refill(h, &pool, 1));
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_set(h, &pool));
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    LT_TEST_ASSERT(LT_OK, mock_get_info(h, &chip_id, TR01_L2_GET_INFO_CHIP_ID_SIZE));
+    LT_TEST_ASSERT(LT_OK, mock_get_info(h, fw_ver, TR01_L2_GET_INFO_RISCV_FW_SIZE));
+    LT_TEST_ASSERT(LT_OK, mock_get_info(h, fw_ver, TR01_L2_GET_INFO_SPECT_FW_SIZE));
+    LT_TEST_ASSERT(LT_OK, mock_get_info_cert_store(h, STPUB_BLOCK_COUNT));
+    LT_TEST_ASSERT(LT_OK, mock_handshake(h, mock_stpriv, mock_stpub, shipub, TR01_PAIRING_KEY_SLOT_INDEX_0,
+                                         pool.keys[0].ehpub));
+    LT_TEST_ASSERT(LT_OK, lt_verify_chip_and_start_secure_session(h, shipriv, shipub, TR01_PAIRING_KEY_SLOT_INDEX_0));
+    LT_TEST_ASSERT(LT_SECURE_SESSION_ON, h->l3.session_status);
+    LT_TEST_ASSERT(3 + STPUB_BLOCK_COUNT + 1, lt_mock_hal_get_request_count(&h->l2));
+    LT_TEST_ASSERT(LT_OK, mock_session_abort(h));
+    LT_TEST_ASSERT(LT_OK, lt_eph_key_pool_set(h, NULL));
+
+    LT_LOG_INFO("Checking that Certificate Store with unknown version is rejected...");
+    uint8_t block[MOCK_CERT_STORE_BLOCK_LEN];
+    memcpy(block, mock_cert_store, sizeof(block));
+    block[0] = LT_CERT_STORE_VERSION + 1;
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    LT_TEST_ASSERT(LT_OK, mock_get_info(h, block, sizeof(block)));
+    LT_TEST_ASSERT(LT_CERT_STORE_INVALID, lt_get_info_st_pub(h, stpub));
+    LT_TEST_ASSERT(1, lt_mock_hal_get_request_count(&h->l2));
+
+    LT_LOG_INFO("Parsing the device certificate in chunks of all sizes...");
+    struct lt_asn1der_stream_t parser;
+    uint8_t stpub_whole[TR01_STPUB_LEN];
+    LT_TEST_ASSERT(LT_OK, asn1der_find_object(device_cert, device_cert_len, LT_OBJ_ID_CURVEX25519, stpub_whole,
+                                              TR01_STPUB_LEN, LT_ASN1DER_CROP_PREFIX));
+    LT_TEST_ASSERT(0, memcmp(mock_stpub, stpub_whole, TR01_STPUB_LEN));
+    for (uint16_t chunk_len = 1; chunk_len <= device_cert_len; chunk_len++) {
+        memset(stpub, 0, sizeof(stpub));
+        LT_TEST_ASSERT(LT_OK,
+                       parse_streamed(device_cert, device_cert_len, chunk_len, LT_OBJ_ID_CURVEX25519, stpub, &parser));
+        LT_TEST_ASSERT(0, memcmp(stpub_whole, stpub, TR01_STPUB_LEN));
+        LT_TEST_ASSERT(stpub_end, parser.past);
+    }
+
+    LT_LOG_INFO("Checking that missing object is not found...");
+    LT_TEST_ASSERT(LT_CERT_ITEM_NOT_FOUND,
+                   parse_streamed(device_cert, device_cert_len, MOCK_CERT_STORE_BLOCK_LEN, OBJ_ID_ED25519, stpub, &parser));
+    LT_TEST_ASSERT(device_cert_len, parser.past);
+
+    LT_LOG_INFO("Checking that truncated device certificate is rejected...");
+    for (uint16_t len = 0; len < stpub_end; len++) {
+        LT_TEST_ASSERT(1, LT_OK != parse_streamed(device_cert, len, 1, LT_OBJ_ID_CURVEX25519, stpub, &parser));
+    }
+
+    LT_LOG_INFO("Parsing randomly corrupted device certificates...");
+    static uint8_t corrupted[TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE];
+    for (int i = 0; i < CORRUPTION_ITERATIONS; i++) {
+        uint8_t rnd[3];
+        LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, rnd, sizeof(rnd)));
+        memcpy(corrupted, device_cert, device_cert_len);
+        // Corrupt mostly the headers before STPub.
+        corrupted[((uint16_t)rnd[0] << 8 | rnd[1]) % stpub_end] = rnd[2];
+        lt_ret_t ret = parse_streamed(corrupted, device_cert_len, 1 + rnd[2] % 64, LT_OBJ_ID_CURVEX25519, stpub,
+                                      &parser);
+        LT_TEST_ASSERT(1, ret == LT_OK || ret == LT_CERT_STORE_INVALID || ret == LT_CERT_UNSUPPORTED
+                              || ret == LT_CERT_ITEM_NOT_FOUND);
+        LT_TEST_ASSERT(1, parser.past <= device_cert_len);
+    }
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+}
@@ -0,0 +1,235 @@
+/**
+ * @file lt_test_mock_l3_queue.c
+ * @brief Test for the queue of L3 Commands with lt_l3_queue_submit() and lt_l3_queue_poll().
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_l3.h"
+#include "libtropic_logging.h"
+#include "libtropic_port_mock.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_l3_process.h"
+#include "lt_mock_helpers.h"
+#include "lt_port_wrap.h"
+#include "lt_test_common.h"
+
+// Each L3 Command fits into one chunk, so all of them are kept in the request log of the mock HAL.
+#define CMD_COUNT 5
+#define DATA_MAX_LEN 200
+
+/**
+ * @brief Ping or Random_Value_Get passed to the queue.
+ */
+typedef struct queue_cmd_t {
+    bool is_ping;
+    uint16_t len;    // Length of the Ping message or number of random bytes
+    uint8_t result;  // RESULT of the mocked L3 Result
+    lt_ret_t expected_ret;
+    uint8_t data[DATA_MAX_LEN];     // Ping message or mocked random bytes
+    uint8_t data_in[DATA_MAX_LEN];  // Received message or random bytes
+    uint8_t in_encryption_iv;       // First byte of the encryption IV when the L3 Result was decoded
+    bool lose_session;              // Secure Session is lost when the L3 Result is decoded
+} queue_cmd_t;
+
+static queue_cmd_t cmds[CMD_COUNT] = {
+    {.is_ping = true, .len = 100, .result = TR01_L3_RESULT_OK, .expected_ret = LT_OK},
+    {.is_ping = false, .len = 32, .result = TR01_L3_RESULT_FAIL, .expected_ret = LT_L3_FAIL},
+    // Not sent at all, the message is too long.
+    {.is_ping = true, .len = TR01_PING_LEN_MAX + 1, .expected_ret = LT_PARAM_ERR},
+    {.is_ping = true, .len = 10, .result = TR01_L3_RESULT_OK, .expected_ret = LT_OK},
+    {.is_ping = false, .len = DATA_MAX_LEN, .result = TR01_L3_RESULT_OK, .expected_ret = LT_OK},
+};
+
+static lt_ret_t queue_cmd_out(lt_handle_t *h, void *ctx)
+{
+    queue_cmd_t *cmd = ctx;
+    if (!cmd->is_ping) {
+        return lt_out__random_value_get(h, cmd->len);
+    }
+
+    lt_ret_t ret = lt_out__ping(h, cmd->data, cmd->len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    return lt_l3_res_payload_into(h, cmd->data_in, cmd->len);
+}
+
+static lt_ret_t queue_cmd_in(lt_handle_t *h, void *ctx)
+{
+    queue_cmd_t *cmd = ctx;
+    cmd->in_encryption_iv = h->l3.encryption_IV[0];
+
+    lt_ret_t ret = cmd->is_ping ? lt_in__ping(h, cmd->data_in, cmd->len)
+                                : lt_in__random_value_get(h, cmd->data_in, cmd->len);
+    if (cmd->lose_session) {
+        lt_l3_invalidate_host_session_data(&h->l3);
+    }
+    return ret;
+}
+
+/**
+ * @brief Mocks a fresh Secure Session and the replies to the L3 Commands which are sent.
+ *
+ * The Secure Session is started again for each way of sending, so the encrypted L3 Commands are the same.
+ */
+static void mock_cmds(lt_handle_t *h, const uint8_t *kcmd)
+{
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    LT_TEST_ASSERT(LT_OK, mock_session_start(h, kcmd, kcmd));
+
+    // L3 Results are encrypted with the IV Libtropic will have when receiving them.
+    uint8_t sent = 0;
+    for (size_t i = 0; i < CMD_COUNT; i++) {
+        queue_cmd_t *cmd = &cmds[i];
+        memset(cmd->data_in, 0, sizeof(cmd->data_in));
+        if (cmd->expected_ret == LT_PARAM_ERR) {
+            continue;
+        }
+
+        uint8_t plaintext[TR01_L3_RESULT_SIZE + 3 + DATA_MAX_LEN] = {cmd->result};
+        size_t plaintext_size = TR01_L3_RESULT_SIZE;
+        if (cmd->result == TR01_L3_RESULT_OK) {
+            size_t offset = cmd->is_ping ? TR01_L3_RESULT_SIZE : TR01_L3_RESULT_SIZE + 3;
+            memcpy(&plaintext[offset], cmd->data, cmd->len);
+            plaintext_size = offset + cmd->len;
+        }
+        h->l3.decryption_IV[0] = sent++;
+        LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, 1));
+        LT_TEST_ASSERT(LT_OK, mock_l3_result(h, plaintext, plaintext_size));
+    }
+    h->l3.decryption_IV[0] = 0;
+}
+
+/**
+ * @brief Checks the received data and stores the written L3 Commands.
+ */
+static void check_cmds(lt_handle_t *h, const size_t request_count, mock_mosi_data_t *requests)
+{
+    for (size_t i = 0; i < CMD_COUNT; i++) {
+        if (cmds[i].expected_ret == LT_OK) {
+            LT_TEST_ASSERT(0, memcmp(cmds[i].data, cmds[i].data_in, cmds[i].len));
+        }
+    }
+
+    LT_TEST_ASSERT(request_count, lt_mock_hal_get_request_count(&h->l2));
+    for (size_t i = 0; i < request_count; i++) {
+        requests[i] = *lt_mock_hal_get_request(&h->l2, i);
+    }
+}
+
+void lt_test_mock_l3_queue(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_l3_queue()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    uint8_t kcmd[TR01_AES256_KEY_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, kcmd, sizeof(kcmd)));
+    size_t request_count = 0;
+    for (size_t i = 0; i < CMD_COUNT; i++) {
+        LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, cmds[i].data, sizeof(cmds[i].data)));
+        if (cmds[i].expected_ret != LT_PARAM_ERR) {
+            request_count++;
+        }
+    }
+    static mock_mosi_data_t sequential[MOCK_REQUEST_LOG_DEPTH], queued[MOCK_REQUEST_LOG_DEPTH];
+
+    LT_LOG_INFO("Executing the L3 Commands one by one...");
+    mock_cmds(h, kcmd);
+    for (size_t i = 0; i < CMD_COUNT; i++) {
+        lt_ret_t ret = cmds[i].is_ping ? lt_ping(h, cmds[i].data, cmds[i].data_in, cmds[i].len)
+                                       : lt_random_value_get(h, cmds[i].data_in, cmds[i].len);
+        LT_TEST_ASSERT(cmds[i].expected_ret, ret);
+    }
+    check_cmds(h, request_count, sequential);
+
+    LT_LOG_INFO("Executing the same L3 Commands in the queue...");
+    lt_l3_queue_t q;
+    LT_TEST_ASSERT(LT_OK, lt_l3_queue_init(&q));
+    mock_cmds(h, kcmd);
+    for (size_t i = 0; i < CMD_COUNT; i++) {
+        LT_TEST_ASSERT(LT_OK, lt_l3_queue_submit(h, &q, queue_cmd_out, queue_cmd_in, &cmds[i]));
+    }
+    // The first L3 Command is sent right away.
+    LT_TEST_ASSERT(1, lt_mock_hal_get_request_count(&h->l2));
+    for (size_t i = 0; i < CMD_COUNT; i++) {
+        void *ctx = NULL;
+        lt_ret_t cmd_ret;
+        LT_TEST_ASSERT(LT_OK, lt_l3_queue_poll(h, &q, &ctx, &cmd_ret));
+        LT_TEST_ASSERT(1, ctx == &cmds[i]);
+        LT_TEST_ASSERT(cmds[i].expected_ret, cmd_ret);
+    }
+    check_cmds(h, request_count, queued);
+
+    LT_LOG_INFO("Checking that the queue sent the same L3 Commands...");
+    for (size_t i = 0; i < request_count; i++) {
+        LT_TEST_ASSERT(sequential[i].len, queued[i].len);
+        LT_TEST_ASSERT(0, memcmp(sequential[i].data, queued[i].data, sequential[i].len));
+    }
+
+    LT_LOG_INFO("Checking that the next L3 Command was encrypted before the L3 Result was received...");
+#if LT_L3_STREAMING
+    // Nothing is prepared aside with LT_L3_STREAMING, the encryption IV is only that of the received L3 Result.
+    LT_TEST_ASSERT(1, cmds[0].in_encryption_iv);
+#else
+    // Ping and Random_Value_Get were encrypted, the next Ping failed, so the one after it is not prepared yet.
+    LT_TEST_ASSERT(2, cmds[0].in_encryption_iv);
+    LT_TEST_ASSERT(2, cmds[1].in_encryption_iv);
+    LT_TEST_ASSERT(4, cmds[3].in_encryption_iv);
+#endif
+    LT_TEST_ASSERT(4, cmds[4].in_encryption_iv);
+
+    LT_LOG_INFO("Checking that L3 Commands are not sent after the Secure Session was lost...");
+    mock_cmds(h, kcmd);
+    cmds[0].lose_session = true;
+    LT_TEST_ASSERT(LT_OK, lt_l3_queue_submit(h, &q, queue_cmd_out, queue_cmd_in, &cmds[0]));
+    LT_TEST_ASSERT(LT_OK, lt_l3_queue_submit(h, &q, queue_cmd_out, queue_cmd_in, &cmds[3]));
+    lt_ret_t cmd_ret;
+    LT_TEST_ASSERT(LT_OK, lt_l3_queue_poll(h, &q, NULL, &cmd_ret));
+    LT_TEST_ASSERT(LT_OK, cmd_ret);
+    LT_TEST_ASSERT(LT_OK, lt_l3_queue_poll(h, &q, NULL, &cmd_ret));
+    LT_TEST_ASSERT(LT_HOST_NO_SESSION, cmd_ret);
+    LT_TEST_ASSERT(1, lt_mock_hal_get_request_count(&h->l2));
+    cmds[0].lose_session = false;
+
+    LT_LOG_INFO("Checking full and empty queue...");
+    for (size_t i = 0; i < LT_L3_QUEUE_SIZE; i++) {
+        LT_TEST_ASSERT(LT_OK, lt_l3_queue_submit(h, &q, queue_cmd_out, queue_cmd_in, &cmds[i % CMD_COUNT]));
+    }
+    LT_TEST_ASSERT(LT_L3_QUEUE_FULL, lt_l3_queue_submit(h, &q, queue_cmd_out, queue_cmd_in, &cmds[0]));
+    for (size_t i = 0; i < LT_L3_QUEUE_SIZE; i++) {
+        void *ctx = NULL;
+        LT_TEST_ASSERT(LT_OK, lt_l3_queue_poll(h, &q, &ctx, &cmd_ret));
+        LT_TEST_ASSERT(1, ctx == &cmds[i % CMD_COUNT]);
+        // Parameters are checked before the Secure Session.
+        LT_TEST_ASSERT(cmds[i % CMD_COUNT].expected_ret == LT_PARAM_ERR ? LT_PARAM_ERR : LT_HOST_NO_SESSION, cmd_ret);
+    }
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_l3_queue_poll(h, &q, NULL, &cmd_ret));
+    LT_TEST_ASSERT(1, lt_mock_hal_get_request_count(&h->l2));
+
+    LT_LOG_INFO("Checking invalid parameters...");
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_l3_queue_init(NULL));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_l3_queue_submit(NULL, &q, queue_cmd_out, queue_cmd_in, NULL));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_l3_queue_submit(h, NULL, queue_cmd_out, queue_cmd_in, NULL));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_l3_queue_submit(h, &q, NULL, queue_cmd_in, NULL));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_l3_queue_submit(h, &q, queue_cmd_out, NULL, NULL));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_l3_queue_poll(NULL, &q, NULL, &cmd_ret));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_l3_queue_poll(h, &q, NULL, NULL));
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+}
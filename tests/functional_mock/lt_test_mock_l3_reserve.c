@@ -0,0 +1,149 @@
+/**
+ * @file lt_test_mock_l3_reserve.c
+ * @brief Test for building L3 Commands in place with the 'lt_out__*_reserve' functions and lt_out__commit().
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_l2.h"
+#include "libtropic_l3.h"
+#include "libtropic_logging.h"
+#include "libtropic_port_mock.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_l2_api_structs.h"
+#include "lt_l3_api_structs.h"
+#include "lt_l3_process.h"
+#include "lt_mock_helpers.h"
+#include "lt_port_wrap.h"
+#include "lt_test_common.h"
+
+// EdDSA_Sign message making L3 Command split into two chunks, which fits into the L3 buffer also with
+// LT_L3_STREAMING.
+#define EDDSA_MSG_LEN 240
+#define EDDSA_CHUNK_COUNT 2
+
+#define PING_MSG_LEN 100
+
+/**
+ * @brief Signs the message with EdDSA and stores the L2 Requests carrying its chunks.
+ *
+ * The Secure Session is started again before the command, so the encrypted chunks are the same on each call.
+ */
+static void eddsa_sign(lt_handle_t *h, const uint8_t *kcmd, const uint8_t *msg, const bool reserve,
+                       mock_mosi_data_t requests[EDDSA_CHUNK_COUNT])
+{
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    LT_TEST_ASSERT(LT_OK, mock_session_start(h, kcmd, kcmd));
+    // Padding of the L3 Command is not set by Libtropic, make it the same for both ways.
+    memset(h->l3.buff, 0, h->l3.buff_len);
+
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, EDDSA_CHUNK_COUNT));
+    uint8_t eddsa_sign_plaintext[TR01_L3_RESULT_SIZE + 15 + TR01_ECDSA_EDDSA_SIGNATURE_LENGTH] = {TR01_L3_RESULT_OK};
+    uint8_t *rs = &eddsa_sign_plaintext[TR01_L3_RESULT_SIZE + 15];
+    memset(rs, 0xa5, TR01_ECDSA_EDDSA_SIGNATURE_LENGTH);
+    LT_TEST_ASSERT(LT_OK, mock_l3_result(h, eddsa_sign_plaintext, sizeof(eddsa_sign_plaintext)));
+
+    if (reserve) {
+        uint8_t *msg_in_place;
+        LT_TEST_ASSERT(LT_OK, lt_out__ecc_eddsa_sign_reserve(h, TR01_ECC_SLOT_0, EDDSA_MSG_LEN, &msg_in_place));
+        LT_TEST_ASSERT(1, msg_in_place >= h->l3.buff && msg_in_place + EDDSA_MSG_LEN <= h->l3.buff + h->l3.buff_len);
+        memcpy(msg_in_place, msg, EDDSA_MSG_LEN);
+        LT_TEST_ASSERT(LT_OK, lt_out__commit(h));
+    }
+    else {
+        LT_TEST_ASSERT(LT_OK, lt_out__ecc_eddsa_sign(h, TR01_ECC_SLOT_0, msg, EDDSA_MSG_LEN));
+    }
+    LT_TEST_ASSERT(LT_OK, lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len));
+    LT_TEST_ASSERT(LT_OK, lt_l2_recv_encrypted_res(&h->l2, h->l3.buff,
+                                                   lt_min(h->l3.buff_len, TR01_L3_EDDSA_SIGN_RES_PACKET_SIZE)));
+    uint8_t rs_in[TR01_ECDSA_EDDSA_SIGNATURE_LENGTH];
+    LT_TEST_ASSERT(LT_OK, lt_in__ecc_eddsa_sign(h, rs_in));
+    LT_TEST_ASSERT(0, memcmp(rs, rs_in, sizeof(rs_in)));
+
+    LT_TEST_ASSERT(EDDSA_CHUNK_COUNT, lt_mock_hal_get_request_count(&h->l2));
+    for (size_t i = 0; i < EDDSA_CHUNK_COUNT; i++) {
+        requests[i] = *lt_mock_hal_get_request(&h->l2, i);
+    }
+}
+
+void lt_test_mock_l3_reserve(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_l3_reserve()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    uint8_t kcmd[TR01_AES256_KEY_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, kcmd, sizeof(kcmd)));
+    uint8_t msg[EDDSA_MSG_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, msg, sizeof(msg)));
+
+    LT_LOG_INFO("Signing with EdDSA_Sign copied into the L3 buffer...");
+    mock_mosi_data_t copied[EDDSA_CHUNK_COUNT];
+    eddsa_sign(h, kcmd, msg, false, copied);
+
+    LT_LOG_INFO("Signing with EdDSA_Sign built in place...");
+    mock_mosi_data_t built[EDDSA_CHUNK_COUNT];
+    eddsa_sign(h, kcmd, msg, true, built);
+
+    LT_LOG_INFO("Checking that both ways write the same L2 Requests...");
+    for (size_t i = 0; i < EDDSA_CHUNK_COUNT; i++) {
+        LT_TEST_ASSERT(copied[i].len, built[i].len);
+        LT_TEST_ASSERT(0, memcmp(copied[i].data, built[i].data, built[i].len));
+    }
+
+    LT_LOG_INFO("Pinging with message built in place...");
+    uint8_t ping_plaintext[TR01_L3_RESULT_SIZE + PING_MSG_LEN] = {TR01_L3_RESULT_OK};
+    uint8_t *msg_out;
+    uint8_t msg_in[PING_MSG_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, &ping_plaintext[TR01_L3_RESULT_SIZE], PING_MSG_LEN));
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, 1));
+    LT_TEST_ASSERT(LT_OK, mock_l3_result(h, ping_plaintext, sizeof(ping_plaintext)));
+    LT_TEST_ASSERT(LT_OK, lt_out__ping_reserve(h, PING_MSG_LEN, &msg_out));
+    memcpy(msg_out, &ping_plaintext[TR01_L3_RESULT_SIZE], PING_MSG_LEN);
+    LT_TEST_ASSERT(LT_OK, lt_out__commit(h));
+    LT_TEST_ASSERT(LT_OK, lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len));
+    LT_TEST_ASSERT(LT_OK, lt_l2_recv_encrypted_res(&h->l2, h->l3.buff,
+                                                   lt_min(h->l3.buff_len, TR01_L3_PING_RES_PACKET_SIZE_MAX)));
+    LT_TEST_ASSERT(LT_OK, lt_in__ping(h, msg_in, PING_MSG_LEN));
+    LT_TEST_ASSERT(0, memcmp(&ping_plaintext[TR01_L3_RESULT_SIZE], msg_in, PING_MSG_LEN));
+
+    LT_LOG_INFO("Checking that lt_out__commit() needs a reserved L3 Command...");
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_out__commit(h));
+    LT_TEST_ASSERT(LT_OK, lt_out__ping_reserve(h, PING_MSG_LEN, &msg_out));
+    LT_TEST_ASSERT(LT_OK, lt_out__r_mem_data_read(h, 0));  // Replaces the reserved L3 Command
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_out__commit(h));
+
+    LT_LOG_INFO("Checking reservation of maximal EdDSA_Sign message...");
+#if LT_L3_STREAMING
+    LT_TEST_ASSERT(LT_L3_BUFFER_TOO_SMALL,
+                   lt_out__ecc_eddsa_sign_reserve(h, TR01_ECC_SLOT_0, TR01_L3_EDDSA_SIGN_CMD_MSG_LEN_MAX, &msg_out));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_out__commit(h));
+#else
+    LT_TEST_ASSERT(LT_OK,
+                   lt_out__ecc_eddsa_sign_reserve(h, TR01_ECC_SLOT_0, TR01_L3_EDDSA_SIGN_CMD_MSG_LEN_MAX, &msg_out));
+    LT_TEST_ASSERT(1, msg_out + TR01_L3_EDDSA_SIGN_CMD_MSG_LEN_MAX + TR01_L3_TAG_SIZE <= h->l3.buff + h->l3.buff_len);
+#endif
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_out__ecc_eddsa_sign_reserve(h, TR01_ECC_SLOT_0,
+                                                                TR01_L3_EDDSA_SIGN_CMD_MSG_LEN_MAX + 1, &msg_out));
+
+    LT_LOG_INFO("Checking that reserved L3 Command is not committed after the session was invalidated...");
+    LT_TEST_ASSERT(LT_OK, lt_out__ping_reserve(h, PING_MSG_LEN, &msg_out));
+    lt_l3_invalidate_host_session_data(&h->l3);
+    LT_TEST_ASSERT(LT_HOST_NO_SESSION, lt_out__commit(h));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_out__commit(h));
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+}
@@ -0,0 +1,231 @@
+/**
+ * @file lt_test_mock_l3_streaming.c
+ * @brief Test for streaming large L3 payloads from/to caller's buffers with LT_L3_STREAMING.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "libtropic_port_mock.h"
+#include "lt_aesgcm.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_l2_api_structs.h"
+#include "lt_l3_api_structs.h"
+#include "lt_l3_process.h"
+#include "lt_mock_helpers.h"
+#include "lt_port_wrap.h"
+#include "lt_test_common.h"
+
+#if LT_L3_STREAMING
+// Handle has to fit into 1 KiB of RAM in this mode.
+#define HANDLE_SIZE_MAX 1024
+
+// Ping message making L3 Command split into four chunks.
+#define PING_MSG_LEN 900
+#define PING_CHUNK_COUNT 4
+
+// R_Mem_Data_Write with the maximal slot size of FW 2.0.0 is split into two chunks.
+#define R_MEM_DATA_LEN 475
+#define R_MEM_CHUNK_COUNT 2
+
+// EdDSA_Sign message making L3 Command split into three chunks.
+#define EDDSA_MSG_LEN 600
+#define EDDSA_CHUNK_COUNT 3
+
+/**
+ * @brief Encrypts the given L3 Command plaintext as a whole with the current IV, as TROPIC01 expects it.
+ */
+static void encrypt_expected(lt_handle_t *h, const uint8_t *plaintext, const uint16_t plaintext_size,
+                             uint8_t *expected)
+{
+    expected[0] = plaintext_size & 0xff;
+    expected[1] = plaintext_size >> 8;
+    LT_TEST_ASSERT(LT_OK, lt_aesgcm_encrypt(h->l3.crypto_ctx, h->l3.encryption_IV, TR01_L3_IV_SIZE, (uint8_t *)"", 0,
+                                            plaintext, plaintext_size, &expected[TR01_L3_SIZE_SIZE],
+                                            plaintext_size + TR01_L3_TAG_SIZE));
+}
+
+/**
+ * @brief Checks that the logged L2 Requests carry the expected L3 packet.
+ */
+static void check_chunks(lt_handle_t *h, const uint8_t *expected, const size_t expected_size, const size_t chunk_count)
+{
+    LT_TEST_ASSERT(chunk_count, lt_mock_hal_get_request_count(&h->l2));
+    size_t offset = 0;
+    for (size_t i = 0; i < chunk_count; i++) {
+        const mock_mosi_data_t *req = lt_mock_hal_get_request(&h->l2, i);
+        uint8_t req_len = req->data[TR01_L2_REQ_LEN_OFFSET];
+        LT_TEST_ASSERT(TR01_L2_ENCRYPTED_CMD_REQ_ID, req->data[0]);
+        LT_TEST_ASSERT(1, offset + req_len <= expected_size);
+        LT_TEST_ASSERT(0, memcmp(&expected[offset], &req->data[TR01_L2_REQ_ID_SIZE + TR01_L2_REQ_RSP_LEN_SIZE], req_len));
+        offset += req_len;
+    }
+    LT_TEST_ASSERT(expected_size, offset);
+}
+
+/**
+ * @brief Mocks Ping echoing the given message, split into the given number of chunks. Only the first
+ * `result_chunk_count` chunks of the L3 Result are mocked.
+ */
+static void mock_ping_part(lt_handle_t *h, const uint8_t *msg, const uint16_t msg_len, const size_t chunk_count,
+                           const size_t result_chunk_count)
+{
+    static uint8_t ping_plaintext[TR01_L3_RESULT_SIZE + TR01_PING_LEN_MAX];
+
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, chunk_count));
+    ping_plaintext[0] = TR01_L3_RESULT_OK;
+    memcpy(&ping_plaintext[TR01_L3_RESULT_SIZE], msg, msg_len);
+    LT_TEST_ASSERT(LT_OK,
+                   mock_l3_result_part(h, ping_plaintext, TR01_L3_RESULT_SIZE + msg_len, result_chunk_count));
+}
+
+/**
+ * @brief Mocks Ping echoing the given message, split into the given number of chunks.
+ */
+static void mock_ping(lt_handle_t *h, const uint8_t *msg, const uint16_t msg_len, const size_t chunk_count)
+{
+    mock_ping_part(h, msg, msg_len, chunk_count, SIZE_MAX);
+}
+
+/**
+ * @brief Mocks R_Mem_Data_Read returning the given data.
+ */
+static void mock_r_mem_data_read(lt_handle_t *h, const uint8_t *data, const uint16_t data_len)
+{
+    uint8_t r_mem_data_read_plaintext[TR01_L3_RESULT_SIZE + 3 + R_MEM_DATA_LEN] = {TR01_L3_RESULT_OK};
+
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, 1));
+    memcpy(&r_mem_data_read_plaintext[TR01_L3_RESULT_SIZE + 3], data, data_len);
+    LT_TEST_ASSERT(LT_OK, mock_l3_result(h, r_mem_data_read_plaintext, TR01_L3_RESULT_SIZE + 3 + data_len));
+}
+#endif
+
+void lt_test_mock_l3_streaming(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_l3_streaming()");
+    LT_LOG_INFO("----------------------------------------------");
+
+#if !LT_L3_STREAMING
+    LT_UNUSED(h);
+    LT_LOG_INFO("LT_L3_STREAMING is not enabled, skipping.");
+#else
+    LT_LOG_INFO("Checking size of the handle...");
+    LT_LOG_INFO("L3 buffer: %u B, handle: %u B", (unsigned)LT_SIZE_OF_L3_BUFF, (unsigned)sizeof(lt_handle_t));
+    LT_TEST_ASSERT(1, sizeof(lt_handle_t) < HANDLE_SIZE_MAX);
+
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+    LT_TEST_ASSERT(LT_L3_STREAMING_BUFF_SIZE, h->l3.buff_len);
+
+    LT_LOG_INFO("Setting up session...");
+    uint8_t kcmd[TR01_AES256_KEY_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, kcmd, sizeof(kcmd)));
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    LT_TEST_ASSERT(LT_OK, mock_session_start(h, kcmd, kcmd));
+
+    // Plaintexts of the L3 Commands, used to get the expected chunks. The payloads are sent from them directly.
+    static uint8_t ping_cmd_plaintext[TR01_L3_CMD_ID_SIZE + TR01_PING_LEN_MAX] = {TR01_L3_PING_CMD_ID};
+    static uint8_t expected[TR01_L3_PACKET_MAX_SIZE];
+    static uint8_t msg_in[TR01_PING_LEN_MAX];
+    uint8_t *msg_out = &ping_cmd_plaintext[TR01_L3_CMD_ID_SIZE];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, msg_out, TR01_PING_LEN_MAX));
+
+    LT_LOG_INFO("Pinging with %d-byte message...", PING_MSG_LEN);
+    uint16_t ping_cmd_size = TR01_L3_CMD_ID_SIZE + PING_MSG_LEN;
+    encrypt_expected(h, ping_cmd_plaintext, ping_cmd_size, expected);
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    mock_ping(h, msg_out, PING_MSG_LEN, PING_CHUNK_COUNT);
+    memset(msg_in, 0, sizeof(msg_in));
+    LT_TEST_ASSERT(LT_OK, lt_ping(h, msg_out, msg_in, PING_MSG_LEN));
+    LT_TEST_ASSERT(0, memcmp(msg_out, msg_in, PING_MSG_LEN));
+    check_chunks(h, expected, TR01_L3_SIZE_SIZE + ping_cmd_size + TR01_L3_TAG_SIZE, PING_CHUNK_COUNT);
+
+    LT_LOG_INFO("Pinging with maximal message...");
+    mock_ping(h, msg_out, TR01_PING_LEN_MAX, 17);
+    memset(msg_in, 0, sizeof(msg_in));
+    LT_TEST_ASSERT(LT_OK, lt_ping(h, msg_out, msg_in, TR01_PING_LEN_MAX));
+    LT_TEST_ASSERT(0, memcmp(msg_out, msg_in, TR01_PING_LEN_MAX));
+
+    LT_LOG_INFO("Writing and reading R-Memory slot with maximal data...");
+    uint8_t r_mem_cmd_plaintext[TR01_L3_CMD_ID_SIZE + 3 + R_MEM_DATA_LEN]
+        = {TR01_L3_R_MEM_DATA_WRITE_CMD_ID, 0x00, 0x00};  // Slot 0, padding
+    uint8_t *r_mem_data = &r_mem_cmd_plaintext[TR01_L3_CMD_ID_SIZE + 3];
+    LT_TEST_ASSERT(R_MEM_DATA_LEN, h->tr01_attrs.r_mem_udata_slot_size_max);
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, r_mem_data, R_MEM_DATA_LEN));
+    encrypt_expected(h, r_mem_cmd_plaintext, sizeof(r_mem_cmd_plaintext), expected);
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    // Padding of the L3 Command is not set by Libtropic, make it match the expected one.
+    memset(h->l3.buff, 0, h->l3.buff_len);
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, R_MEM_CHUNK_COUNT));
+    uint8_t r_mem_data_write_plaintext[] = {TR01_L3_RESULT_OK};
+    LT_TEST_ASSERT(LT_OK, mock_l3_result(h, r_mem_data_write_plaintext, sizeof(r_mem_data_write_plaintext)));
+    LT_TEST_ASSERT(LT_OK, lt_r_mem_data_write(h, 0, r_mem_data, R_MEM_DATA_LEN));
+    check_chunks(h, expected, TR01_L3_SIZE_SIZE + sizeof(r_mem_cmd_plaintext) + TR01_L3_TAG_SIZE, R_MEM_CHUNK_COUNT);
+
+    mock_r_mem_data_read(h, r_mem_data, R_MEM_DATA_LEN);
+    uint8_t r_mem_data_in[R_MEM_DATA_LEN];
+    uint16_t r_mem_data_read_size;
+    LT_TEST_ASSERT(LT_OK, lt_r_mem_data_read(h, 0, r_mem_data_in, sizeof(r_mem_data_in), &r_mem_data_read_size));
+    LT_TEST_ASSERT(R_MEM_DATA_LEN, r_mem_data_read_size);
+    LT_TEST_ASSERT(0, memcmp(r_mem_data, r_mem_data_in, R_MEM_DATA_LEN));
+
+    LT_LOG_INFO("Checking that reading R-Memory slot into too small buffer fails...");
+    mock_r_mem_data_read(h, r_mem_data, R_MEM_DATA_LEN);
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_r_mem_data_read(h, 0, r_mem_data_in, R_MEM_DATA_LEN - 1, &r_mem_data_read_size));
+
+    LT_LOG_INFO("Signing %d-byte message with EdDSA...", EDDSA_MSG_LEN);
+    uint8_t eddsa_cmd_plaintext[TR01_L3_CMD_ID_SIZE + 15 + EDDSA_MSG_LEN]
+        = {TR01_L3_EDDSA_SIGN_CMD_ID, TR01_ECC_SLOT_0, 0x00};  // Slot 0, padding of zeroes
+    uint8_t *eddsa_msg = &eddsa_cmd_plaintext[TR01_L3_CMD_ID_SIZE + 15];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, eddsa_msg, EDDSA_MSG_LEN));
+    encrypt_expected(h, eddsa_cmd_plaintext, sizeof(eddsa_cmd_plaintext), expected);
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    memset(h->l3.buff, 0, h->l3.buff_len);
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, EDDSA_CHUNK_COUNT));
+    uint8_t eddsa_sign_plaintext[TR01_L3_RESULT_SIZE + 15 + TR01_ECDSA_EDDSA_SIGNATURE_LENGTH] = {TR01_L3_RESULT_OK};
+    uint8_t *rs = &eddsa_sign_plaintext[TR01_L3_RESULT_SIZE + 15];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, rs, TR01_ECDSA_EDDSA_SIGNATURE_LENGTH));
+    LT_TEST_ASSERT(LT_OK, mock_l3_result(h, eddsa_sign_plaintext, sizeof(eddsa_sign_plaintext)));
+    uint8_t rs_in[TR01_ECDSA_EDDSA_SIGNATURE_LENGTH];
+    LT_TEST_ASSERT(LT_OK, lt_ecc_eddsa_sign(h, TR01_ECC_SLOT_0, eddsa_msg, EDDSA_MSG_LEN, rs_in));
+    LT_TEST_ASSERT(0, memcmp(rs, rs_in, sizeof(rs_in)));
+    check_chunks(h, expected, TR01_L3_SIZE_SIZE + sizeof(eddsa_cmd_plaintext) + TR01_L3_TAG_SIZE, EDDSA_CHUNK_COUNT);
+
+    LT_LOG_INFO("Checking that L3 Result whose transfer breaks clears the message...");
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    // The first chunk carries a part of the message, the next one is never received.
+    mock_ping_part(h, msg_out, PING_MSG_LEN, PING_CHUNK_COUNT, 1);
+    memset(msg_in, 0xff, sizeof(msg_in));
+    LT_TEST_ASSERT(1, LT_OK != lt_ping(h, msg_out, msg_in, PING_MSG_LEN));
+    for (size_t i = 0; i < PING_MSG_LEN; i++) {
+        LT_TEST_ASSERT(0, msg_in[i]);
+    }
+
+    LT_LOG_INFO("Checking that L3 Result with invalid tag invalidates the session and clears the message...");
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    mock_ping(h, msg_out, PING_MSG_LEN, PING_CHUNK_COUNT);
+    // The mocked L3 Result is encrypted with the current IV, so Libtropic expects a different tag.
+    h->l3.decryption_IV[0] ^= 0x01;
+    memset(msg_in, 0xff, sizeof(msg_in));
+    LT_TEST_ASSERT(LT_CRYPTO_ERR, lt_ping(h, msg_out, msg_in, PING_MSG_LEN));
+    LT_TEST_ASSERT(LT_SECURE_SESSION_OFF, h->l3.session_status);
+    for (size_t i = 0; i < PING_MSG_LEN; i++) {
+        LT_TEST_ASSERT(0, msg_in[i]);
+    }
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+#endif
+}
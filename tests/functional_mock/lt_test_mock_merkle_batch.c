@@ -0,0 +1,236 @@
+/**
+ * @file lt_test_mock_merkle_batch.c
+ * @brief Test for signing batches of messages with one signature of the root of their Merkle tree.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_port_mock.h"
+#include "lt_ecdsa_p256.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_l3_process.h"
+#include "lt_mock_helpers.h"
+#include "lt_port_wrap.h"
+#include "lt_test_common.h"
+
+#ifdef LT_ECDSA_P256_VERIFY
+// Result of lt_merkle_proof_verify() with a P-256 public key, the signature is checked.
+#define P256_VERIFIED(ret) (ret)
+#else
+// Result of lt_merkle_proof_verify() with a P-256 public key, the signature cannot be checked.
+#define P256_VERIFIED(ret) LT_NOT_SUPPORTED
+#endif
+
+// Odd number of messages, so nodes without a sibling are moved up on several levels.
+#define BATCH_COUNT 13
+// Large batch, still signed with a single L3 Command.
+#define LARGE_BATCH_COUNT 1000
+
+// Merkle Tree Hash (RFC 6962) of messages "message 0" - "message 12", computed independently.
+static const uint8_t expected_root[LT_MERKLE_NODE_LEN] = {
+    0x7e, 0x8f, 0x16, 0x27, 0x3e, 0x2b, 0xf4, 0x09, 0x2e, 0x0e, 0x77, 0xe0, 0x76, 0x67, 0x4d, 0xd1,
+    0x6a, 0x86, 0xad, 0xcf, 0x2f, 0x8f, 0x8e, 0x92, 0x26, 0xad, 0x36, 0xc9, 0x54, 0xf4, 0x17, 0xcf,
+};
+
+// P-256 key and its ECDSA signature of SHA-256(LT_MERKLE_ROOT_TAG || BATCH_COUNT || expected_root) as a digest, made
+// by the host in place of TROPIC01.
+static const uint8_t pubkey[TR01_CURVE_P256_PUBKEY_LEN] = {
+    0x9c, 0xea, 0x29, 0x0b, 0x08, 0xb2, 0x6a, 0x8a, 0x0f, 0x08, 0x39, 0x28, 0xf1, 0x19, 0x35, 0x57,
+    0xde, 0x38, 0xc6, 0xe2, 0x46, 0x52, 0xb1, 0xc7, 0xad, 0xab, 0x12, 0xf3, 0x57, 0x93, 0xf5, 0x34,
+    0xf2, 0xfc, 0x33, 0x7f, 0xb8, 0x9a, 0xde, 0x8b, 0x28, 0x2e, 0x3c, 0x47, 0xa9, 0x02, 0xca, 0x96,
+    0xff, 0x96, 0x3f, 0x9a, 0x83, 0x3f, 0x85, 0x9d, 0x51, 0x21, 0xcf, 0x84, 0x98, 0xfd, 0x13, 0x00,
+};
+static const uint8_t root_sig[TR01_ECDSA_EDDSA_SIGNATURE_LENGTH] = {
+    0x5d, 0x4a, 0x0a, 0x4a, 0xeb, 0xfc, 0x1b, 0xe3, 0xd1, 0x19, 0x9d, 0x86, 0xd3, 0x4c, 0x0e, 0x8f,
+    0x05, 0x6e, 0x75, 0xd8, 0xe3, 0xeb, 0x0d, 0x79, 0xd0, 0x7a, 0x1b, 0x0e, 0xec, 0x14, 0xa5, 0x7c,
+    0x24, 0xbb, 0x7e, 0xc7, 0xb2, 0x20, 0x16, 0x96, 0x64, 0xb4, 0x97, 0x52, 0xd1, 0x5f, 0x4d, 0xb6,
+    0x11, 0xab, 0x8c, 0xa0, 0x08, 0x96, 0xe1, 0x24, 0x53, 0x2b, 0x16, 0xbf, 0x8c, 0x28, 0x5d, 0x36,
+};
+// Plain ECDSA signature of 0x00 || "message 0" by the same key, as lt_ecc_ecdsa_sign() would make it. Its digest is
+// the root of a batch holding only "message 0".
+static const uint8_t plain_sig[TR01_ECDSA_EDDSA_SIGNATURE_LENGTH] = {
+    0x12, 0xdf, 0x57, 0x80, 0x3e, 0x9e, 0x24, 0x0c, 0xc8, 0x17, 0x83, 0xd7, 0x63, 0x61, 0xb6, 0xc1,
+    0xca, 0x9f, 0xdc, 0xee, 0x64, 0x1a, 0x95, 0xbc, 0x44, 0x9b, 0x5f, 0xb8, 0xa7, 0x20, 0xf1, 0x56,
+    0x31, 0x0e, 0x30, 0x7d, 0x8c, 0xad, 0x65, 0x4a, 0xe5, 0x22, 0xe6, 0x4e, 0xbb, 0xd2, 0xd6, 0x9e,
+    0x37, 0x5d, 0x4b, 0x3b, 0x2a, 0xb7, 0x8d, 0x32, 0x02, 0x59, 0x85, 0x25, 0x98, 0x86, 0xf7, 0xe4,
+};
+
+/**
+ * @brief Mocks the replies to ECDSA_Sign or EDDSA_Sign returning the signature.
+ */
+static void mock_sign(lt_handle_t *h, const uint8_t *rs)
+{
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, 1));
+    uint8_t sign_plaintext[TR01_L3_RESULT_SIZE + 15 + TR01_ECDSA_EDDSA_SIGNATURE_LENGTH] = {TR01_L3_RESULT_OK};
+    memcpy(&sign_plaintext[TR01_L3_RESULT_SIZE + 15], rs, TR01_ECDSA_EDDSA_SIGNATURE_LENGTH);
+    LT_TEST_ASSERT(LT_OK, mock_l3_result(h, sign_plaintext, sizeof(sign_plaintext)));
+}
+
+static uint32_t message(const uint32_t i, char *msg)
+{
+    return (uint32_t)sprintf(msg, "message %u", (unsigned)i);
+}
+
+void lt_test_mock_merkle_batch(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_merkle_batch()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    uint8_t kcmd[TR01_AES256_KEY_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, kcmd, sizeof(kcmd)));
+    LT_TEST_ASSERT(LT_OK, mock_session_start(h, kcmd, kcmd));
+
+    static uint8_t nodes[LT_MERKLE_BATCH_NODES(LARGE_BATCH_COUNT)][LT_MERKLE_NODE_LEN];
+    lt_merkle_batch_t batch;
+    static lt_merkle_proof_t proof;
+    char msg[32];
+    uint32_t msg_len;
+    uint16_t index;
+
+    LT_LOG_INFO("Adding %d messages to the batch...", BATCH_COUNT);
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_merkle_batch_init(&batch, nodes, 0));
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_init(&batch, nodes, BATCH_COUNT));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_merkle_batch_sign(h, &batch, TR01_ECC_SLOT_1, TR01_CURVE_P256));
+    for (uint32_t i = 0; i < BATCH_COUNT; i++) {
+        msg_len = message(i, msg);
+        LT_TEST_ASSERT(LT_OK, lt_merkle_batch_add(h, &batch, (uint8_t *)msg, msg_len, &index));
+        LT_TEST_ASSERT(i, index);
+    }
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_merkle_batch_add(h, &batch, (uint8_t *)msg, msg_len, &index));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_merkle_batch_proof(&batch, 0, &proof));
+
+    LT_LOG_INFO("Checking that the batch is not hashed while a message for ECDSA is hashed...");
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_init(h, TR01_ECC_SLOT_1));
+    LT_TEST_ASSERT(LT_SHA256_BUSY, lt_merkle_batch_sign(h, &batch, TR01_ECC_SLOT_1, TR01_CURVE_P256));
+    LT_TEST_ASSERT(LT_OK, lt_ecc_ecdsa_sign_abort(h));
+
+    LT_LOG_INFO("Signing the root with ECDSA...");
+    mock_sign(h, root_sig);
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_merkle_batch_sign(h, &batch, TR01_ECC_SLOT_31 + 1, TR01_CURVE_P256));
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_sign(h, &batch, TR01_ECC_SLOT_1, TR01_CURVE_P256));
+    LT_TEST_ASSERT(1, lt_mock_hal_get_request_count(&h->l2));
+    LT_TEST_ASSERT(0, memcmp(expected_root, batch.root, sizeof(expected_root)));
+    LT_TEST_ASSERT(0, memcmp(root_sig, batch.root_sig, sizeof(root_sig)));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_merkle_batch_add(h, &batch, (uint8_t *)msg, msg_len, &index));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_merkle_batch_sign(h, &batch, TR01_ECC_SLOT_1, TR01_CURVE_P256));
+
+    LT_LOG_INFO("Verifying proofs and the root signature of all messages...");
+    for (uint32_t i = 0; i < BATCH_COUNT; i++) {
+        msg_len = message(i, msg);
+        LT_TEST_ASSERT(LT_OK, lt_merkle_batch_proof(&batch, (uint16_t)i, &proof));
+        LT_TEST_ASSERT(P256_VERIFIED(LT_OK), lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, pubkey));
+    }
+    // The last message has no sibling on the two lowest levels.
+    LT_TEST_ASSERT(2, proof.path_len);
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_proof(&batch, 0, &proof));
+    LT_TEST_ASSERT(4, proof.path_len);
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_merkle_batch_proof(&batch, BATCH_COUNT, &proof));
+
+    LT_LOG_INFO("Checking that modified messages and proofs are rejected...");
+    msg_len = message(5, msg);
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_proof(&batch, 5, &proof));
+    LT_TEST_ASSERT(LT_MERKLE_PROOF_INVALID, lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len - 1, &proof, NULL));
+    msg[0] ^= 0x01;
+    LT_TEST_ASSERT(LT_MERKLE_PROOF_INVALID, lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, NULL));
+    msg[0] ^= 0x01;
+    proof.index = 4;
+    LT_TEST_ASSERT(LT_MERKLE_PROOF_INVALID, lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, NULL));
+    proof.index = BATCH_COUNT;
+    LT_TEST_ASSERT(LT_MERKLE_PROOF_INVALID, lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, NULL));
+    proof.index = 5;
+    // With 6 messages, the parent of the message has no sibling, so the path does not fit.
+    proof.count = 6;
+    LT_TEST_ASSERT(LT_MERKLE_PROOF_INVALID, lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, NULL));
+    proof.count = BATCH_COUNT;
+    proof.path_len--;
+    LT_TEST_ASSERT(LT_MERKLE_PROOF_INVALID, lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, NULL));
+    proof.path_len += 2;
+    LT_TEST_ASSERT(LT_MERKLE_PROOF_INVALID, lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, NULL));
+    proof.path_len = LT_MERKLE_PATH_MAX_LEN + 1;
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, NULL));
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_proof(&batch, 5, &proof));
+    proof.path[1][7] ^= 0x01;
+    LT_TEST_ASSERT(LT_MERKLE_PROOF_INVALID, lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, NULL));
+    proof.path[1][7] ^= 0x01;
+    proof.root[0] ^= 0x01;
+    LT_TEST_ASSERT(LT_MERKLE_PROOF_INVALID, lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, NULL));
+    proof.root[0] ^= 0x01;
+    proof.root_sig[63] ^= 0x01;
+    LT_TEST_ASSERT(LT_OK, lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, NULL));
+    LT_TEST_ASSERT(P256_VERIFIED(LT_MERKLE_PROOF_INVALID),
+                   lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, pubkey));
+    proof.root_sig[63] ^= 0x01;
+    LT_TEST_ASSERT(P256_VERIFIED(LT_OK), lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, pubkey));
+
+    LT_LOG_INFO("Checking that a plain signature of a message is not taken for a signed root...");
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_reset(&batch));
+    msg_len = message(0, msg);
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_add(h, &batch, (uint8_t *)msg, msg_len, &index));
+    mock_sign(h, plain_sig);
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_sign(h, &batch, TR01_ECC_SLOT_1, TR01_CURVE_P256));
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_proof(&batch, 0, &proof));
+#ifdef LT_ECDSA_P256_VERIFY
+    uint8_t key[LT_ECDSA_P256_PUBKEY_LEN] = {0x04};
+    memcpy(&key[1], pubkey, sizeof(pubkey));
+    LT_TEST_ASSERT(LT_OK, lt_ecdsa_p256_verify(key, proof.root, plain_sig));
+#endif
+    LT_TEST_ASSERT(LT_OK, lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, NULL));
+    LT_TEST_ASSERT(P256_VERIFIED(LT_MERKLE_PROOF_INVALID),
+                   lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, pubkey));
+
+    LT_LOG_INFO("Signing batch of one message with EdDSA...");
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_reset(&batch));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_merkle_batch_proof(&batch, 0, &proof));
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_add(h, &batch, NULL, 0, &index));
+    LT_TEST_ASSERT(0, index);
+    uint8_t rs[TR01_ECDSA_EDDSA_SIGNATURE_LENGTH];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, rs, sizeof(rs)));
+    mock_sign(h, rs);
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_sign(h, &batch, TR01_ECC_SLOT_2, TR01_CURVE_ED25519));
+    LT_TEST_ASSERT(0, memcmp(rs, batch.root_sig, sizeof(rs)));
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_proof(&batch, 0, &proof));
+    LT_TEST_ASSERT(0, proof.path_len);
+    LT_TEST_ASSERT(TR01_CURVE_ED25519, proof.curve);
+    LT_TEST_ASSERT(LT_OK, lt_merkle_proof_verify(h, NULL, 0, &proof, NULL));
+    LT_TEST_ASSERT(LT_NOT_SUPPORTED, lt_merkle_proof_verify(h, NULL, 0, &proof, pubkey));
+
+    LT_LOG_INFO("Signing batch of %d messages with one L3 Command...", LARGE_BATCH_COUNT);
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_init(&batch, nodes, LARGE_BATCH_COUNT));
+    int failed = 0;
+    for (uint32_t i = 0; i < LARGE_BATCH_COUNT; i++) {
+        msg_len = message(i, msg);
+        if (lt_merkle_batch_add(h, &batch, (uint8_t *)msg, msg_len, NULL) != LT_OK) {
+            failed++;
+        }
+    }
+    mock_sign(h, rs);
+    LT_TEST_ASSERT(LT_OK, lt_merkle_batch_sign(h, &batch, TR01_ECC_SLOT_2, TR01_CURVE_ED25519));
+    LT_TEST_ASSERT(1, lt_mock_hal_get_request_count(&h->l2));
+    for (uint32_t i = 0; i < LARGE_BATCH_COUNT; i++) {
+        msg_len = message(i, msg);
+        if (lt_merkle_batch_proof(&batch, (uint16_t)i, &proof) != LT_OK
+            || lt_merkle_proof_verify(h, (uint8_t *)msg, msg_len, &proof, NULL) != LT_OK) {
+            failed++;
+        }
+    }
+    LT_TEST_ASSERT(0, failed);
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+}
@@ -0,0 +1,90 @@
+/**
+ * @file lt_test_mock_pipelined_encryption.c
+ * @brief Test for encrypting L3 Command chunk by chunk while it is sent.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_l2.h"
+#include "libtropic_l3.h"
+#include "libtropic_logging.h"
+#include "libtropic_port_mock.h"
+#include "lt_aesgcm.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_l2_api_structs.h"
+#include "lt_l3_api_structs.h"
+#include "lt_l3_process.h"
+#include "lt_mock_helpers.h"
+#include "lt_port_wrap.h"
+#include "lt_test_common.h"
+
+// Ping message making L3 Command whose tag starts 4 bytes before the end of the second chunk, so the third chunk
+// contains only the rest of the tag.
+#define PING_MSG_LEN 497
+#define CHUNK_COUNT 3
+
+void lt_test_mock_pipelined_encryption(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_pipelined_encryption()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    LT_LOG_INFO("Setting up session...");
+    uint8_t kcmd[TR01_AES256_KEY_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, kcmd, sizeof(kcmd)));
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    LT_TEST_ASSERT(LT_OK, mock_session_start(h, kcmd, kcmd));
+
+    LT_LOG_INFO("Encrypting expected L3 Command as a whole...");
+    uint8_t ping_cmd_plaintext[TR01_L3_CMD_ID_SIZE + PING_MSG_LEN] = {TR01_L3_PING_CMD_ID};
+    uint8_t *msg_out = &ping_cmd_plaintext[TR01_L3_CMD_ID_SIZE];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, msg_out, PING_MSG_LEN));
+    uint8_t expected[TR01_L3_SIZE_SIZE + sizeof(ping_cmd_plaintext) + TR01_L3_TAG_SIZE]
+        = {sizeof(ping_cmd_plaintext) & 0xff, sizeof(ping_cmd_plaintext) >> 8};
+    LT_TEST_ASSERT(LT_OK, lt_aesgcm_encrypt(h->l3.crypto_ctx, h->l3.encryption_IV, TR01_L3_IV_SIZE, (uint8_t *)"", 0,
+                                            ping_cmd_plaintext, sizeof(ping_cmd_plaintext),
+                                            &expected[TR01_L3_SIZE_SIZE], sizeof(expected) - TR01_L3_SIZE_SIZE));
+
+    LT_LOG_INFO("Pinging with the L3 Command encrypted while it is sent...");
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, CHUNK_COUNT));
+    uint8_t ping_plaintext[TR01_L3_RESULT_SIZE + PING_MSG_LEN] = {TR01_L3_RESULT_OK};
+    memcpy(&ping_plaintext[TR01_L3_RESULT_SIZE], msg_out, PING_MSG_LEN);
+    LT_TEST_ASSERT(LT_OK, mock_l3_result(h, ping_plaintext, sizeof(ping_plaintext)));
+    uint8_t msg_in[PING_MSG_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_ping(h, msg_out, msg_in, PING_MSG_LEN));
+    LT_TEST_ASSERT(0, memcmp(msg_out, msg_in, PING_MSG_LEN));
+
+    LT_LOG_INFO("Checking that the chunks carry the L3 Command encrypted as a whole...");
+    LT_TEST_ASSERT(CHUNK_COUNT, lt_mock_hal_get_request_count(&h->l2));
+    size_t offset = 0;
+    for (size_t i = 0; i < CHUNK_COUNT; i++) {
+        const mock_mosi_data_t *req = lt_mock_hal_get_request(&h->l2, i);
+        uint8_t req_len = req->data[TR01_L2_REQ_LEN_OFFSET];
+        LT_TEST_ASSERT(TR01_L2_ENCRYPTED_CMD_REQ_ID, req->data[0]);
+        LT_TEST_ASSERT(1, offset + req_len <= sizeof(expected));
+        LT_TEST_ASSERT(0, memcmp(&expected[offset], &req->data[TR01_L2_REQ_ID_SIZE + TR01_L2_REQ_RSP_LEN_SIZE], req_len));
+        offset += req_len;
+    }
+    LT_TEST_ASSERT(sizeof(expected), offset);
+
+    LT_LOG_INFO("Checking that L3 Command left to be encrypted is not sent after the session was invalidated...");
+    LT_TEST_ASSERT(LT_OK, lt_out__ping(h, msg_out, PING_MSG_LEN));
+    lt_l3_invalidate_host_session_data(&h->l3);
+    LT_TEST_ASSERT(LT_HOST_NO_SESSION, lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len));
+    LT_TEST_ASSERT(CHUNK_COUNT, lt_mock_hal_get_request_count(&h->l2));
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+}
@@ -0,0 +1,146 @@
+/**
+ * @file lt_test_mock_res_decryption.c
+ * @brief Test for decrypting L3 Result chunk by chunk while it is received.
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_l2.h"
+#include "libtropic_l3.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "libtropic_port_mock.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_l2_api_structs.h"
+#include "lt_l3_api_structs.h"
+#include "lt_l3_process.h"
+#include "lt_mock_helpers.h"
+#include "lt_port_wrap.h"
+#include "lt_test_common.h"
+
+// Both the L3 Command and the L3 Result of the maximal Ping are split into 17 chunks.
+#define PING_MSG_LEN TR01_PING_LEN_MAX
+#define CHUNK_COUNT 17
+
+#if !LT_L3_STREAMING
+/**
+ * @brief Mocks Ping echoing the given message, only the first `result_chunk_count` chunks of the L3 Result are sent.
+ */
+static void mock_ping(lt_handle_t *h, const uint8_t *msg_out, const size_t result_chunk_count)
+{
+    static uint8_t ping_plaintext[TR01_L3_RESULT_SIZE + PING_MSG_LEN];
+
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, CHUNK_COUNT));
+    ping_plaintext[0] = TR01_L3_RESULT_OK;
+    memcpy(&ping_plaintext[TR01_L3_RESULT_SIZE], msg_out, PING_MSG_LEN);
+    LT_TEST_ASSERT(LT_OK, mock_l3_result_part(h, ping_plaintext, sizeof(ping_plaintext), result_chunk_count));
+}
+
+/**
+ * @brief Same as lt_ping(), but the L3 Result is decrypted while it is received only if `res_decryption` is set.
+ */
+static void ping(lt_handle_t *h, const uint8_t *msg_out, uint8_t *msg_in, const bool res_decryption)
+{
+    LT_TEST_ASSERT(LT_OK, lt_out__ping(h, msg_out, PING_MSG_LEN));
+    LT_TEST_ASSERT(LT_OK, lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len));
+    if (!res_decryption) {
+        h->l2.res_decryption = NULL;
+    }
+    LT_TEST_ASSERT(LT_OK, lt_l2_recv_encrypted_res(&h->l2, h->l3.buff,
+                                                   lt_min(h->l3.buff_len, TR01_L3_PING_RES_PACKET_SIZE_MAX)));
+    LT_TEST_ASSERT(res_decryption ? LT_L3_RES_DECRYPTION_DONE : LT_L3_RES_DECRYPTION_NONE,
+                   h->l3.res_decryption_status);
+    LT_TEST_ASSERT(LT_OK, lt_in__ping(h, msg_in, PING_MSG_LEN));
+}
+
+/**
+ * @brief Checks that no byte of the L3 buffer is left set.
+ */
+static bool l3_buff_zeroed(const lt_handle_t *h)
+{
+    for (uint16_t i = 0; i < h->l3.buff_len; i++) {
+        if (h->l3.buff[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+#endif
+
+void lt_test_mock_res_decryption(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_res_decryption()");
+    LT_LOG_INFO("----------------------------------------------");
+
+#if LT_L3_STREAMING
+    LT_UNUSED(h);
+    LT_LOG_INFO("LT_L3_STREAMING is enabled (the maximal L3 Result does not fit the L3 buffer), skipping.");
+#else
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    LT_LOG_INFO("Setting up session...");
+    uint8_t kcmd[TR01_AES256_KEY_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, kcmd, sizeof(kcmd)));
+    LT_TEST_ASSERT(LT_OK, mock_session_start(h, kcmd, kcmd));
+
+    static uint8_t msg_out[PING_MSG_LEN], msg_in[PING_MSG_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, msg_out, sizeof(msg_out)));
+
+    LT_LOG_INFO("Pinging with the L3 Result decrypted as a whole...");
+    mock_ping(h, msg_out, SIZE_MAX);
+    memset(msg_in, 0, sizeof(msg_in));
+    ping(h, msg_out, msg_in, false);
+    LT_TEST_ASSERT(0, memcmp(msg_out, msg_in, PING_MSG_LEN));
+
+    LT_LOG_INFO("Pinging with the L3 Result decrypted while it is received...");
+    mock_ping(h, msg_out, SIZE_MAX);
+    memset(msg_in, 0, sizeof(msg_in));
+    ping(h, msg_out, msg_in, true);
+    LT_TEST_ASSERT(0, memcmp(msg_out, msg_in, PING_MSG_LEN));
+
+    LT_LOG_INFO("Checking that L3 Result broken after its first chunk is not left decrypted in L3 buffer...");
+    mock_ping(h, msg_out, 1);
+    LT_TEST_ASSERT(LT_OK, lt_out__ping(h, msg_out, PING_MSG_LEN));
+    LT_TEST_ASSERT(LT_OK, lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len));
+    // The mock HAL has no more responses, so reading the second chunk fails.
+    LT_TEST_ASSERT(LT_FAIL, lt_l2_recv_encrypted_res(&h->l2, h->l3.buff,
+                                                     lt_min(h->l3.buff_len, TR01_L3_PING_RES_PACKET_SIZE_MAX)));
+    LT_TEST_ASSERT(true, l3_buff_zeroed(h));
+    LT_TEST_ASSERT(LT_L3_RES_DECRYPTION_NONE, h->l3.res_decryption_status);
+    LT_TEST_ASSERT(LT_SECURE_SESSION_ON, h->l3.session_status);
+
+    LT_LOG_INFO("Pinging after the broken L3 Result...");
+    // The failed read left the mock HAL in the middle of a frame.
+    lt_mock_hal_reset(&h->l2);
+    // The aborted L3 Result did not increase the decryption IV, the next one is mocked with the same.
+    mock_ping(h, msg_out, SIZE_MAX);
+    memset(msg_in, 0, sizeof(msg_in));
+    ping(h, msg_out, msg_in, true);
+    LT_TEST_ASSERT(0, memcmp(msg_out, msg_in, PING_MSG_LEN));
+
+    LT_LOG_INFO("Checking that L3 Result with invalid tag invalidates the session...");
+    mock_ping(h, msg_out, SIZE_MAX);
+    // The mocked L3 Result is encrypted with the current IV, so Libtropic expects a different tag.
+    h->l3.decryption_IV[0] ^= 0x01;
+    LT_TEST_ASSERT(LT_CRYPTO_ERR, lt_ping(h, msg_out, msg_in, PING_MSG_LEN));
+    LT_TEST_ASSERT(LT_SECURE_SESSION_OFF, h->l3.session_status);
+    LT_TEST_ASSERT(LT_L3_RES_DECRYPTION_NONE, h->l3.res_decryption_status);
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+#endif
+}
@@ -0,0 +1,102 @@
+/**
+ * @file lt_test_mock_spi_transfer_into.c
+ * @brief Test for receiving L3 Result chunks directly into the L3 buffer through lt_port_spi_transfer_into().
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "libtropic_port_mock.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_l1.h"
+#include "lt_l2_api_structs.h"
+#include "lt_l2_frame_check.h"
+#include "lt_l3_process.h"
+#include "lt_mock_helpers.h"
+#include "lt_port_wrap.h"
+#include "lt_test_common.h"
+
+// Ping message long enough to split both the L3 Command and the L3 Result into three chunks.
+#define PING_MSG_LEN 600
+#define CHUNK_COUNT 3
+
+#if !LT_L3_STREAMING
+/**
+ * @brief Sends Ping with the given message and checks that the same message is received.
+ */
+static void ping(lt_handle_t *h, const uint8_t *msg_out, const bool into_enabled)
+{
+    uint8_t ping_plaintext[TR01_L3_RESULT_SIZE + PING_MSG_LEN];
+    uint8_t msg_in[PING_MSG_LEN];
+
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_enable_spi_transfer_into(&h->l2, into_enabled));
+    size_t into_count = lt_mock_hal_get_spi_transfer_into_count(&h->l2);
+
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, CHUNK_COUNT));
+    ping_plaintext[0] = TR01_L3_RESULT_OK;
+    memcpy(&ping_plaintext[TR01_L3_RESULT_SIZE], msg_out, PING_MSG_LEN);
+    LT_TEST_ASSERT(LT_OK, mock_l3_result(h, ping_plaintext, sizeof(ping_plaintext)));
+
+    memset(msg_in, 0, sizeof(msg_in));
+    LT_TEST_ASSERT(LT_OK, lt_ping(h, msg_out, msg_in, PING_MSG_LEN));
+    LT_TEST_ASSERT(0, memcmp(msg_out, msg_in, PING_MSG_LEN));
+    LT_TEST_ASSERT(into_enabled ? CHUNK_COUNT : 0, lt_mock_hal_get_spi_transfer_into_count(&h->l2) - into_count);
+}
+
+#endif
+
+void lt_test_mock_spi_transfer_into(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_spi_transfer_into()");
+    LT_LOG_INFO("----------------------------------------------");
+
+#if LT_L3_STREAMING
+    LT_UNUSED(h);
+    LT_LOG_INFO("LT_L3_STREAMING is enabled (the L3 Result is not received into the L3 buffer), skipping.");
+#else
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    LT_LOG_INFO("Setting up session...");
+    uint8_t kcmd[TR01_AES256_KEY_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, kcmd, sizeof(kcmd)));
+    LT_TEST_ASSERT(LT_OK, mock_session_start(h, kcmd, kcmd));
+
+    uint8_t msg_out[PING_MSG_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, msg_out, sizeof(msg_out)));
+
+    LT_LOG_INFO("Pinging with the L3 Result copied from the L1 buffer...");
+    ping(h, msg_out, false);
+
+    LT_LOG_INFO("Pinging with the L3 Result received directly into the L3 buffer...");
+    ping(h, msg_out, true);
+
+    LT_LOG_INFO("Checking L3 Result chunk with invalid CRC received directly into the L3 buffer...");
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, 1));
+    uint8_t invalid_crc_frame[TR01_L1_CHIP_STATUS_SIZE + TR01_L2_STATUS_SIZE + TR01_L2_REQ_RSP_LEN_SIZE + 20
+                              + TR01_L2_REQ_RSP_CRC_SIZE]
+        = {TR01_L1_CHIP_MODE_READY_bit, TR01_L2_STATUS_RESULT_OK, 20};  // Dummy data and CRC of zeroes
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_enqueue_response(&h->l2, invalid_crc_frame, sizeof(invalid_crc_frame)));
+    size_t into_count = lt_mock_hal_get_spi_transfer_into_count(&h->l2);
+    uint8_t msg_in[1];
+    LT_TEST_ASSERT(LT_L2_IN_CRC_ERR, lt_ping(h, msg_out, msg_in, sizeof(msg_in)));
+    LT_TEST_ASSERT(1, lt_mock_hal_get_spi_transfer_into_count(&h->l2) - into_count);
+
+    LT_LOG_INFO("Terminating the Secure Session...");
+    LT_TEST_ASSERT(LT_OK, mock_session_abort(h));
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+#endif
+}
@@ -0,0 +1,108 @@
+/**
+ * @file lt_test_mock_spi_transfer_iov.c
+ * @brief Test for writing L3 Command chunks through lt_port_spi_transfer_iov().
+ * @copyright Copyright (c) 2020-2026 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "libtropic_port_mock.h"
+#include "lt_crc16.h"
+#include "lt_functional_mock_tests.h"
+#include "lt_l2_api_structs.h"
+#include "lt_l3_process.h"
+#include "lt_mock_helpers.h"
+#include "lt_port_wrap.h"
+#include "lt_test_common.h"
+
+// R_Mem_Data_Write with the maximal slot size of FW 2.0.0 is split into two chunks.
+#define CHUNK_COUNT 2
+
+#if !LT_L3_STREAMING
+/**
+ * @brief Writes R_Mem_Data_Write and stores the L2 Requests carrying its chunks.
+ *
+ * The Secure Session is started again before the command, so the encrypted chunks are the same on each call.
+ */
+static void write_r_mem_data(lt_handle_t *h, const uint8_t *kcmd, const uint8_t *data, const uint16_t data_size,
+                             const bool iov_enabled, mock_mosi_data_t requests[CHUNK_COUNT])
+{
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_reset(&h->l2));
+    LT_TEST_ASSERT(LT_OK, lt_mock_hal_enable_spi_transfer_iov(&h->l2, iov_enabled));
+    LT_TEST_ASSERT(LT_OK, mock_session_start(h, kcmd, kcmd));
+
+    LT_TEST_ASSERT(LT_OK, mock_l3_command_responses(h, CHUNK_COUNT));
+    uint8_t r_mem_data_write_plaintext[] = {
+        TR01_L3_RESULT_OK,
+    };
+    LT_TEST_ASSERT(LT_OK, mock_l3_result(h, r_mem_data_write_plaintext, sizeof(r_mem_data_write_plaintext)));
+    LT_TEST_ASSERT(LT_OK, lt_r_mem_data_write(h, 0, data, data_size));
+
+    LT_TEST_ASSERT(CHUNK_COUNT, lt_mock_hal_get_request_count(&h->l2));
+    LT_TEST_ASSERT(iov_enabled ? CHUNK_COUNT : 0, lt_mock_hal_get_spi_transfer_iov_count(&h->l2));
+    for (size_t i = 0; i < CHUNK_COUNT; i++) {
+        requests[i] = *lt_mock_hal_get_request(&h->l2, i);
+    }
+}
+
+#endif
+
+void lt_test_mock_spi_transfer_iov(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_mock_spi_transfer_iov()");
+    LT_LOG_INFO("----------------------------------------------");
+
+#if LT_L3_STREAMING
+    LT_UNUSED(h);
+    LT_LOG_INFO("LT_L3_STREAMING is enabled (the L3 Command is not kept in the L3 buffer), skipping.");
+#else
+    lt_mock_hal_reset(&h->l2);
+    LT_LOG_INFO("Mocking initialization...");
+    LT_TEST_ASSERT(LT_OK, mock_init_communication(h, (uint8_t[]){0x00, 0x00, 0x00, 0x02}));  // Version 2.0.0
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    uint8_t kcmd[TR01_AES256_KEY_LEN];
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, kcmd, sizeof(kcmd)));
+    uint8_t data[475];
+    LT_TEST_ASSERT(sizeof(data), h->tr01_attrs.r_mem_udata_slot_size_max);
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, data, sizeof(data)));
+
+    LT_LOG_INFO("Writing R_Mem_Data_Write with chunks copied into the L1 buffer...");
+    mock_mosi_data_t copied[CHUNK_COUNT];
+    write_r_mem_data(h, kcmd, data, sizeof(data), false, copied);
+
+    LT_LOG_INFO("Writing R_Mem_Data_Write with chunks gathered from the L3 buffer...");
+    mock_mosi_data_t gathered[CHUNK_COUNT];
+    write_r_mem_data(h, kcmd, data, sizeof(data), true, gathered);
+
+    LT_LOG_INFO("Checking that both ways write the same L2 Requests...");
+    for (size_t i = 0; i < CHUNK_COUNT; i++) {
+        const uint8_t *req = gathered[i].data;
+        uint16_t req_len = req[TR01_L2_REQ_LEN_OFFSET];
+        LT_TEST_ASSERT(TR01_L2_ENCRYPTED_CMD_REQ_ID, req[0]);
+        LT_TEST_ASSERT(TR01_L2_REQ_ID_SIZE + TR01_L2_REQ_RSP_LEN_SIZE + req_len + TR01_L2_REQ_RSP_CRC_SIZE,
+                       gathered[i].len);
+        uint16_t crc = crc16(req, TR01_L2_REQ_ID_SIZE + TR01_L2_REQ_RSP_LEN_SIZE + req_len);
+        LT_TEST_ASSERT(crc, (req[gathered[i].len - 2] << 8) | req[gathered[i].len - 1]);
+
+        LT_TEST_ASSERT(copied[i].len, gathered[i].len);
+        LT_TEST_ASSERT(0, memcmp(copied[i].data, gathered[i].data, gathered[i].len));
+    }
+    LT_TEST_ASSERT(TR01_L2_CHUNK_MAX_DATA_SIZE, gathered[0].data[TR01_L2_REQ_LEN_OFFSET]);
+
+    LT_LOG_INFO("Terminating the Secure Session...");
+    LT_TEST_ASSERT(LT_OK, mock_session_abort(h));
+
+    LT_LOG_INFO("Deinitializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_deinit(h));
+#endif
+}